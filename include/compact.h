@@ -0,0 +1,36 @@
+#ifndef COMPACT_H
+#define COMPACT_H
+
+#include <stdbool.h>
+#include "types.h"
+
+// 内存整理默认参数
+#define COMPACT_DEFAULT_BUDGET  16    // 后台整理每个时间片最多迁移的页框数
+
+// 内存整理状态
+typedef struct {
+    bool enabled;                // 是否在时间片轮转时后台整理
+    uint32_t budget;             // 每个时间片最多迁移的页框数
+    uint32_t migrated;           // 累计迁移页框数
+    uint32_t migrate_failed;     // 迁移失败次数
+    uint32_t background_runs;    // 后台整理发生迁移的时间片数
+    uint32_t full_runs;          // 不限迁移数的完整整理次数
+    uint32_t demand_success;     // 按需整理出连续区域的次数
+    uint32_t demand_failed;      // 按需整理失败的次数
+} CompactManager;
+
+// 内存整理管理函数
+void compact_init(void);
+void compact_set_enabled(bool enabled);
+void compact_tick(void);
+uint32_t compact_memory(uint32_t budget);
+bool compact_region(uint32_t count, uint32_t align);
+uint32_t compact_allocate_contiguous(uint32_t count, uint32_t align);
+void print_compact_stats(void);
+
+// 页框迁移
+bool compact_frame_movable(uint32_t frame);
+bool compact_migrate_frame(uint32_t src, uint32_t dst);
+uint32_t largest_free_run(void);
+
+#endif // COMPACT_H
@@ -0,0 +1,17 @@
+#ifndef COMPRESS_H
+#define COMPRESS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 压缩结果的最坏大小（不可压缩数据每255字节字面量多一个长度字节）
+#define LZ_COMPRESS_BOUND(n) ((n) + (n) / 255 + 16)
+
+// LZ77类块压缩（LZ4风格的序列格式，无外部依赖）
+// 返回压缩后的字节数，输出空间不足时返回0
+size_t lz_compress(const uint8_t* src, size_t src_len, uint8_t* dst, size_t dst_capacity);
+
+// 解压缩，返回解压后的字节数，数据损坏或输出空间不足时返回0
+size_t lz_decompress(const uint8_t* src, size_t src_len, uint8_t* dst, size_t dst_capacity);
+
+#endif // COMPRESS_H
@@ -0,0 +1,89 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define CONFIG_PATH_MAX         256   // 配置中文件路径的最大长度（含结尾的'\0'）
+
+// 系统几何参数（启动时由命令行或配置文件设置，之后不再改变）
+typedef struct {
+    uint32_t page_size;       // 页大小（字节，2的幂）
+    uint32_t page_shift;      // log2(page_size)
+    uint32_t physical_pages;  // 物理页框数
+    uint32_t virtual_pages;   // 每个进程的虚拟页数
+    uint32_t swap_size;       // 交换区块数
+    uint32_t max_processes;   // 进程表大小
+    uint64_t storage_size;    // 存储空间大小（字节）
+    uint32_t huge_page_size;  // 大页大小（字节，页大小的2的幂倍）
+    uint32_t huge_page_pages; // 每个大页包含的页数
+    uint32_t numa_nodes;      // NUMA 节点数（物理页框按节点等分）
+    uint32_t numa_distance;   // 跨节点访问距离（本节点为10）
+    uint32_t slow_pages;      // 慢速内存层页框数（包含在 physical_pages 中，位于 DRAM 之后）
+    uint32_t slow_latency;    // 慢速内存访问延迟（纳秒）
+    char storage_image[CONFIG_PATH_MAX]; // 启动时直接映射的存储映像文件，空表示使用内存存储
+} SystemConfig;
+
+extern SystemConfig system_config;
+
+// 默认值与原来的编译期常量相同
+#ifdef FIXED_PAGE_SIZE
+#define DEFAULT_PAGE_SIZE       FIXED_PAGE_SIZE
+#else
+#define DEFAULT_PAGE_SIZE       4096
+#endif
+#define DEFAULT_PHYSICAL_PAGES  256
+#define DEFAULT_VIRTUAL_PAGES   1024
+#define DEFAULT_MAX_PROCESSES   64
+#define DEFAULT_STORAGE_SIZE    (64ULL * 1024 * 1024)
+#define DEFAULT_HUGE_PAGE_SIZE  (2u * 1024 * 1024)
+#define DEFAULT_NUMA_NODES      1
+#define DEFAULT_NUMA_DISTANCE   20
+#define DEFAULT_SLOW_LATENCY    300
+
+#define MIN_PAGE_SIZE           512
+#define MAX_PAGE_SIZE           65536
+#define MAX_SWAP_SIZE           (1u << 24)   // 页表项中 swap_index 的位宽
+#define MAX_HUGE_PAGE_SIZE      (1u << 30)
+#define MAX_NUMA_NODES          8
+#define NUMA_LOCAL_DISTANCE     10    // 距离为相对单位，与 ACPI SLIT 表相同
+#define MAX_NUMA_DISTANCE       255
+#define DRAM_LATENCY_NS         100   // DRAM 访问延迟（纳秒），慢速内存的延迟不低于它
+#define MAX_SLOW_LATENCY        100000
+
+// 大页包含的页数（大页在虚拟和物理地址上都按此对齐）
+#define HUGE_PAGE_PAGES         (system_config.huge_page_pages)
+
+// 物理页框中 [0, DRAM_PAGES) 为 DRAM，[DRAM_PAGES, PHYSICAL_PAGES) 为慢速内存层
+#define SLOW_PAGES              (system_config.slow_pages)
+#define DRAM_PAGES              (system_config.physical_pages - system_config.slow_pages)
+
+// 编译时定义 FIXED_PAGE_SIZE（例如 -DFIXED_PAGE_SIZE=4096）时页大小是常量，
+// 地址转换中的移位和掩码在编译期确定，配置中只能使用该页大小
+#ifdef FIXED_PAGE_SIZE
+#define PAGE_SIZE           ((uint32_t)FIXED_PAGE_SIZE)
+#define PAGE_SHIFT          ((uint32_t)__builtin_ctz(FIXED_PAGE_SIZE))
+#else
+#define PAGE_SIZE           (system_config.page_size)
+#define PAGE_SHIFT          (system_config.page_shift)
+#endif
+
+// 虚拟地址到页号和页内偏移（页大小总是2的幂）
+static inline uint32_t page_of(uint32_t address) {
+    return address >> PAGE_SHIFT;
+}
+
+static inline uint32_t offset_in_page(uint32_t address) {
+    return address & (PAGE_SIZE - 1);
+}
+
+// 配置接口：先设置各项，最后由 config_apply 校验并计算派生值
+void config_defaults(void);
+bool config_set(const char* key, const char* value);
+bool config_load_file(const char* path);
+bool config_parse_args(int argc, char* argv[]);
+bool config_apply(void);
+void print_config(void);
+
+#endif // CONFIG_H
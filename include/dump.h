@@ -4,24 +4,124 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include "types.h"
+#include "process.h"
 
-// תṹ
+#define DUMP_PATH_MAX      256          // 快照文件路径最大长度
+#define DUMP_CHAIN_MAX     64           // 增量快照链最大长度
+#define SNAPSHOT_MAGIC     "VMSNAPSH"   // 快照文件标识
+#define SNAPSHOT_VERSION   7            // 快照格式版本
+#define SNAPSHOT_MAX_SECTIONS 8         // 最大段数
+
+// 快照类型
+typedef enum {
+    SNAPSHOT_FULL,          // 完整快照：所有已分配页框和已使用的交换区块
+    SNAPSHOT_INCREMENTAL    // 增量快照：只含上一个检查点以来变化的页框和交换区块
+} SnapshotType;
+
+// 段类型
+typedef enum {
+    SECTION_SYSTEM = 1,     // 系统状态（SnapshotSystem）
+    SECTION_PROCESSES,      // 进程记录（SnapshotProcess + 页表项）
+    SECTION_SWAP_TABLE,     // 交换区块信息（SwapBlockInfo[SWAP_SIZE]）
+    SECTION_FRAME_DATA,     // 页框数据（页面记录表 + 页面数据）
+    SECTION_SWAP_DATA       // 交换区块数据（页面记录表 + 页面数据）
+} SnapshotSectionType;
+
+#define SECTION_COMPRESSED  0x1   // 段内容整体压缩（元数据段）
+#define PAGE_COMPRESSED     0x1   // 页面数据已压缩
+#define PAGE_ZERO           0x2   // 全零页面的游程，不存放页面数据
+
+// 文件头，其后紧跟段表
+typedef struct {
+    char magic[8];                // SNAPSHOT_MAGIC
+    uint32_t version;             // SNAPSHOT_VERSION
+    uint32_t header_size;         // 文件头大小
+    uint32_t snapshot_type;       // 快照类型（SnapshotType）
+    uint32_t sequence;            // 在快照链中的序号（完整快照为0）
+    char parent[DUMP_PATH_MAX];   // 增量快照依赖的上一个快照文件
+    uint32_t page_size;           // 页面大小
+    uint32_t physical_pages;      // 物理页框数
+    uint32_t swap_size;           // 交换区块数
+    uint32_t section_count;       // 段数
+    uint32_t checksum;            // 文件头（本字段置0）和段表的CRC32
+    uint32_t reserved;            // 保持段表8字节对齐
+} SnapshotFileHeader;
+
+// 段表项
+typedef struct {
+    uint32_t type;                // 段类型（SnapshotSectionType）
+    uint32_t flags;               // SECTION_COMPRESSED
+    uint64_t offset;              // 段在文件中的偏移（8字节对齐，映射后可直接访问记录表）
+    uint64_t stored_size;         // 文件中的字节数
+    uint64_t raw_size;            // 解压后的字节数
+    uint32_t item_count;          // 记录数
+    uint32_t checksum;            // 元数据段：整段CRC32；数据段：页面记录表的CRC32
+} SnapshotSection;
+
+// 页面记录，数据段以记录表开头，页面数据按 offset 存放，可单独解压（按需读入）
+// 只记录已分配的页框和已使用的交换区块，连续的全零页面合并为一条 PAGE_ZERO 记录
+typedef struct {
+    uint32_t index;               // 起始页框号或交换区块索引
+    uint32_t count;               // 覆盖的页面数（只有零页游程大于1）
+    uint32_t flags;               // PAGE_COMPRESSED、PAGE_ZERO
+    uint32_t stored_size;         // 页面数据字节数（零页游程为0）
+    uint32_t checksum;            // 原始页面的CRC32
+    uint32_t reserved;
+    uint64_t offset;              // 页面数据相对段起始的偏移
+} SnapshotPageRecord;
+
+// 系统状态段
+typedef struct {
+    MemoryStats memory_stats;     // 内存统计
+    uint32_t process_count;       // 进程数量
+    uint32_t current_pid;         // 当前运行进程ID
+    uint32_t next_pid;            // 下一个可用的进程ID
+    uint32_t total_runtime;       // 系统总运行时间（时钟滴答）
+    uint32_t zero_frame;          // 零页框号
+} SnapshotSystem;
+
+// 进程记录（不含指针），其后紧跟 page_table_size 个页表项
 typedef struct {
-    // ϵͳ״̬
-    uint32_t total_pages;          // ҳ
-    uint32_t physical_pages;       // ҳ
-    uint32_t swap_size;           // С
-    
-    // ͳϢ
-    MemoryStats memory_stats;     // ڴͳ
-    
-    // Ϣ
-    uint32_t process_count;       // 
-    uint32_t current_pid;         // ǰнID
-} SystemStateHeader;
-
-// תָӿ
+    uint32_t pid;
+    char name[MAX_PROCESS_NAME];
+    uint32_t state;
+    uint32_t priority;
+    uint32_t time_slice;
+    uint32_t total_time_slice;
+    uint32_t wait_time;
+    uint32_t wake_tick;
+    uint32_t was_preempted;
+    uint32_t page_table_size;
+    uint64_t last_schedule_time;
+    ProcessStats stats;
+    ProcessMemoryLayout memory_layout;
+    AppConfig app_config;
+    MonitorConfig monitor_config;
+    NumaPlacement numa;
+} SnapshotProcess;
+
+// 数据转储与恢复接口
 bool dump_system_state(const char* filename);
-bool restore_system_state(const char* filename);
+bool restore_system_state(const char* filename);   // 增量快照沿快照链先恢复其依赖
+
+// 增量检查点：没有可用的检查点时自动保存完整快照
+bool dump_incremental_state(const char* filename);
+
+// 后台写入：捕获变化的数据后由写入线程保存，模拟继续运行
+bool dump_start_stream(const char* filename, bool incremental);
+bool dump_wait_stream(void);
+
+// 按时钟滴答周期保存增量检查点（interval 为0时关闭）
+void dump_set_auto_checkpoint(uint32_t interval, const char* prefix);
+void dump_tick(void);
+
+// 恢复后尚未读入的交换区块留在映射的快照文件中，首次读取时解压
+bool dump_swap_is_lazy(uint32_t swap_index);
+bool dump_lazy_swap_read(uint32_t swap_index, void* buffer);
+void dump_forget_lazy_swap(uint32_t swap_index);   // 交换区块被改写或释放时调用
+
+// 系统重置后旧的检查点不再可作为增量基线
+void dump_forget_checkpoint(void);
+void print_dump_status(void);
 
-#endif // DUMP_H 
\ No newline at end of file
+#endif // DUMP_H
@@ -0,0 +1,34 @@
+#ifndef KSM_H
+#define KSM_H
+
+#include <stdbool.h>
+#include "types.h"
+
+// 相同页合并默认参数
+#define KSM_DEFAULT_SCAN_INTERVAL  1     // 每隔多少个时间片扫描一次
+#define KSM_DEFAULT_PAGES_TO_SCAN  64    // 每次扫描的页框数
+
+// 相同页合并扫描器状态
+typedef struct {
+    bool enabled;                // 是否在时间片轮转时后台扫描
+    uint32_t scan_interval;      // 扫描间隔（时间片数）
+    uint32_t pages_to_scan;      // 每次扫描的页框数
+    uint32_t cursor;             // 下一个要扫描的页框
+    uint32_t ticks;              // 距上次扫描经过的时间片数
+    uint32_t full_scans;         // 完整扫描轮数
+    uint32_t pages_scanned;      // 累计扫描页框数
+    uint32_t pages_merged;       // 累计合并回收的页框数
+    uint32_t hash_collisions;    // 哈希相同但内容不同的次数
+} KsmManager;
+
+// 相同页合并管理函数
+void ksm_init(void);
+void ksm_set_enabled(bool enabled);
+void ksm_tick(void);
+uint32_t ksm_scan(uint32_t pages_to_scan);
+void print_ksm_stats(void);
+
+// 页面内容哈希（64位，四路并行累加）
+uint64_t ksm_hash_page(const void* page);
+
+#endif // KSM_H
@@ -16,13 +16,27 @@ typedef struct {
     uint32_t process_id;        // 占用进程ID
     uint32_t virtual_page_num;  // 对应的虚拟页号
     uint64_t last_access_time;  // 添加访问时间戳
+    uint32_t ref_count;         // 引用计数（页表项映射数，加上共享内存段的持有）
+    uint32_t rmap_head;         // 反向映射链表头，-1表示没有页表项映射
+    PCB* charged;               // 计入其私有页框数的进程，NULL表示不计入任何进程
+    uint64_t write_seq;         // 最后一次写入或重新分配时的写入序号（增量快照用）
+    bool thp_untouched;         // 透明大页中清零后尚未写入的子页，内存紧张时可直接回收
 } FrameInfo;
 
+// 页框的一个映射（反向映射项）
+typedef struct {
+    PCB* process;               // 映射该页框的进程
+    uint32_t virtual_page;      // 进程中的虚拟页号
+} FrameMapping;
+
 // 内存管理器结构
 typedef struct {
-    FrameInfo frames[PHYSICAL_PAGES];  // 页框信息数组
+    FrameInfo* frames;                 // 页框信息数组（PHYSICAL_PAGES 项）
     uint32_t free_frames_count;        // 空闲页框数量
     AllocationStrategy strategy;       // 分配策略
+    ReplacementScope replacement_scope; // 页面置换范围
+    uint32_t zero_frame;               // 全局只读零页框，未写入过的页面首次读取时映射到这里
+    uint64_t write_count;              // 页框写入序号（单调递增）
 } MemoryManager;
 
 // 物理内存结构
@@ -53,6 +67,7 @@ bool write_frame(uint32_t frame_number, const void* buffer);
 
 // 获取空闲页框数量
 uint32_t get_free_frames_count(void);
+uint32_t get_free_dram_frames(void);
 bool is_frame_allocated(uint32_t frame_number);
 
 // 读取物理内存
@@ -123,4 +138,41 @@ uint32_t select_victim_frame(void);
 bool swap_out_page(uint32_t frame);
 bool swap_in_page(uint32_t pid, uint32_t page, uint32_t frame);
 
+// 按置换范围为缺页进程选择牺牲页框（requester 为 NULL 时按全局处理）
+uint32_t select_victim_frame_for(PCB* requester);
+
+// 设置和获取页面置换范围
+void set_replacement_scope(ReplacementScope scope);
+ReplacementScope get_replacement_scope(void);
+const char* get_replacement_scope_name(ReplacementScope scope);
+
+// 页框引用计数和反向映射（写时复制和共享内存段共享）
+bool frame_get(uint32_t frame_number, uint32_t pid, uint32_t virtual_page);
+bool claim_frame(uint32_t frame_number);   // 把指定页框标记为已分配、暂无映射（恢复快照时使用）
+uint32_t allocate_contiguous_frames(uint32_t count, uint32_t align); // 连续对齐的页框（大页使用）
+uint32_t count_free_contiguous(uint32_t count, uint32_t align);
+void release_frame(uint32_t frame_number, uint32_t pid, uint32_t virtual_page);
+uint32_t get_frame_mappings(uint32_t frame_number, FrameMapping* mappings, uint32_t max_mappings);
+bool collect_frame_mappings(uint32_t frame_number, FrameMapping** mappings, uint32_t* count); // 数组由调用者释放
+uint32_t frame_mappings_begin(uint32_t frame_number);
+bool frame_mappings_next(uint32_t frame_number, uint32_t* cursor, FrameMapping* mapping);
+uint32_t count_frame_mappings(uint32_t frame_number);
+void clear_frame_mappings(uint32_t frame_number);
+void frame_update_charge(uint32_t frame_number); // 修改页框引用计数或归属后调用
+void frame_mark_written(uint32_t frame_number);  // 页框内容改变前调用，增量快照据此判断页框是否变化
+uint32_t count_shared_frames(void);
+uint32_t count_private_frames(void);
+
+// 零页框
+bool is_zero_page(const void* data);
+bool is_zero_frame(uint32_t frame_number);
+
+// 进程页框配额（由 app_config.min_memory/max_memory 换算，0 表示不限制）
+uint32_t get_process_resident_pages(PCB* process);
+uint32_t get_process_private_frames(PCB* process);
+uint32_t get_process_min_frames(PCB* process);
+uint32_t get_process_max_frames(PCB* process);
+bool process_at_frame_ceiling(PCB* process);
+bool can_evict_from(PCB* owner, PCB* requester);
+
 #endif // MEMORY_H
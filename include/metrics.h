@@ -0,0 +1,95 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdbool.h>
+#include <stdio.h>
+#include "types.h"
+
+// 指标注册表容量
+#define METRICS_MAX               128   // 注册的指标数
+#define METRICS_MAX_COUNTERS      32    // 分片计数器数
+#define METRICS_MAX_HISTOGRAMS    8     // 分片延迟直方图数
+#define METRICS_MAX_SHARDS        16    // 每个线程一个分片，超出的线程共用最后一个分片（原子加）
+#define METRICS_BUCKETS           25    // 直方图桶：2^7 ns 到 2^30 ns 各一个，再加 +Inf
+#define METRICS_FIRST_BUCKET_SHIFT 7
+
+// 指标类型（与 Prometheus 的类型对应）
+typedef enum {
+    METRIC_COUNTER,
+    METRIC_GAUGE,
+    METRIC_HISTOGRAM
+} MetricType;
+
+// 分片计数器：由调用者在热路径上累加
+typedef enum {
+    METRIC_LRU_HITS,          // 访问时页面已在内存中
+    METRIC_LRU_MISSES,        // 访问时缺页
+    METRIC_BUILTIN_COUNTERS
+} MetricCounter;
+
+// 分片延迟直方图
+typedef enum {
+    METRIC_FAULT_SERVICE,     // 缺页处理耗时（同步缺页的处理时间，异步换入从提交到完成）
+    METRIC_EVICTION,          // 换出一个页框的耗时
+    METRIC_SWAP_READ,         // 交换设备读取一个块的耗时
+    METRIC_SWAP_WRITE,        // 交换设备写入一个块的耗时
+    METRIC_BUILTIN_HISTOGRAMS
+} MetricHistogram;
+
+// 导出格式
+typedef enum {
+    METRICS_FORMAT_PROMETHEUS,
+    METRICS_FORMAT_JSON
+} MetricsFormat;
+
+// 快照中的一个进程样本（带 pid 标签）
+typedef struct {
+    uint32_t pid;
+    double value;
+} MetricSample;
+
+// 一个指标在快照中的值
+typedef struct {
+    const char* name;
+    const char* help;
+    MetricType type;
+    double value;                        // 计数器和仪表的值
+    MetricSample* samples;               // 按进程的样本（非 NULL 时代替 value）
+    uint32_t sample_count;
+    uint64_t buckets[METRICS_BUCKETS];   // 直方图各桶（非累计）
+    uint64_t count;                      // 直方图观测次数
+    double sum;                          // 直方图观测值之和（秒）
+} MetricValue;
+
+// 所有指标的一致快照
+typedef struct {
+    MetricValue values[METRICS_MAX];
+    uint32_t count;
+    uint64_t timestamp_ms;
+} MetricsSnapshot;
+
+// 注册表
+void metrics_init(void);
+void metrics_reset(void);
+uint32_t metrics_register_counter(const char* name, const char* help);
+uint32_t metrics_register_histogram(const char* name, const char* help);
+// 采集回调：导出时读取已有的统计结构，不在热路径上重复计数
+uint32_t metrics_register_reader(const char* name, const char* help, MetricType type, double (*read)(void));
+uint32_t metrics_register_process(const char* name, const char* help, MetricType type,
+                                  double (*read)(PCB* process));
+
+// 热路径更新（写本线程的分片，不加锁）
+void metrics_add(uint32_t counter, uint64_t delta);
+void metrics_observe_ns(uint32_t histogram, uint64_t nanoseconds);
+uint64_t metrics_now_ns(void);
+uint64_t metrics_counter_value(uint32_t counter);
+
+// 快照和导出
+void metrics_snapshot(MetricsSnapshot* snapshot);
+void metrics_snapshot_free(MetricsSnapshot* snapshot);
+void metrics_write_prometheus(FILE* out, const MetricsSnapshot* snapshot);
+void metrics_write_json(FILE* out, const MetricsSnapshot* snapshot);
+bool metrics_export(const char* path, MetricsFormat format);
+void print_metrics_summary(void);
+
+#endif // METRICS_H
@@ -0,0 +1,73 @@
+#ifndef NUMA_H
+#define NUMA_H
+
+#include <stdbool.h>
+#include "types.h"
+
+// 自动NUMA平衡默认参数
+#define NUMA_DEFAULT_HOT_THRESHOLD   4    // 同一远端节点连续访问多少次视为热页
+#define NUMA_DEFAULT_MIGRATE_BUDGET  8    // 每个时间片最多迁移的页框数
+
+// 内存分配策略
+typedef enum {
+    NUMA_POLICY_LOCAL,       // 优先分配进程所在节点的页框
+    NUMA_POLICY_INTERLEAVE,  // 按虚拟页号在各节点间轮流分配
+    NUMA_POLICY_PREFERRED    // 优先分配指定节点的页框
+} NumaPolicy;
+
+// 进程的NUMA放置信息
+typedef struct {
+    uint32_t home_node;        // 进程运行所在的节点
+    uint32_t policy;           // 分配策略（NumaPolicy）
+    uint32_t preferred_node;   // preferred 策略的首选节点
+    uint32_t local_accesses;   // 访问本节点页框的次数
+    uint32_t remote_accesses;  // 访问其他节点页框的次数
+} NumaPlacement;
+
+// 节点统计
+typedef struct {
+    uint32_t first_frame;      // 节点的第一个页框
+    uint32_t frame_count;      // 节点的页框数
+    uint32_t allocations;      // 在本节点分配页框的次数
+    uint32_t fallbacks;        // 首选其他节点但其空闲页框用尽、改在本节点分配的次数
+} NumaNode;
+
+// NUMA管理器
+typedef struct {
+    uint32_t node_count;
+    NumaNode nodes[MAX_NUMA_NODES];
+    uint32_t distance;                 // 跨节点访问距离（本节点为 NUMA_LOCAL_DISTANCE）
+    bool balancing;                    // 是否自动把热页迁移到访问节点
+    uint32_t hot_threshold;            // 热页阈值
+    uint32_t migrate_budget;           // 每个时间片最多迁移的页框数
+    uint64_t accesses[MAX_NUMA_NODES][MAX_NUMA_NODES]; // [进程节点][页框节点] 访问次数
+    uint64_t access_cost;              // 累计访问距离
+    uint32_t migrated;                 // 平衡迁移的页框数
+    uint32_t migrate_failed;           // 目标节点没有空闲页框或页框不可迁移的次数
+    uint32_t next_home;                // 节点负载相同时轮流分配进程
+} NumaManager;
+
+// 拓扑和页框分配
+void numa_init(void);
+uint32_t numa_node_count(void);
+uint32_t numa_node_of(uint32_t frame);
+void numa_node_range(uint32_t node, uint32_t* first, uint32_t* end);
+uint32_t numa_alloc_order(uint32_t pid, uint32_t virtual_page, uint32_t* order);
+void numa_note_allocation(uint32_t node, bool fallback);
+uint32_t numa_free_frames(uint32_t node);
+
+// 进程放置
+void numa_assign_home(PCB* process);
+bool numa_set_home(uint32_t pid, uint32_t node);
+bool numa_set_policy(uint32_t pid, NumaPolicy policy, uint32_t node);
+const char* numa_policy_name(uint32_t policy);
+
+// 访问统计和自动平衡
+void numa_record_access(PCB* process, uint32_t frame);
+void numa_set_balancing(bool enabled);
+void numa_set_distance(uint32_t distance);
+void numa_tick(void);
+uint32_t numa_balance(uint32_t budget);
+void print_numa_stats(void);
+
+#endif // NUMA_H
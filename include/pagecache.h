@@ -0,0 +1,59 @@
+#ifndef PAGECACHE_H
+#define PAGECACHE_H
+
+#include <stdbool.h>
+#include "types.h"
+#include "process.h"
+
+// 页缓存相关常量
+#define MAX_FILE_MAPPINGS  64     // 最大文件映射记录数
+
+// 文件映射记录（把一段连续的存储块映射到进程的一段连续虚拟页上）
+typedef struct {
+    bool in_use;            // 是否有效
+    uint32_t process_id;    // 映射进程ID
+    uint32_t start_block;   // 起始存储块号
+    uint32_t block_count;   // 块数（即页数）
+    uint32_t start_page;    // 起始虚拟页号
+} FileMapping;
+
+// 页缓存统计
+typedef struct {
+    uint32_t hits;           // 命中次数（读写和映射缺页）
+    uint32_t misses;         // 未命中、从存储读入的次数
+    uint32_t writebacks;     // 脏页写回存储的块数
+    uint32_t evictions;      // 被页面置换回收的页框数
+    uint32_t map_faults;     // 文件映射页面的缺页次数
+} PageCacheStats;
+
+// 页缓存管理函数
+void pagecache_init(void);
+
+// 经页缓存读写存储块（写入只修改缓存页，回写时才写入存储）
+bool pagecache_read(uint32_t block, void* buffer);
+bool pagecache_write(uint32_t block, const void* data);
+bool pagecache_readv(uint32_t start_block, uint32_t block_count, void* buffer);
+
+// 写回所有脏页，返回写回的块数
+uint32_t pagecache_sync(void);
+// 丢弃缓存中不再属于已分配区段的块（释放存储区段后调用）
+void pagecache_drop_unallocated(void);
+// 写回并丢弃全部缓存（切换存储后端时调用）
+void pagecache_invalidate_all(void);
+
+// 文件映射
+bool pagecache_map(uint32_t pid, uint32_t start_block, uint32_t block_count, uint32_t start_page);
+bool pagecache_unmap(uint32_t pid, uint32_t start_page);
+void pagecache_unmap_all(uint32_t pid);
+bool pagecache_fork_mappings(uint32_t parent_pid, uint32_t child_pid);
+
+// 缺页处理和回收（由虚拟内存管理调用）
+bool pagecache_handle_fault(PCB* process, uint32_t virtual_page);
+bool pagecache_find_frame(uint32_t frame_number, uint32_t* block);
+bool pagecache_evict_frame(uint32_t frame_number);
+void pagecache_migrate_frame(uint32_t old_frame, uint32_t new_frame);
+
+PageCacheStats get_pagecache_stats(void);
+void print_pagecache_status(void);
+
+#endif // PAGECACHE_H
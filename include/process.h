@@ -3,6 +3,7 @@
 
 #include "types.h"
 #include "memory.h"
+#include "numa.h"
 
 // 内存段类型
 typedef enum {
@@ -42,6 +43,7 @@ typedef struct {
         uint32_t stack_accesses;  // 栈访问次数
         uint32_t reads_from_disk; // 从磁盘读取次数
     } mem_stats;
+    uint32_t io_wait_ticks;       // 阻塞等待换入的时钟滴答数
 } ProcessStats;
 
 // PCB结构体定义
@@ -54,6 +56,7 @@ struct PCB {
     uint32_t total_time_slice;              // 总时间片
     uint32_t wait_time;                     // 等待时间
     uint64_t last_schedule_time;            // 上次调度时间
+    uint32_t wake_tick;                     // 缺页服务完成的时钟滴答（0表示等待I/O完成事件）
     bool was_preempted;                     // 是否被抢占
     PageTableEntry *page_table;             // 页表指针
     uint32_t page_table_size;               // 页表大小
@@ -64,6 +67,8 @@ struct PCB {
     ProcessMemoryLayout memory_layout;      // 内存布局
     AppConfig app_config;                   // 应用程序配置
     MonitorConfig monitor_config;           // 监控配置
+    NumaPlacement numa;                     // NUMA节点和分配策略
+    uint32_t private_frames;                // 只由本进程映射的页框数（页框配额按此计算）
 };
 
 // 进程调度器结构
@@ -75,8 +80,15 @@ typedef struct {
     
     // 新增字段
     uint32_t next_pid;      // 下一个可用的进程ID
-    uint32_t total_runtime; // 系统总运行时间
+    uint32_t total_runtime; // 系统总运行时间（时钟滴答）
     bool auto_balance;      // 是否启用自动平衡
+    
+    // CPU利用率统计
+    uint32_t fault_service_ticks; // 同步换入的缺页服务时间（时钟滴答，0表示不阻塞）
+    uint32_t busy_ticks;    // 有进程运行的滴答数
+    uint32_t iowait_ticks;  // 无进程可运行但有进程等待换入的滴答数
+    uint32_t idle_ticks;    // 无进程可运行的空闲滴答数
+    uint32_t fault_blocks;  // 因缺页服务阻塞的次数
 } ProcessScheduler;
 
 // 声明全局调度器
@@ -85,7 +97,7 @@ extern ProcessScheduler scheduler;
 // 新增的进程管理函数
 PCB* create_application(const char* name, AppConfig* config);
 bool setup_process_memory(PCB* process, ProcessMemoryLayout* layout);
-void update_process_stats(PCB* process, AccessType type);
+void update_process_stats(PCB* process, uint32_t virtual_page);
 void balance_process_memory(PCB* process);
 void print_process_stats(PCB* process);
 void monitor_process(PCB* process);
@@ -99,6 +111,7 @@ void optimize_memory_layout(PCB* process);
 // 进程管理函数
 PCB* process_create(uint32_t pid, uint32_t page_table_size);         // 创建进程
 void process_destroy(PCB* process);                                   // 销毁进程
+PCB* process_restore(const PCB* image);                               // 按快照中的状态放回进程表
 bool process_allocate_memory(PCB* pcb, uint32_t start_page, uint32_t num_pages);
 void process_free_memory(PCB* pcb, uint32_t start_page, uint32_t num_pages);
 
@@ -113,7 +126,12 @@ void set_process_priority(PCB* process, ProcessPriority priority);
 void update_process_state(PCB* process, ProcessState new_state);
 PCB* get_current_process(void);
 void time_tick(void);                    // 时间片轮转
-void set_running_process(PCB* process);
+bool set_running_process(PCB* process);  // 进程的页面无法调入时返回 false
+
+// 缺页服务时间：运行中的进程换入页面后阻塞到服务完成的时钟滴答，返回是否已阻塞
+bool block_for_fault_service(PCB* process);
+void set_fault_service_ticks(uint32_t ticks);
+void print_cpu_utilization(void);
 
 // 进程状态查询函数
 PCB* get_ready_queue(ProcessPriority priority);
@@ -131,6 +149,7 @@ bool is_process_analyzed(PCB* process, PCB** analyzed_list, int analyzed_count);
 
 // 进程查询函数
 PCB* get_process_by_pid(uint32_t pid);
+PCB* get_process_by_index(uint32_t index);  // 按进程表槽位查询，用于遍历所有进程
 
 // 内存优化相关函数
 void analyze_memory_usage(PCB* process);
@@ -140,6 +159,7 @@ void balance_memory_usage(void);
 // 进程管理相关函数声明
 PCB* create_process_with_pid(uint32_t pid, uint32_t priority, uint32_t code_pages, uint32_t data_pages);
 PCB* create_process(uint32_t priority, uint32_t code_pages, uint32_t data_pages);
+PCB* fork_process(uint32_t parent_pid);  // 以写时复制方式复制进程
 void process_destroy(PCB* process);
 PCB* get_process_by_pid(uint32_t pid);
 void balance_process_memory(PCB* process);
@@ -149,8 +169,10 @@ void initialize_process_memory(PCB* process);
 
 // 进程相关常量
 #define DEFAULT_TIME_SLICE 10
+#define DEFAULT_FAULT_SERVICE_TICKS 2  // 默认缺页服务时间（时钟滴答）
 #define DEFAULT_PRIORITY 1
-#define MAX_PAGES_PER_PROCESS 256  // 每个进程最大页表项数
+#define MAX_PAGES_PER_PROCESS 256       // 每个进程最大页表项数
+#define MIN_RUNNABLE_PAGES_RATIO 25.0f  // 进程运行前可运行页面（驻留或可按需建立）的最低比例（%）
 
 // 模拟进程访存
 void simulate_process_memory_access(uint32_t pid, uint32_t access_count);
@@ -161,7 +183,7 @@ void allocate_process_memory(uint32_t pid, uint32_t size, uint32_t flags);
 
 // 新增函数声明
 void check_preemption(PCB* new_process);           // 检查是否需要进程抢占
-void preempt_process(PCB* current, PCB* new_proc); // 执行进程抢占
+bool preempt_process(PCB* current, PCB* new_proc); // 执行进程抢占，新进程无法运行时返回 false
 void restore_preempted_process(PCB* process);      // 恢复被抢占的进程
 bool should_preempt(PCB* current, PCB* new_proc);  // 判断是否应该抢占
 
@@ -188,5 +210,6 @@ void analyze_memory_usage(PCB* process);
 void optimize_memory_layout(PCB* process);
 void balance_memory_usage(void);
 float calculate_physical_pages_ratio(PCB* process);
+float calculate_runnable_pages_ratio(PCB* process);  // 驻留或不需要换入就能建立的页面比例
 
 #endif // PROCESS_H 
\ No newline at end of file
@@ -0,0 +1,49 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdbool.h>
+#include "types.h"
+
+// 访问剖析参数
+#define PROFILE_MAX_PROCESSES   8     // 同时剖析的进程数
+#define PROFILE_MRC_POINTS      16    // 缺页率曲线打印的页框数采样点
+#define PROFILE_HEATMAP_WIDTH   64    // 热度图每行的页数
+#define PROFILE_TOP_PAGES       8     // 打印访问最多的页面数
+
+// 一个进程的访问剖析
+//
+// 重用距离（LRU 栈距离）是同一页面两次访问之间访问过的不同页面数。
+// 按访问时间戳建立树状数组，每个页面只在它最近一次访问的时间戳上记 1，
+// 两次访问之间的不同页面数即为区间和，每次访问 O(log n)。
+typedef struct {
+    bool active;
+    uint32_t pid;
+    uint32_t pages;               // 剖析的页数（进程页表大小）
+    uint32_t* access_counts;      // 每页访问次数
+    uint32_t* last_time;          // 每页最近一次访问的时间戳，0 表示还没访问过
+    uint32_t* tree;               // 树状数组（下标 1..tree_size）
+    uint32_t tree_size;           // 时间戳窗口大小，用尽后按访问顺序重新编号
+    uint32_t clock;               // 最近一次访问的时间戳
+    uint32_t* histogram;          // histogram[d]：重用距离为 d 的访问次数
+    uint64_t accesses;            // 剖析期间的访问次数
+    uint64_t cold_misses;         // 首次访问（重用距离为无穷大）
+    uint32_t distinct_pages;      // 访问过的不同页面数
+    uint32_t renumbers;           // 时间戳重新编号的次数
+    uint32_t start_faults;        // 开始剖析时进程的缺页次数
+} ProcessProfile;
+
+// 访问剖析管理函数
+void profile_init(void);
+bool profile_start(uint32_t pid);
+bool profile_stop(uint32_t pid);
+void profile_forget(uint32_t pid);
+void profile_record_access(PCB* process, uint32_t virtual_page);
+
+// 缺页率曲线：进程独占 frames 个页框、按 LRU 置换时的预测缺页次数
+uint64_t profile_predicted_misses(uint32_t pid, uint32_t frames);
+
+void print_profile(uint32_t pid, double target_rate);
+void print_profile_heatmap(uint32_t pid);
+void print_profile_list(void);
+
+#endif // PROFILE_H
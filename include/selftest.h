@@ -0,0 +1,7 @@
+#ifndef SELFTEST_H
+#define SELFTEST_H
+
+// 场景测试：以 --test 启动时运行（make test），返回失败的场景数
+int run_scenario_tests(void);
+
+#endif // SELFTEST_H
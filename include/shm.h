@@ -0,0 +1,49 @@
+#ifndef SHM_H
+#define SHM_H
+
+#include <stdbool.h>
+#include "types.h"
+#include "process.h"
+
+// 共享内存相关常量
+#define MAX_SHM_SEGMENTS     16     // 最大共享内存段数
+#define MAX_SHM_PAGES        64     // 每个共享内存段最大页数
+#define MAX_SHM_ATTACHMENTS  128    // 最大挂接记录数
+#define MAX_SHM_NAME         32     // 共享内存段名称最大长度
+
+// 共享内存段结构
+typedef struct {
+    bool in_use;                          // 是否已创建
+    char name[MAX_SHM_NAME];              // 段名称
+    uint32_t page_count;                  // 页数
+    uint32_t frames[MAX_SHM_PAGES];       // 每页所在页框，-1表示不在内存中
+    uint32_t swap_blocks[MAX_SHM_PAGES];  // 每页所在交换区块，-1表示不在交换区
+    uint32_t attach_count;                // 挂接次数
+} ShmSegment;
+
+// 共享内存挂接记录（进程把段挂接到一段连续的虚拟页上）
+typedef struct {
+    bool in_use;            // 是否有效
+    uint32_t process_id;    // 挂接进程ID
+    uint32_t segment_id;    // 共享内存段下标
+    uint32_t start_page;    // 起始虚拟页号
+} ShmAttachment;
+
+// 共享内存管理函数
+void shm_init(void);
+int shm_create(const char* name, uint32_t page_count);
+bool shm_destroy(const char* name);
+bool shm_attach(uint32_t pid, const char* name, uint32_t start_page);
+bool shm_detach(uint32_t pid, const char* name);
+void shm_detach_all(uint32_t pid);
+bool shm_fork_attachments(uint32_t parent_pid, uint32_t child_pid);
+void print_shm_status(void);
+
+// 缺页处理和换出（由虚拟内存管理调用）
+bool shm_handle_fault(PCB* process, uint32_t virtual_page);
+bool shm_find_frame(uint32_t frame_number, uint32_t* segment_id, uint32_t* page_index);
+bool shm_swap_out_page(uint32_t segment_id, uint32_t page_index, uint32_t frame_number);
+void shm_migrate_frame(uint32_t old_frame, uint32_t new_frame);
+bool shm_relocate_swap_block(uint32_t old_index, uint32_t new_index);
+
+#endif // SHM_H
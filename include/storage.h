@@ -5,41 +5,70 @@
 #include <stdbool.h>
 #include "types.h"
 
-// 洢ó
-#define STORAGE_SIZE (64 * 1024 * 1024)  // 64MB 洢ռ
-#define BLOCK_SIZE (4 * 1024)            // 4KB С
-#define MAX_BLOCKS (STORAGE_SIZE / BLOCK_SIZE)
+// 存储配置常量
+#define STORAGE_SIZE ((size_t)system_config.storage_size)  // 存储空间大小（默认64MB）
+#define BLOCK_SIZE PAGE_SIZE                               // 块大小与页大小相同
+#define MAX_BLOCKS ((uint32_t)(STORAGE_SIZE / BLOCK_SIZE))
+#define STORAGE_NIL ((uint32_t)-1)       // 空节点
+#define STORAGE_PATH_MAX 256             // 存储映像文件路径最大长度
 
-// 洢״̬
+// 存储区段（按起始块号排序的AVL树节点）
 typedef struct {
-    uint32_t start_block;     // ʼ
-    uint32_t block_count;     // 
-    bool is_free;            // Ƿ
-    uint32_t process_id;      // ռýID
+    uint32_t start_block;     // 起始块号
+    uint32_t block_count;     // 块数量
+    bool is_free;            // 是否空闲
+    uint32_t process_id;      // 占用进程ID
+    uint32_t left;            // 左子树（节点下标）
+    uint32_t right;           // 右子树（节点下标）
+    uint32_t height;          // 子树高度
+    uint32_t max_count;       // 子树中最大区段的块数（首次适应查找用）
 } StorageBlock;
 
-// 洢
+// 存储管理器
 typedef struct {
-    void* disk_space;                    // ģ̿ռ
-    StorageBlock* blocks;                // 洢Ϣ
-    uint32_t total_blocks;               // ܿ
-    uint32_t free_blocks;                // п
-    uint32_t block_size;                 // С
+    uint8_t* region;                     // 元数据和块数据所在的整块空间
+    bool mapped;                         // 是否映射到存储映像文件
+    int fd;                              // 存储映像文件描述符
+    char path[STORAGE_PATH_MAX];         // 存储映像文件路径
+    uint32_t syncs;                      // msync 检查点次数
+    void* disk_space;                    // 模拟磁盘空间
+    StorageBlock* blocks;                // 区段节点池
+    uint32_t* alloc_bitmap;              // 块分配位图（每块一位）
+    uint32_t free_root;                  // 空闲区段树
+    uint32_t used_root;                  // 已分配区段树
+    uint32_t free_node;                  // 未使用节点链表（经 left 链接）
+    uint32_t free_extents;               // 空闲区段数
+    uint32_t used_extents;               // 已分配区段数
+    uint32_t total_blocks;               // 总块数
+    uint32_t free_blocks;                // 空闲块数
+    uint32_t block_size;                 // 块大小
 } StorageManager;
 
-// 洢ӿ
+// 存储管理接口
 void storage_init(void);
 void storage_shutdown(void);
 
-// 洢
+// 存储后端：内存或映射的存储映像文件（元数据保存在文件头部区域）
+bool storage_use_memory(void);
+bool storage_use_file(const char* path);
+bool storage_sync(void);
+
+// 存储分配与回收
 uint32_t storage_allocate(uint32_t size);
 void storage_free(uint32_t start_block);
 
-// ݶд
+// 数据读写
 bool storage_read(uint32_t block_num, void* buffer);
 bool storage_write(uint32_t block_num, const void* data);
 
-// ״̬ѯ
+// 连续多块读写，一次复制整个范围（范围内的块必须都已分配）
+bool storage_readv(uint32_t start_block, uint32_t block_count, void* buffer);
+bool storage_writev(uint32_t start_block, uint32_t block_count, const void* data);
+
+// 范围内的块是否都已分配（不打印错误）
+bool storage_is_allocated(uint32_t start_block, uint32_t block_count);
+
+// 状态查询
 uint32_t get_free_blocks_count(void);
 void print_storage_status(void);
 
@@ -0,0 +1,59 @@
+#ifndef SWAPALLOC_H
+#define SWAPALLOC_H
+
+#include <stdbool.h>
+#include "types.h"
+
+// 交换区簇参数
+#define SWAP_CLUSTER_SIZE    16                              // 每个簇的交换区块数
+#define SWAP_CLUSTERS        (SWAP_SIZE / SWAP_CLUSTER_SIZE) // 簇数
+#define SWAP_COMPACT_BATCH   4                               // 每个时钟滴答后台整理迁移的块数
+#define SWAP_COMPACT_SCAN    (SWAP_COMPACT_BATCH * SWAP_CLUSTER_SIZE) // 每个时钟滴答后台整理最多检查的块数
+
+// 交换区簇：预留给一个进程（或共享内存段）的一段连续虚拟页，
+// 虚拟页在簇内的槽位与其在这段虚拟页中的偏移相同
+typedef struct {
+    bool reserved;           // 是否已预留
+    uint32_t owner;          // 所属进程ID（共享内存段为0）
+    uint32_t group;          // 虚拟页组号（虚拟页号 / SWAP_CLUSTER_SIZE）
+    uint32_t used;           // 簇内已使用的块数
+} SwapCluster;
+
+// 交换区分配统计
+typedef struct {
+    uint32_t cluster_allocs;     // 分配到所属簇对应槽位的次数
+    uint32_t cluster_reserves;   // 预留新簇的次数
+    uint32_t fallback_allocs;    // 没有可用簇时退化为首次适应的次数
+    uint32_t compact_runs;       // 整理次数
+    uint32_t compact_moves;      // 整理迁移的块数
+    uint32_t compact_failures;   // 迁移失败次数
+} SwapAllocStats;
+
+// 交换区碎片信息
+typedef struct {
+    uint32_t free_blocks;        // 空闲块数
+    uint32_t free_extents;       // 空闲区段数
+    uint32_t largest_free;       // 最大空闲区段块数
+    uint32_t free_clusters;      // 完全空闲的簇数
+    uint32_t misplaced_blocks;   // 不在所属簇对应槽位上的块数
+    uint32_t adjacent_pairs;     // 虚拟相邻且都在交换区的页面对数
+    uint32_t contiguous_pairs;   // 其中交换区块也相邻的对数
+} SwapFragInfo;
+
+// 交换区分配器管理
+void swapalloc_init(void);
+void swapalloc_rebuild(void);   // 按交换区块信息重建簇状态（清理或恢复交换区后调用）
+
+// 为进程虚拟页选择交换区块并计入所属簇，返回-1表示交换区已满
+uint32_t swapalloc_alloc(uint32_t process_id, uint32_t virtual_page);
+void swapalloc_free(uint32_t swap_index);
+
+// 交换区整理：把错位的块迁移到所属簇的对应槽位，返回迁移块数
+uint32_t swap_compact(uint32_t max_moves);
+void swap_compact_tick(void);
+
+SwapFragInfo get_swap_fragmentation(void);
+SwapAllocStats get_swapalloc_stats(void);
+void print_swap_fragmentation(void);
+
+#endif // SWAPALLOC_H
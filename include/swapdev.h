@@ -0,0 +1,54 @@
+#ifndef SWAPDEV_H
+#define SWAPDEV_H
+
+#include <stdbool.h>
+#include "types.h"
+
+#define SWAPDEV_PATH_MAX   256     // 交换文件路径最大长度
+#define SWAPDEV_ALIGNMENT  4096    // O_DIRECT 要求的缓冲区与偏移对齐
+
+// 交换设备类型
+typedef enum {
+    SWAPDEV_MEMORY,   // 内存中的交换区（malloc 缓冲区）
+    SWAPDEV_FILE      // 文件或块设备，按块偏移 pread/pwrite
+} SwapDevType;
+
+// 交换文件的同步方式
+typedef enum {
+    SWAPDEV_SYNC_NONE,    // 不主动同步，依赖页缓存回写
+    SWAPDEV_SYNC_WRITE,   // 每次写入后 fdatasync
+    SWAPDEV_SYNC_DSYNC    // 以 O_DSYNC 打开，写入返回时已落盘
+} SwapDevSync;
+
+// 交换设备读写统计
+typedef struct {
+    uint32_t reads;            // 读取块数
+    uint32_t writes;           // 写入块数
+    uint32_t errors;           // 读写失败次数
+    uint64_t read_time_us;     // 累计读取耗时（微秒）
+    uint64_t write_time_us;    // 累计写入耗时（微秒，含同步）
+    uint64_t max_read_us;      // 单次读取最大耗时
+    uint64_t max_write_us;     // 单次写入最大耗时
+} SwapDevStats;
+
+// 交换设备管理函数（按当前配置打开，关闭后配置保留）
+bool swapdev_init(void);
+void swapdev_shutdown(void);
+
+// 切换交换设备，已使用的交换区块会迁移到新设备
+bool swapdev_use_memory(void);
+bool swapdev_use_file(const char* path, bool direct_io, SwapDevSync sync);
+
+// 按交换区块索引读写一个块
+bool swapdev_write(uint32_t swap_index, const void* data);
+bool swapdev_read(uint32_t swap_index, void* buffer);
+
+// 文件设备的描述符（内存交换区返回-1）和同步方式，供异步I/O引擎使用
+int swapdev_get_fd(void);
+SwapDevSync swapdev_get_sync(void);
+
+const char* get_swapdev_sync_name(SwapDevSync sync);
+SwapDevStats get_swapdev_stats(void);
+void print_swapdev_stats(void);
+
+#endif // SWAPDEV_H
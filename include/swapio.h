@@ -0,0 +1,65 @@
+#ifndef SWAPIO_H
+#define SWAPIO_H
+
+#include <stdbool.h>
+#include "types.h"
+#include "process.h"
+
+#define SWAPIO_QUEUE_DEPTH  64    // 同时排队或执行中的交换区请求数
+#define SWAPIO_WORKERS      4     // 线程池引擎的工作线程数
+
+// 异步I/O引擎
+typedef enum {
+    SWAPIO_ENGINE_SYNC,      // 提交时直接 pread/pwrite（无可用的异步机制）
+    SWAPIO_ENGINE_URING,     // io_uring
+    SWAPIO_ENGINE_THREADS    // 工作线程池
+} SwapIoEngine;
+
+// 异步交换区I/O统计
+typedef struct {
+    uint32_t reads;              // 提交的读请求数（缺页换入）
+    uint32_t writes;             // 提交的写请求数（换出）
+    uint32_t completions;        // 已收割的完成事件数
+    uint32_t submit_batches;     // 批量提交次数
+    uint32_t reap_batches;       // 收割到完成事件的批次数
+    uint32_t max_inflight;       // 同时在途请求数峰值
+    uint32_t pending_write_hits; // 读取时命中尚未落盘的写请求次数
+    uint32_t retries;            // 异步失败后同步重试次数
+    uint32_t syncs;              // 批量 fdatasync 次数
+    uint64_t read_latency_us;    // 读请求从提交到完成的累计耗时
+    uint64_t write_latency_us;   // 写请求从提交到完成的累计耗时
+} SwapIoStats;
+
+// 异步I/O引擎管理（只在交换设备为文件时生效）
+void swapio_init(void);
+void swapio_shutdown(void);
+void swapio_set_enabled(bool enabled);
+bool swapio_is_active(void);
+
+// 换出：复制页面数据后排队写入，返回 false 时由调用者同步写入
+bool swapio_queue_write(uint32_t swap_index, const void* data);
+
+// 读取尚未落盘的写请求中的数据
+bool swapio_read_pending(uint32_t swap_index, void* buffer);
+
+// 缺页换入：提交读请求并阻塞进程，返回 false 时由调用者同步处理缺页
+bool swapio_start_fault(PCB* process, uint32_t virtual_page);
+
+// 同步完成进程页面上尚未完成的换入，没有时返回 false
+bool swapio_finish_fault(PCB* process, uint32_t virtual_page);
+
+// 进程销毁时放弃其尚未完成的换入
+void swapio_cancel_process(uint32_t pid);
+
+// 提交排队的请求并收割已完成的请求，wait 为 true 时至少等待一个缺页换入完成
+uint32_t swapio_poll(bool wait);
+uint32_t swapio_pending_faults(void);
+
+// 等待所有请求完成
+void swapio_drain(void);
+
+const char* get_swapio_engine_name(void);
+SwapIoStats get_swapio_stats(void);
+void print_swapio_stats(void);
+
+#endif // SWAPIO_H
@@ -0,0 +1,52 @@
+#ifndef THP_H
+#define THP_H
+
+#include <stdbool.h>
+#include "types.h"
+
+// 透明大页默认参数
+#define THP_DEFAULT_SCAN_INTERVAL    1     // 每隔多少个时间片后台扫描一次
+#define THP_DEFAULT_REGIONS_TO_SCAN  4     // 每次扫描的大页区域数
+#define THP_MAX_PTES_NONE_DIVISOR    8     // 合并时最多允许 1/8 的页面未映射（补零）
+#define THP_LOW_WATERMARK_DIVISOR    32    // 空闲页框低于物理页框的 1/32 时拆分大页回收全零子页
+
+// 透明大页管理器状态
+typedef struct {
+    bool enabled;                // 缺页时分配大页，并在时间片轮转时后台合并
+    uint32_t scan_interval;      // 扫描间隔（时间片数）
+    uint32_t regions_to_scan;    // 每次扫描的区域数
+    uint32_t max_ptes_none;      // 合并时允许的未映射页数
+    uint32_t scan_slot;          // 下一个要扫描的进程表槽位
+    uint32_t scan_region;        // 该进程中下一个要扫描的区域起始页号
+    uint32_t ticks;              // 距上次扫描经过的时间片数
+    uint32_t full_scans;         // 完整扫描轮数
+    uint32_t regions_scanned;    // 累计扫描区域数
+    uint32_t fault_alloc;        // 缺页时直接映射大页的次数
+    uint32_t fault_fallback;     // 缺页时整理后仍没有连续页框、退回普通页的次数
+    uint32_t collapsed;          // 后台合并成大页的次数
+    uint32_t collapsed_in_place; // 其中页框本已连续对齐、无需复制的次数
+    uint32_t collapse_failed;    // 区域可以合并但整理后仍没有连续页框的次数
+    uint32_t splits;             // 大页拆分为普通页的次数
+    uint32_t split_reclaimed;    // 内存紧张时拆分大页回收的全零子页数
+    uint32_t untouched;          // 当前大页中清零后尚未写入的子页数
+} ThpManager;
+
+// 透明大页管理函数
+void thp_init(void);
+void thp_set_enabled(bool enabled);
+void thp_tick(void);
+uint32_t thp_scan(uint32_t regions_to_scan);
+bool thp_handle_fault(PCB* process, uint32_t virtual_page);
+uint32_t thp_shrink(uint32_t target);
+void print_thp_stats(void);
+
+// 大页拆分：页表项要被换出、共享或解除映射前调用
+void thp_split_page(PCB* process, uint32_t virtual_page);
+void thp_split_frame(uint32_t frame);
+uint32_t thp_split_process(PCB* process);
+uint32_t thp_split_all(void);
+bool thp_frame_is_huge(uint32_t frame);
+void thp_subpage_written(uint32_t frame);  // 页框被写入或释放时调用，清除未写入子页标记
+uint32_t thp_count_huge_pages(void);
+
+#endif // THP_H
@@ -0,0 +1,47 @@
+#ifndef TIER_H
+#define TIER_H
+
+#include <stdbool.h>
+#include "types.h"
+
+// 分层内存默认参数
+#define TIER_DEFAULT_SCAN_INTERVAL    4     // 每隔多少个时间片扫描一次访问位
+#define TIER_DEFAULT_PROMOTE_SCANS    2     // 连续多少次扫描都被访问的慢速内存页面视为热页
+#define TIER_DEFAULT_MIGRATE_BUDGET   8     // 每次扫描最多提升或降级的页框数
+#define TIER_LOW_WATERMARK_DIVISOR    32    // DRAM 空闲页框低于 DRAM 页框数的 1/32 时后台降级冷页
+
+// 分层内存管理器
+typedef struct {
+    bool enabled;                 // 是否把冷页降级到慢速内存层、把热页提升回 DRAM
+    uint32_t scan_interval;       // 扫描间隔（时间片）
+    uint32_t promote_scans;       // 热页判定所需的连续被访问扫描次数
+    uint32_t migrate_budget;      // 每次扫描最多迁移的页框数
+    uint32_t ticks;               // 距上次扫描经过的时间片
+    uint32_t scans;               // 累计扫描次数
+    uint64_t dram_hits;           // 访问驻留在 DRAM 的页面的次数
+    uint64_t slow_hits;           // 访问驻留在慢速内存层的页面的次数
+    uint64_t misses;              // 访问时页面不在内存中、经缺页调入的次数
+    uint64_t access_time_ns;      // 命中访问的累计延迟（纳秒）
+    uint32_t demoted;             // 分配页框时按需降级的页面数
+    uint32_t background_demoted;  // 扫描时为保持 DRAM 空闲页框而降级的页面数
+    uint32_t promoted;            // 提升回 DRAM 的热页数
+    uint32_t migrate_failed;      // 页框不可迁移或目标层没有空闲页框的次数
+    uint32_t slow_evicted;        // 慢速内存层满时换出的页面数
+} TierManager;
+
+// 分层内存管理函数
+void tier_init(void);
+void tier_set_enabled(bool enabled);
+bool tier_is_enabled(void);
+bool frame_in_slow_tier(uint32_t frame);
+uint32_t tier_free_slow_frames(void);
+
+// 访问统计和迁移
+void tier_record_access(uint32_t frame, bool resident);
+void tier_migrate_frame(uint32_t src, uint32_t dst);
+uint32_t tier_demote(PCB* requester, uint32_t count);
+uint32_t tier_scan(void);
+void tier_tick(void);
+void print_tier_stats(void);
+
+#endif // TIER_H
@@ -0,0 +1,38 @@
+#ifndef TLB_H
+#define TLB_H
+
+#include <stdbool.h>
+#include "types.h"
+
+// 快表容量（普通页与大页分别使用独立的全相联条目，按LRU替换）
+#define TLB_ENTRIES       64
+#define TLB_HUGE_ENTRIES  32
+
+// 快表条目
+typedef struct {
+    bool valid;
+    uint32_t pid;          // 所属进程
+    uint32_t tag;          // 普通页为虚拟页号，大页为大页区域的起始虚拟页号
+    uint32_t frame;        // 普通页为页框号，大页为起始页框号
+    uint64_t last_use;     // LRU 时间戳
+} TlbEntry;
+
+// 快表模型：只统计命中与覆盖范围，不改变地址转换结果
+typedef struct {
+    TlbEntry entries[TLB_ENTRIES];
+    TlbEntry huge_entries[TLB_HUGE_ENTRIES];
+    uint64_t clock;        // 访问计数，作为LRU时间戳
+    uint64_t hits;         // 命中次数
+    uint64_t huge_hits;    // 其中命中大页条目的次数
+    uint64_t misses;       // 未命中（需要遍历页表）次数
+    uint64_t stale;        // 条目对应的页表项已改变而失效的次数
+} Tlb;
+
+// 快表管理函数
+void tlb_init(void);
+bool tlb_access(PCB* process, uint32_t virtual_page);
+void tlb_flush(void);
+uint64_t tlb_reach(void);
+void print_tlb_stats(void);
+
+#endif // TLB_H
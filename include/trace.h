@@ -0,0 +1,81 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>
+#include "types.h"
+#include "metrics.h"
+
+// 事件跟踪参数
+#define TRACE_RING_SIZE     8192  // 每个线程的环形缓冲区事件数（2 的幂），写满后覆盖最旧的事件
+#define TRACE_MAX_THREADS   16    // 同时记录事件的线程数，超出的线程的事件被丢弃
+
+// 事件类型
+typedef enum {
+    TRACE_FAULT,        // 缺页处理（持续事件）
+    TRACE_VICTIM,       // 选中牺牲页框（瞬时事件）
+    TRACE_EVICT,        // 换出页框（持续事件）
+    TRACE_SWAP_READ,    // 读取交换区块（持续事件）
+    TRACE_SWAP_WRITE,   // 写入交换区块（持续事件）
+    TRACE_SWITCH,       // 上下文切换（瞬时事件）
+    TRACE_PREEMPT,      // 抢占（瞬时事件）
+    TRACE_EVENT_TYPES
+} TraceEventType;
+
+// 缺页事件的标志位（arg1）
+#define TRACE_FAULT_WRITE   0x1   // 写访问
+#define TRACE_FAULT_ASYNC   0x2   // 异步换入，起止为请求提交到完成
+
+// 一个二进制事件记录
+typedef struct {
+    uint64_t timestamp_ns;   // 开始时间（单调时钟）
+    uint64_t duration_ns;    // 持续时间，瞬时事件为 0
+    uint32_t pid;            // 事件所属进程，0 表示不属于任何进程
+    uint32_t arg0;           // 缺页/换出：页号；牺牲页框/交换 I/O：页框号或块号；切换：换出的进程
+    uint32_t arg1;           // 缺页：标志位；牺牲页框/换出：所属进程；切换：换入的进程
+    uint32_t arg2;           // 缺页：是否成功；牺牲页框/换出：页号
+    uint16_t type;           // TraceEventType
+    uint16_t thread;         // 记录事件的线程（环形缓冲区下标）
+    uint32_t reserved;
+} TraceEvent;
+
+// 跟踪开关，关闭时每个跟踪点只有一次读取和分支
+extern bool trace_enabled;
+
+// 事件跟踪管理函数
+void trace_start(void);
+void trace_stop(void);
+bool trace_export(const char* path);
+void print_trace_status(void);
+void trace_thread_exit(void);   // 记录过事件的线程退出前调用，归还环形缓冲区
+void trace_shutdown(void);
+
+// 缺页处理期间的当前进程，换出和牺牲页框事件记在该进程的时间线上
+uint32_t trace_set_context(uint32_t pid);
+uint32_t trace_context(void);
+
+// 记录事件（调用者已检查 trace_enabled）
+void trace_record(TraceEventType type, uint64_t start_ns, uint64_t end_ns, uint32_t pid,
+                  uint32_t arg0, uint32_t arg1, uint32_t arg2);
+
+// 跟踪点：关闭时不读时钟
+static inline uint64_t trace_clock(void) {
+    return __builtin_expect(trace_enabled, 0) ? metrics_now_ns() : 0;
+}
+
+// 持续事件：start_ns 为 trace_clock() 的返回值，为 0 表示开始时跟踪尚未开启
+static inline void trace_complete(TraceEventType type, uint64_t start_ns, uint32_t pid,
+                                  uint32_t arg0, uint32_t arg1, uint32_t arg2) {
+    if (__builtin_expect(trace_enabled, 0) && start_ns != 0) {
+        trace_record(type, start_ns, metrics_now_ns(), pid, arg0, arg1, arg2);
+    }
+}
+
+static inline void trace_instant(TraceEventType type, uint32_t pid,
+                                 uint32_t arg0, uint32_t arg1, uint32_t arg2) {
+    if (__builtin_expect(trace_enabled, 0)) {
+        uint64_t now = metrics_now_ns();
+        trace_record(type, now, now, pid, arg0, arg1, arg2);
+    }
+}
+
+#endif // TRACE_H
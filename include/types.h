@@ -3,23 +3,24 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "config.h"
 
 // ǰ������
 typedef struct PCB PCB;
 
 // ϵͳ���ó���
-#define PAGE_SIZE           4096    // ҳ��С��4KB
-#define VIRTUAL_PAGES       1024    // ����ҳ����
-#define PHYSICAL_PAGES      256     // ����ҳ����
-#define MAX_PROCESSES       64      // 
+// 页大小、物理页框数等几何参数在启动时配置（见 config.h），以下为运行时取值
+#define VIRTUAL_PAGES       (system_config.virtual_pages)   // 每个进程的虚拟页数
+#define PHYSICAL_PAGES      (system_config.physical_pages)  // 物理页框数
+#define MAX_PROCESSES       (system_config.max_processes)   // 进程表大小
 #define MAX_PROCESS_NAME    32      // 进程名称最大长度
-#define SWAP_SIZE           (4 * PHYSICAL_PAGES)  // Сڴ4
+#define SWAP_SIZE           (system_config.swap_size)       // 交换区块数（默认为物理页框数的4倍）
 #define SWAP_BLOCK_SIZE     PAGE_SIZE            // С
 #define MAX_MEMORY_ACCESSES 1000  // ڴʼ¼
 #define PAGE_TABLE_ENTRIES  1024  // ҳ
 
 // 内存相关常量
-#define VIRTUAL_MEMORY_SIZE (1024 * PAGE_SIZE)  // 虚拟内存大小为1024页
+#define VIRTUAL_MEMORY_SIZE ((uint64_t)VIRTUAL_PAGES * PAGE_SIZE)  // 每个进程的虚拟内存大小
 
 // ״̬
 typedef enum {
@@ -39,6 +40,13 @@ typedef enum {
     BUDDY_SYSTEM     // 
 } AllocationStrategy;
 
+// 页面置换范围
+typedef enum {
+    REPLACE_GLOBAL,  // 全局置换：可以从任意进程回收页框
+    REPLACE_LOCAL,   // 局部置换：只能置换缺页进程自己的页面
+    REPLACE_QUOTA    // 配额置换：min_memory/max_memory 作为页框下限和上限
+} ReplacementScope;
+
 // 
 #define SWAP_BLOCKS 1024            // 
 #define SWAP_BLOCK_SIZE PAGE_SIZE   // 
@@ -48,6 +56,7 @@ typedef struct {
     bool is_used;           // 
     uint32_t process_id;    // 
     uint32_t virtual_page;  // 
+    uint32_t ref_count;     // 引用该块的页表项数，写时复制共享的页框换出后各映射共享同一个块
 } SwapBlockInfo;
 
 // 页表项标志位
@@ -56,7 +65,11 @@ typedef struct {
     bool swapped : 1;     // 页面是否在交换区
     bool dirty : 1;       // 页面是否被修改
     bool referenced : 1;  // 页面是否被访问
-    uint32_t swap_index : 28; // 交换区索引
+    bool cow : 1;         // 写时复制：与其他进程只读共享页框，首次写入时复制
+    bool shm : 1;         // 共享内存段映射：缺页时从所属段取得页框
+    bool file : 1;        // 文件映射：缺页时经页缓存从存储块读入
+    bool huge : 1;        // 属于透明大页映射：所在对齐区域由连续页框整体映射
+    uint32_t swap_index : 24; // 交换区索引
 } PageFlags;
 
 // 内存统计信息结构
@@ -70,6 +83,13 @@ typedef struct {
     uint32_t pages_swapped_in;    // 换入页面数
     uint32_t writes_to_disk;      // 写入磁盘次数
     uint32_t last_replaced_page;  // 最后被替换的页面
+    uint32_t cow_faults;          // 写时复制缺页次数
+    uint32_t cow_copies;          // 写时复制实际复制页面数
+    uint32_t zero_page_maps;      // 首次读取映射到共享零页框的次数
+    uint32_t zero_fill_faults;    // 首次写入按需分配并清零页框的次数
+    uint32_t zero_swap_skips;     // 换出全零页面时跳过交换区写入的次数
+    uint32_t major_faults;        // 需要从交换区调入页面的缺页次数
+    uint64_t major_fault_time_us; // 换入缺页累计耗时（微秒，含交换设备读取）
 } MemoryStats;
 
 // 进程优先级
@@ -113,8 +133,8 @@ typedef struct {
 // Ӧó
 typedef struct {
     char name[32];              // Ӧó
-    uint32_t min_memory;        // Сڴ
-    uint32_t max_memory;        // ڴ
+    uint64_t min_memory;        // Сڴ
+    uint64_t max_memory;        // ڴ
     uint32_t priority;          // ȼ
     MemoryLayout layout;        // ڴ沼
     MonitorConfig monitor;      // 
@@ -146,6 +166,7 @@ typedef struct {
     uint32_t code_pages;  // 代码段页数
     uint32_t data_pages;  // 数据段页数
     uint32_t time_slice;  // 时间片
+    uint32_t block;     // 磁盘块号
     char* text;         // 文本
 } CommandArgs;
 
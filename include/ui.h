@@ -39,11 +39,19 @@ typedef enum {
     CMD_DISK_READ,      // 读取磁盘
     CMD_DISK_WRITE,     // 写入磁盘
     CMD_DISK_STAT,      // 磁盘状态
+    CMD_DISK_BACKEND,   // 切换磁盘存储后端
+    CMD_DISK_SYNC,      // 同步磁盘映像
+    CMD_DISK_MAP,       // 把磁盘块映射到进程虚拟页
+    CMD_DISK_UNMAP,     // 解除磁盘块映射
     
     // 系统状态命令
     CMD_STATE_SAVE,     // 保存系统状态
     CMD_STATE_LOAD,     // 加载系统状态
     CMD_STATE_RESET,    // 重置系统状态
+    CMD_STATE_CHECKPOINT, // 保存增量检查点
+    CMD_STATE_AUTO,     // 周期检查点
+    CMD_STATE_STAT,     // 快照状态
+    CMD_STATE_CONFIG,   // 显示系统配置
     CMD_DEMO_SCHEDULE,  // 演示调度
     CMD_DEMO_MEMORY,    // 内存演示
     CMD_UNKNOWN,        // 未知
@@ -62,6 +70,43 @@ typedef enum {
     CMD_DEMO_PAGE_THRASH,  // 页面抖动演示
     CMD_PROC_ACCESS,    // 模拟进程访存
     CMD_PROC_ALLOC,     // 为进程分配堆/栈空间
+    CMD_MEM_SCOPE,      // 设置页面置换范围
+    CMD_PROC_QUOTA,     // 设置进程页框配额
+    CMD_PROC_FORK,      // 写时复制方式复制进程
+    CMD_SHM_CREATE,     // 创建共享内存段
+    CMD_SHM_DESTROY,    // 销毁共享内存段
+    CMD_SHM_ATTACH,     // 挂接共享内存段
+    CMD_SHM_DETACH,     // 解除挂接共享内存段
+    CMD_SHM_LIST,       // 显示共享内存段
+    CMD_MEM_KSM,        // 相同页合并
+    CMD_MEM_THP,        // 透明大页
+    CMD_MEM_COMPACT,    // 内存整理
+    CMD_NUMA_STAT,      // NUMA拓扑和访问统计
+    CMD_NUMA_POLICY,    // 设置进程的内存分配策略
+    CMD_NUMA_HOME,      // 把进程迁到另一个节点运行
+    CMD_NUMA_BALANCE,   // 自动NUMA平衡
+    CMD_NUMA_DISTANCE,  // 设置跨节点访问距离
+    CMD_TIER_STAT,      // 分层内存统计
+    CMD_TIER_SET,       // 开启或关闭分层内存
+    CMD_TIER_SCAN,      // 立即扫描热度并提升/降级
+    CMD_TIER_DEMOTE,    // 把DRAM中的冷页降级到慢速内存层
+    CMD_PROFILE_START,  // 开始剖析进程的内存访问
+    CMD_PROFILE_STOP,   // 停止剖析
+    CMD_PROFILE_SHOW,   // 重用距离分布和缺页率曲线
+    CMD_PROFILE_HEATMAP,// 页面访问热度图
+    CMD_PROFILE_LIST,   // 列出正在剖析的进程
+    CMD_METRICS_SHOW,   // 打印所有指标
+    CMD_METRICS_PROM,   // 按 Prometheus 文本格式打印指标
+    CMD_METRICS_EXPORT, // 把指标快照导出到文件
+    CMD_TRACE_START,    // 开始事件跟踪
+    CMD_TRACE_STOP,     // 停止事件跟踪
+    CMD_TRACE_EXPORT,   // 导出 Chrome Trace Event JSON
+    CMD_TRACE_STAT,     // 事件跟踪状态
+    CMD_VM_ZSWAP,       // 压缩交换池
+    CMD_VM_SWAPDEV,     // 交换设备
+    CMD_VM_AIO,         // 异步交换I/O
+    CMD_TIME_FAULT,     // 设置缺页服务时间
+    CMD_TIME_STAT,      // CPU利用率统计
 } CommandType;
 
 // 命令字符串定义
@@ -71,6 +116,19 @@ typedef enum {
 #define CMD_STR_APP_RUN "app run"        // 运行应用程序命令
 #define CMD_STR_PROC_TIME "proc time"      // 设置进程时间片命令
 #define CMD_STR_MEM_STRATEGY "mem strategy" // 设置内存分配策略命令
+#define CMD_STR_MEM_SCOPE "mem scope"       // 设置页面置换范围命令
+#define CMD_STR_PROC_QUOTA "proc quota"     // 设置进程页框配额命令
+#define CMD_STR_PROC_FORK "proc fork"       // 复制进程命令
+#define CMD_STR_SHM "shm"                   // 共享内存段命令
+#define CMD_STR_MEM_KSM "mem ksm"           // 相同页合并命令
+#define CMD_STR_VM_ZSWAP "vm zswap"         // 压缩交换池命令
+#define CMD_STR_VM_SWAPDEV "vm swapdev"     // 交换设备命令
+#define CMD_STR_VM_AIO "vm aio"             // 异步交换I/O命令
+#define CMD_STR_NUMA "numa"                 // NUMA命令
+#define CMD_STR_TIER "tier"                 // 分层内存命令
+#define CMD_STR_PROFILE "profile"           // 访问剖析命令
+#define CMD_STR_METRICS "metrics"           // 指标命令
+#define CMD_STR_TRACE "trace"               // 事件跟踪命令
 
 // 结构体
 typedef struct {
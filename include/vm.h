@@ -8,8 +8,10 @@
 typedef struct {
     SwapBlockInfo* swap_blocks;        // 交换区块信息
     uint32_t swap_free_blocks;         // 空闲交换块数量
-    void* swap_area;                   // 模拟的交换区空间
+    void* swap_area;                   // 模拟的交换区空间（使用交换文件时为NULL）
     MemoryStats stats;                 // 内存访问统计
+    uint64_t* swap_write_seq;          // 每个交换区块最后一次写入时的写入序号（增量快照用）
+    uint64_t swap_write_count;         // 交换区写入序号
 } VMManager;
 
 // 声明全局虚拟内存管理器实例
@@ -25,12 +27,25 @@ bool page_out(PCB* process, uint32_t virtual_page);
 // 页面调入相关
 bool page_in(PCB* process, uint32_t virtual_page);
 
-// 缺页中断处理
-bool handle_page_fault(PCB* process, uint32_t virtual_address);
+// 缺页中断处理（is_write 决定未写入过的页面映射零页框还是分配新页框）
+bool handle_page_fault(PCB* process, uint32_t virtual_page, bool is_write);
+
+// 写时复制缺页处理（首次写入共享页面时复制私有页面）
+bool handle_cow_fault(PCB* process, uint32_t virtual_page);
+
+// 按置换范围和页框配额为进程的虚拟页获取页框（必要时置换）
+uint32_t obtain_frame_for_page(PCB* process, uint32_t virtual_page);
+
+// 选择牺牲页框并换出，返回已释放的页框（换出失败时改选其他候选页框）
+#define MAX_EVICTION_ATTEMPTS 8   // 一次置换最多尝试的牺牲页框数
+uint32_t evict_victim_frame(PCB* requester);
 
 // 交换区管理
 uint32_t allocate_swap_block(uint32_t process_id, uint32_t virtual_page);
-void free_swap_block(uint32_t swap_index);
+uint32_t find_swap_block(uint32_t process_id, uint32_t virtual_page);
+void swap_block_get(uint32_t swap_index);      // 增加一个页表项对交换区块的引用
+void free_swap_block(uint32_t swap_index);     // 释放一个引用，最后一个引用释放时回收块
+bool relocate_swap_block(uint32_t from, uint32_t to);
 
 // 内存访问和统计
 void access_memory(PCB* process, uint32_t virtual_address, bool is_write);
@@ -72,7 +87,7 @@ bool page_out(PCB* process, uint32_t page_num);
 void vm_init(void);                                                    // 初始化虚拟内存系统
 void vm_shutdown(void);                                                // 关闭虚拟内存系统
 void access_memory(PCB* process, uint32_t virtual_address, bool is_write);  // 访问内存
-bool handle_page_fault(PCB* process, uint32_t address);               // 处理缺页中断
+bool handle_page_fault(PCB* process, uint32_t virtual_page, bool is_write); // 处理缺页中断
 
 // 添加函数声明
 uint64_t get_current_time(void);
@@ -0,0 +1,49 @@
+#ifndef ZSWAP_H
+#define ZSWAP_H
+
+#include <stdbool.h>
+#include "types.h"
+
+// 压缩交换池参数
+#define ZSWAP_POOL_PAGES       128                                   // 压缩池大小（页）
+#define ZSWAP_CHUNK_SIZE       64                                    // 池分配粒度（字节）
+#define ZSWAP_POOL_CHUNKS      (ZSWAP_POOL_PAGES * PAGE_SIZE / ZSWAP_CHUNK_SIZE)
+#define ZSWAP_MAX_STORED_SIZE  (PAGE_SIZE * 3 / 4)                   // 压缩后超过该大小视为不可压缩
+
+// 交换区块在压缩池中的存放位置
+typedef struct {
+    bool stored;             // 是否存放在压缩池中
+    uint32_t first_chunk;    // 起始分配块
+    uint32_t chunk_count;    // 占用分配块数
+    uint32_t length;         // 压缩后字节数
+} ZswapEntry;
+
+// 压缩交换池统计
+typedef struct {
+    uint32_t stored_pages;       // 当前存放在池中的页面数
+    uint32_t store_attempts;     // 尝试压缩的页面数
+    uint32_t rejected_pages;     // 压缩率不足直接写交换区的页面数
+    uint32_t spilled_pages;      // 池已满写交换区的页面数
+    uint32_t loads;              // 从池中解压的次数
+    uint64_t original_bytes;     // 池中页面的原始字节数
+    uint64_t compressed_bytes;   // 池中页面的压缩后字节数
+    uint64_t compress_time_us;   // 累计压缩耗时（微秒）
+    uint64_t decompress_time_us; // 累计解压耗时（微秒）
+} ZswapStats;
+
+// 压缩交换池管理函数
+void zswap_init(void);
+void zswap_shutdown(void);
+void zswap_set_enabled(bool enabled);
+bool zswap_is_enabled(void);
+
+// 交换区读写时调用：放入池中返回 true，否则由调用者写入交换区
+bool zswap_store(uint32_t swap_index, const void* data);
+bool zswap_load(uint32_t swap_index, void* buffer);
+void zswap_invalidate(uint32_t swap_index);
+bool zswap_contains(uint32_t swap_index);
+
+ZswapStats get_zswap_stats(void);
+void print_zswap_stats(void);
+
+#endif // ZSWAP_H
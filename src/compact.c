@@ -0,0 +1,268 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../include/compact.h"
+#include "../include/memory.h"
+#include "../include/process.h"
+#include "../include/shm.h"
+#include "../include/pagecache.h"
+#include "../include/thp.h"
+#include "../include/numa.h"
+#include "../include/tier.h"
+
+// 内存整理状态
+static CompactManager compact;
+
+// 初始化内存整理
+void compact_init(void) {
+    memset(&compact, 0, sizeof(CompactManager));
+    compact.budget = COMPACT_DEFAULT_BUDGET;
+}
+
+void compact_set_enabled(bool enabled) {
+    compact.enabled = enabled;
+    printf("后台内存整理已%s\n", enabled ? "开启" : "关闭");
+}
+
+/**
+ * @brief 页框能否迁移
+ *
+ * 零页框、正在交换的页框和大页页框不迁移。引用计数必须恰好等于
+ * 反向映射中的页表项数加上共享内存段和页缓存的持有，保证迁移后没有遗漏的引用。
+ */
+bool compact_frame_movable(uint32_t frame) {
+    if (frame >= PHYSICAL_PAGES) {
+        return false;
+    }
+    FrameInfo* info = &memory_manager.frames[frame];
+    if (!info->is_allocated || info->is_swapping || info->ref_count == 0 ||
+        is_zero_frame(frame) || thp_frame_is_huge(frame)) {
+        return false;
+    }
+
+    uint32_t references = count_frame_mappings(frame);
+    if (shm_find_frame(frame, NULL, NULL)) {
+        references++;
+    }
+    if (pagecache_find_frame(frame, NULL)) {
+        references++;
+    }
+    return references == info->ref_count;
+}
+
+/**
+ * @brief 把页框 src 迁移到空闲页框 dst
+ *
+ * 复制页面内容，经反向映射把所有页表项改为指向 dst，
+ * 再更新共享内存段和页缓存的记录，最后释放 src。
+ *
+ * @return true 迁移成功
+ */
+bool compact_migrate_frame(uint32_t src, uint32_t dst) {
+    if (!compact_frame_movable(src) || !claim_frame(dst)) {
+        return false;
+    }
+
+    FrameMapping* mappings;
+    uint32_t count;
+    if (!collect_frame_mappings(src, &mappings, &count)) {
+        free_frame(dst);
+        return false;
+    }
+
+    FrameInfo* from = &memory_manager.frames[src];
+    FrameInfo* to = &memory_manager.frames[dst];
+    memcpy(get_physical_address(dst), get_physical_address(src), PAGE_SIZE);
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (!frame_get(dst, mappings[i].process->pid, mappings[i].virtual_page)) {
+            // 反向映射项分配失败：恢复已改动的页表项
+            for (uint32_t j = 0; j < i; j++) {
+                mappings[j].process->page_table[mappings[j].virtual_page].frame_number = src;
+            }
+            free(mappings);
+            free_frame(dst);
+            return false;
+        }
+        mappings[i].process->page_table[mappings[i].virtual_page].frame_number = dst;
+    }
+    free(mappings);
+
+    // 引用计数包括共享内存段和页缓存的持有
+    to->ref_count = from->ref_count;
+    to->process_id = from->process_id;
+    to->virtual_page_num = from->virtual_page_num;
+    to->is_dirty = from->is_dirty;
+    to->last_access_time = from->last_access_time;
+    frame_update_charge(dst);
+    shm_migrate_frame(src, dst);
+    pagecache_migrate_frame(src, dst);
+    tier_migrate_frame(src, dst);
+
+    free_frame(src);
+    return true;
+}
+
+/**
+ * @brief 整理物理内存，把已用页框向低地址集中
+ *
+ * 每个NUMA节点内分别整理，页框不会被迁到其他节点：空闲指针从节点低地址向上
+ * 寻找空闲页框，迁移指针从节点高地址向下寻找可迁移页框，两者相遇时停止。
+ * 空闲页框因此集中到各节点的高地址，形成大段连续空闲区域。
+ *
+ * @param budget 最多迁移的页框数，0表示不限制
+ * @return uint32_t 迁移的页框数
+ */
+uint32_t compact_memory(uint32_t budget) {
+    uint32_t migrated = 0;
+
+    for (uint32_t node = 0; node < numa_node_count(); node++) {
+        uint32_t low, high;
+        numa_node_range(node, &low, &high);
+
+        while (budget == 0 || migrated < budget) {
+            while (low < high && memory_manager.frames[low].is_allocated) {
+                low++;
+            }
+            while (high > low && !compact_frame_movable(high - 1)) {
+                high--;
+            }
+            if (high <= low) {
+                break;
+            }
+
+            high--;
+            if (!compact_migrate_frame(high, low)) {
+                compact.migrate_failed++;
+                continue;
+            }
+            compact.migrated++;
+            migrated++;
+            low++;
+        }
+    }
+
+    if (budget == 0) {
+        compact.full_runs++;
+    }
+    return migrated;
+}
+
+// 区域 [start, start + count) 之外地址最低的空闲页框，优先选择 node 节点内的页框
+static uint32_t free_frame_outside(uint32_t start, uint32_t count, uint32_t node) {
+    uint32_t first, end;
+    numa_node_range(node, &first, &end);
+    for (int pass = 0; pass < 2; pass++) {
+        for (uint32_t i = first; i < end; i++) {
+            if (!memory_manager.frames[i].is_allocated && (i < start || i >= start + count)) {
+                return i;
+            }
+        }
+        first = 0;
+        end = DRAM_PAGES;
+    }
+    return (uint32_t)-1;
+}
+
+/**
+ * @brief 按需整理出一段连续对齐的空闲页框
+ *
+ * 选择需要迁移页框最少、且其中已用页框都可迁移的对齐区域，
+ * 把其中的页框迁移到区域外地址最低的空闲页框（优先同一NUMA节点）。
+ *
+ * @param count 页框数
+ * @param align 起始页框号的对齐（2的幂）
+ * @return true 已有满足要求的连续空闲区域
+ */
+bool compact_region(uint32_t count, uint32_t align) {
+    // 迁移出的页框需要区域外的空闲页框，空闲页框总数至少为 count
+    if (count == 0 || count > DRAM_PAGES || get_free_dram_frames() < count) {
+        compact.demand_failed++;
+        return false;
+    }
+
+    uint32_t best = (uint32_t)-1, best_cost = UINT32_MAX;
+    for (uint32_t start = 0; (uint64_t)start + count <= DRAM_PAGES; start += align) {
+        uint32_t cost = 0;
+        bool movable = true;
+        for (uint32_t i = 0; i < count && movable; i++) {
+            if (memory_manager.frames[start + i].is_allocated) {
+                movable = compact_frame_movable(start + i);
+                cost++;
+            }
+        }
+        if (movable && cost < best_cost) {
+            best = start;
+            best_cost = cost;
+        }
+    }
+    if (best == (uint32_t)-1) {
+        compact.demand_failed++;
+        return false;
+    }
+
+    for (uint32_t frame = best; frame < best + count; frame++) {
+        if (!memory_manager.frames[frame].is_allocated) {
+            continue;
+        }
+        uint32_t target = free_frame_outside(best, count, numa_node_of(frame));
+        if (target == (uint32_t)-1 || !compact_migrate_frame(frame, target)) {
+            compact.migrate_failed++;
+            compact.demand_failed++;
+            return false;
+        }
+        compact.migrated++;
+    }
+
+    compact.demand_success++;
+    printf("内存整理：迁移 %u 个页框，整理出连续页框 %u-%u\n", best_cost, best, best + count - 1);
+    return true;
+}
+
+// 分配连续对齐的页框，因碎片而失败时先按需整理再分配
+uint32_t compact_allocate_contiguous(uint32_t count, uint32_t align) {
+    uint32_t first = allocate_contiguous_frames(count, align);
+    if (first == (uint32_t)-1 && compact_region(count, align)) {
+        first = allocate_contiguous_frames(count, align);
+    }
+    return first;
+}
+
+// DRAM 中最长的连续空闲页框数
+uint32_t largest_free_run(void) {
+    uint32_t largest = 0, run = 0;
+    for (uint32_t i = 0; i < DRAM_PAGES; i++) {
+        if (memory_manager.frames[i].is_allocated) {
+            run = 0;
+        } else if (++run > largest) {
+            largest = run;
+        }
+    }
+    return largest;
+}
+
+// 时间片轮转时调用，每次最多迁移 budget 个页框
+void compact_tick(void) {
+    if (!compact.enabled) {
+        return;
+    }
+
+    uint32_t migrated = compact_memory(compact.budget);
+    if (migrated > 0) {
+        compact.background_runs++;
+        printf("后台内存整理迁移 %u 个页框\n", migrated);
+    }
+}
+
+// 打印内存整理统计信息
+void print_compact_stats(void) {
+    printf("\n=== 内存整理统计信息 ===\n");
+    printf("后台整理: %s（每个时间片最多迁移 %u 个页框）\n",
+           compact.enabled ? "开启" : "关闭", compact.budget);
+    printf("空闲页框: %u，空闲碎片: %u，最长连续空闲: %u 页\n",
+           get_free_frames_count(), count_memory_fragments(), largest_free_run());
+    printf("可整块分配的大页区域: %u\n", count_free_contiguous(HUGE_PAGE_PAGES, HUGE_PAGE_PAGES));
+    printf("累计迁移页框: %u，迁移失败: %u\n", compact.migrated, compact.migrate_failed);
+    printf("完整整理: %u 次，后台整理: %u 次\n", compact.full_runs, compact.background_runs);
+    printf("按需整理连续区域: 成功 %u 次，失败 %u 次\n", compact.demand_success, compact.demand_failed);
+}
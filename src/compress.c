@@ -0,0 +1,169 @@
+#include <stdbool.h>
+#include <string.h>
+#include "../include/compress.h"
+
+/*
+ * 压缩数据由若干序列组成，每个序列的格式为：
+ *   标记字节：高4位为字面量长度，低4位为匹配长度减4（取15时后跟扩展长度字节）
+ *   字面量
+ *   匹配偏移（2字节，小端），匹配长度扩展字节
+ * 最后一个序列只有字面量，没有匹配部分。
+ */
+
+#define LZ_MIN_MATCH   4
+#define LZ_HASH_BITS   12
+#define LZ_HASH_SIZE   (1 << LZ_HASH_BITS)
+#define LZ_MAX_OFFSET  65535
+#define LZ_NO_POSITION 0xFFFFFFFFu
+
+static uint32_t lz_read32(const uint8_t* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static uint32_t lz_hash(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+// 写入扩展长度（每个字节最多255，以小于255的字节结束）
+static bool lz_write_length(uint8_t* dst, size_t* op, size_t capacity, size_t length) {
+    while (length >= 255) {
+        if (*op >= capacity) return false;
+        dst[(*op)++] = 255;
+        length -= 255;
+    }
+    if (*op >= capacity) return false;
+    dst[(*op)++] = (uint8_t)length;
+    return true;
+}
+
+// 输出一个序列，match_length 为0表示最后一个只有字面量的序列
+static bool lz_emit_sequence(uint8_t* dst, size_t* op, size_t capacity,
+                             const uint8_t* literals, size_t literal_length,
+                             size_t offset, size_t match_length) {
+    if (*op >= capacity) return false;
+
+    size_t token_position = (*op)++;
+    uint8_t token = (uint8_t)((literal_length >= 15 ? 15 : literal_length) << 4);
+    if (literal_length >= 15 && !lz_write_length(dst, op, capacity, literal_length - 15)) {
+        return false;
+    }
+
+    if (*op + literal_length > capacity) return false;
+    memcpy(dst + *op, literals, literal_length);
+    *op += literal_length;
+
+    if (match_length > 0) {
+        size_t extra = match_length - LZ_MIN_MATCH;
+        token |= (uint8_t)(extra >= 15 ? 15 : extra);
+
+        if (*op + 2 > capacity) return false;
+        dst[(*op)++] = (uint8_t)(offset & 0xFF);
+        dst[(*op)++] = (uint8_t)(offset >> 8);
+        if (extra >= 15 && !lz_write_length(dst, op, capacity, extra - 15)) {
+            return false;
+        }
+    }
+
+    dst[token_position] = token;
+    return true;
+}
+
+size_t lz_compress(const uint8_t* src, size_t src_len, uint8_t* dst, size_t dst_capacity) {
+    uint32_t table[LZ_HASH_SIZE];
+    for (uint32_t i = 0; i < LZ_HASH_SIZE; i++) {
+        table[i] = LZ_NO_POSITION;
+    }
+
+    size_t ip = 0, anchor = 0, op = 0;
+    while (ip + LZ_MIN_MATCH <= src_len) {
+        uint32_t sequence = lz_read32(src + ip);
+        uint32_t h = lz_hash(sequence);
+        uint32_t ref = table[h];
+        table[h] = (uint32_t)ip;
+
+        if (ref == LZ_NO_POSITION || ip - ref > LZ_MAX_OFFSET || lz_read32(src + ref) != sequence) {
+            ip++;
+            continue;
+        }
+
+        // 向后延长匹配（允许与当前位置重叠，连续相同字节可以整段匹配）
+        size_t match_length = LZ_MIN_MATCH;
+        while (ip + match_length < src_len && src[ref + match_length] == src[ip + match_length]) {
+            match_length++;
+        }
+
+        if (!lz_emit_sequence(dst, &op, dst_capacity, src + anchor, ip - anchor,
+                              ip - ref, match_length)) {
+            return 0;
+        }
+        ip += match_length;
+        anchor = ip;
+    }
+
+    if (!lz_emit_sequence(dst, &op, dst_capacity, src + anchor, src_len - anchor, 0, 0)) {
+        return 0;
+    }
+    return op;
+}
+
+// 读取扩展长度
+static bool lz_read_length(const uint8_t* src, size_t* ip, size_t src_len, size_t* length) {
+    uint8_t byte;
+    do {
+        if (*ip >= src_len) return false;
+        byte = src[(*ip)++];
+        *length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+size_t lz_decompress(const uint8_t* src, size_t src_len, uint8_t* dst, size_t dst_capacity) {
+    size_t ip = 0, op = 0;
+
+    while (ip < src_len) {
+        uint8_t token = src[ip++];
+
+        // 字面量
+        size_t literal_length = token >> 4;
+        if (literal_length == 15 && !lz_read_length(src, &ip, src_len, &literal_length)) {
+            return 0;
+        }
+        if (ip + literal_length > src_len || op + literal_length > dst_capacity) {
+            return 0;
+        }
+        memcpy(dst + op, src + ip, literal_length);
+        ip += literal_length;
+        op += literal_length;
+
+        // 最后一个序列没有匹配部分
+        if (ip >= src_len) {
+            break;
+        }
+
+        // 匹配
+        if (ip + 2 > src_len) return 0;
+        size_t offset = (size_t)src[ip] | ((size_t)src[ip + 1] << 8);
+        ip += 2;
+
+        size_t match_length = token & 0x0F;
+        if (match_length == 15 && !lz_read_length(src, &ip, src_len, &match_length)) {
+            return 0;
+        }
+        match_length += LZ_MIN_MATCH;
+
+        if (offset == 0 || offset > op || op + match_length > dst_capacity) {
+            return 0;
+        }
+
+        // 逐字节复制，支持重叠匹配
+        const uint8_t* match = dst + op - offset;
+        for (size_t i = 0; i < match_length; i++) {
+            dst[op + i] = match[i];
+        }
+        op += match_length;
+    }
+
+    return op;
+}
@@ -0,0 +1,416 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "../include/config.h"
+#include "../include/swapalloc.h"
+
+// 当前配置，未调用 config_apply 时即为默认值
+SystemConfig system_config = {
+    .page_size = DEFAULT_PAGE_SIZE,
+    .page_shift = 12,
+    .physical_pages = DEFAULT_PHYSICAL_PAGES,
+    .virtual_pages = DEFAULT_VIRTUAL_PAGES,
+    .swap_size = 4 * DEFAULT_PHYSICAL_PAGES,
+    .max_processes = DEFAULT_MAX_PROCESSES,
+    .storage_size = DEFAULT_STORAGE_SIZE,
+    .huge_page_size = DEFAULT_HUGE_PAGE_SIZE,
+    .huge_page_pages = DEFAULT_HUGE_PAGE_SIZE / DEFAULT_PAGE_SIZE,
+    .numa_nodes = DEFAULT_NUMA_NODES,
+    .numa_distance = DEFAULT_NUMA_DISTANCE,
+    .slow_pages = 0,
+    .slow_latency = DEFAULT_SLOW_LATENCY
+};
+
+// 按字节给出的大小在 config_apply 时按页大小换算，与设置顺序无关
+static struct {
+    uint64_t memory;     // 物理内存字节数，0表示使用 physical_pages
+    uint64_t swap;       // 交换区字节数，0表示使用 swap_size
+    bool swap_set;       // 是否显式设置了交换区大小（否则为物理内存的4倍）
+    uint64_t slow_memory; // 慢速内存层字节数，0表示不使用分层内存
+} pending;
+
+void config_defaults(void) {
+    system_config.page_size = DEFAULT_PAGE_SIZE;
+    system_config.physical_pages = DEFAULT_PHYSICAL_PAGES;
+    system_config.virtual_pages = DEFAULT_VIRTUAL_PAGES;
+    system_config.swap_size = 0;
+    system_config.max_processes = DEFAULT_MAX_PROCESSES;
+    system_config.storage_size = DEFAULT_STORAGE_SIZE;
+    system_config.huge_page_size = DEFAULT_HUGE_PAGE_SIZE;
+    system_config.numa_nodes = DEFAULT_NUMA_NODES;
+    system_config.numa_distance = DEFAULT_NUMA_DISTANCE;
+    system_config.slow_pages = 0;
+    system_config.slow_latency = DEFAULT_SLOW_LATENCY;
+    system_config.storage_image[0] = '\0';
+    memset(&pending, 0, sizeof(pending));
+}
+
+// 解析带单位的大小：K、M、G、T（1024进制），没有单位时为字节数或个数
+static bool parse_size(const char* text, uint64_t* value) {
+    char* end;
+    unsigned long long number = strtoull(text, &end, 10);
+    if (end == text) {
+        return false;
+    }
+
+    uint64_t scale = 1;
+    switch (toupper((unsigned char)*end)) {
+        case 'K': scale = 1ULL << 10; end++; break;
+        case 'M': scale = 1ULL << 20; end++; break;
+        case 'G': scale = 1ULL << 30; end++; break;
+        case 'T': scale = 1ULL << 40; end++; break;
+        default: break;
+    }
+    if (toupper((unsigned char)*end) == 'B') {
+        end++;
+    }
+    if (*end != '\0' || (scale > 1 && number > UINT64_MAX / scale)) {
+        return false;
+    }
+    *value = number * scale;
+    return true;
+}
+
+static bool parse_count(const char* text, uint32_t* value) {
+    uint64_t number;
+    if (!parse_size(text, &number) || number > UINT32_MAX) {
+        return false;
+    }
+    *value = (uint32_t)number;
+    return true;
+}
+
+/**
+ * @brief 设置一个配置项
+ *
+ * 键名中的 '-' 与 '_' 等价。memory、swap、storage 为字节数（可带 K/M/G/T 单位），
+ * physical_pages、swap_size 为页数和块数，storage_image 为文件路径。
+ *
+ * @return true 键名和取值有效
+ */
+bool config_set(const char* key, const char* value) {
+    char name[64];
+    size_t len = strlen(key);
+    if (len >= sizeof(name)) {
+        printf("未知的配置项: %s\n", key);
+        return false;
+    }
+    for (size_t i = 0; i <= len; i++) {
+        name[i] = key[i] == '-' ? '_' : (char)tolower((unsigned char)key[i]);
+    }
+
+    uint64_t size;
+    bool ok;
+    if (strcmp(name, "page_size") == 0) {
+        ok = parse_count(value, &system_config.page_size);
+    } else if (strcmp(name, "physical_pages") == 0) {
+        ok = parse_count(value, &system_config.physical_pages);
+        pending.memory = 0;
+    } else if (strcmp(name, "memory") == 0) {
+        ok = parse_size(value, &size) && size > 0;
+        if (ok) {
+            pending.memory = size;
+        }
+    } else if (strcmp(name, "virtual_pages") == 0) {
+        ok = parse_count(value, &system_config.virtual_pages);
+    } else if (strcmp(name, "swap_size") == 0) {
+        ok = parse_count(value, &system_config.swap_size);
+        pending.swap = 0;
+        pending.swap_set = true;
+    } else if (strcmp(name, "swap") == 0) {
+        ok = parse_size(value, &size) && size > 0;
+        if (ok) {
+            pending.swap = size;
+            pending.swap_set = true;
+        }
+    } else if (strcmp(name, "max_processes") == 0) {
+        ok = parse_count(value, &system_config.max_processes);
+    } else if (strcmp(name, "storage") == 0) {
+        ok = parse_size(value, &system_config.storage_size);
+    } else if (strcmp(name, "storage_image") == 0) {
+        ok = strlen(value) < sizeof(system_config.storage_image);
+        if (ok) {
+            strcpy(system_config.storage_image, value);
+        }
+    } else if (strcmp(name, "huge_page_size") == 0) {
+        ok = parse_size(value, &size) && size <= MAX_HUGE_PAGE_SIZE;
+        if (ok) {
+            system_config.huge_page_size = (uint32_t)size;
+        }
+    } else if (strcmp(name, "numa_nodes") == 0) {
+        ok = parse_count(value, &system_config.numa_nodes);
+    } else if (strcmp(name, "numa_distance") == 0) {
+        ok = parse_count(value, &system_config.numa_distance);
+    } else if (strcmp(name, "slow_memory") == 0) {
+        ok = parse_size(value, &pending.slow_memory);
+    } else if (strcmp(name, "slow_latency") == 0) {
+        ok = parse_count(value, &system_config.slow_latency);
+    } else {
+        printf("未知的配置项: %s\n", key);
+        return false;
+    }
+
+    if (!ok) {
+        printf("配置项 %s 的取值无效: %s\n", key, value);
+    }
+    return ok;
+}
+
+// 读取配置文件：每行 "键 = 值"，'#' 之后为注释
+bool config_load_file(const char* path) {
+    FILE* fp = fopen(path, "r");
+    if (!fp) {
+        printf("无法打开配置文件%s\n", path);
+        return false;
+    }
+
+    char line[256];
+    uint32_t line_number = 0;
+    bool ok = true;
+    while (fgets(line, sizeof(line), fp)) {
+        line_number++;
+        char* comment = strchr(line, '#');
+        if (comment) {
+            *comment = '\0';
+        }
+
+        char* key = strtok(line, " \t\r\n=");
+        if (!key) {
+            continue;
+        }
+        char* value = strtok(NULL, " \t\r\n=");
+        if (!value) {
+            printf("配置文件 %s 第 %u 行缺少取值\n", path, line_number);
+            ok = false;
+            continue;
+        }
+        if (!config_set(key, value)) {
+            printf("配置文件 %s 第 %u 行无效\n", path, line_number);
+            ok = false;
+        }
+    }
+    fclose(fp);
+    return ok;
+}
+
+static void print_usage(const char* program) {
+    printf("用法: %s [--test] [选项]\n", program);
+    printf("  --test                   运行场景测试后退出（须为第一个参数）\n");
+    printf("  --config <文件>          从配置文件读取（每行 键 = 值）\n");
+    printf("  --page-size <字节>       页大小，2的幂（默认 %u）\n", DEFAULT_PAGE_SIZE);
+    printf("  --memory <大小>          物理内存大小，如 64M、16G\n");
+    printf("  --physical-pages <页数>  物理页框数（默认 %u）\n", DEFAULT_PHYSICAL_PAGES);
+    printf("  --virtual-pages <页数>   每个进程的虚拟页数（默认 %u）\n", DEFAULT_VIRTUAL_PAGES);
+    printf("  --swap <大小>            交换区大小（默认为物理内存的4倍）\n");
+    printf("  --swap-size <块数>       交换区块数\n");
+    printf("  --max-processes <个数>   进程表大小（默认 %u）\n", DEFAULT_MAX_PROCESSES);
+    printf("  --storage <大小>         存储空间大小（默认 64M）\n");
+    printf("  --storage-image <文件>   启动时直接映射的存储映像文件（不存在时创建，默认使用内存存储）\n");
+    printf("  --huge-page-size <大小>  透明大页大小（默认 2M）\n");
+    printf("  --numa-nodes <个数>      NUMA 节点数（默认 %u，最多 %u）\n", DEFAULT_NUMA_NODES, MAX_NUMA_NODES);
+    printf("  --numa-distance <距离>   跨节点访问距离，本节点为 %u（默认 %u）\n",
+           NUMA_LOCAL_DISTANCE, DEFAULT_NUMA_DISTANCE);
+    printf("  --slow-memory <大小>     慢速内存层大小，冷页降级到这里而不是换出（默认 0，不使用）\n");
+    printf("  --slow-latency <纳秒>    慢速内存访问延迟，DRAM 为 %u（默认 %u）\n", DRAM_LATENCY_NS, DEFAULT_SLOW_LATENCY);
+}
+
+/**
+ * @brief 解析命令行并应用配置
+ *
+ * 选项写作 "--键 值" 或 "--键=值"，按出现顺序生效，--config 读入的配置可被其后的选项覆盖。
+ *
+ * @return true 配置有效，可以初始化系统
+ */
+bool config_parse_args(int argc, char* argv[]) {
+    config_defaults();
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+            print_usage(argv[0]);
+            return false;
+        }
+        if (strncmp(arg, "--", 2) != 0) {
+            printf("无效的参数: %s\n", arg);
+            print_usage(argv[0]);
+            return false;
+        }
+
+        char key[64];
+        const char* value;
+        const char* equals = strchr(arg + 2, '=');
+        size_t key_len = equals ? (size_t)(equals - arg - 2) : strlen(arg + 2);
+        if (key_len >= sizeof(key)) {
+            printf("无效的参数: %s\n", arg);
+            return false;
+        }
+        memcpy(key, arg + 2, key_len);
+        key[key_len] = '\0';
+        if (equals) {
+            value = equals + 1;
+        } else if (i + 1 < argc) {
+            value = argv[++i];
+        } else {
+            printf("参数 %s 缺少取值\n", arg);
+            return false;
+        }
+
+        bool ok = strcmp(key, "config") == 0 ? config_load_file(value) : config_set(key, value);
+        if (!ok) {
+            return false;
+        }
+    }
+    return config_apply();
+}
+
+static bool is_power_of_two(uint64_t value) {
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+// 校验配置并计算派生值
+bool config_apply(void) {
+    SystemConfig* cfg = &system_config;
+
+    if (!is_power_of_two(cfg->page_size) || cfg->page_size < MIN_PAGE_SIZE || cfg->page_size > MAX_PAGE_SIZE) {
+        printf("页大小必须是 %u 到 %u 之间的2的幂\n", MIN_PAGE_SIZE, MAX_PAGE_SIZE);
+        return false;
+    }
+#ifdef FIXED_PAGE_SIZE
+    if (cfg->page_size != FIXED_PAGE_SIZE) {
+        printf("本程序编译为固定页大小 %u\n", (uint32_t)FIXED_PAGE_SIZE);
+        return false;
+    }
+#endif
+    cfg->page_shift = 0;
+    // physical_pages 在上次校验时加上了慢速内存页框
+    cfg->physical_pages -= cfg->slow_pages;
+    cfg->slow_pages = 0;
+    while ((1u << cfg->page_shift) < cfg->page_size) {
+        cfg->page_shift++;
+    }
+
+    if (pending.memory) {
+        if (pending.memory % cfg->page_size != 0 || pending.memory / cfg->page_size > UINT32_MAX) {
+            printf("物理内存大小必须是页大小的整数倍，且不超过 %u 页\n", UINT32_MAX);
+            return false;
+        }
+        cfg->physical_pages = (uint32_t)(pending.memory / cfg->page_size);
+    }
+    if (cfg->physical_pages < 16 || (uint64_t)cfg->physical_pages * cfg->page_size > SIZE_MAX / 2) {
+        printf("物理页框数无效: %u（至少16页）\n", cfg->physical_pages);
+        return false;
+    }
+
+    // 虚拟地址为32位
+    if (cfg->virtual_pages < 16 || (uint64_t)cfg->virtual_pages * cfg->page_size > (1ULL << 32)) {
+        printf("虚拟页数无效: %u（至少16页，虚拟地址空间不超过4GB）\n", cfg->virtual_pages);
+        return false;
+    }
+
+    if (pending.swap) {
+        if (pending.swap % cfg->page_size != 0 || pending.swap / cfg->page_size > MAX_SWAP_SIZE) {
+            printf("交换区大小必须是页大小的整数倍，且不超过 %u 块\n", MAX_SWAP_SIZE);
+            return false;
+        }
+        cfg->swap_size = (uint32_t)(pending.swap / cfg->page_size);
+    } else if (!pending.swap_set) {
+        uint64_t blocks = 4ULL * cfg->physical_pages;
+        cfg->swap_size = (uint32_t)(blocks > MAX_SWAP_SIZE ? MAX_SWAP_SIZE : blocks);
+    }
+    if (cfg->swap_size == 0 || cfg->swap_size > MAX_SWAP_SIZE) {
+        printf("交换区块数无效: %u（1 到 %u）\n", cfg->swap_size, MAX_SWAP_SIZE);
+        return false;
+    }
+    // 交换区按簇分配，块数向上取整到整簇（MAX_SWAP_SIZE 本身是整簇）
+    if (cfg->swap_size % SWAP_CLUSTER_SIZE != 0) {
+        uint32_t rounded = (cfg->swap_size + SWAP_CLUSTER_SIZE - 1) / SWAP_CLUSTER_SIZE * SWAP_CLUSTER_SIZE;
+        if (pending.swap_set) {
+            printf("交换区块数 %u 向上取整为 %u（%u 块一簇）\n", cfg->swap_size, rounded, SWAP_CLUSTER_SIZE);
+        }
+        cfg->swap_size = rounded;
+    }
+
+    if (cfg->max_processes == 0 || cfg->max_processes > 65536) {
+        printf("进程表大小无效: %u（1 到 65536）\n", cfg->max_processes);
+        return false;
+    }
+
+    // 存储块与页大小相同（页缓存按页缓存存储块）
+    if (cfg->storage_size == 0 || cfg->storage_size % cfg->page_size != 0 ||
+        cfg->storage_size / cfg->page_size >= UINT32_MAX || cfg->storage_size > SIZE_MAX / 2) {
+        printf("存储空间大小必须是页大小的整数倍\n");
+        return false;
+    }
+
+    // 大页由连续且对齐的页框组成，至少包含2页
+    if (!is_power_of_two(cfg->huge_page_size) || cfg->huge_page_size < 2 * cfg->page_size ||
+        cfg->huge_page_size > MAX_HUGE_PAGE_SIZE) {
+        printf("大页大小必须是页大小2倍以上的2的幂，且不超过 1G\n");
+        return false;
+    }
+    cfg->huge_page_pages = cfg->huge_page_size / cfg->page_size;
+
+    // 每个节点至少16个页框
+    if (cfg->numa_nodes == 0 || cfg->numa_nodes > MAX_NUMA_NODES || cfg->physical_pages / cfg->numa_nodes < 16) {
+        printf("NUMA 节点数无效: %u（1 到 %u，每个节点至少16个页框）\n", cfg->numa_nodes, MAX_NUMA_NODES);
+        return false;
+    }
+    if (cfg->numa_distance < NUMA_LOCAL_DISTANCE || cfg->numa_distance > MAX_NUMA_DISTANCE) {
+        printf("跨节点访问距离无效: %u（%u 到 %u）\n", cfg->numa_distance, NUMA_LOCAL_DISTANCE, MAX_NUMA_DISTANCE);
+        return false;
+    }
+
+    // 慢速内存层的页框接在 DRAM 之后，页框总数仍不超过 UINT32_MAX
+    if (pending.slow_memory % cfg->page_size != 0 ||
+        pending.slow_memory / cfg->page_size > UINT32_MAX - cfg->physical_pages ||
+        (cfg->physical_pages + pending.slow_memory / cfg->page_size) * (uint64_t)cfg->page_size > SIZE_MAX / 2) {
+        printf("慢速内存大小必须是页大小的整数倍\n");
+        return false;
+    }
+    if (cfg->slow_latency < DRAM_LATENCY_NS || cfg->slow_latency > MAX_SLOW_LATENCY) {
+        printf("慢速内存访问延迟无效: %u（%u 到 %u 纳秒）\n", cfg->slow_latency, DRAM_LATENCY_NS, MAX_SLOW_LATENCY);
+        return false;
+    }
+    cfg->slow_pages = (uint32_t)(pending.slow_memory / cfg->page_size);
+    cfg->physical_pages += cfg->slow_pages;
+    return true;
+}
+
+static void print_bytes(const char* label, uint64_t bytes) {
+    if (bytes >= (1ULL << 30)) {
+        printf("%s: %.2f GB\n", label, (double)bytes / (1ULL << 30));
+    } else if (bytes >= (1ULL << 20)) {
+        printf("%s: %.2f MB\n", label, (double)bytes / (1ULL << 20));
+    } else {
+        printf("%s: %llu KB\n", label, (unsigned long long)(bytes >> 10));
+    }
+}
+
+// 打印当前配置
+void print_config(void) {
+    const SystemConfig* cfg = &system_config;
+    printf("\n=== 系统配置 ===\n");
+#ifdef FIXED_PAGE_SIZE
+    printf("页大小: %u 字节（编译期固定）\n", cfg->page_size);
+#else
+    printf("页大小: %u 字节\n", cfg->page_size);
+#endif
+    printf("物理页框数: %u\n", cfg->physical_pages);
+    print_bytes("物理内存", (uint64_t)cfg->physical_pages * cfg->page_size);
+    if (cfg->slow_pages > 0) {
+        printf("其中慢速内存: %u 页，访问延迟 %u ns\n", cfg->slow_pages, cfg->slow_latency);
+    }
+    printf("虚拟页数: %u\n", cfg->virtual_pages);
+    printf("交换区块数: %u\n", cfg->swap_size);
+    print_bytes("交换区", (uint64_t)cfg->swap_size * cfg->page_size);
+    printf("进程表大小: %u\n", cfg->max_processes);
+    print_bytes("存储空间", cfg->storage_size);
+    if (cfg->storage_image[0]) {
+        printf("存储映像: %s\n", cfg->storage_image);
+    }
+    print_bytes("大页大小", cfg->huge_page_size);
+    printf("每个大页页数: %u\n", cfg->huge_page_pages);
+    printf("NUMA 节点数: %u（跨节点访问距离 %u，本节点 %u）\n",
+           cfg->numa_nodes, cfg->numa_distance, NUMA_LOCAL_DISTANCE);
+}
@@ -1,176 +1,1251 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 #include "../include/dump.h"
 #include "../include/memory.h"
 #include "../include/vm.h"
 #include "../include/process.h"
+#include "../include/swapalloc.h"
+#include "../include/pagecache.h"
+#include "../include/shm.h"
+#include "../include/ksm.h"
+#include "../include/thp.h"
+#include "../include/tlb.h"
+#include "../include/compact.h"
+#include "../include/profile.h"
+#include "../include/compress.h"
 
-// ⲿ
+// 外部变量
 extern VMManager vm_manager;
 
-// ϵͳ״̬
-bool dump_system_state(const char* filename) {
-    FILE* fp = fopen(filename, "wb");
-    if (!fp) {
-        printf("޷ļ%s\n", filename);
+// 内存中的字节缓冲区（快照映像、段内容）
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    size_t capacity;
+} SnapshotImage;
+
+// 打开的快照文件（mmap 映射，或不支持映射时读入的缓冲区）
+typedef struct {
+    uint8_t* base;
+    size_t size;
+    bool mapped;
+    uint32_t lazy_blocks;        // 仍在其中按需读入的交换区块数
+    char path[DUMP_PATH_MAX];
+} SnapshotFile;
+
+// 检查点基线：上一个快照捕获时的页框写入序号和交换区写入序号
+static struct {
+    bool valid;
+    char path[DUMP_PATH_MAX];
+    uint32_t sequence;
+    uint64_t frame_seq;
+    uint64_t swap_seq;
+} checkpoint;
+
+// 后台写入状态
+static struct {
+    bool active;
+    volatile bool done;
+    bool ok;
+    bool threaded;
+    char path[DUMP_PATH_MAX];
+    SnapshotImage image;
+#ifndef _WIN32
+    pthread_t thread;
+#endif
+} stream;
+
+// 周期检查点
+static uint32_t auto_interval = 0;
+static uint32_t auto_ticks = 0;
+static char auto_prefix[DUMP_PATH_MAX] = "checkpoint";
+
+// 最近一次快照的统计
+static struct {
+    uint32_t snapshots;
+    uint32_t frames_written;
+    uint32_t swap_written;
+    uint32_t records;
+    size_t bytes;
+    size_t raw_bytes;
+    uint64_t capture_us;
+    uint64_t restore_us;
+} last;
+
+// 页面在快照链中的最新记录（页框数据和仍留在快照文件中的交换区块）
+typedef struct {
+    const SnapshotPageRecord* record;   // NULL表示没有记录（交换区块：已在交换区中）
+    const uint8_t* section;             // 记录所在数据段的起始地址
+    uint32_t file;
+} PageSource;
+
+// 恢复时打开的快照链文件，和仍留在其中的交换区块（SWAP_SIZE 项）
+static SnapshotFile lazy_files[DUMP_CHAIN_MAX];
+static PageSource* lazy_swap = NULL;
+static uint32_t lazy_swap_count = 0;
+
+// 按启动时配置的交换区块数分配按需读入表
+static bool dump_tables_ready(void) {
+    if (lazy_swap) {
+        return true;
+    }
+    lazy_swap = (PageSource*)calloc(SWAP_SIZE, sizeof(PageSource));
+    if (!lazy_swap) {
+        printf("快照表分配失败\n");
+        return false;
+    }
+    return true;
+}
+
+// ---------------- 校验和 ----------------
+
+static uint32_t crc_table[256];
+static bool crc_ready = false;
+
+// CRC32（IEEE 802.3 多项式）
+static uint32_t crc32_update(uint32_t crc, const void* data, size_t size) {
+    if (!crc_ready) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            crc_table[i] = c;
+        }
+        crc_ready = true;
+    }
+
+    const uint8_t* p = (const uint8_t*)data;
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc = crc_table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static uint32_t crc32(const void* data, size_t size) {
+    return crc32_update(0, data, size);
+}
+
+// ---------------- 写入 ----------------
+
+static bool image_append(SnapshotImage* image, const void* data, size_t size) {
+    if (image->size + size > image->capacity) {
+        size_t capacity = image->capacity ? image->capacity : 64 * 1024;
+        while (capacity < image->size + size) {
+            capacity *= 2;
+        }
+        uint8_t* grown = (uint8_t*)realloc(image->data, capacity);
+        if (!grown) {
+            return false;
+        }
+        image->data = grown;
+        image->capacity = capacity;
+    }
+    memcpy(image->data + image->size, data, size);
+    image->size += size;
+    return true;
+}
+
+static void image_free(SnapshotImage* image) {
+    free(image->data);
+    memset(image, 0, sizeof(*image));
+}
+
+// 元数据段：整段压缩（压缩后不更小时原样存放）
+static bool add_meta_section(SnapshotSection* section, SnapshotImage* body, uint32_t type,
+                             const void* raw, size_t raw_size, uint32_t item_count) {
+    memset(section, 0, sizeof(*section));
+    section->type = type;
+    section->raw_size = raw_size;
+    section->item_count = item_count;
+
+    size_t bound = LZ_COMPRESS_BOUND(raw_size);
+    uint8_t* packed = (uint8_t*)malloc(bound);
+    size_t packed_size = packed && raw_size ? lz_compress((const uint8_t*)raw, raw_size, packed, bound) : 0;
+    bool ok;
+    if (packed_size > 0 && packed_size < raw_size) {
+        section->flags = SECTION_COMPRESSED;
+        ok = image_append(body, packed, packed_size);
+    } else {
+        ok = raw_size == 0 || image_append(body, raw, raw_size);
+    }
+    free(packed);
+
+    section->stored_size = body->size;
+    section->checksum = crc32(body->data, body->size);
+    return ok;
+}
+
+/**
+ * @brief 向数据段加入一个页面
+ *
+ * 全零页面不存放数据，与紧邻的上一条零页记录合并为游程；其余页面可压缩时压缩存放。
+ * 页面数据的偏移先相对页面数据区，收尾时修正。
+ */
+static bool add_page(SnapshotImage* table, SnapshotImage* payload, uint32_t index, const uint8_t* page) {
+    SnapshotPageRecord record;
+    memset(&record, 0, sizeof(record));
+    record.index = index;
+    record.count = 1;
+
+    if (is_zero_page(page)) {
+        SnapshotPageRecord* prev = table->size ?
+            (SnapshotPageRecord*)(table->data + table->size - sizeof(record)) : NULL;
+        if (prev && (prev->flags & PAGE_ZERO) && prev->index + prev->count == index) {
+            prev->count++;
+            return true;
+        }
+        record.flags = PAGE_ZERO;
+        return image_append(table, &record, sizeof(record));
+    }
+
+    uint8_t packed[LZ_COMPRESS_BOUND(PAGE_SIZE)];
+    size_t packed_size = lz_compress(page, PAGE_SIZE, packed, sizeof(packed));
+    record.checksum = crc32(page, PAGE_SIZE);
+    record.offset = payload->size;
+    bool ok;
+    if (packed_size > 0 && packed_size < PAGE_SIZE) {
+        record.flags = PAGE_COMPRESSED;
+        record.stored_size = (uint32_t)packed_size;
+        ok = image_append(payload, packed, packed_size);
+    } else {
+        record.stored_size = PAGE_SIZE;
+        ok = image_append(payload, page, PAGE_SIZE);
+    }
+    return ok && image_append(table, &record, sizeof(record));
+}
+
+// 数据段收尾：记录表在前、页面数据在后，校验和覆盖记录表
+static bool finish_data_section(SnapshotSection* section, SnapshotImage* body, uint32_t type,
+                                SnapshotImage* table, const SnapshotImage* payload) {
+    uint32_t count = (uint32_t)(table->size / sizeof(SnapshotPageRecord));
+    SnapshotPageRecord* records = (SnapshotPageRecord*)table->data;
+    uint64_t pages = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (!(records[i].flags & PAGE_ZERO)) {
+            records[i].offset += table->size;
+        }
+        pages += records[i].count;
+    }
+
+    memset(section, 0, sizeof(*section));
+    section->type = type;
+    section->item_count = count;
+    section->raw_size = pages * PAGE_SIZE;
+    section->checksum = crc32(table->data, table->size);
+    bool ok = (table->size == 0 || image_append(body, table->data, table->size)) &&
+              (payload->size == 0 || image_append(body, payload->data, payload->size));
+    section->stored_size = body->size;
+    return ok;
+}
+
+// 进程记录（不含指针）
+static void process_to_record(const PCB* process, SnapshotProcess* record) {
+    memset(record, 0, sizeof(*record));
+    record->pid = process->pid;
+    memcpy(record->name, process->name, sizeof(record->name));
+    record->state = process->state;
+    record->priority = process->priority;
+    record->time_slice = process->time_slice;
+    record->total_time_slice = process->total_time_slice;
+    record->wait_time = process->wait_time;
+    record->wake_tick = process->wake_tick;
+    record->was_preempted = process->was_preempted;
+    record->page_table_size = process->page_table_size;
+    record->last_schedule_time = process->last_schedule_time;
+    record->stats = process->stats;
+    record->memory_layout = process->memory_layout;
+    record->app_config = process->app_config;
+    record->monitor_config = process->monitor_config;
+    record->numa = process->numa;
+}
+
+static void record_to_process(const SnapshotProcess* record, PCB* process) {
+    memset(process, 0, sizeof(*process));
+    process->pid = record->pid;
+    memcpy(process->name, record->name, sizeof(process->name));
+    process->name[MAX_PROCESS_NAME - 1] = '\0';
+    process->state = (ProcessState)record->state;
+    process->priority = (ProcessPriority)record->priority;
+    process->time_slice = record->time_slice;
+    process->total_time_slice = record->total_time_slice;
+    process->wait_time = record->wait_time;
+    process->wake_tick = record->wake_tick;
+    process->was_preempted = record->was_preempted != 0;
+    process->page_table_size = record->page_table_size;
+    process->last_schedule_time = record->last_schedule_time;
+    process->stats = record->stats;
+    process->memory_layout = record->memory_layout;
+    process->app_config = record->app_config;
+    process->monitor_config = record->monitor_config;
+    process->numa = record->numa;
+}
+
+static bool append_process(SnapshotImage* image, const PCB* process, uint32_t* count) {
+    SnapshotProcess record;
+    process_to_record(process, &record);
+    if (!image_append(image, &record, sizeof(record)) ||
+        !image_append(image, process->page_table, sizeof(PageTableEntry) * process->page_table_size)) {
+        return false;
+    }
+    (*count)++;
+    return true;
+}
+
+/**
+ * @brief 捕获快照映像，并把当前状态设为新的检查点基线
+ *
+ * 运行、就绪和阻塞的进程都按队列顺序记录。页面数据只包含已分配的页框和已使用的
+ * 交换区块，大小随实际占用增长；增量快照进一步只记录内容指纹与基线不同的页框，
+ * 以及基线之后写入过的交换区块。进程和交换区块信息很小，每次都完整记录。
+ *
+ * @param image 输出的快照映像
+ * @param filename 快照文件名（记录为后续增量快照的依赖）
+ * @param incremental 是否增量
+ * @return true 捕获成功
+ */
+static bool capture_snapshot(SnapshotImage* image, const char* filename, bool incremental) {
+    uint64_t start = get_current_time();
+    uint8_t* memory = get_physical_memory();
+    bool* frame_map = get_frame_map();
+    SwapBlockInfo* swap_blocks = get_swap_blocks();
+    if (!memory || !frame_map || !swap_blocks || !dump_tables_ready()) {
         return false;
     }
 
-    // 1. дϵͳ״̬ͷϢ
-    SystemStateHeader header = {
-        .total_pages = VIRTUAL_PAGES,
+    SnapshotSection sections[SNAPSHOT_MAX_SECTIONS];
+    SnapshotImage bodies[SNAPSHOT_MAX_SECTIONS];
+    SnapshotImage procs = {0}, table = {0}, payload = {0};
+    memset(bodies, 0, sizeof(bodies));
+    uint32_t section_count = 0;
+    bool ok = true;
+
+    // 1. 进程：运行中、就绪队列、阻塞队列
+    uint32_t process_count = 0;
+    PCB* running = get_running_process();
+    if (running) {
+        ok = append_process(&procs, running, &process_count);
+    }
+    for (int i = 0; ok && i < 3; i++) {
+        for (PCB* proc = get_ready_queue(i); ok && proc; proc = proc->next) {
+            ok = append_process(&procs, proc, &process_count);
+        }
+    }
+    for (PCB* proc = get_blocked_queue(); ok && proc; proc = proc->next) {
+        ok = append_process(&procs, proc, &process_count);
+    }
+
+    SnapshotSystem system = {
+        .memory_stats = get_memory_stats(),
+        .process_count = process_count,
+        .current_pid = running ? running->pid : 0,
+        .next_pid = scheduler.next_pid,
+        .total_runtime = scheduler.total_runtime,
+        .zero_frame = memory_manager.zero_frame
+    };
+    ok = ok && add_meta_section(&sections[section_count], &bodies[section_count], SECTION_SYSTEM,
+                                &system, sizeof(system), 1);
+    section_count++;
+    ok = ok && add_meta_section(&sections[section_count], &bodies[section_count], SECTION_PROCESSES,
+                                procs.data, procs.size, process_count);
+    section_count++;
+    image_free(&procs);
+
+    // 2. 页框数据（增量快照只保存检查点之后分配或写入过的页框）
+    for (uint32_t i = 0; ok && i < PHYSICAL_PAGES; i++) {
+        if (!frame_map[i] ||
+            (incremental && memory_manager.frames[i].write_seq <= checkpoint.frame_seq)) {
+            continue;
+        }
+        ok = add_page(&table, &payload, i, memory + (size_t)i * PAGE_SIZE);
+    }
+    ok = ok && finish_data_section(&sections[section_count], &bodies[section_count],
+                                   SECTION_FRAME_DATA, &table, &payload);
+    section_count++;
+    image_free(&table);
+    image_free(&payload);
+
+    // 3. 交换区块信息和已使用交换区块的数据（块数据经交换设备读出）
+    ok = ok && add_meta_section(&sections[section_count], &bodies[section_count], SECTION_SWAP_TABLE,
+                                swap_blocks, sizeof(SwapBlockInfo) * SWAP_SIZE, SWAP_SIZE);
+    section_count++;
+    uint8_t block[SWAP_BLOCK_SIZE];
+    for (uint32_t i = 0; ok && i < SWAP_SIZE; i++) {
+        if (!swap_blocks[i].is_used ||
+            (incremental && vm_manager.swap_write_seq[i] <= checkpoint.swap_seq)) {
+            continue;
+        }
+        if (!read_from_swap(i, block)) {
+            printf("读取交换区块 %u 失败\n", i);
+            ok = false;
+            break;
+        }
+        ok = add_page(&table, &payload, i, block);
+    }
+    ok = ok && finish_data_section(&sections[section_count], &bodies[section_count],
+                                   SECTION_SWAP_DATA, &table, &payload);
+    section_count++;
+    image_free(&table);
+    image_free(&payload);
+
+    // 4. 文件头、段表和各段内容
+    SnapshotFileHeader header = {
+        .version = SNAPSHOT_VERSION,
+        .header_size = sizeof(SnapshotFileHeader),
+        .snapshot_type = incremental ? SNAPSHOT_INCREMENTAL : SNAPSHOT_FULL,
+        .sequence = incremental ? checkpoint.sequence + 1 : 0,
+        .page_size = PAGE_SIZE,
         .physical_pages = PHYSICAL_PAGES,
         .swap_size = SWAP_SIZE,
-        .memory_stats = get_memory_stats(),
-        .process_count = get_total_processes(),
-        .current_pid = get_running_process() ? get_running_process()->pid : 0
+        .section_count = section_count
     };
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    if (incremental) {
+        snprintf(header.parent, sizeof(header.parent), "%s", checkpoint.path);
+    }
 
-    if (fwrite(&header, sizeof(header), 1, fp) != 1) {
-        printf("дͷϢʧ\n");
-        fclose(fp);
+    uint64_t offset = sizeof(header) + sizeof(SnapshotSection) * section_count;
+    size_t raw_bytes = 0;
+    for (uint32_t i = 0; i < section_count; i++) {
+        offset = (offset + 7) & ~(uint64_t)7;
+        sections[i].offset = offset;
+        offset += sections[i].stored_size;
+        raw_bytes += sections[i].raw_size;
+    }
+    header.checksum = crc32_update(crc32(&header, sizeof(header)),
+                                   sections, sizeof(SnapshotSection) * section_count);
+
+    ok = ok && image_append(image, &header, sizeof(header)) &&
+         image_append(image, sections, sizeof(SnapshotSection) * section_count);
+    static const uint8_t padding[8];
+    for (uint32_t i = 0; i < section_count; i++) {
+        ok = ok && image_append(image, padding, (size_t)(sections[i].offset - image->size));
+        ok = ok && (bodies[i].size == 0 || image_append(image, bodies[i].data, bodies[i].size));
+        image_free(&bodies[i]);
+    }
+    if (!ok) {
         return false;
     }
 
-    // 2. дн״̬
-    for (int i = 0; i < 3; i++) {  // 
-        PCB* proc = get_ready_queue(i);
-        while (proc) {
-            // дϢ
-            if (fwrite(proc, sizeof(PCB), 1, fp) != 1) {
-                fclose(fp);
-                return false;
-            }
-            // дҳ
-            if (fwrite(proc->page_table, sizeof(PageTableEntry) * proc->page_table_size, 1, fp) != 1) {
-                fclose(fp);
-                return false;
-            }
-            proc = proc->next;
-        }
+    // 5. 当前状态成为新的检查点基线
+    checkpoint.valid = true;
+    snprintf(checkpoint.path, sizeof(checkpoint.path), "%s", filename);
+    checkpoint.sequence = header.sequence;
+    checkpoint.frame_seq = memory_manager.write_count;
+    checkpoint.swap_seq = vm_manager.swap_write_count;
+
+    last.snapshots++;
+    last.frames_written = (uint32_t)(sections[2].raw_size / PAGE_SIZE);
+    last.swap_written = (uint32_t)(sections[4].raw_size / PAGE_SIZE);
+    last.records = sections[2].item_count + sections[4].item_count;
+    last.bytes = image->size;
+    last.raw_bytes = raw_bytes;
+    last.capture_us = get_current_time() - start;
+    return true;
+}
+
+static bool write_image(const char* filename, const SnapshotImage* image) {
+    FILE* fp = fopen(filename, "wb");
+    if (!fp) {
+        printf("无法打开文件%s\n", filename);
+        return false;
+    }
+    bool ok = fwrite(image->data, 1, image->size, fp) == image->size;
+    if (fclose(fp) != 0) {
+        ok = false;
+    }
+    return ok;
+}
+
+// 保存快照（在当前线程写入）
+static bool save_snapshot(const char* filename, bool incremental) {
+    dump_wait_stream();
+
+    SnapshotImage image = {0};
+    bool ok = capture_snapshot(&image, filename, incremental) && write_image(filename, &image);
+    image_free(&image);
+    if (!ok) {
+        // 写入失败的快照不能作为后续增量快照的依赖
+        checkpoint.valid = false;
+        printf("写入快照 %s 失败\n", filename);
     }
+    return ok;
+}
 
-    // 3. дڴ״̬
-    uint8_t* memory = get_physical_memory();
-    bool* frame_map = get_frame_map();
-    if (!memory || !frame_map ||
-        fwrite(memory, PAGE_SIZE, PHYSICAL_PAGES, fp) != PHYSICAL_PAGES ||
-        fwrite(frame_map, sizeof(bool), PHYSICAL_PAGES, fp) != PHYSICAL_PAGES) {
-        printf("дڴ״̬ʧ\n");
-        fclose(fp);
+// 保存系统状态（完整快照）
+bool dump_system_state(const char* filename) {
+    return save_snapshot(filename, false);
+}
+
+// 保存相对上一个检查点的增量快照
+bool dump_incremental_state(const char* filename) {
+    if (!checkpoint.valid) {
+        printf("没有可用的检查点，保存完整快照\n");
+        return save_snapshot(filename, false);
+    }
+    if (checkpoint.sequence + 1 >= DUMP_CHAIN_MAX) {
+        printf("增量快照链已达到 %d 个，保存完整快照\n", DUMP_CHAIN_MAX);
+        return save_snapshot(filename, false);
+    }
+    bool ok = save_snapshot(filename, true);
+    if (ok) {
+        printf("增量快照 %s：%u 个页框，%u 个交换区块\n",
+               filename, last.frames_written, last.swap_written);
+    }
+    return ok;
+}
+
+#ifndef _WIN32
+static void* stream_writer(void* arg) {
+    (void)arg;
+    stream.ok = write_image(stream.path, &stream.image);
+    stream.done = true;
+    return NULL;
+}
+#endif
+
+/**
+ * @brief 后台保存快照
+ *
+ * 在当前线程只捕获变化的数据（耗时与变化量成正比），文件由写入线程保存，
+ * 模拟在写入期间继续运行。前一个后台写入未完成时先等待它完成。
+ *
+ * @param filename 快照文件名
+ * @param incremental 是否增量（没有可用检查点时保存完整快照）
+ * @return true 已开始写入
+ */
+bool dump_start_stream(const char* filename, bool incremental) {
+    dump_wait_stream();
+
+    incremental = incremental && checkpoint.valid && checkpoint.sequence + 1 < DUMP_CHAIN_MAX;
+    memset(&stream.image, 0, sizeof(stream.image));
+    if (!capture_snapshot(&stream.image, filename, incremental)) {
+        image_free(&stream.image);
+        checkpoint.valid = false;
+        printf("捕获快照失败\n");
         return false;
     }
+    snprintf(stream.path, sizeof(stream.path), "%s", filename);
+    stream.done = false;
+    stream.threaded = false;
+    stream.active = true;
 
-    // 4. д뽻״̬
-    SwapBlockInfo* swap_blocks = get_swap_blocks();
-    void* swap_area = get_swap_area();
-    if (!swap_blocks || !swap_area ||
-        fwrite(swap_blocks, sizeof(SwapBlockInfo), SWAP_SIZE, fp) != SWAP_SIZE ||
-        fwrite(swap_area, SWAP_BLOCK_SIZE, SWAP_SIZE, fp) != SWAP_SIZE) {
-        printf("д뽻״̬ʧ\n");
-        fclose(fp);
+#ifndef _WIN32
+    if (pthread_create(&stream.thread, NULL, stream_writer, NULL) == 0) {
+        stream.threaded = true;
+        printf("%s快照 %s 开始后台写入（%zu 字节）\n",
+               incremental ? "增量" : "完整", filename, stream.image.size);
+        return true;
+    }
+#endif
+    // 无法创建写入线程时直接写入
+    stream.ok = write_image(stream.path, &stream.image);
+    stream.done = true;
+    return dump_wait_stream();
+}
+
+// 等待后台写入完成
+bool dump_wait_stream(void) {
+    if (!stream.active) {
+        return true;
+    }
+#ifndef _WIN32
+    if (stream.threaded) {
+        pthread_join(stream.thread, NULL);
+    }
+#endif
+    stream.active = false;
+    image_free(&stream.image);
+
+    if (!stream.ok) {
+        checkpoint.valid = false;
+        printf("后台写入快照 %s 失败，下一个检查点将保存完整快照\n", stream.path);
         return false;
     }
+    printf("快照 %s 后台写入完成\n", stream.path);
+    return true;
+}
+
+// 设置周期检查点
+void dump_set_auto_checkpoint(uint32_t interval, const char* prefix) {
+    auto_interval = interval;
+    auto_ticks = 0;
+    if (prefix) {
+        snprintf(auto_prefix, sizeof(auto_prefix), "%s", prefix);
+    }
+    if (interval) {
+        printf("每 %u 个时钟滴答保存一次检查点：%s.<序号>\n", interval, auto_prefix);
+    } else {
+        printf("周期检查点已关闭\n");
+    }
+}
+
+// 时钟滴答：收割完成的后台写入，到期时开始新的增量检查点
+void dump_tick(void) {
+    if (stream.active && stream.done) {
+        dump_wait_stream();
+    }
+    if (auto_interval == 0 || ++auto_ticks < auto_interval) {
+        return;
+    }
+    auto_ticks = 0;
+
+    char filename[DUMP_PATH_MAX + 16];
+    uint32_t sequence = checkpoint.valid ? checkpoint.sequence + 1 : 0;
+    snprintf(filename, sizeof(filename), "%s.%u", auto_prefix, sequence);
+    dump_start_stream(filename, true);
+}
 
+// ---------------- 读取 ----------------
+
+// 打开快照文件：优先 mmap 映射，页面数据在首次访问时才从文件读入
+static bool open_snapshot(const char* path, SnapshotFile* file) {
+    memset(file, 0, sizeof(*file));
+    snprintf(file->path, sizeof(file->path), "%s", path);
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("无法打开文件%s\n", path);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (base != MAP_FAILED) {
+            file->base = (uint8_t*)base;
+            file->size = (size_t)st.st_size;
+            file->mapped = true;
+        }
+    }
+    close(fd);
+    if (file->mapped) {
+        return true;
+    }
+#endif
+    // 不支持映射时整个读入内存
+    FILE* fp = fopen(path, "rb");
+    if (!fp) {
+        printf("无法打开文件%s\n", path);
+        return false;
+    }
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    file->base = size > 0 ? (uint8_t*)malloc((size_t)size) : NULL;
+    bool ok = file->base && fread(file->base, 1, (size_t)size, fp) == (size_t)size;
     fclose(fp);
+    if (!ok) {
+        free(file->base);
+        file->base = NULL;
+        printf("读取文件%s失败\n", path);
+        return false;
+    }
+    file->size = (size_t)size;
     return true;
 }
 
-// ָϵͳ״̬
-bool restore_system_state(const char* filename) {
-    FILE* fp = fopen(filename, "rb");
-    if (!fp) {
-        printf("޷ļ%s\n", filename);
+static void close_snapshot(SnapshotFile* file) {
+    if (!file->base) {
+        return;
+    }
+#ifndef _WIN32
+    if (file->mapped) {
+        munmap(file->base, file->size);
+    } else
+#endif
+    {
+        free(file->base);
+    }
+    memset(file, 0, sizeof(*file));
+}
+
+static const SnapshotFileHeader* file_header(const SnapshotFile* file) {
+    return (const SnapshotFileHeader*)file->base;
+}
+
+static const SnapshotSection* file_sections(const SnapshotFile* file) {
+    return (const SnapshotSection*)(file->base + sizeof(SnapshotFileHeader));
+}
+
+// 检查文件头、版本、配置、段表校验和和段范围
+static bool check_snapshot(const SnapshotFile* file) {
+    if (file->size < sizeof(SnapshotFileHeader) ||
+        memcmp(file_header(file)->magic, SNAPSHOT_MAGIC, sizeof(file_header(file)->magic)) != 0) {
+        printf("%s 不是快照文件\n", file->path);
         return false;
     }
 
-    // 1. ȡϵͳ״̬ͷϢ
-    SystemStateHeader header;
-    if (fread(&header, sizeof(header), 1, fp) != 1) {
-        printf("ȡͷϢʧ\n");
-        fclose(fp);
+    SnapshotFileHeader header;
+    memcpy(&header, file->base, sizeof(header));
+    if (header.version != SNAPSHOT_VERSION || header.header_size != sizeof(SnapshotFileHeader)) {
+        printf("快照 %s 的格式版本 %u 不受支持（当前版本 %d）\n", file->path, header.version, SNAPSHOT_VERSION);
+        return false;
+    }
+    if (header.page_size != PAGE_SIZE || header.physical_pages != PHYSICAL_PAGES ||
+        header.swap_size != SWAP_SIZE || header.snapshot_type > SNAPSHOT_INCREMENTAL) {
+        printf("快照 %s 与当前配置不匹配\n", file->path);
+        return false;
+    }
+    size_t table_size = sizeof(SnapshotSection) * header.section_count;
+    if (header.section_count > SNAPSHOT_MAX_SECTIONS || file->size < sizeof(header) + table_size) {
+        printf("快照 %s 的段表损坏\n", file->path);
         return false;
     }
 
-    // 2. رյ
-    scheduler_shutdown();
-    vm_shutdown();
-    
-    // 3. ʼϵͳ
-    scheduler_init();
-    vm_init();
-    memory_init();
+    uint32_t expected = header.checksum;
+    header.checksum = 0;
+    if (crc32_update(crc32(&header, sizeof(header)), file_sections(file), table_size) != expected) {
+        printf("快照 %s 的文件头校验失败\n", file->path);
+        return false;
+    }
 
-    // 4. ָϵͳ״̬
-    for (uint32_t i = 0; i < header.process_count; i++) {
-        PCB proc_info;
-        if (fread(&proc_info, sizeof(PCB), 1, fp) != 1) {
-            printf("ȡϢʧ\n");
-            fclose(fp);
+    const SnapshotSection* sections = file_sections(file);
+    for (uint32_t i = 0; i < header.section_count; i++) {
+        if ((sections[i].offset & 7) != 0 || sections[i].offset > file->size ||
+            sections[i].stored_size > file->size - sections[i].offset) {
+            printf("快照 %s 的段 %u 超出文件范围\n", file->path, sections[i].type);
             return false;
         }
+    }
+    return true;
+}
+
+static const SnapshotSection* find_section(const SnapshotFile* file, uint32_t type) {
+    const SnapshotSection* sections = file_sections(file);
+    for (uint32_t i = 0; i < file_header(file)->section_count; i++) {
+        if (sections[i].type == type) {
+            return &sections[i];
+        }
+    }
+    printf("快照 %s 缺少段 %u\n", file->path, type);
+    return NULL;
+}
 
-        // ½
-        uint32_t total_pages = proc_info.memory_layout.code.num_pages + 
-                             proc_info.memory_layout.data.num_pages +
-                             proc_info.memory_layout.heap.num_pages +
-                             proc_info.memory_layout.stack.num_pages;
-        PCB* new_proc = process_create(proc_info.pid, total_pages);
-        if (!new_proc) {
-            printf("̴ʧ\n");
-            fclose(fp);
-            return false;
+// 读出元数据段：校验后解压到新分配的缓冲区
+static uint8_t* load_meta_section(const SnapshotFile* file, uint32_t type, const SnapshotSection** out) {
+    const SnapshotSection* section = find_section(file, type);
+    if (!section) {
+        return NULL;
+    }
+    const uint8_t* stored = file->base + section->offset;
+    if (crc32(stored, section->stored_size) != section->checksum) {
+        printf("快照 %s 的段 %u 校验失败\n", file->path, type);
+        return NULL;
+    }
+
+    uint8_t* raw = (uint8_t*)malloc(section->raw_size ? section->raw_size : 1);
+    if (!raw) {
+        return NULL;
+    }
+    bool ok;
+    if (section->flags & SECTION_COMPRESSED) {
+        ok = lz_decompress(stored, section->stored_size, raw, section->raw_size) == section->raw_size;
+    } else {
+        ok = section->stored_size == section->raw_size;
+        if (ok) {
+            memcpy(raw, stored, section->raw_size);
         }
+    }
+    if (!ok) {
+        printf("快照 %s 的段 %u 解压失败\n", file->path, type);
+        free(raw);
+        return NULL;
+    }
+    *out = section;
+    return raw;
+}
+
+// 取得数据段的页面记录表，校验记录表和每条记录的范围
+static const SnapshotPageRecord* load_records(const SnapshotFile* file, uint32_t type, uint32_t limit,
+                                              const uint8_t** section_base, uint32_t* count) {
+    const SnapshotSection* section = find_section(file, type);
+    if (!section) {
+        return NULL;
+    }
+    size_t table_size = sizeof(SnapshotPageRecord) * (size_t)section->item_count;
+    const uint8_t* base = file->base + section->offset;
+    if (table_size > section->stored_size || crc32(base, table_size) != section->checksum) {
+        printf("快照 %s 的段 %u 校验失败\n", file->path, type);
+        return NULL;
+    }
 
-        // ƽϢ
-        new_proc->state = proc_info.state;
-        new_proc->priority = proc_info.priority;
-        new_proc->time_slice = proc_info.time_slice;
-        new_proc->wait_time = proc_info.wait_time;
+    const SnapshotPageRecord* records = (const SnapshotPageRecord*)base;
+    for (uint32_t i = 0; i < section->item_count; i++) {
+        bool zero = (records[i].flags & PAGE_ZERO) != 0;
+        if (records[i].count == 0 || records[i].index >= limit ||
+            records[i].count > limit - records[i].index ||
+            (zero ? records[i].stored_size != 0 :
+                    records[i].count != 1 || records[i].stored_size > PAGE_SIZE ||
+                    records[i].offset > section->stored_size ||
+                    records[i].stored_size > section->stored_size - records[i].offset)) {
+            printf("快照 %s 的段 %u 中第 %u 条记录损坏\n", file->path, type, i);
+            return NULL;
+        }
+    }
+    *section_base = base;
+    *count = section->item_count;
+    return records;
+}
 
-        // ȡָҳ
-        if (fread(new_proc->page_table, sizeof(PageTableEntry) * new_proc->page_table_size, 1, fp) != 1) {
-            printf("ȡҳʧ\n");
-            fclose(fp);
+// 解出一个页面并校验（零页游程中的每一页都解为全零）
+static bool decode_page(const uint8_t* section_base, const SnapshotPageRecord* record, void* page) {
+    if (record->flags & PAGE_ZERO) {
+        memset(page, 0, PAGE_SIZE);
+        return true;
+    }
+    const uint8_t* stored = section_base + record->offset;
+    if (record->flags & PAGE_COMPRESSED) {
+        if (lz_decompress(stored, record->stored_size, (uint8_t*)page, PAGE_SIZE) != PAGE_SIZE) {
             return false;
         }
+    } else if (record->stored_size == PAGE_SIZE) {
+        memcpy(page, stored, PAGE_SIZE);
+    } else {
+        return false;
+    }
+    return crc32(page, PAGE_SIZE) == record->checksum;
+}
+
+// 关闭不再有交换区块引用的快照文件
+static void release_unused_files(void) {
+    for (uint32_t i = 0; i < DUMP_CHAIN_MAX; i++) {
+        if (lazy_files[i].base && lazy_files[i].lazy_blocks == 0) {
+            close_snapshot(&lazy_files[i]);
+        }
     }
+}
 
-    // 5. ָڴ״̬
-    uint8_t* memory = get_physical_memory();
-    bool* frame_map = get_frame_map();
-    if (!memory || !frame_map ||
-        fread(memory, PAGE_SIZE, PHYSICAL_PAGES, fp) != PHYSICAL_PAGES ||
-        fread(frame_map, sizeof(bool), PHYSICAL_PAGES, fp) != PHYSICAL_PAGES) {
-        printf("ָڴ״̬ʧ\n");
-        fclose(fp);
+// 放弃所有按需读入的交换区块（系统重置或重新恢复时调用）
+static void release_lazy_swap(void) {
+    if (lazy_swap) {
+        memset(lazy_swap, 0, sizeof(PageSource) * SWAP_SIZE);
+    }
+    lazy_swap_count = 0;
+    for (uint32_t i = 0; i < DUMP_CHAIN_MAX; i++) {
+        lazy_files[i].lazy_blocks = 0;
+    }
+    release_unused_files();
+}
+
+bool dump_swap_is_lazy(uint32_t swap_index) {
+    return lazy_swap && swap_index < SWAP_SIZE && lazy_swap[swap_index].record != NULL;
+}
+
+// 从映射的快照文件中解出尚未读入的交换区块
+bool dump_lazy_swap_read(uint32_t swap_index, void* buffer) {
+    if (!dump_swap_is_lazy(swap_index)) {
+        return false;
+    }
+    if (!decode_page(lazy_swap[swap_index].section, lazy_swap[swap_index].record, buffer)) {
+        printf("快照 %s 中交换区块 %u 的数据校验失败\n",
+               lazy_files[lazy_swap[swap_index].file].path, swap_index);
         return false;
     }
+    return true;
+}
 
-    // 6. ָ״̬
-    SwapBlockInfo* swap_blocks = get_swap_blocks();
-    void* swap_area = get_swap_area();
-    if (!swap_blocks || !swap_area ||
-        fread(swap_blocks, sizeof(SwapBlockInfo), SWAP_SIZE, fp) != SWAP_SIZE ||
-        fread(swap_area, SWAP_BLOCK_SIZE, SWAP_SIZE, fp) != SWAP_SIZE) {
-        printf("ָ״̬ʧ\n");
-        fclose(fp);
+void dump_forget_lazy_swap(uint32_t swap_index) {
+    if (!dump_swap_is_lazy(swap_index)) {
+        return;
+    }
+    SnapshotFile* file = &lazy_files[lazy_swap[swap_index].file];
+    lazy_swap[swap_index].record = NULL;
+    lazy_swap_count--;
+    if (--file->lazy_blocks == 0) {
+        close_snapshot(file);
+    }
+}
+
+void dump_forget_checkpoint(void) {
+    dump_wait_stream();
+    checkpoint.valid = false;
+    release_lazy_swap();
+}
+
+// 打开快照链，files[0] 为完整快照，files[count-1] 为 filename
+static bool open_chain(const char* filename, SnapshotFile* files, uint32_t* count) {
+    char path[DUMP_PATH_MAX];
+    snprintf(path, sizeof(path), "%s", filename);
+
+    uint32_t length = 0;
+    while (length < DUMP_CHAIN_MAX) {
+        SnapshotFile* file = &files[length];
+        if (!open_snapshot(path, file)) {
+            break;
+        }
+        length++;
+        if (!check_snapshot(file)) {
+            break;
+        }
+
+        const SnapshotFileHeader* header = file_header(file);
+        if (header->snapshot_type == SNAPSHOT_FULL) {
+            // 反转为从完整快照开始的顺序
+            for (uint32_t i = 0; i < length / 2; i++) {
+                SnapshotFile tmp = files[i];
+                files[i] = files[length - 1 - i];
+                files[length - 1 - i] = tmp;
+            }
+            *count = length;
+            return true;
+        }
+        memcpy(path, header->parent, sizeof(path));
+        path[DUMP_PATH_MAX - 1] = '\0';
+    }
+    if (length == DUMP_CHAIN_MAX) {
+        printf("快照链超过 %d 个文件\n", DUMP_CHAIN_MAX);
+    }
+    for (uint32_t i = 0; i < length; i++) {
+        close_snapshot(&files[i]);
+    }
+    return false;
+}
+
+// 检查进程段的记录和页表大小，恢复前调用，不修改任何状态
+static bool check_process_records(const uint8_t* data, size_t size, uint32_t count) {
+    size_t pos = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        SnapshotProcess record;
+        if (size - pos < sizeof(record)) {
+            return false;
+        }
+        memcpy(&record, data + pos, sizeof(record));
+        pos += sizeof(record);
+
+        size_t table_size = sizeof(PageTableEntry) * (size_t)record.page_table_size;
+        if (record.page_table_size > MAX_PAGES_PER_PROCESS || size - pos < table_size) {
+            return false;
+        }
+        pos += table_size;
+    }
+    return count <= MAX_PROCESSES;
+}
+
+// 恢复进程：共享内存段和文件映射不在快照中，已驻留的页面转为私有（写时复制）
+static bool restore_processes(const uint8_t* data, size_t size, uint32_t count) {
+    size_t pos = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        SnapshotProcess record;
+        if (size - pos < sizeof(record)) {
+            return false;
+        }
+        memcpy(&record, data + pos, sizeof(record));
+        pos += sizeof(record);
+
+        size_t table_size = sizeof(PageTableEntry) * (size_t)record.page_table_size;
+        if (record.page_table_size > MAX_PAGES_PER_PROCESS || size - pos < table_size) {
+            return false;
+        }
+
+        PCB image;
+        record_to_process(&record, &image);
+        image.page_table = (PageTableEntry*)calloc(record.page_table_size ? record.page_table_size : 1,
+                                                   sizeof(PageTableEntry));
+        if (!image.page_table) {
+            return false;
+        }
+        memcpy(image.page_table, data + pos, table_size);
+        pos += table_size;
+
+        for (uint32_t page = 0; page < image.page_table_size; page++) {
+            PageTableEntry* pte = &image.page_table[page];
+            if (pte->flags.present && pte->frame_number >= PHYSICAL_PAGES) {
+                pte->flags.present = false;
+            }
+            if (pte->flags.swapped && pte->flags.swap_index >= SWAP_SIZE) {
+                pte->flags.swapped = false;
+            }
+            if (pte->flags.shm || pte->flags.file) {
+                pte->flags.shm = false;
+                pte->flags.file = false;
+                if (pte->flags.present) {
+                    pte->flags.cow = true;
+                } else {
+                    memset(pte, 0, sizeof(*pte));
+                    pte->frame_number = (uint32_t)-1;
+                }
+            }
+        }
+
+        if (!process_restore(&image)) {
+            free(image.page_table);
+            return false;
+        }
+    }
+    return true;
+}
+
+// 按页表项重新占用页框并建立反向映射
+static void restore_frame_mappings(uint32_t saved_zero_frame) {
+    for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
+        PCB* process = get_process_by_index(i);
+        if (!process || !process->page_table) {
+            continue;
+        }
+        for (uint32_t page = 0; page < process->page_table_size; page++) {
+            PageTableEntry* pte = &process->page_table[page];
+            if (!pte->flags.present) {
+                continue;
+            }
+            if (pte->frame_number == saved_zero_frame) {
+                pte->frame_number = memory_manager.zero_frame;
+            } else if (is_zero_frame(pte->frame_number)) {
+                // 保存时的零页框号被普通页面占用，不能在这里复用
+                pte->flags.present = false;
+                pte->frame_number = (uint32_t)-1;
+                continue;
+            }
+            if (!memory_manager.frames[pte->frame_number].is_allocated) {
+                claim_frame(pte->frame_number);
+            }
+            frame_get(pte->frame_number, process->pid, page);
+        }
+    }
+}
+
+// 按快照链顺序记下每一页的最新记录，并校验各文件中该数据段的记录表
+static bool resolve_sources(SnapshotFile* chain, uint32_t chain_length, uint32_t type,
+                            uint32_t limit, PageSource* sources) {
+    for (uint32_t f = 0; f < chain_length; f++) {
+        const uint8_t* base;
+        uint32_t count;
+        const SnapshotPageRecord* records = load_records(&chain[f], type, limit, &base, &count);
+        if (!records) {
+            return false;
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            for (uint32_t k = 0; k < records[i].count; k++) {
+                PageSource* source = &sources[records[i].index + k];
+                source->record = &records[i];
+                source->section = base;
+                source->file = f;
+            }
+        }
+    }
+    return true;
+}
+
+// 重新初始化各模块，得到没有进程的空系统
+static void reinit_system(void) {
+    scheduler_init();
+    vm_init();
+    memory_init();
+    shm_init();
+    ksm_init();
+    thp_init();
+    tlb_init();
+    compact_init();
+    profile_init();
+    pagecache_init();
+}
+
+/**
+ * @brief 恢复系统状态
+ *
+ * 映射快照链中的所有文件，进程和元数据取自链末端；每个页框取链中最新的页面记录。
+ * 拆除当前系统之前先校验全部段：进程记录、各文件的记录表，以及每个页框数据的校验和
+ * （页框数据解到暂存区，校验通过后才复制到物理内存）。任何一项失败时当前系统保持不变。
+ * 交换区块数据不复制：每个已使用的块记下它在链中最新的页面记录，
+ * 首次读取时才从映射的文件解压并校验，被改写或释放后不再引用文件。
+ *
+ * @param filename 快照文件（增量快照沿 parent 找到完整快照）
+ * @return true 恢复成功
+ */
+bool restore_system_state(const char* filename) {
+    static SnapshotFile chain[DUMP_CHAIN_MAX];
+    uint64_t start = get_current_time();
+    uint32_t chain_length = 0;
+    dump_wait_stream();
+    if (!dump_tables_ready() || !open_chain(filename, chain, &chain_length)) {
         return false;
     }
 
-    // ָ״̬¼
+    // 1. 读取链末端的系统状态、进程和交换区块信息
+    const SnapshotFile* tip = &chain[chain_length - 1];
+    const SnapshotSection *system_section = NULL, *process_section = NULL, *swap_section = NULL;
+    uint8_t* system_data = load_meta_section(tip, SECTION_SYSTEM, &system_section);
+    uint8_t* process_data = load_meta_section(tip, SECTION_PROCESSES, &process_section);
+    uint8_t* swap_table = load_meta_section(tip, SECTION_SWAP_TABLE, &swap_section);
+    PageSource* frame_sources = (PageSource*)calloc(PHYSICAL_PAGES, sizeof(PageSource));
+    PageSource* swap_sources = (PageSource*)calloc(SWAP_SIZE, sizeof(PageSource));
+    uint8_t* staged = NULL;
+    SnapshotSystem system;
+    bool ok = system_data && process_data && swap_table && frame_sources && swap_sources &&
+              system_section->raw_size == sizeof(SnapshotSystem) &&
+              swap_section->raw_size == sizeof(SwapBlockInfo) * SWAP_SIZE;
+    if (ok) {
+        memcpy(&system, system_data, sizeof(system));
+        ok = check_process_records(process_data, process_section->raw_size, system.process_count);
+        if (!ok) {
+            printf("快照 %s 的进程段损坏\n", tip->path);
+        }
+    }
+
+    // 2. 拆除当前系统之前校验全部数据段，页框数据解到暂存区
+    ok = ok && resolve_sources(chain, chain_length, SECTION_FRAME_DATA, PHYSICAL_PAGES, frame_sources) &&
+         resolve_sources(chain, chain_length, SECTION_SWAP_DATA, SWAP_SIZE, swap_sources);
+    uint32_t frames_restored = 0;
+    for (uint32_t i = 0; ok && i < PHYSICAL_PAGES; i++) {
+        frames_restored += frame_sources[i].record != NULL;
+    }
+    if (ok && frames_restored > 0) {
+        staged = (uint8_t*)malloc((size_t)frames_restored * PAGE_SIZE);
+        ok = staged != NULL;
+    }
+    for (uint32_t i = 0, n = 0; ok && i < PHYSICAL_PAGES; i++) {
+        PageSource* source = &frame_sources[i];
+        if (source->record && !decode_page(source->section, source->record, staged + (size_t)n++ * PAGE_SIZE)) {
+            printf("快照 %s 中页框 %u 的数据校验失败\n", chain[source->file].path, i);
+            ok = false;
+        }
+    }
+
+    // 共享内存段的块不恢复，其余已使用的块必须在链中有数据
+    SwapBlockInfo* saved_blocks = (SwapBlockInfo*)swap_table;
     uint32_t used_blocks = 0;
-    for (uint32_t i = 0; i < SWAP_SIZE; i++) {
-        if (swap_blocks[i].is_used) {
+    for (uint32_t i = 0; ok && i < SWAP_SIZE; i++) {
+        if (saved_blocks[i].is_used && saved_blocks[i].process_id == 0) {
+            memset(&saved_blocks[i], 0, sizeof(saved_blocks[i]));
+        }
+        if (!saved_blocks[i].is_used) {
+            swap_sources[i].record = NULL;
+        } else if (!swap_sources[i].record) {
+            printf("快照链中缺少交换区块 %u 的数据\n", i);
+            ok = false;
+        } else {
             used_blocks++;
         }
     }
+
+    free(system_data);
+    if (!ok) {
+        free(process_data);
+        free(swap_table);
+        free(frame_sources);
+        free(swap_sources);
+        free(staged);
+        for (uint32_t i = 0; i < chain_length; i++) {
+            close_snapshot(&chain[i]);
+        }
+        printf("恢复系统状态失败，当前系统状态未改变\n");
+        return false;
+    }
+
+    // 3. 关闭调度器和虚拟机，放弃上一次恢复留下的按需读入，重新初始化
+    release_lazy_swap();
+    scheduler_shutdown();
+    vm_shutdown();
+    reinit_system();
+
+    // 4. 恢复进程（只可能因内存不足失败，此时回到没有进程的空系统）
+    ok = restore_processes(process_data, process_section->raw_size, system.process_count);
+    free(process_data);
+    if (!ok) {
+        printf("恢复进程失败，系统已重置\n");
+        scheduler_shutdown();
+        vm_shutdown();
+        reinit_system();
+        free(swap_table);
+        free(frame_sources);
+        free(swap_sources);
+        free(staged);
+        for (uint32_t i = 0; i < chain_length; i++) {
+            close_snapshot(&chain[i]);
+        }
+        return false;
+    }
+
+    // 5. 页框数据从暂存区复制到物理内存，再按页表项重建映射
+    uint8_t* memory = get_physical_memory();
+    for (uint32_t i = 0, n = 0; i < PHYSICAL_PAGES; i++) {
+        if (frame_sources[i].record) {
+            memcpy(memory + (size_t)i * PAGE_SIZE, staged + (size_t)n++ * PAGE_SIZE, PAGE_SIZE);
+        }
+    }
+    free(staged);
+    free(frame_sources);
+    restore_frame_mappings(system.zero_frame);
+
+    // 6. 交换区块：每块引用链中最新的页面记录
+    SwapBlockInfo* swap_blocks = get_swap_blocks();
+    memcpy(swap_blocks, saved_blocks, sizeof(SwapBlockInfo) * SWAP_SIZE);
+    memcpy(lazy_swap, swap_sources, sizeof(PageSource) * SWAP_SIZE);
+    free(swap_table);
+    free(swap_sources);
+    for (uint32_t i = 0; i < SWAP_SIZE; i++) {
+        if (lazy_swap[i].record) {
+            chain[lazy_swap[i].file].lazy_blocks++;
+        }
+    }
+    lazy_swap_count = used_blocks;
+
+    // 仍被交换区块引用的文件保持映射，其余关闭
+    memcpy(lazy_files, chain, sizeof(SnapshotFile) * chain_length);
+    memset(chain, 0, sizeof(SnapshotFile) * chain_length);
+    uint32_t sequence = file_header(&lazy_files[chain_length - 1])->sequence;
+    release_unused_files();
+
     vm_manager.swap_free_blocks = SWAP_SIZE - used_blocks;
+    swapalloc_rebuild();
 
-    // 7. ָͳϢ
-    vm_manager.stats = header.memory_stats;
+    // 7. 恢复统计信息和调度器时钟
+    vm_manager.stats = system.memory_stats;
+    scheduler.next_pid = system.next_pid;
+    scheduler.total_runtime = system.total_runtime;
 
-    fclose(fp);
+    // 8. 恢复的状态成为新的检查点基线，后续增量快照接在这条链之后
+    checkpoint.valid = true;
+    snprintf(checkpoint.path, sizeof(checkpoint.path), "%s", filename);
+    checkpoint.sequence = sequence;
+    checkpoint.frame_seq = memory_manager.write_count;
+    checkpoint.swap_seq = vm_manager.swap_write_count;
+
+    last.restore_us = get_current_time() - start;
+    printf("已恢复 %u 个进程、%u 个页框，%u 个交换区块按需读入（快照链 %u 个文件，耗时 %llu 微秒）\n",
+           system.process_count, frames_restored, lazy_swap_count, chain_length,
+           (unsigned long long)last.restore_us);
     return true;
-} 
\ No newline at end of file
+}
+
+// 打印快照状态
+void print_dump_status(void) {
+    printf("\n=== 系统快照 ===\n");
+    printf("快照格式: %s 版本 %d\n", SNAPSHOT_MAGIC, SNAPSHOT_VERSION);
+    if (checkpoint.valid) {
+        printf("检查点: %s（快照链序号 %u）\n", checkpoint.path, checkpoint.sequence);
+    } else {
+        printf("检查点: 无（下一个快照为完整快照）\n");
+    }
+    printf("后台写入: %s\n", stream.active ? (stream.done ? "已完成，待收割" : "进行中") : "空闲");
+    if (auto_interval) {
+        printf("周期检查点: 每 %u 个时钟滴答，文件 %s.<序号>\n", auto_interval, auto_prefix);
+    } else {
+        printf("周期检查点: 关闭\n");
+    }
+    if (last.snapshots) {
+        printf("最近一次快照: %u 个页框，%u 个交换区块（%u 条页面记录），%zu 字节（未压缩 %zu 字节），捕获耗时 %llu 微秒\n",
+               last.frames_written, last.swap_written, last.records, last.bytes, last.raw_bytes,
+               (unsigned long long)last.capture_us);
+    }
+    if (last.restore_us) {
+        printf("最近一次恢复耗时: %llu 微秒\n", (unsigned long long)last.restore_us);
+    }
+    if (lazy_swap_count) {
+        printf("按需读入: %u 个交换区块仍在快照文件中\n", lazy_swap_count);
+        for (uint32_t i = 0; i < DUMP_CHAIN_MAX; i++) {
+            if (lazy_files[i].base) {
+                printf("  %s：%u 块（%s）\n", lazy_files[i].path, lazy_files[i].lazy_blocks,
+                       lazy_files[i].mapped ? "mmap" : "已读入内存");
+            }
+        }
+    }
+}
@@ -0,0 +1,290 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../include/ksm.h"
+#include "../include/memory.h"
+#include "../include/process.h"
+#include "../include/shm.h"
+#include "../include/pagecache.h"
+#include "../include/thp.h"
+
+// 哈希并行路数：各路互不依赖，内层循环可被编译器向量化
+#define KSM_HASH_LANES 4
+#define KSM_HASH_PRIME 0x9E3779B97F4A7C15ULL
+
+// 相同页合并扫描器
+static KsmManager ksm;
+
+// 每个页框最近一次扫描得到的哈希值
+static uint64_t* frame_hashes = NULL;
+static bool* frame_hashed = NULL;
+
+// 已扫描的页框按哈希值分桶（链地址法），查找内容相同的页框时只检查同一桶
+static uint32_t* hash_buckets = NULL;   // 桶中第一个页框，-1表示空桶
+static uint32_t* hash_next = NULL;      // 同一桶中的下一个页框（PHYSICAL_PAGES 项）
+static uint32_t hash_mask = 0;          // 桶数减1，桶数为不小于页框数的2的幂
+
+static uint32_t bucket_of(uint64_t hash) {
+    return (uint32_t)(hash ^ (hash >> 32)) & hash_mask;
+}
+
+// 记录页框的哈希值
+static void hash_insert(uint32_t frame, uint64_t hash) {
+    uint32_t bucket = bucket_of(hash);
+    frame_hashes[frame] = hash;
+    frame_hashed[frame] = true;
+    hash_next[frame] = hash_buckets[bucket];
+    hash_buckets[bucket] = frame;
+}
+
+// 删除页框的哈希记录
+static void hash_remove(uint32_t frame) {
+    if (!frame_hashed[frame]) {
+        return;
+    }
+    frame_hashed[frame] = false;
+    uint32_t* link = &hash_buckets[bucket_of(frame_hashes[frame])];
+    while (*link != (uint32_t)-1) {
+        if (*link == frame) {
+            *link = hash_next[frame];
+            return;
+        }
+        link = &hash_next[*link];
+    }
+}
+
+// 初始化相同页合并扫描器
+void ksm_init(void) {
+    memset(&ksm, 0, sizeof(KsmManager));
+    ksm.scan_interval = KSM_DEFAULT_SCAN_INTERVAL;
+    ksm.pages_to_scan = KSM_DEFAULT_PAGES_TO_SCAN;
+
+    if (!frame_hashes) {
+        uint32_t buckets = 1;
+        while (buckets < PHYSICAL_PAGES && buckets < (1u << 31)) {
+            buckets <<= 1;
+        }
+        hash_mask = buckets - 1;
+        frame_hashes = (uint64_t*)malloc(sizeof(uint64_t) * PHYSICAL_PAGES);
+        frame_hashed = (bool*)malloc(sizeof(bool) * PHYSICAL_PAGES);
+        hash_next = (uint32_t*)malloc(sizeof(uint32_t) * PHYSICAL_PAGES);
+        hash_buckets = (uint32_t*)malloc(sizeof(uint32_t) * buckets);
+        if (!frame_hashes || !frame_hashed || !hash_next || !hash_buckets) {
+            fprintf(stderr, "相同页合并初始化失败\n");
+            exit(1);
+        }
+    }
+    memset(frame_hashed, 0, sizeof(bool) * PHYSICAL_PAGES);
+    memset(hash_buckets, 0xff, sizeof(uint32_t) * ((size_t)hash_mask + 1));
+}
+
+void ksm_set_enabled(bool enabled) {
+    ksm.enabled = enabled;
+    ksm.ticks = 0;
+    printf("相同页合并后台扫描已%s\n", enabled ? "开启" : "关闭");
+}
+
+/**
+ * @brief 计算页面内容的64位哈希
+ *
+ * 页面按64位字分成四路交错累加，每路做乘法和移位混合，最后合并各路结果。
+ * 相同内容一定得到相同哈希，合并前仍需逐字节比较确认。
+ *
+ * @param page 页面数据（PAGE_SIZE 字节）
+ * @return uint64_t 哈希值
+ */
+uint64_t ksm_hash_page(const void* page) {
+    const uint64_t* words = (const uint64_t*)page;
+    uint64_t lanes[KSM_HASH_LANES] = {
+        0x243F6A8885A308D3ULL, 0x13198A2E03707344ULL,
+        0xA4093822299F31D0ULL, 0x082EFA98EC4E6C89ULL
+    };
+
+    for (uint32_t i = 0; i < PAGE_SIZE / sizeof(uint64_t); i += KSM_HASH_LANES) {
+        for (uint32_t lane = 0; lane < KSM_HASH_LANES; lane++) {
+            uint64_t value = lanes[lane] ^ words[i + lane];
+            lanes[lane] = (value ^ (value >> 29)) * KSM_HASH_PRIME;
+        }
+    }
+
+    uint64_t hash = 0;
+    for (uint32_t lane = 0; lane < KSM_HASH_LANES; lane++) {
+        hash = (hash ^ lanes[lane]) * KSM_HASH_PRIME;
+        hash ^= hash >> 32;
+    }
+    return hash;
+}
+
+// 页框是否可以参与合并：已分配、有进程映射、不在交换中、不属于大页、共享内存段或页缓存
+static bool frame_mergeable(uint32_t frame) {
+    FrameInfo* info = &memory_manager.frames[frame];
+    if (!info->is_allocated || info->is_swapping || info->process_id == 0 || thp_frame_is_huge(frame)) {
+        return false;
+    }
+    return !shm_find_frame(frame, NULL, NULL) && !pagecache_find_frame(frame, NULL);
+}
+
+/**
+ * @brief 把页框 duplicate 的所有映射改为只读映射到 keep，并释放 duplicate
+ *
+ * 合并后的页框对所有映射者设置写时复制，首次写入时由
+ * handle_cow_fault 复制出私有页面。
+ *
+ * @return true duplicate 已被回收
+ */
+static bool merge_frames(uint32_t keep, uint32_t duplicate) {
+    // 合并过程中会修改 duplicate 的反向映射链，先收集全部映射
+    FrameMapping* mappings;
+    uint32_t count;
+    if (!collect_frame_mappings(duplicate, &mappings, &count)) {
+        return false;
+    }
+    if (count == 0) {
+        free(mappings);
+        return false;
+    }
+
+    bool dirty = memory_manager.frames[duplicate].is_dirty;
+    for (uint32_t i = 0; i < count; i++) {
+        PCB* process = mappings[i].process;
+        uint32_t page = mappings[i].virtual_page;
+        if (!frame_get(keep, process->pid, page)) {
+            free(mappings);
+            return false;
+        }
+
+        process->page_table[page].frame_number = keep;
+        process->page_table[page].flags.cow = true;
+        release_frame(duplicate, process->pid, page);
+    }
+
+    // 保留的页框对所有映射者只读共享（零页框的映射本来就是只读的）
+    if (!is_zero_frame(keep)) {
+        FrameMapping mapping;
+        uint32_t cursor = frame_mappings_begin(keep);
+        while (frame_mappings_next(keep, &cursor, &mapping)) {
+            mapping.process->page_table[mapping.virtual_page].flags.cow = true;
+        }
+        if (dirty) {
+            memory_manager.frames[keep].is_dirty = true;
+        }
+    }
+
+    free(mappings);
+    hash_remove(duplicate);
+    return true;
+}
+
+/**
+ * @brief 扫描一批页框，把内容相同的页框合并为一个只读共享页框
+ *
+ * 从上次停止的位置继续，依次计算页框内容哈希，并与已扫描页框的哈希比较；
+ * 哈希相同时逐字节确认后再合并。
+ *
+ * @param pages_to_scan 本次扫描的页框数，0表示扫描全部页框
+ * @return uint32_t 本次合并回收的页框数
+ */
+uint32_t ksm_scan(uint32_t pages_to_scan) {
+    if (pages_to_scan == 0 || pages_to_scan > PHYSICAL_PAGES) {
+        pages_to_scan = PHYSICAL_PAGES;
+    }
+
+    uint8_t* memory = get_physical_memory();
+    uint32_t merged = 0;
+
+    for (uint32_t n = 0; n < pages_to_scan; n++) {
+        uint32_t frame = ksm.cursor;
+        ksm.cursor = (ksm.cursor + 1) % PHYSICAL_PAGES;
+        if (ksm.cursor == 0) {
+            ksm.full_scans++;
+        }
+
+        hash_remove(frame);
+        if (!frame_mergeable(frame)) {
+            continue;
+        }
+
+        const uint8_t* data = memory + (size_t)frame * PAGE_SIZE;
+        
+        // 全零页面直接合并到零页框
+        if (is_zero_page(data)) {
+            ksm.pages_scanned++;
+            if (merge_frames(memory_manager.zero_frame, frame)) {
+                merged++;
+                printf("相同页合并：页框 %u 内容全零，合并到零页框 %u\n", frame, memory_manager.zero_frame);
+            }
+            continue;
+        }
+        
+        uint64_t hash = ksm_hash_page(data);
+        ksm.pages_scanned++;
+
+        // 在哈希值同桶的已扫描页框中查找内容相同的页框
+        uint32_t next;
+        for (uint32_t other = hash_buckets[bucket_of(hash)]; other != (uint32_t)-1; other = next) {
+            next = hash_next[other];
+            if (frame_hashes[other] != hash) {
+                continue;
+            }
+            if (!frame_mergeable(other)) {
+                hash_remove(other);
+                continue;
+            }
+            if (memcmp(memory + (size_t)other * PAGE_SIZE, data, PAGE_SIZE) != 0) {
+                ksm.hash_collisions++;
+                continue;
+            }
+
+            // 保留引用较多的页框，减少需要改写的页表项
+            uint32_t keep = other, duplicate = frame;
+            if (memory_manager.frames[frame].ref_count > memory_manager.frames[other].ref_count) {
+                keep = frame;
+                duplicate = other;
+            }
+
+            if (merge_frames(keep, duplicate)) {
+                merged++;
+                printf("相同页合并：页框 %u 与页框 %u 内容相同，合并到页框 %u（引用数=%u）\n",
+                       duplicate, keep, keep, memory_manager.frames[keep].ref_count);
+            }
+            break;
+        }
+
+        // 页框未被合并掉时记录其哈希，供之后扫描的页框查找
+        if (frame_mergeable(frame) && !frame_hashed[frame]) {
+            hash_insert(frame, hash);
+        }
+    }
+
+    ksm.pages_merged += merged;
+    return merged;
+}
+
+// 时间片轮转时调用，按间隔进行后台扫描
+void ksm_tick(void) {
+    if (!ksm.enabled) {
+        return;
+    }
+
+    if (++ksm.ticks < ksm.scan_interval) {
+        return;
+    }
+    ksm.ticks = 0;
+
+    uint32_t merged = ksm_scan(ksm.pages_to_scan);
+    if (merged > 0) {
+        printf("相同页合并后台扫描回收 %u 个页框\n", merged);
+    }
+}
+
+// 打印相同页合并统计信息
+void print_ksm_stats(void) {
+    printf("\n=== 相同页合并统计信息 ===\n");
+    printf("后台扫描: %s（每 %u 个时间片扫描 %u 个页框）\n",
+           ksm.enabled ? "开启" : "关闭", ksm.scan_interval, ksm.pages_to_scan);
+    printf("完整扫描轮数: %u\n", ksm.full_scans);
+    printf("累计扫描页框数: %u\n", ksm.pages_scanned);
+    printf("累计合并回收页框数: %u\n", ksm.pages_merged);
+    printf("哈希冲突次数: %u\n", ksm.hash_collisions);
+    printf("当前共享页框数: %u\n", count_shared_frames());
+}
@@ -1,27 +1,67 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include "../include/config.h"
 #include "../include/memory.h"
 #include "../include/process.h"
 #include "../include/vm.h"
+#include "../include/shm.h"
+#include "../include/ksm.h"
+#include "../include/thp.h"
+#include "../include/tlb.h"
+#include "../include/compact.h"
+#include "../include/profile.h"
+#include "../include/metrics.h"
+#include "../include/trace.h"
 #include "../include/dump.h"
 #include "../include/storage.h"
+#include "../include/pagecache.h"
 #include "../include/ui.h"
+#include "../include/selftest.h"
 
-int main(void) {
-    // ģʽ
+int main(int argc, char* argv[]) {
+    // 测试模式（make test）：其余参数照常解析，跑完场景测试后退出
+    bool test_mode = argc > 1 && strcmp(argv[1], "--test") == 0;
+    if (test_mode) {
+        argv[1] = argv[0];
+        argc--;
+        argv++;
+    }
+
+    // 按命令行和配置文件确定内存几何参数，之后各模块按此分配表
+    if (!config_parse_args(argc, argv)) {
+        return 1;
+    }
+
+    // 正常运行模式
+    metrics_init();
     memory_init();
     vm_init();
+    shm_init();
+    ksm_init();
+    thp_init();
+    tlb_init();
+    compact_init();
+    profile_init();
     scheduler_init();
     storage_init();
+    pagecache_init();
     ui_init();
     
-    printf("ϵͳʼ\n");
-    ui_run();
+    printf("系统初始化完成\n");
+    int failed = 0;
+    if (test_mode) {
+        failed = run_scenario_tests();
+    } else {
+        ui_run();
+    }
     
     ui_shutdown();
+    dump_wait_stream();
+    pagecache_sync();
     storage_shutdown();
     vm_shutdown();
+    trace_shutdown();
     
-    return 0;
+    return failed ? 1 : 0;
 } 
\ No newline at end of file
@@ -5,50 +5,149 @@
 #include "../include/memory.h"
 #include "../include/process.h"
 #include "../include/vm.h"
+#include "../include/pagecache.h"
+#include "../include/numa.h"
+#include "../include/tier.h"
+#include "../include/thp.h"
+#include "../include/trace.h"
 
-// ڴ
-MemoryManager memory_manager;  // ڴ
-PhysicalMemory phys_mem;      // ڴṹ壬ڴҳλͼ
+// 内存管理器
+MemoryManager memory_manager;  // 内存管理器
+PhysicalMemory phys_mem;      // 物理内存结构体，包含物理内存和页框位图
 
-// ҳûҳϢṹ
+// 用于页面置换的页面信息结构体
 typedef struct {
     uint32_t page_num;
     uint32_t frame_num;
     uint64_t access_time;
 } PageInfo;
 
-// ҳ
+// 页表
 page_t *pages = NULL;
 uint32_t total_pages = 0;
 
-// ʼڴ
+// 反向映射项：记录映射某个页框的一个页表项
+typedef struct {
+    uint32_t process_id;    // 映射进程ID
+    uint32_t virtual_page;  // 虚拟页号
+    uint32_t next;          // 同一页框的下一个映射项，-1表示链表结束
+} RmapEntry;
+
+// 映射项池初始为每个页框两项，用完时加倍（共享页框的映射数不超过进程数）
+static RmapEntry* rmap_pool = NULL;
+static uint32_t rmap_capacity = 0;
+static uint32_t rmap_free_head;
+
+// 把 [start, end) 的映射项接入空闲链表
+static void rmap_link_free(uint32_t start, uint32_t end) {
+    for (uint32_t i = start; i < end; i++) {
+        rmap_pool[i].next = (i + 1 < end) ? i + 1 : rmap_free_head;
+    }
+    rmap_free_head = start;
+}
+
+// 初始化反向映射项空闲链表
+static void rmap_init(void) {
+    free(rmap_pool);
+    rmap_capacity = PHYSICAL_PAGES * 2;
+    rmap_pool = (RmapEntry*)malloc(sizeof(RmapEntry) * rmap_capacity);
+    if (!rmap_pool) {
+        fprintf(stderr, "反向映射初始化失败！\n");
+        exit(1);
+    }
+    rmap_free_head = (uint32_t)-1;
+    rmap_link_free(0, rmap_capacity);
+}
+
+// 为页框添加一个映射项
+static bool rmap_add(uint32_t frame_number, uint32_t pid, uint32_t virtual_page) {
+    if (rmap_free_head == (uint32_t)-1) {
+        uint64_t capacity = (uint64_t)rmap_capacity * 2;
+        RmapEntry* grown = capacity < UINT32_MAX ?
+            (RmapEntry*)realloc(rmap_pool, sizeof(RmapEntry) * capacity) : NULL;
+        if (!grown) {
+            printf("错误：反向映射项已用完\n");
+            return false;
+        }
+        rmap_pool = grown;
+        rmap_link_free(rmap_capacity, (uint32_t)capacity);
+        rmap_capacity = (uint32_t)capacity;
+    }
+    
+    uint32_t index = rmap_free_head;
+    rmap_free_head = rmap_pool[index].next;
+    
+    rmap_pool[index].process_id = pid;
+    rmap_pool[index].virtual_page = virtual_page;
+    rmap_pool[index].next = memory_manager.frames[frame_number].rmap_head;
+    memory_manager.frames[frame_number].rmap_head = index;
+    return true;
+}
+
+// 删除页框的一个映射项
+static void rmap_remove(uint32_t frame_number, uint32_t pid, uint32_t virtual_page) {
+    uint32_t* link = &memory_manager.frames[frame_number].rmap_head;
+    while (*link != (uint32_t)-1) {
+        uint32_t index = *link;
+        if (rmap_pool[index].process_id == pid && rmap_pool[index].virtual_page == virtual_page) {
+            *link = rmap_pool[index].next;
+            rmap_pool[index].next = rmap_free_head;
+            rmap_free_head = index;
+            return;
+        }
+        link = &rmap_pool[index].next;
+    }
+}
+
+// 清空页框的所有映射项
+void clear_frame_mappings(uint32_t frame_number) {
+    if (frame_number >= PHYSICAL_PAGES) return;
+    
+    uint32_t index = memory_manager.frames[frame_number].rmap_head;
+    while (index != (uint32_t)-1) {
+        uint32_t next = rmap_pool[index].next;
+        rmap_pool[index].next = rmap_free_head;
+        rmap_free_head = index;
+        index = next;
+    }
+    memory_manager.frames[frame_number].rmap_head = (uint32_t)-1;
+}
+
+// 初始化内存管理器
 void memory_init(void) {
-    // ʼڴṹ壬ʼгԱΪ0
+    // 重新初始化（恢复快照、系统重置）时先释放之前的物理内存和页框表
+    memory_shutdown();
+
+    // 初始化内存管理器结构体，初始化所有成员为0
     memset(&memory_manager, 0, sizeof(MemoryManager));
-    memory_manager.free_frames_count = PHYSICAL_PAGES;  // ʼʱҳΪҳ
-    memory_manager.strategy = FIRST_FIT;               // ĬʹFIFO
+    numa_init();
+    tier_init();
+    memory_manager.frames = (FrameInfo*)calloc(PHYSICAL_PAGES, sizeof(FrameInfo));
+    memory_manager.free_frames_count = PHYSICAL_PAGES;  // 初始化时物理页框数为物理页框数
+    memory_manager.strategy = FIRST_FIT;               // 默认使用FIFO分配策略
+    memory_manager.replacement_scope = REPLACE_GLOBAL; // 默认使用全局置换
 
-    // ʼڴ棬ڴռ䣬ʼΪ0
-    phys_mem.memory = (uint8_t*)calloc(PHYSICAL_PAGES * PAGE_SIZE, 1);  // ڴռ䣬ʼΪ0
-    phys_mem.frame_map = (bool*)calloc(PHYSICAL_PAGES, sizeof(bool));   // ҳλͼʼΪfalse
-    phys_mem.total_frames = PHYSICAL_PAGES;                            // ҳ
-    phys_mem.free_frames = PHYSICAL_PAGES;                             // ʼʱҳ
+    // 初始化物理内存，分配物理内存空间，初始化为0
+    phys_mem.memory = (uint8_t*)calloc((size_t)PHYSICAL_PAGES * PAGE_SIZE, 1);  // 分配物理内存空间，初始化为0
+    phys_mem.frame_map = (bool*)calloc(PHYSICAL_PAGES, sizeof(bool));   // 分配页框位图，初始化为false
+    phys_mem.total_frames = PHYSICAL_PAGES;                            // 物理页框数
+    phys_mem.free_frames = PHYSICAL_PAGES;                             // 初始化时物理页框数
 
-    // ڴʼǷɹ
-    if (!phys_mem.memory || !phys_mem.frame_map) {
-        fprintf(stderr, "ڴʼʧܣ\n");
-        exit(1);  // ڴʼʧܣ˳
+    // 检查内存初始化是否成功
+    if (!phys_mem.memory || !phys_mem.frame_map || !memory_manager.frames) {
+        fprintf(stderr, "内存初始化失败！\n");
+        exit(1);  // 内存初始化失败，退出程序
     }
 
-    // ʼҳ
-    total_pages = PHYSICAL_PAGES;  // ʵҳ
+    // 初始化页表
+    total_pages = PHYSICAL_PAGES;  // 实际页框数
     pages = (page_t*)calloc(total_pages, sizeof(page_t));
     if (!pages) {
-        fprintf(stderr, "ҳʼʧܣ\n");
+        fprintf(stderr, "页表初始化失败！\n");
         exit(1);
     }
     
-    // ʼÿҳ
+    // 初始化每个页框
     uint64_t current_time = get_current_time();
     for (uint32_t i = 0; i < total_pages; i++) {
         pages[i].frame_number = (uint32_t)-1;
@@ -57,32 +156,56 @@ void memory_init(void) {
         pages[i].is_dirty = false;
         pages[i].last_access = current_time;
         
-        // ͬʱʼڴеҳϢ
+        // 同时初始化内存管理器中的页框信息
         memory_manager.frames[i].last_access_time = current_time;
         memory_manager.frames[i].is_allocated = false;
         memory_manager.frames[i].is_dirty = false;
         memory_manager.frames[i].process_id = 0;
         memory_manager.frames[i].virtual_page_num = 0;
+        memory_manager.frames[i].ref_count = 0;
+        memory_manager.frames[i].rmap_head = (uint32_t)-1;
     }
+    
+    rmap_init();
+    
+    // 保留一个全零页框，供未写入过的页面只读共享
+    memory_manager.zero_frame = allocate_frame(0, 0);
 }
 
-// ҳ
+// 分配页框：按进程的NUMA分配策略依次尝试各节点，节点内首次适应
 uint32_t allocate_frame(uint32_t pid, uint32_t virtual_page) {
-    // ҿҳ
-    for (uint32_t i = 0; i < PHYSICAL_PAGES; i++) {
-        if (!memory_manager.frames[i].is_allocated) {
-            // ڴ״̬
+    uint32_t order[MAX_NUMA_NODES];
+    uint32_t node_count = numa_alloc_order(pid, virtual_page, order);
+    for (uint32_t n = 0; n < node_count; n++) {
+        uint32_t first, end;
+        numa_node_range(order[n], &first, &end);
+        for (uint32_t i = first; i < end; i++) {
+            if (memory_manager.frames[i].is_allocated) {
+                continue;
+            }
+            
+            // 更新内存管理器状态
             memory_manager.frames[i].is_allocated = true;
             memory_manager.frames[i].process_id = pid;
             memory_manager.frames[i].virtual_page_num = virtual_page;
             memory_manager.frames[i].last_access_time = get_current_time();
             memory_manager.frames[i].is_dirty = false;
+            memory_manager.frames[i].ref_count = 1;
             memory_manager.free_frames_count--;
             
-            // ڴӳ
+            // 记录首个映射（pid为0表示暂不映射到进程）
+            clear_frame_mappings(i);
+            if (pid != 0) {
+                rmap_add(i, pid, virtual_page);
+            }
+            
+            // 更新物理内存映射
             phys_mem.frame_map[i] = true;
             phys_mem.free_frames--;
             
+            numa_note_allocation(i, n > 0);
+            frame_update_charge(i);
+            frame_mark_written(i);
             return i;
         }
     }
@@ -90,32 +213,36 @@ uint32_t allocate_frame(uint32_t pid, uint32_t virtual_page) {
     return (uint32_t)-1;
 }
 
-// ͷҳ
+// 释放页框
 void free_frame(uint32_t frame_number) {
     if (frame_number >= PHYSICAL_PAGES) return;
     
-    // 1. ȼҳǷѾͷ
+    // 1. 先检查页框是否已经被释放
     if (!memory_manager.frames[frame_number].is_allocated) {
         return;
     }
     
-    // 2. ҳ״̬
+    // 2. 更新页框状态
     memory_manager.frames[frame_number].is_allocated = false;
     memory_manager.frames[frame_number].is_swapping = false;
     memory_manager.frames[frame_number].is_dirty = false;
     memory_manager.frames[frame_number].process_id = 0;
     memory_manager.frames[frame_number].virtual_page_num = 0;
     memory_manager.frames[frame_number].last_access_time = 0;
+    memory_manager.frames[frame_number].ref_count = 0;
+    clear_frame_mappings(frame_number);
+    frame_update_charge(frame_number);
+    thp_subpage_written(frame_number);
     
-    // 3. ڴӳ
+    // 3. 更新物理内存映射
     phys_mem.frame_map[frame_number] = false;
     
-    // 4. ¼
+    // 4. 更新计数器
     memory_manager.free_frames_count++;
     phys_mem.free_frames++;
 }
 
-// ҳǷѷ
+// 检查页框是否已分配
 bool is_frame_allocated(uint32_t frame_number) {
     if (frame_number >= PHYSICAL_PAGES) {
         return false;
@@ -123,37 +250,37 @@ bool is_frame_allocated(uint32_t frame_number) {
     return memory_manager.frames[frame_number].is_allocated;
 }
 
-// úͻȡ
+// 设置和获取分配策略
 void set_allocation_strategy(AllocationStrategy strategy) {
-    memory_manager.strategy = strategy;  // ڴ
+    memory_manager.strategy = strategy;  // 设置内存分配策略
 }
 
 AllocationStrategy get_allocation_strategy(void) {
     return memory_manager.strategy;
 }
 
-// ȡڴָ
+// 获取物理内存指针
 uint8_t* get_physical_memory(void) {
-    return phys_mem.memory;  // ڴָ
+    return phys_mem.memory;  // 返回物理内存指针
 }
 
-// ȡҳӳ
+// 获取页框映射
 bool* get_frame_map(void) {
-    return phys_mem.frame_map;  // ҳλͼָ
+    return phys_mem.frame_map;  // 返回页框位图指针
 }
 
 void update_free_frames_count(uint32_t free_count) {
-    phys_mem.free_frames = free_count;  // ڴеĿҳ
+    phys_mem.free_frames = free_count;  // 更新物理内存中的空闲页框数
 }
 
-// ӡڴ沼
+// 打印内存布局
 void print_memory_map(void) {
-    // ͳʹõҳڴƬ
+    // 统计已使用的页框和内存碎片
     uint32_t used_frames = 0;
     uint32_t fragments = 0;
     bool in_fragment = false;
     
-    // ʹҳƬ
+    // 计算已使用页框数和碎片数
     for (uint32_t i = 0; i < PHYSICAL_PAGES; i++) {
         if (memory_manager.frames[i].is_allocated) {
             used_frames++;
@@ -166,33 +293,34 @@ void print_memory_map(void) {
         }
     }
 
-    printf("\n=== ڴ沼 ===\n");
-    printf("ҳ%u\n\n", PHYSICAL_PAGES);
+    printf("\n=== 物理内存布局 ===\n");
+    printf("总页框数：%u\n\n", PHYSICAL_PAGES);
     
-    // ʾѷҳб
-    printf("ѷҳб\n");
+    // 显示已分配页框列表
+    printf("已分配页框列表：\n");
     for (uint32_t i = 0; i < PHYSICAL_PAGES; i++) {
         if (memory_manager.frames[i].is_allocated) {
-            printf("[%3u] PID=%-4u ҳ=0x%04x\n", 
+            printf("[%3u] PID=%-4u 虚拟页号=0x%04x\n", 
                    i, memory_manager.frames[i].process_id, memory_manager.frames[i].virtual_page_num);
         }
     }
     
-    printf("\nڴʹ飺\n");
-    printf("ڴ棺%u ֽ\n", PHYSICAL_PAGES * PAGE_SIZE);
-    printf("ڴ棺%u ֽ (%.1f%%)\n", 
-           used_frames * PAGE_SIZE,
-           (float)(used_frames * 100) / PHYSICAL_PAGES);
-    printf("Ƭ%u\n", fragments);
+    printf("\n内存使用详情：\n");
+    printf("总物理内存：%llu 字节\n", (unsigned long long)PHYSICAL_PAGES * PAGE_SIZE);
+    printf("已用内存：%llu 字节 (%.1f%%)\n", 
+           (unsigned long long)used_frames * PAGE_SIZE,
+           (float)used_frames * 100 / PHYSICAL_PAGES);
+    printf("碎片数：%u\n", fragments);
+    printf("共享页框：%u，私有页框：%u\n", count_shared_frames(), count_private_frames());
     
-    // ASCIIͼʾ
-    printf("\nڴʹͼʾ\n");
-    printf("ʾãʾУ\n");
+    // ASCII图形显示
+    printf("\n内存使用图示：\n");
+    printf("（■表示已用，□表示空闲）\n");
     for (uint32_t i = 0; i < PHYSICAL_PAGES; i++) {
         if (i % 32 == 0) {
             printf("\n%3u: ", i);
         }
-        printf("%s", memory_manager.frames[i].is_allocated ? "" : "");
+        printf("%s", memory_manager.frames[i].is_allocated ? "■" : "□");
         if ((i + 1) % 8 == 0) {
             printf(" ");
         }
@@ -200,27 +328,32 @@ void print_memory_map(void) {
     printf("\n");
 }
 
-// ȡҳ
+// 获取空闲页框数量
 uint32_t get_free_frames_count(void) {
     return memory_manager.free_frames_count;
 }
 
-// ڴƬ
+// DRAM 中的空闲页框数（不含慢速内存层）
+uint32_t get_free_dram_frames(void) {
+    return memory_manager.free_frames_count - tier_free_slow_frames();
+}
+
+// 计算内存碎片数量
 uint32_t count_memory_fragments(void) {
     uint32_t fragments = 0;
     bool in_fragment = false;
     
-    // ҳ
+    // 遍历所有页框
     for (uint32_t i = 0; i < PHYSICAL_PAGES; i++) {
         if (!memory_manager.frames[i].is_allocated) {
-            // ҵҳ
+            // 找到空闲页框
             if (!in_fragment) {
-                // µƬʼ
+                // 新的碎片开始
                 fragments++;
                 in_fragment = true;
             }
         } else {
-            // ҵѷҳ
+            // 找到已分配页框
             in_fragment = false;
         }
     }
@@ -229,20 +362,20 @@ uint32_t count_memory_fragments(void) {
 }
 
 /**
- * @brief ȡҳӦַ
+ * @brief 获取页框对应的物理地址
  * 
- * @param frame ҳ
- * @return void* ַҳЧ򷵻NULL
+ * @param frame 页框号
+ * @return void* 返回物理地址，如果页框无效则返回NULL
  */
 void* get_physical_address(uint32_t frame) {
     if (frame >= PHYSICAL_PAGES) {
         return NULL;
     }
-    // ַ = ַ + ҳ * ҳС
-    return (void*)(phys_mem.memory + (frame * PAGE_SIZE));
+    // 返回物理地址 = 基地址 + 页框号 * 页面大小
+    return (void*)(phys_mem.memory + ((size_t)frame * PAGE_SIZE));
 }
 
-// ڴ״̬һ
+// 检查内存管理器状态一致性
 void check_memory_state(void) {
     uint32_t allocated_count = 0;
     uint32_t mapped_count = 0;
@@ -255,35 +388,35 @@ void check_memory_state(void) {
             mapped_count++;
         }
         
-        // ״̬һ
+        // 检查状态一致性
         if (memory_manager.frames[i].is_allocated != phys_mem.frame_map[i]) {
-            printf("棺ҳ %u ״̬һ£=%d, ӳ=%d\n",
+            printf("警告：页框 %u 状态不一致，分配=%d, 映射=%d\n",
                    i, memory_manager.frames[i].is_allocated, phys_mem.frame_map[i]);
         }
     }
     
     if (allocated_count != mapped_count || 
         PHYSICAL_PAGES - allocated_count != memory_manager.free_frames_count) {
-        printf("棺ڴһ£ѷ=%u, ӳ=%u, м=%u\n",
+        printf("警告：内存管理不一致，已分配=%u, 已映射=%u, 空闲计数=%u\n",
                allocated_count, mapped_count, memory_manager.free_frames_count);
     }
 }
 
-// ҳʱ
+// 更新页面访问时间戳
 void update_page_access(page_t *page) {
     if (page) {
         page->last_access = get_current_time();
     }
 }
 
-// LRU㷨ѡҳ
+// LRU算法选择牺牲页框
 page_t* find_lru_victim(void) {
-    uint32_t victim_frame = select_victim_frame(); // ʹselect_victim_frameѡҳ
+    uint32_t victim_frame = select_victim_frame(); // 使用select_victim_frame选择牺牲页框
     if (victim_frame == (uint32_t)-1) {
         return NULL;
     }
     
-    // ҵӦҳ
+    // 找到对应的页框
     for (uint32_t i = 0; i < total_pages; i++) {
         if (pages[i].frame_number == victim_frame) {
             return &pages[i];
@@ -293,29 +426,29 @@ page_t* find_lru_victim(void) {
     return NULL;
 }
 
-// 滻ҳ
+// 替换页框
 int replace_page(page_t *victim, page_t *new_page) {
     if (!victim || !new_page) {
         return -1;
     }
     
-    // ȡ̿ƿ
+    // 获取进程控制块
     PCB* process = get_process_by_pid(memory_manager.frames[victim->frame_number].process_id);
     if (!process) {
         return -1;
     }
     
-    // ʹҳ
+    // 使用页框
     if (victim->is_dirty) {
-        // ʹpage_out
+        // 使用page_out
         if (!page_out(process, memory_manager.frames[victim->frame_number].virtual_page_num)) {
             return -1;
         }
     }
     
-    // ҳϢ
+    // 更新页框信息
     victim->frame_number = new_page->frame_number;
-    victim->last_access = get_current_time(); // ʹvm.hget_current_time
+    victim->last_access = get_current_time(); // 使用vm.h的get_current_time
     victim->is_valid = true;
     victim->is_dirty = false;
     
@@ -323,23 +456,27 @@ int replace_page(page_t *victim, page_t *new_page) {
 }
 
 void memory_shutdown(void) {
-    // ͷڴҳλͼ
+    // 释放物理内存、页框位图和页框信息
     free(phys_mem.memory);
     free(phys_mem.frame_map);
+    free(memory_manager.frames);
+    phys_mem.memory = NULL;
+    phys_mem.frame_map = NULL;
+    memory_manager.frames = NULL;
     
-    // ͷҳ
+    // 释放页表
     if (pages) {
         free(pages);
         pages = NULL;
     }
 }
 
-// ҳʱ
+// 更新页框访问时间
 void update_frame_access_time(uint32_t frame_number) {
     if (frame_number < PHYSICAL_PAGES && memory_manager.frames[frame_number].is_allocated) {
         uint64_t old_time = memory_manager.frames[frame_number].last_access_time;
         memory_manager.frames[frame_number].last_access_time = get_current_time();
-        printf("ҳ %u ķʱ䣺%llu -> %llu\n", 
+        printf("更新页框 %u 的访问时间：%llu -> %llu\n", 
                frame_number, 
                old_time,
                memory_manager.frames[frame_number].last_access_time);
@@ -347,31 +484,59 @@ void update_frame_access_time(uint32_t frame_number) {
 }
 
 uint32_t select_victim_frame(void) {
+    return select_victim_frame_for(NULL);
+}
+
+// 页框归属的进程，私有页框直接记录了所属进程，无需查找进程表
+static PCB* frame_owner(FrameInfo* info) {
+    if (info->charged && info->charged->pid == info->process_id &&
+        info->charged->state != PROCESS_TERMINATED) {
+        return info->charged;
+    }
+    return get_process_by_pid(info->process_id);
+}
+
+// 页框能否作为牺牲页框：进程映射的驻留页面，或未被映射的页缓存页框
+static bool is_victim_candidate(uint32_t frame, PCB* requester) {
+    FrameInfo* info = &memory_manager.frames[frame];
+    if (!info->is_allocated || info->is_swapping) {
+        return false;
+    }
+    
+    // 页缓存与匿名页面参与同一个LRU，未被映射时不属于任何进程
+    if (info->process_id == 0) {
+        return pagecache_find_frame(frame, NULL);
+    }
+    
+    // 获取该页框对应的进程和页表项
+    PCB* process = frame_owner(info);
+    if (!process || info->virtual_page_num >= process->page_table_size) {
+        return false;
+    }
+    
+    // 检查页表项的present标志
+    if (!process->page_table[info->virtual_page_num].flags.present) {
+        return false;  // 如果页面不在内存中，跳过
+    }
+    
+    // 检查置换范围和页框配额
+    return can_evict_from(process, requester);
+}
+
+// 按当前置换范围选择牺牲页框
+uint32_t select_victim_frame_for(PCB* requester) {
     uint32_t victim_frame = (uint32_t)-1;
-    uint64_t oldest_access = 0;  // ʼΪ0ǻҵķʱ
+    uint64_t oldest_access = 0;  // 初始化为0，这样我们会找到最早的访问时间
     uint64_t current_time = get_current_time();
     
-    printf("\n=== LRUҳû ===\n");
+    printf("\n=== LRU页面置换 ===\n");
     
-    // һɨ裺Ѱδ޸δʹõҳ
+    // 第一次扫描：寻找未修改且最久未使用的页面
     for (uint32_t i = 0; i < PHYSICAL_PAGES; i++) {
-        if (!memory_manager.frames[i].is_allocated || 
-            memory_manager.frames[i].process_id == 0) {
-            continue;
-        }
-        
-        // ȡҳӦĽ̺ҳ
-        PCB* process = get_process_by_pid(memory_manager.frames[i].process_id);
-        if (!process || memory_manager.frames[i].virtual_page_num >= process->page_table_size) {
+        if (!is_victim_candidate(i, requester)) {
             continue;
         }
         
-        // ҳpresent־
-        PageTableEntry* pte = &process->page_table[memory_manager.frames[i].virtual_page_num];
-        if (!pte->flags.present) {
-            continue;  // ҳ治ڴУ
-        }
-        
         uint64_t time_diff = current_time - memory_manager.frames[i].last_access_time;
         if (!memory_manager.frames[i].is_dirty && 
             (victim_frame == (uint32_t)-1 || time_diff > oldest_access)) {
@@ -380,28 +545,15 @@ uint32_t select_victim_frame(void) {
         }
     }
     
-    // ûҵδ޸ĵҳ棬Ѱδʹõҳ棨Ƿ޸ģ
+    // 如果没找到未修改的页面，寻找最久未使用的页面（不考虑是否修改）
     if (victim_frame == (uint32_t)-1) {
         oldest_access = 0;
         
         for (uint32_t i = 0; i < PHYSICAL_PAGES; i++) {
-            if (!memory_manager.frames[i].is_allocated || 
-                memory_manager.frames[i].process_id == 0) {
-                continue;
-            }
-            
-            // ȡҳӦĽ̺ҳ
-            PCB* process = get_process_by_pid(memory_manager.frames[i].process_id);
-            if (!process || memory_manager.frames[i].virtual_page_num >= process->page_table_size) {
+            if (!is_victim_candidate(i, requester)) {
                 continue;
             }
             
-            // ҳpresent־
-            PageTableEntry* pte = &process->page_table[memory_manager.frames[i].virtual_page_num];
-            if (!pte->flags.present) {
-                continue;  // ҳ治ڴУ
-            }
-            
             uint64_t time_diff = current_time - memory_manager.frames[i].last_access_time;
             if (victim_frame == (uint32_t)-1 || time_diff > oldest_access) {
                 oldest_access = time_diff;
@@ -410,79 +562,84 @@ uint32_t select_victim_frame(void) {
         }
     }
     
+    // 置换次数由调用者统计，换出次数由 swap_out_page 统计
     if (victim_frame != (uint32_t)-1) {
-        // ͳϢ
-        vm_manager.stats.page_replacements++;
-        if (memory_manager.frames[victim_frame].is_dirty) {
-            vm_manager.stats.disk_writes++;
-            vm_manager.stats.pages_swapped_out++;
-        }
-        
-        printf("\nѡҳ %u û (PID=%u, ҳ=0x%04x, =%s)\n", 
+        trace_instant(TRACE_VICTIM, requester ? requester->pid : trace_context(), victim_frame,
+                      memory_manager.frames[victim_frame].process_id,
+                      memory_manager.frames[victim_frame].virtual_page_num);
+        printf("\n选择页框 %u 进行置换 (PID=%u, 页号=0x%04x, 脏=%s)\n", 
                victim_frame,
                memory_manager.frames[victim_frame].process_id,
                memory_manager.frames[victim_frame].virtual_page_num,
-               memory_manager.frames[victim_frame].is_dirty ? "" : "");
+               memory_manager.frames[victim_frame].is_dirty ? "是" : "否");
     } else {
-        printf("޷ҵʵҳû\n");
+        printf("错误：无法找到合适的页框进行置换\n");
     }
     
     return victim_frame;
 }
 
-// ڴжȡ
+// 从物理内存中读取
 bool read_physical_memory(uint32_t frame, uint32_t offset, void* buffer, size_t size) {
-    // Ч
+    // 检查参数有效性
     if (frame >= PHYSICAL_PAGES || offset + size > PAGE_SIZE || !buffer) {
-        return false;  // ЧĲʧ
+        return false;  // 无效的参数，返回失败
     }
 
-    // ҳǷѱʹ
+    // 检查页框是否已被使用
     if (!phys_mem.frame_map[frame]) {
-        return false;  // ҳδʹãʧ
+        return false;  // 页框未被使用，返回失败
     }
 
-    // ·ʱ
+    // 更新访问时间
     memory_manager.frames[frame].last_access_time = get_current_time();
     
-    // Դִַڴ濽
-    uint8_t* src = phys_mem.memory + (frame * PAGE_SIZE) + offset;
+    // 计算源地址并执行内存拷贝
+    uint8_t* src = phys_mem.memory + ((size_t)frame * PAGE_SIZE) + offset;
     memcpy(buffer, src, size);
-    return true;  // ɹȡ true
+    return true;  // 成功读取，返回 true
 }
 
-// дڴ
+// 写入物理内存
 bool write_physical_memory(uint32_t frame, uint32_t offset, const void* data, size_t size) {
-    // Ч
+    // 检查参数有效性
     if (frame >= PHYSICAL_PAGES || offset + size > PAGE_SIZE || !data) {
-        return false;  // ЧĲʧ
+        return false;  // 无效的参数，返回失败
     }
 
-    // ҳǷѱʹ
+    // 检查页框是否已被使用
     if (!phys_mem.frame_map[frame]) {
-        return false;  // ҳδʹãʧ
+        return false;  // 页框未被使用，返回失败
     }
 
-    // ·ʱ־
+    // 更新访问时间和脏标志
     memory_manager.frames[frame].last_access_time = get_current_time();
     memory_manager.frames[frame].is_dirty = true;
+    frame_mark_written(frame);
     
-    // Ŀִַڴ濽
-    uint8_t* dst = phys_mem.memory + (frame * PAGE_SIZE) + offset;
+    // 计算目标地址并执行内存拷贝
+    uint8_t* dst = phys_mem.memory + ((size_t)frame * PAGE_SIZE) + offset;
     memcpy(dst, data, size);
-    return true;  // ɹд룬 true
+    return true;  // 成功写入，返回 true
 }
 
 uint32_t select_victim_page(PCB* process) {
-    // н̲ҿûҳ
+    bool evict_locally = process &&
+        (memory_manager.replacement_scope == REPLACE_LOCAL || process_at_frame_ceiling(process));
+    
+    // 遍历所有进程查找可以置换的页面
     for (uint32_t pid = 1; pid <= MAX_PROCESSES; pid++) {
         PCB* current_process = get_process_by_pid(pid);
-        if (!current_process || current_process == process || 
-            current_process->state == PROCESS_TERMINATED) {
+        if (!current_process || current_process->state == PROCESS_TERMINATED) {
+            continue;
+        }
+        
+        // 全局置换时跳过请求进程自身；局部置换或超出上限时只能置换自身
+        if (current_process == process ? !evict_locally : !can_evict_from(current_process, process)) {
             continue;
         }
         
-        // ̵ǰҳ
+        // 计算进程当前的物理页面数量
         uint32_t present_pages = 0;
         for (uint32_t i = 0; i < current_process->page_table_size; i++) {
             if (current_process->page_table[i].flags.present) {
@@ -492,13 +649,13 @@ uint32_t select_victim_page(PCB* process) {
         
         float physical_ratio = calculate_physical_pages_ratio(current_process);
         
-        // ҳ40%Կû
+        // 如果进程物理页面比例超过40%，则可以考虑置换
         if (physical_ratio > 40.0f) {
-            // ռҳ
+            // 收集并排序所有页面
             PageInfo* pages = (PageInfo*)malloc(present_pages * sizeof(PageInfo));
             uint32_t page_count = 0;
             
-            // ռڴеҳ
+            // 收集所有在内存中的页面
             for (uint32_t i = 0; i < current_process->page_table_size; i++) {
                 if (current_process->page_table[i].flags.present) {
                     pages[page_count].page_num = i;
@@ -508,7 +665,7 @@ uint32_t select_victim_page(PCB* process) {
                 }
             }
             
-            // ʱ򣨴Ӿɵ£
+            // 按访问时间排序（从旧到新）
             for (uint32_t i = 0; i < page_count - 1; i++) {
                 for (uint32_t j = 0; j < page_count - i - 1; j++) {
                     if (pages[j].access_time > pages[j + 1].access_time) {
@@ -519,21 +676,20 @@ uint32_t select_victim_page(PCB* process) {
                 }
             }
             
-            // ÿҳ棬ֱҵһԳɹû
+            // 尝试每个页面，直到找到一个可以成功置换的
             for (uint32_t i = 0; i < page_count; i++) {
-                // ǷΪҳ
-                if (current_process->page_table[pages[i].page_num].flags.dirty) {
-                    if (!swap_out_page(pages[i].frame_num)) {
-                        continue;  // һҳ
-                    }
+                // 零页框不可置换
+                if (is_zero_frame(pages[i].frame_num)) {
+                    continue;
                 }
                 
-                // ҳ
-                current_process->page_table[pages[i].page_num].flags.present = false;
-                current_process->page_table[pages[i].page_num].flags.swapped = true;
-                free_frame(pages[i].frame_num);
+                // 通过交换区换出，由 swap_out_page 更新所有映射的页表项
+                // （全零页面不写交换区，页表项恢复为按需清零）
+                if (!swap_out_page(pages[i].frame_num)) {
+                    continue;  // 尝试下一个页面
+                }
                 
-                printf("ӽ %uҳ=%.2f%%ûҳ %uͷҳ %u\n", 
+                printf("从进程 %u（物理页面比例=%.2f%%）置换出页面 %u，释放页框 %u\n", 
                        pid, physical_ratio, pages[i].page_num, pages[i].frame_num);
                 uint32_t result = pages[i].frame_num;
                 free(pages);
@@ -544,14 +700,18 @@ uint32_t select_victim_page(PCB* process) {
         }
     }
     
-    // ûҵʵҳ棬ռڴĽǿû
+    // 如果没有找到合适的页面，从占用内存最多的进程中强制置换
     PCB* max_pages_process = NULL;
     uint32_t max_present_pages = 0;
     
     for (uint32_t pid = 1; pid <= MAX_PROCESSES; pid++) {
         PCB* current_process = get_process_by_pid(pid);
-        if (!current_process || current_process == process || 
-            current_process->state == PROCESS_TERMINATED) {
+        if (!current_process || current_process->state == PROCESS_TERMINATED) {
+            continue;
+        }
+        
+        // 全局置换时跳过请求进程自身；局部置换或超出上限时只能置换自身
+        if (current_process == process ? !evict_locally : !can_evict_from(current_process, process)) {
             continue;
         }
         
@@ -569,7 +729,7 @@ uint32_t select_victim_page(PCB* process) {
     }
     
     if (max_pages_process && max_present_pages > 0) {
-        // ռҳ
+        // 收集并排序所有页面
         PageInfo* pages = (PageInfo*)malloc(max_present_pages * sizeof(PageInfo));
         uint32_t page_count = 0;
         
@@ -582,7 +742,7 @@ uint32_t select_victim_page(PCB* process) {
             }
         }
         
-        // ʱ
+        // 按访问时间排序
         for (uint32_t i = 0; i < page_count - 1; i++) {
             for (uint32_t j = 0; j < page_count - i - 1; j++) {
                 if (pages[j].access_time > pages[j + 1].access_time) {
@@ -593,19 +753,13 @@ uint32_t select_victim_page(PCB* process) {
             }
         }
         
-        // ÿҳ
+        // 尝试每个页面
         for (uint32_t i = 0; i < page_count; i++) {
-            if (max_pages_process->page_table[pages[i].page_num].flags.dirty) {
-                if (!swap_out_page(pages[i].frame_num)) {
-                    continue;
-                }
+            if (is_zero_frame(pages[i].frame_num) || !swap_out_page(pages[i].frame_num)) {
+                continue;
             }
             
-            max_pages_process->page_table[pages[i].page_num].flags.present = false;
-            max_pages_process->page_table[pages[i].page_num].flags.swapped = true;
-            free_frame(pages[i].frame_num);
-            
-            printf("ռڴĽ %uҳ=%uǿûҳ %uͷҳ %u\n", 
+            printf("从占用内存最多的进程 %u（页面数=%u）强制置换出页面 %u，释放页框 %u\n", 
                    max_pages_process->pid, max_present_pages, pages[i].page_num, pages[i].frame_num);
             uint32_t result = pages[i].frame_num;
             free(pages);
@@ -615,6 +769,443 @@ uint32_t select_victim_page(PCB* process) {
         free(pages);
     }
     
-    printf("δҵûҳ\n");
+    printf("未找到可置换的页面\n");
+    return (uint32_t)-1;
+}
+
+// 增加页框引用计数，并记录新的页表项映射
+bool frame_get(uint32_t frame_number, uint32_t pid, uint32_t virtual_page) {
+    if (frame_number >= PHYSICAL_PAGES || !memory_manager.frames[frame_number].is_allocated) {
+        return false;
+    }
+    
+    // 零页框只计数，不记录反向映射，也不归属任何进程
+    if (is_zero_frame(frame_number)) {
+        memory_manager.frames[frame_number].ref_count++;
+        return true;
+    }
+    
+    if (!rmap_add(frame_number, pid, virtual_page)) {
+        return false;
+    }
+    
+    FrameInfo* info = &memory_manager.frames[frame_number];
+    info->ref_count++;
+    
+    // 只被共享内存段持有的页框没有归属进程，由新的映射者接管
+    if (info->process_id == 0) {
+        info->process_id = pid;
+        info->virtual_page_num = virtual_page;
+    }
+    frame_update_charge(frame_number);
+    return true;
+}
+
+/**
+ * @brief 把指定的空闲页框标记为已分配
+ * 
+ * 恢复快照时页框号由页表项决定，不能由 allocate_frame 选择；
+ * 标记后引用计数为0，由随后的 frame_get 为每个映射增加。
+ * 
+ * @param frame_number 页框号
+ * @return true 页框原本空闲，已标记
+ */
+bool claim_frame(uint32_t frame_number) {
+    if (frame_number >= PHYSICAL_PAGES || memory_manager.frames[frame_number].is_allocated) {
+        return false;
+    }
+    
+    FrameInfo* info = &memory_manager.frames[frame_number];
+    info->is_allocated = true;
+    info->is_swapping = false;
+    info->is_dirty = false;
+    info->process_id = 0;
+    info->virtual_page_num = 0;
+    info->last_access_time = get_current_time();
+    info->ref_count = 0;
+    clear_frame_mappings(frame_number);
+    frame_update_charge(frame_number);
+    frame_mark_written(frame_number);
+    memory_manager.free_frames_count--;
+    
+    phys_mem.frame_map[frame_number] = true;
+    phys_mem.free_frames--;
+    return true;
+}
+
+/**
+ * @brief 分配一段物理上连续、起始页框号按 align 对齐的空闲页框
+ * 
+ * 按对齐边界逐段检查，遇到已分配页框时直接跳到它之后的下一个对齐边界。
+ * 分配到的页框与 claim_frame 一样暂无映射，由调用者为每个页框 frame_get。
+ * 
+ * @param count 页框数
+ * @param align 起始页框号的对齐（2的幂）
+ * @return uint32_t 起始页框号，没有足够的连续空闲页框时返回-1
+ */
+uint32_t allocate_contiguous_frames(uint32_t count, uint32_t align) {
+    if (count == 0 || get_free_dram_frames() < count) {
+        return (uint32_t)-1;
+    }
+    
+    uint32_t start = 0;
+    while ((uint64_t)start + count <= DRAM_PAGES) {
+        uint32_t i = 0;
+        while (i < count && !memory_manager.frames[start + i].is_allocated) {
+            i++;
+        }
+        if (i == count) {
+            for (i = 0; i < count; i++) {
+                claim_frame(start + i);
+            }
+            return start;
+        }
+        start = (start + i + align) & ~(align - 1);
+    }
     return (uint32_t)-1;
 }
+
+// 统计可以整段分配的连续对齐空闲区域数
+uint32_t count_free_contiguous(uint32_t count, uint32_t align) {
+    uint32_t regions = 0;
+    for (uint32_t start = 0; (uint64_t)start + count <= DRAM_PAGES; start += align) {
+        uint32_t i = 0;
+        while (i < count && !memory_manager.frames[start + i].is_allocated) {
+            i++;
+        }
+        if (i == count) {
+            regions++;
+        }
+    }
+    return regions;
+}
+
+/**
+ * @brief 释放一个页表项对页框的引用
+ * 
+ * 调用前需先清除该页表项的 present 标志。引用计数归零时释放页框，
+ * 否则把页框归属转给剩余的某个映射者，保证置换选择仍然有效；
+ * 没有剩余映射（只被共享内存段持有）时页框不归属任何进程。
+ * 
+ * @param frame_number 页框号
+ * @param pid 解除映射的进程ID（共享内存段释放持有时为0）
+ * @param virtual_page 解除映射的虚拟页号
+ */
+void release_frame(uint32_t frame_number, uint32_t pid, uint32_t virtual_page) {
+    if (frame_number >= PHYSICAL_PAGES || !memory_manager.frames[frame_number].is_allocated) {
+        return;
+    }
+    
+    FrameInfo* info = &memory_manager.frames[frame_number];
+    
+    // 零页框常驻内存，只减少引用计数
+    if (is_zero_frame(frame_number)) {
+        if (info->ref_count > 1) {
+            info->ref_count--;
+        }
+        return;
+    }
+    
+    if (pid != 0) {
+        rmap_remove(frame_number, pid, virtual_page);
+    }
+    
+    if (info->ref_count > 1) {
+        info->ref_count--;
+        
+        FrameMapping mapping;
+        if (get_frame_mappings(frame_number, &mapping, 1) > 0) {
+            info->process_id = mapping.process->pid;
+            info->virtual_page_num = mapping.virtual_page;
+        } else {
+            info->process_id = 0;
+            info->virtual_page_num = 0;
+        }
+        frame_update_charge(frame_number);
+        return;
+    }
+    
+    free_frame(frame_number);
+}
+
+/**
+ * @brief 记录页框内容即将改变
+ * 
+ * 新分配（或被置换后重新使用）的页框和被写入的页框取得新的写入序号，
+ * 增量快照只保存序号大于检查点基线的页框，无需逐页比较内容。
+ * 大页中未写入过的子页同时失去可回收标记。
+ * 
+ * @param frame_number 页框号
+ */
+void frame_mark_written(uint32_t frame_number) {
+    if (frame_number < PHYSICAL_PAGES) {
+        memory_manager.frames[frame_number].write_seq = ++memory_manager.write_count;
+        thp_subpage_written(frame_number);
+    }
+}
+
+/**
+ * @brief 重新计算页框计入哪个进程的私有页框数
+ * 
+ * 只有一个引用且归属某个进程的页框，置换该进程的页面后才会真正释放，
+ * 计入该进程；零页框、写时复制共享、共享内存段和页缓存持有的页框
+ * 不计入任何进程。页框配额按私有页框数计算，缺页时无需遍历页表。
+ * 
+ * @param frame_number 页框号
+ */
+void frame_update_charge(uint32_t frame_number) {
+    if (frame_number >= PHYSICAL_PAGES) return;
+    
+    FrameInfo* info = &memory_manager.frames[frame_number];
+    PCB* owner = NULL;
+    if (info->is_allocated && info->ref_count == 1 && info->process_id != 0 &&
+        !is_zero_frame(frame_number)) {
+        owner = frame_owner(info);
+    }
+    if (owner == info->charged) {
+        return;
+    }
+    
+    if (info->charged && info->charged->private_frames > 0) {
+        info->charged->private_frames--;
+    }
+    if (owner) {
+        owner->private_frames++;
+    }
+    info->charged = owner;
+}
+
+/**
+ * @brief 通过反向映射查找映射某个页框的所有页表项
+ * 
+ * 已失效的映射项（进程已终止或页表项已指向别处）会被跳过。
+ * 
+ * @param frame_number 页框号
+ * @param mappings 输出数组
+ * @param max_mappings 输出数组容量
+ * @return uint32_t 找到的映射数
+ */
+uint32_t get_frame_mappings(uint32_t frame_number, FrameMapping* mappings, uint32_t max_mappings) {
+    uint32_t count = 0;
+    uint32_t cursor = frame_mappings_begin(frame_number);
+    while (count < max_mappings && frame_mappings_next(frame_number, &cursor, &mappings[count])) {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief 开始遍历页框的反向映射链，不需要输出数组
+ * 
+ * 遍历期间不能增删该页框的映射；需要边遍历边修改映射时用 collect_frame_mappings。
+ * 
+ * @return uint32_t 遍历游标，传给 frame_mappings_next
+ */
+uint32_t frame_mappings_begin(uint32_t frame_number) {
+    if (frame_number >= PHYSICAL_PAGES || !memory_manager.frames[frame_number].is_allocated) {
+        return (uint32_t)-1;
+    }
+    return memory_manager.frames[frame_number].rmap_head;
+}
+
+/**
+ * @brief 取得下一个有效映射，跳过已失效的映射项
+ * 
+ * @return false 没有更多映射
+ */
+bool frame_mappings_next(uint32_t frame_number, uint32_t* cursor, FrameMapping* mapping) {
+    while (*cursor != (uint32_t)-1) {
+        RmapEntry* entry = &rmap_pool[*cursor];
+        *cursor = entry->next;
+        
+        PCB* process = get_process_by_pid(entry->process_id);
+        if (!process || process->state == PROCESS_TERMINATED ||
+            entry->virtual_page >= process->page_table_size) {
+            continue;
+        }
+        
+        PageTableEntry* pte = &process->page_table[entry->virtual_page];
+        if (pte->flags.present && pte->frame_number == frame_number) {
+            mapping->process = process;
+            mapping->virtual_page = entry->virtual_page;
+            return true;
+        }
+    }
+    return false;
+}
+
+// 页框的有效映射数
+uint32_t count_frame_mappings(uint32_t frame_number) {
+    FrameMapping mapping;
+    uint32_t count = 0;
+    uint32_t cursor = frame_mappings_begin(frame_number);
+    while (frame_mappings_next(frame_number, &cursor, &mapping)) {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief 收集映射某个页框的所有页表项
+ * 
+ * 输出数组按反向映射链的长度分配，不受固定容量限制，由调用者释放。
+ * 
+ * @param frame_number 页框号
+ * @param mappings 输出数组，没有映射时为 NULL
+ * @param count 找到的映射数
+ * @return false 内存不足
+ */
+bool collect_frame_mappings(uint32_t frame_number, FrameMapping** mappings, uint32_t* count) {
+    *mappings = NULL;
+    *count = 0;
+    if (frame_number >= PHYSICAL_PAGES || !memory_manager.frames[frame_number].is_allocated) {
+        return true;
+    }
+    
+    uint32_t length = 0;
+    for (uint32_t index = memory_manager.frames[frame_number].rmap_head;
+         index != (uint32_t)-1; index = rmap_pool[index].next) {
+        length++;
+    }
+    if (length == 0) {
+        return true;
+    }
+    
+    *mappings = (FrameMapping*)malloc(sizeof(FrameMapping) * length);
+    if (!*mappings) {
+        printf("错误：无法为页框 %u 的 %u 个映射分配内存\n", frame_number, length);
+        return false;
+    }
+    *count = get_frame_mappings(frame_number, *mappings, length);
+    return true;
+}
+
+// 统计被多个页表项共享的页框数
+uint32_t count_shared_frames(void) {
+    uint32_t shared = 0;
+    for (uint32_t i = 0; i < PHYSICAL_PAGES; i++) {
+        if (memory_manager.frames[i].is_allocated && memory_manager.frames[i].ref_count > 1) {
+            shared++;
+        }
+    }
+    return shared;
+}
+
+// 统计只被一个页表项映射的页框数
+uint32_t count_private_frames(void) {
+    uint32_t private_frames = 0;
+    for (uint32_t i = 0; i < PHYSICAL_PAGES; i++) {
+        if (memory_manager.frames[i].is_allocated && memory_manager.frames[i].ref_count <= 1) {
+            private_frames++;
+        }
+    }
+    return private_frames;
+}
+
+// 判断页面内容是否全零
+bool is_zero_page(const void* data) {
+    const uint64_t* words = (const uint64_t*)data;
+    for (uint32_t i = 0; i < PAGE_SIZE / sizeof(uint64_t); i++) {
+        if (words[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 判断是否为全局零页框
+bool is_zero_frame(uint32_t frame_number) {
+    return frame_number == memory_manager.zero_frame;
+}
+
+// 设置页面置换范围
+void set_replacement_scope(ReplacementScope scope) {
+    memory_manager.replacement_scope = scope;
+}
+
+// 获取页面置换范围
+ReplacementScope get_replacement_scope(void) {
+    return memory_manager.replacement_scope;
+}
+
+const char* get_replacement_scope_name(ReplacementScope scope) {
+    switch (scope) {
+        case REPLACE_GLOBAL: return "全局置换";
+        case REPLACE_LOCAL:  return "局部置换";
+        case REPLACE_QUOTA:  return "配额置换";
+        default:             return "未知";
+    }
+}
+
+// 统计进程当前驻留在物理内存中的页数
+uint32_t get_process_resident_pages(PCB* process) {
+    if (!process || !process->page_table) {
+        return 0;
+    }
+    
+    uint32_t resident = 0;
+    for (uint32_t i = 0; i < process->page_table_size; i++) {
+        if (process->page_table[i].flags.present) {
+            resident++;
+        }
+    }
+    return resident;
+}
+
+// 进程私有页框数：置换该进程的页面能够释放的页框数
+uint32_t get_process_private_frames(PCB* process) {
+    return process ? process->private_frames : 0;
+}
+
+// 页框下限（字节数向上取整为页框数）
+uint32_t get_process_min_frames(PCB* process) {
+    if (!process) return 0;
+    uint64_t frames = (process->app_config.min_memory + PAGE_SIZE - 1) / PAGE_SIZE;
+    return frames > UINT32_MAX ? UINT32_MAX : (uint32_t)frames;
+}
+
+// 页框上限（0 表示不限制）
+uint32_t get_process_max_frames(PCB* process) {
+    if (!process) return 0;
+    uint64_t frames = (process->app_config.max_memory + PAGE_SIZE - 1) / PAGE_SIZE;
+    return frames > UINT32_MAX ? UINT32_MAX : (uint32_t)frames;
+}
+
+// 配额模式下进程是否已达到页框上限
+bool process_at_frame_ceiling(PCB* process) {
+    if (!process || memory_manager.replacement_scope != REPLACE_QUOTA) {
+        return false;
+    }
+    
+    uint32_t max_frames = get_process_max_frames(process);
+    return max_frames > 0 && get_process_private_frames(process) >= max_frames;
+}
+
+// 判断 requester 缺页时能否置换 owner 的页面
+bool can_evict_from(PCB* owner, PCB* requester) {
+    if (!owner) {
+        return false;
+    }
+    
+    switch (memory_manager.replacement_scope) {
+        case REPLACE_LOCAL:
+            // 局部置换：只能置换缺页进程自己的页面
+            return !requester || owner == requester;
+            
+        case REPLACE_QUOTA:
+            // 超出上限的进程只能置换自身页面
+            if (process_at_frame_ceiling(requester)) {
+                return owner == requester;
+            }
+            // 其他进程的驻留页数不能低于其下限
+            if (owner != requester &&
+                get_process_private_frames(owner) <= get_process_min_frames(owner)) {
+                return false;
+            }
+            return true;
+            
+        case REPLACE_GLOBAL:
+        default:
+            return true;
+    }
+}
@@ -0,0 +1,598 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../include/metrics.h"
+#include "../include/vm.h"
+#include "../include/memory.h"
+#include "../include/process.h"
+#include "../include/zswap.h"
+
+// 指标的数据来源
+typedef enum {
+    SOURCE_COUNTER,     // 分片计数器
+    SOURCE_HISTOGRAM,   // 分片延迟直方图
+    SOURCE_READER,      // 导出时回调读取
+    SOURCE_PROCESS      // 导出时对每个进程回调读取，带 pid 标签
+} MetricSource;
+
+// 注册的一个指标
+typedef struct {
+    const char* name;
+    const char* help;
+    MetricType type;
+    MetricSource source;
+    uint32_t slot;                     // 分片计数器或直方图的下标
+    double (*read)(void);
+    double (*read_process)(PCB* process);
+} MetricDescriptor;
+
+// 每个线程的分片，按缓存行对齐避免线程之间伪共享
+//
+// 分片只由所属线程写入，更新是普通的读-加-写（用原子读写避免撕裂），
+// 不需要锁或原子加；线程数超过分片数时多出的线程共用最后一个分片，
+// 这个分片上的更新改用原子加。快照时按原子读把所有分片相加。
+typedef struct {
+    uint64_t counters[METRICS_MAX_COUNTERS];
+    uint64_t buckets[METRICS_MAX_HISTOGRAMS][METRICS_BUCKETS];
+    uint64_t sums[METRICS_MAX_HISTOGRAMS];    // 观测值之和（纳秒）
+} __attribute__((aligned(64))) MetricShard;
+
+// 指标注册表（只在主线程注册，工作线程只更新分片）
+typedef struct {
+    MetricDescriptor metrics[METRICS_MAX];
+    uint32_t count;
+    uint32_t counter_count;
+    uint32_t histogram_count;
+    bool initialized;
+} MetricsRegistry;
+
+static MetricsRegistry registry;
+static MetricShard shards[METRICS_MAX_SHARDS];
+static uint32_t shards_claimed = 0;
+static __thread MetricShard* local_shard = NULL;
+
+// 取得本线程的分片，首次更新时认领
+static MetricShard* claim_shard(void) {
+    if (!local_shard) {
+        uint32_t index = __atomic_fetch_add(&shards_claimed, 1, __ATOMIC_RELAXED);
+        local_shard = &shards[index < METRICS_MAX_SHARDS ? index : METRICS_MAX_SHARDS - 1];
+    }
+    return local_shard;
+}
+
+static inline void shard_add(MetricShard* shard, uint64_t* cell, uint64_t delta) {
+    if (shard == &shards[METRICS_MAX_SHARDS - 1]) {
+        __atomic_fetch_add(cell, delta, __ATOMIC_RELAXED);
+    } else {
+        __atomic_store_n(cell, __atomic_load_n(cell, __ATOMIC_RELAXED) + delta, __ATOMIC_RELAXED);
+    }
+}
+
+// 观测值所在的桶：桶 i 的上界为 2^(7+i) 纳秒，最后一个桶为 +Inf
+static uint32_t bucket_of(uint64_t nanoseconds) {
+    uint64_t bound = 1ULL << METRICS_FIRST_BUCKET_SHIFT;
+    uint32_t bucket = 0;
+    while (bucket < METRICS_BUCKETS - 1 && nanoseconds > bound) {
+        bound <<= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+// 桶的上界（秒）
+static double bucket_bound_seconds(uint32_t bucket) {
+    return (double)(1ULL << (METRICS_FIRST_BUCKET_SHIFT + bucket)) / 1e9;
+}
+
+static const char* get_metric_type_name(MetricType type) {
+    switch (type) {
+        case METRIC_COUNTER:   return "counter";
+        case METRIC_GAUGE:     return "gauge";
+        case METRIC_HISTOGRAM: return "histogram";
+        default:               return "untyped";
+    }
+}
+
+static MetricDescriptor* find_metric(const char* name) {
+    for (uint32_t i = 0; i < registry.count; i++) {
+        if (strcmp(registry.metrics[i].name, name) == 0) {
+            return &registry.metrics[i];
+        }
+    }
+    return NULL;
+}
+
+// 新增一个指标描述，注册表已满时返回 NULL
+static MetricDescriptor* add_metric(const char* name, const char* help, MetricType type,
+                                    MetricSource source) {
+    if (registry.count >= METRICS_MAX) {
+        printf("错误：指标注册表已满，无法注册 %s\n", name);
+        return NULL;
+    }
+
+    MetricDescriptor* metric = &registry.metrics[registry.count++];
+    memset(metric, 0, sizeof(MetricDescriptor));
+    metric->name = name;
+    metric->help = help;
+    metric->type = type;
+    metric->source = source;
+    return metric;
+}
+
+/**
+ * @brief 注册一个分片计数器
+ *
+ * @return uint32_t 计数器下标（传给 metrics_add），同名计数器已注册时返回已有的下标，失败返回-1
+ */
+uint32_t metrics_register_counter(const char* name, const char* help) {
+    MetricDescriptor* metric = find_metric(name);
+    if (metric) {
+        return metric->source == SOURCE_COUNTER ? metric->slot : (uint32_t)-1;
+    }
+    if (registry.counter_count >= METRICS_MAX_COUNTERS) {
+        printf("错误：分片计数器已用完，无法注册 %s\n", name);
+        return (uint32_t)-1;
+    }
+
+    metric = add_metric(name, help, METRIC_COUNTER, SOURCE_COUNTER);
+    if (!metric) {
+        return (uint32_t)-1;
+    }
+    metric->slot = registry.counter_count++;
+    return metric->slot;
+}
+
+/**
+ * @brief 注册一个分片延迟直方图
+ *
+ * @return uint32_t 直方图下标（传给 metrics_observe_ns），失败返回-1
+ */
+uint32_t metrics_register_histogram(const char* name, const char* help) {
+    MetricDescriptor* metric = find_metric(name);
+    if (metric) {
+        return metric->source == SOURCE_HISTOGRAM ? metric->slot : (uint32_t)-1;
+    }
+    if (registry.histogram_count >= METRICS_MAX_HISTOGRAMS) {
+        printf("错误：延迟直方图已用完，无法注册 %s\n", name);
+        return (uint32_t)-1;
+    }
+
+    metric = add_metric(name, help, METRIC_HISTOGRAM, SOURCE_HISTOGRAM);
+    if (!metric) {
+        return (uint32_t)-1;
+    }
+    metric->slot = registry.histogram_count++;
+    return metric->slot;
+}
+
+/**
+ * @brief 注册一个由回调读取的计数器或仪表
+ */
+uint32_t metrics_register_reader(const char* name, const char* help, MetricType type,
+                                 double (*read)(void)) {
+    if (!read || type == METRIC_HISTOGRAM || find_metric(name)) {
+        return (uint32_t)-1;
+    }
+    MetricDescriptor* metric = add_metric(name, help, type, SOURCE_READER);
+    if (!metric) {
+        return (uint32_t)-1;
+    }
+    metric->read = read;
+    return registry.count - 1;
+}
+
+/**
+ * @brief 注册一个按进程读取的计数器或仪表，每个进程导出一个带 pid 标签的样本
+ */
+uint32_t metrics_register_process(const char* name, const char* help, MetricType type,
+                                  double (*read)(PCB* process)) {
+    if (!read || type == METRIC_HISTOGRAM || find_metric(name)) {
+        return (uint32_t)-1;
+    }
+    MetricDescriptor* metric = add_metric(name, help, type, SOURCE_PROCESS);
+    if (!metric) {
+        return (uint32_t)-1;
+    }
+    metric->read_process = read;
+    return registry.count - 1;
+}
+
+// 已有统计结构的采集回调
+//
+// 这些计数在各模块中原地累加，注册表在导出时读取，不在热路径上重复计数。
+#define MEMORY_STAT_READER(field) \
+    static double read_##field(void) { return (double)vm_manager.stats.field; }
+
+MEMORY_STAT_READER(total_accesses)
+MEMORY_STAT_READER(page_faults)
+MEMORY_STAT_READER(major_faults)
+MEMORY_STAT_READER(page_replacements)
+MEMORY_STAT_READER(disk_reads)
+MEMORY_STAT_READER(disk_writes)
+MEMORY_STAT_READER(pages_swapped_in)
+MEMORY_STAT_READER(pages_swapped_out)
+MEMORY_STAT_READER(cow_faults)
+MEMORY_STAT_READER(cow_copies)
+MEMORY_STAT_READER(zero_page_maps)
+MEMORY_STAT_READER(zero_fill_faults)
+MEMORY_STAT_READER(zero_swap_skips)
+
+static double read_free_frames(void)       { return (double)memory_manager.free_frames_count; }
+static double read_free_dram_frames(void)  { return (double)get_free_dram_frames(); }
+static double read_physical_frames(void)   { return (double)PHYSICAL_PAGES; }
+static double read_shared_frames(void)     { return (double)count_shared_frames(); }
+static double read_free_swap_blocks(void)  { return (double)vm_manager.swap_free_blocks; }
+static double read_processes(void)         { return (double)get_total_processes(); }
+static double read_zswap_pages(void)       { return (double)get_zswap_stats().stored_pages; }
+
+static double read_process_faults(PCB* process)       { return (double)process->stats.page_faults; }
+static double read_process_replacements(PCB* process) { return (double)process->stats.page_replacements; }
+static double read_process_swapped_in(PCB* process)   { return (double)process->stats.pages_swapped_in; }
+static double read_process_swapped_out(PCB* process)  { return (double)process->stats.pages_swapped_out; }
+static double read_process_accesses(PCB* process)     { return (double)process->stats.mem_stats.total_accesses; }
+static double read_process_io_wait(PCB* process)      { return (double)process->stats.io_wait_ticks; }
+static double read_process_resident(PCB* process)     { return (double)get_process_resident_pages(process); }
+
+/**
+ * @brief 注册内置指标，重复调用时不做任何事
+ *
+ * 内置的分片计数器和直方图最先注册，下标与 MetricCounter、MetricHistogram 枚举值一致。
+ * 帮助文本用 ASCII，导出的文本和 JSON 不依赖源文件编码。
+ */
+void metrics_init(void) {
+    if (registry.initialized) {
+        return;
+    }
+    memset(&registry, 0, sizeof(registry));
+    registry.initialized = true;
+
+    metrics_register_counter("vmsim_lru_hits_total", "Accesses that found the page resident");
+    metrics_register_counter("vmsim_lru_misses_total", "Accesses that found the page not resident");
+
+    metrics_register_histogram("vmsim_fault_service_seconds", "Page fault service time");
+    metrics_register_histogram("vmsim_eviction_seconds", "Time to evict one frame");
+    metrics_register_histogram("vmsim_swap_read_seconds", "Time to read one swap block");
+    metrics_register_histogram("vmsim_swap_write_seconds", "Time to write one swap block");
+
+    metrics_register_reader("vmsim_accesses_total", "Memory accesses", METRIC_COUNTER, read_total_accesses);
+    metrics_register_reader("vmsim_page_faults_total", "Page faults", METRIC_COUNTER, read_page_faults);
+    metrics_register_reader("vmsim_major_faults_total", "Page faults that read from swap",
+                            METRIC_COUNTER, read_major_faults);
+    metrics_register_reader("vmsim_page_replacements_total", "Page replacements",
+                            METRIC_COUNTER, read_page_replacements);
+    metrics_register_reader("vmsim_disk_reads_total", "Swap reads", METRIC_COUNTER, read_disk_reads);
+    metrics_register_reader("vmsim_disk_writes_total", "Swap writes", METRIC_COUNTER, read_disk_writes);
+    metrics_register_reader("vmsim_pages_swapped_in_total", "Pages swapped in",
+                            METRIC_COUNTER, read_pages_swapped_in);
+    metrics_register_reader("vmsim_pages_swapped_out_total", "Pages swapped out",
+                            METRIC_COUNTER, read_pages_swapped_out);
+    metrics_register_reader("vmsim_cow_faults_total", "Copy-on-write faults", METRIC_COUNTER, read_cow_faults);
+    metrics_register_reader("vmsim_cow_copies_total", "Copy-on-write page copies",
+                            METRIC_COUNTER, read_cow_copies);
+    metrics_register_reader("vmsim_zero_page_maps_total", "Reads mapped to the zero frame",
+                            METRIC_COUNTER, read_zero_page_maps);
+    metrics_register_reader("vmsim_zero_fill_faults_total", "First writes served by a zeroed frame",
+                            METRIC_COUNTER, read_zero_fill_faults);
+    metrics_register_reader("vmsim_zero_swap_skips_total", "Zero pages evicted without a swap write",
+                            METRIC_COUNTER, read_zero_swap_skips);
+
+    metrics_register_reader("vmsim_free_frames", "Free physical frames", METRIC_GAUGE, read_free_frames);
+    metrics_register_reader("vmsim_free_dram_frames", "Free DRAM frames", METRIC_GAUGE, read_free_dram_frames);
+    metrics_register_reader("vmsim_physical_frames", "Physical frames", METRIC_GAUGE, read_physical_frames);
+    metrics_register_reader("vmsim_shared_frames", "Frames mapped by more than one page",
+                            METRIC_GAUGE, read_shared_frames);
+    metrics_register_reader("vmsim_free_swap_blocks", "Free swap blocks", METRIC_GAUGE, read_free_swap_blocks);
+    metrics_register_reader("vmsim_processes", "Live processes", METRIC_GAUGE, read_processes);
+    metrics_register_reader("vmsim_zswap_pages", "Pages held in the compressed swap pool",
+                            METRIC_GAUGE, read_zswap_pages);
+
+    metrics_register_process("vmsim_process_page_faults_total", "Page faults per process",
+                             METRIC_COUNTER, read_process_faults);
+    metrics_register_process("vmsim_process_page_replacements_total", "Page replacements per process",
+                             METRIC_COUNTER, read_process_replacements);
+    metrics_register_process("vmsim_process_pages_swapped_in_total", "Pages swapped in per process",
+                             METRIC_COUNTER, read_process_swapped_in);
+    metrics_register_process("vmsim_process_pages_swapped_out_total", "Pages swapped out per process",
+                             METRIC_COUNTER, read_process_swapped_out);
+    metrics_register_process("vmsim_process_accesses_total", "Memory accesses per process",
+                             METRIC_COUNTER, read_process_accesses);
+    metrics_register_process("vmsim_process_io_wait_ticks_total", "Ticks blocked on swap-in per process",
+                             METRIC_COUNTER, read_process_io_wait);
+    metrics_register_process("vmsim_process_resident_pages", "Resident pages per process",
+                             METRIC_GAUGE, read_process_resident);
+}
+
+/**
+ * @brief 清零所有分片（恢复快照或重置系统时随内存统计一起清零）
+ */
+void metrics_reset(void) {
+    for (uint32_t s = 0; s < METRICS_MAX_SHARDS; s++) {
+        MetricShard* shard = &shards[s];
+        for (uint32_t i = 0; i < METRICS_MAX_COUNTERS; i++) {
+            __atomic_store_n(&shard->counters[i], 0, __ATOMIC_RELAXED);
+        }
+        for (uint32_t h = 0; h < METRICS_MAX_HISTOGRAMS; h++) {
+            for (uint32_t b = 0; b < METRICS_BUCKETS; b++) {
+                __atomic_store_n(&shard->buckets[h][b], 0, __ATOMIC_RELAXED);
+            }
+            __atomic_store_n(&shard->sums[h], 0, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+void metrics_add(uint32_t counter, uint64_t delta) {
+    if (counter >= METRICS_MAX_COUNTERS) {
+        return;
+    }
+    MetricShard* shard = claim_shard();
+    shard_add(shard, &shard->counters[counter], delta);
+}
+
+void metrics_observe_ns(uint32_t histogram, uint64_t nanoseconds) {
+    if (histogram >= METRICS_MAX_HISTOGRAMS) {
+        return;
+    }
+    MetricShard* shard = claim_shard();
+    shard_add(shard, &shard->buckets[histogram][bucket_of(nanoseconds)], 1);
+    shard_add(shard, &shard->sums[histogram], nanoseconds);
+}
+
+/**
+ * @brief 单调时钟（纳秒），用于延迟直方图
+ */
+uint64_t metrics_now_ns(void) {
+#ifdef _WIN32
+    return get_current_time() * 1000;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+uint64_t metrics_counter_value(uint32_t counter) {
+    if (counter >= METRICS_MAX_COUNTERS) {
+        return 0;
+    }
+    uint64_t total = 0;
+    for (uint32_t s = 0; s < METRICS_MAX_SHARDS; s++) {
+        total += __atomic_load_n(&shards[s].counters[counter], __ATOMIC_RELAXED);
+    }
+    return total;
+}
+
+/**
+ * @brief 读取所有指标的快照
+ *
+ * 分片按原子读相加，与并发的更新之间不加锁：各指标各自一致，
+ * 不同指标之间可能相差快照期间发生的几次更新。
+ */
+void metrics_snapshot(MetricsSnapshot* snapshot) {
+    memset(snapshot, 0, sizeof(MetricsSnapshot));
+    snapshot->timestamp_ms = (uint64_t)time(NULL) * 1000;
+
+    for (uint32_t i = 0; i < registry.count; i++) {
+        const MetricDescriptor* metric = &registry.metrics[i];
+        MetricValue* value = &snapshot->values[snapshot->count++];
+        value->name = metric->name;
+        value->help = metric->help;
+        value->type = metric->type;
+
+        switch (metric->source) {
+            case SOURCE_COUNTER:
+                value->value = (double)metrics_counter_value(metric->slot);
+                break;
+
+            case SOURCE_HISTOGRAM: {
+                uint64_t sum_ns = 0;
+                for (uint32_t s = 0; s < METRICS_MAX_SHARDS; s++) {
+                    for (uint32_t b = 0; b < METRICS_BUCKETS; b++) {
+                        value->buckets[b] += __atomic_load_n(&shards[s].buckets[metric->slot][b],
+                                                             __ATOMIC_RELAXED);
+                    }
+                    sum_ns += __atomic_load_n(&shards[s].sums[metric->slot], __ATOMIC_RELAXED);
+                }
+                for (uint32_t b = 0; b < METRICS_BUCKETS; b++) {
+                    value->count += value->buckets[b];
+                }
+                value->sum = (double)sum_ns / 1e9;
+                break;
+            }
+
+            case SOURCE_READER:
+                value->value = metric->read();
+                break;
+
+            case SOURCE_PROCESS:
+                value->samples = (MetricSample*)calloc(MAX_PROCESSES, sizeof(MetricSample));
+                if (!value->samples) {
+                    break;
+                }
+                for (uint32_t p = 0; p < MAX_PROCESSES; p++) {
+                    PCB* process = get_process_by_index(p);
+                    if (!process) {
+                        continue;
+                    }
+                    MetricSample* sample = &value->samples[value->sample_count++];
+                    sample->pid = process->pid;
+                    sample->value = metric->read_process(process);
+                }
+                break;
+        }
+    }
+}
+
+void metrics_snapshot_free(MetricsSnapshot* snapshot) {
+    for (uint32_t i = 0; i < snapshot->count; i++) {
+        free(snapshot->values[i].samples);
+        snapshot->values[i].samples = NULL;
+        snapshot->values[i].sample_count = 0;
+    }
+}
+
+/**
+ * @brief 按 Prometheus 文本格式写出快照
+ *
+ * 直方图按 Prometheus 约定以秒为单位，桶为累计计数。
+ */
+void metrics_write_prometheus(FILE* out, const MetricsSnapshot* snapshot) {
+    for (uint32_t i = 0; i < snapshot->count; i++) {
+        const MetricValue* value = &snapshot->values[i];
+        fprintf(out, "# HELP %s %s\n", value->name, value->help);
+        fprintf(out, "# TYPE %s %s\n", value->name, get_metric_type_name(value->type));
+
+        if (value->type == METRIC_HISTOGRAM) {
+            uint64_t cumulative = 0;
+            for (uint32_t b = 0; b < METRICS_BUCKETS - 1; b++) {
+                cumulative += value->buckets[b];
+                fprintf(out, "%s_bucket{le=\"%.10g\"} %llu\n", value->name,
+                        bucket_bound_seconds(b), (unsigned long long)cumulative);
+            }
+            fprintf(out, "%s_bucket{le=\"+Inf\"} %llu\n", value->name, (unsigned long long)value->count);
+            fprintf(out, "%s_sum %.9g\n", value->name, value->sum);
+            fprintf(out, "%s_count %llu\n", value->name, (unsigned long long)value->count);
+        } else if (value->samples) {
+            for (uint32_t s = 0; s < value->sample_count; s++) {
+                fprintf(out, "%s{pid=\"%u\"} %.15g\n", value->name,
+                        value->samples[s].pid, value->samples[s].value);
+            }
+        } else {
+            fprintf(out, "%s %.15g\n", value->name, value->value);
+        }
+    }
+}
+
+/**
+ * @brief 按 JSON 写出快照，直方图的桶与 Prometheus 格式一样是累计计数
+ */
+void metrics_write_json(FILE* out, const MetricsSnapshot* snapshot) {
+    fprintf(out, "{\n  \"timestamp_ms\": %llu,\n  \"metrics\": [", (unsigned long long)snapshot->timestamp_ms);
+    for (uint32_t i = 0; i < snapshot->count; i++) {
+        const MetricValue* value = &snapshot->values[i];
+        fprintf(out, "%s\n    {\"name\": \"%s\", \"help\": \"%s\", \"type\": \"%s\"",
+                i > 0 ? "," : "", value->name, value->help, get_metric_type_name(value->type));
+
+        if (value->type == METRIC_HISTOGRAM) {
+            fprintf(out, ", \"count\": %llu, \"sum\": %.9g, \"buckets\": [",
+                    (unsigned long long)value->count, value->sum);
+            uint64_t cumulative = 0;
+            for (uint32_t b = 0; b < METRICS_BUCKETS - 1; b++) {
+                cumulative += value->buckets[b];
+                fprintf(out, "%s{\"le\": %.10g, \"count\": %llu}", b > 0 ? ", " : "",
+                        bucket_bound_seconds(b), (unsigned long long)cumulative);
+            }
+            fprintf(out, ", {\"le\": \"+Inf\", \"count\": %llu}]}", (unsigned long long)value->count);
+        } else if (value->samples) {
+            fprintf(out, ", \"samples\": [");
+            for (uint32_t s = 0; s < value->sample_count; s++) {
+                fprintf(out, "%s{\"pid\": %u, \"value\": %.15g}", s > 0 ? ", " : "",
+                        value->samples[s].pid, value->samples[s].value);
+            }
+            fprintf(out, "]}");
+        } else {
+            fprintf(out, ", \"value\": %.15g}", value->value);
+        }
+    }
+    fprintf(out, "\n  ]\n}\n");
+}
+
+/**
+ * @brief 把当前指标快照导出到文件
+ */
+bool metrics_export(const char* path, MetricsFormat format) {
+    FILE* out = fopen(path, "w");
+    if (!out) {
+        printf("错误：无法打开文件 %s\n", path);
+        return false;
+    }
+
+    MetricsSnapshot* snapshot = (MetricsSnapshot*)malloc(sizeof(MetricsSnapshot));
+    if (!snapshot) {
+        fclose(out);
+        return false;
+    }
+    metrics_snapshot(snapshot);
+    if (format == METRICS_FORMAT_JSON) {
+        metrics_write_json(out, snapshot);
+    } else {
+        metrics_write_prometheus(out, snapshot);
+    }
+    uint32_t count = snapshot->count;
+    metrics_snapshot_free(snapshot);
+    free(snapshot);
+
+    bool ok = !ferror(out);
+    if (fclose(out) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        printf("错误：写入文件 %s 失败\n", path);
+        return false;
+    }
+    printf("已导出 %u 个指标到 %s（%s）\n", count, path,
+           format == METRICS_FORMAT_JSON ? "JSON" : "Prometheus 文本格式");
+    return true;
+}
+
+// 直方图的分位数估计：返回所在桶的上界（微秒），落在 +Inf 桶时返回 -1
+static double histogram_quantile_us(const MetricValue* value, double quantile) {
+    uint64_t target = (uint64_t)(quantile * (double)value->count);
+    if (target == 0) {
+        target = 1;
+    }
+    uint64_t cumulative = 0;
+    for (uint32_t b = 0; b < METRICS_BUCKETS - 1; b++) {
+        cumulative += value->buckets[b];
+        if (cumulative >= target) {
+            return bucket_bound_seconds(b) * 1e6;
+        }
+    }
+    return -1;
+}
+
+static void format_quantile(char* buffer, size_t size, double us) {
+    if (us < 0) {
+        snprintf(buffer, size, ">%.0f us", bucket_bound_seconds(METRICS_BUCKETS - 2) * 1e6);
+    } else {
+        snprintf(buffer, size, "<=%.1f us", us);
+    }
+}
+
+/**
+ * @brief 打印所有指标的当前值
+ */
+void print_metrics_summary(void) {
+    MetricsSnapshot* snapshot = (MetricsSnapshot*)malloc(sizeof(MetricsSnapshot));
+    if (!snapshot) {
+        return;
+    }
+    metrics_snapshot(snapshot);
+
+    printf("\n=== 指标（%u 个，已使用 %u 个线程分片） ===\n", snapshot->count,
+           __atomic_load_n(&shards_claimed, __ATOMIC_RELAXED) < METRICS_MAX_SHARDS ?
+           __atomic_load_n(&shards_claimed, __ATOMIC_RELAXED) : METRICS_MAX_SHARDS);
+    for (uint32_t i = 0; i < snapshot->count; i++) {
+        const MetricValue* value = &snapshot->values[i];
+        if (value->type == METRIC_HISTOGRAM) {
+            if (value->count == 0) {
+                printf("%-40s 无观测\n", value->name);
+                continue;
+            }
+            char p50[32], p99[32];
+            format_quantile(p50, sizeof(p50), histogram_quantile_us(value, 0.5));
+            format_quantile(p99, sizeof(p99), histogram_quantile_us(value, 0.99));
+            printf("%-40s 次数=%llu 平均=%.1f us p50%s p99%s\n", value->name,
+                   (unsigned long long)value->count, value->sum * 1e6 / (double)value->count, p50, p99);
+        } else if (value->samples) {
+            for (uint32_t s = 0; s < value->sample_count; s++) {
+                printf("%s{pid=%u} = %.15g\n", value->name, value->samples[s].pid, value->samples[s].value);
+            }
+        } else {
+            printf("%-40s %.15g\n", value->name, value->value);
+        }
+    }
+
+    metrics_snapshot_free(snapshot);
+    free(snapshot);
+}
@@ -0,0 +1,328 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../include/numa.h"
+#include "../include/memory.h"
+#include "../include/process.h"
+#include "../include/compact.h"
+
+// NUMA管理器
+static NumaManager numa;
+
+// 每个页框最近被哪个远端节点连续访问，以及连续访问次数
+static uint8_t* hot_node = NULL;
+static uint16_t* hot_count = NULL;
+
+/**
+ * @brief 按配置建立NUMA拓扑
+ *
+ * DRAM 页框按节点数等分为连续的区段，最后一个节点包含除不尽的余数。
+ * 慢速内存层的页框不属于任何节点。
+ * 只有一个节点时分配顺序与原来的首次适应完全相同。
+ */
+void numa_init(void) {
+    memset(&numa, 0, sizeof(NumaManager));
+    numa.node_count = system_config.numa_nodes;
+    numa.distance = system_config.numa_distance;
+    numa.hot_threshold = NUMA_DEFAULT_HOT_THRESHOLD;
+    numa.migrate_budget = NUMA_DEFAULT_MIGRATE_BUDGET;
+
+    uint32_t per_node = DRAM_PAGES / numa.node_count;
+    for (uint32_t i = 0; i < numa.node_count; i++) {
+        numa.nodes[i].first_frame = i * per_node;
+        numa.nodes[i].frame_count = (i == numa.node_count - 1) ? DRAM_PAGES - i * per_node : per_node;
+    }
+
+    if (!hot_node) {
+        hot_node = (uint8_t*)malloc(sizeof(uint8_t) * PHYSICAL_PAGES);
+        hot_count = (uint16_t*)malloc(sizeof(uint16_t) * PHYSICAL_PAGES);
+        if (!hot_node || !hot_count) {
+            fprintf(stderr, "NUMA初始化失败\n");
+            exit(1);
+        }
+    }
+    memset(hot_node, 0, sizeof(uint8_t) * PHYSICAL_PAGES);
+    memset(hot_count, 0, sizeof(uint16_t) * PHYSICAL_PAGES);
+}
+
+uint32_t numa_node_count(void) {
+    return numa.node_count;
+}
+
+uint32_t numa_node_of(uint32_t frame) {
+    uint32_t node = frame / (DRAM_PAGES / numa.node_count);
+    return node < numa.node_count ? node : numa.node_count - 1;
+}
+
+// 节点的页框范围 [first, end)
+void numa_node_range(uint32_t node, uint32_t* first, uint32_t* end) {
+    *first = numa.nodes[node].first_frame;
+    *end = numa.nodes[node].first_frame + numa.nodes[node].frame_count;
+}
+
+/**
+ * @brief 按进程的分配策略给出尝试分配的节点顺序
+ *
+ * local 从进程所在节点开始，preferred 从首选节点开始，interleave 从虚拟页号对应的节点开始；
+ * 首选节点没有空闲页框时依次尝试其他节点。不属于进程的页框（零页框、页缓存）从节点0开始。
+ *
+ * @param pid 进程ID，0表示不属于进程
+ * @param virtual_page 虚拟页号
+ * @param order 输出的节点顺序（MAX_NUMA_NODES 项）
+ * @return uint32_t 节点数
+ */
+uint32_t numa_alloc_order(uint32_t pid, uint32_t virtual_page, uint32_t* order) {
+    uint32_t start = 0;
+    PCB* process = pid ? get_process_by_pid(pid) : NULL;
+    if (process) {
+        switch (process->numa.policy) {
+            case NUMA_POLICY_INTERLEAVE:
+                start = virtual_page % numa.node_count;
+                break;
+            case NUMA_POLICY_PREFERRED:
+                start = process->numa.preferred_node;
+                break;
+            default:
+                start = process->numa.home_node;
+                break;
+        }
+        if (start >= numa.node_count) {
+            start = 0;
+        }
+    }
+
+    for (uint32_t i = 0; i < numa.node_count; i++) {
+        order[i] = (start + i) % numa.node_count;
+    }
+    return numa.node_count;
+}
+
+// 记录一次页框分配，重置页框的热度
+void numa_note_allocation(uint32_t frame, bool fallback) {
+    uint32_t node = numa_node_of(frame);
+    numa.nodes[node].allocations++;
+    if (fallback) {
+        numa.nodes[node].fallbacks++;
+    }
+    hot_count[frame] = 0;
+}
+
+uint32_t numa_free_frames(uint32_t node) {
+    uint32_t first, end, free_count = 0;
+    numa_node_range(node, &first, &end);
+    for (uint32_t i = first; i < end; i++) {
+        if (!memory_manager.frames[i].is_allocated) {
+            free_count++;
+        }
+    }
+    return free_count;
+}
+
+// 新进程放到空闲页框最多的节点，空闲页框相同时轮流选择
+void numa_assign_home(PCB* process) {
+    uint32_t best = 0, best_free = 0;
+    for (uint32_t i = 0; i < numa.node_count; i++) {
+        uint32_t node = (numa.next_home + i) % numa.node_count;
+        uint32_t free_count = numa_free_frames(node);
+        if (i == 0 || free_count > best_free) {
+            best = node;
+            best_free = free_count;
+        }
+    }
+    numa.next_home = (best + 1) % numa.node_count;
+
+    memset(&process->numa, 0, sizeof(NumaPlacement));
+    process->numa.home_node = best;
+    process->numa.policy = NUMA_POLICY_LOCAL;
+    process->numa.preferred_node = best;
+}
+
+// 把进程迁到另一个节点上运行（之后它原来的页面成为远端访问，由自动平衡迁移）
+bool numa_set_home(uint32_t pid, uint32_t node) {
+    PCB* process = get_process_by_pid(pid);
+    if (!process || node >= numa.node_count) {
+        printf("无效的进程 %u 或节点 %u\n", pid, node);
+        return false;
+    }
+    process->numa.home_node = node;
+    printf("进程 %u 迁到节点 %u 运行\n", pid, node);
+    return true;
+}
+
+bool numa_set_policy(uint32_t pid, NumaPolicy policy, uint32_t node) {
+    PCB* process = get_process_by_pid(pid);
+    if (!process || (policy == NUMA_POLICY_PREFERRED && node >= numa.node_count)) {
+        printf("无效的进程 %u 或节点 %u\n", pid, node);
+        return false;
+    }
+    process->numa.policy = policy;
+    if (policy == NUMA_POLICY_PREFERRED) {
+        process->numa.preferred_node = node;
+    }
+    printf("进程 %u 的内存分配策略设置为 %s\n", pid, numa_policy_name(policy));
+    return true;
+}
+
+const char* numa_policy_name(uint32_t policy) {
+    switch (policy) {
+        case NUMA_POLICY_INTERLEAVE: return "interleave";
+        case NUMA_POLICY_PREFERRED: return "preferred";
+        default: return "local";
+    }
+}
+
+/**
+ * @brief 记录一次内存访问的节点和代价
+ *
+ * 进程所在节点访问本节点页框的距离为 NUMA_LOCAL_DISTANCE，访问其他节点为配置的距离。
+ * 同一个远端节点连续访问的页框累计热度，供自动平衡迁移。
+ * 慢速内存层的页框不属于任何节点，其访问由分层内存统计。
+ */
+void numa_record_access(PCB* process, uint32_t frame) {
+    if (!process || frame >= DRAM_PAGES) {
+        return;
+    }
+
+    uint32_t cpu = process->numa.home_node < numa.node_count ? process->numa.home_node : 0;
+    uint32_t node = numa_node_of(frame);
+    numa.accesses[cpu][node]++;
+    if (cpu == node) {
+        process->numa.local_accesses++;
+        numa.access_cost += NUMA_LOCAL_DISTANCE;
+        hot_count[frame] = 0;
+        return;
+    }
+
+    process->numa.remote_accesses++;
+    numa.access_cost += numa.distance;
+    if (hot_node[frame] == cpu) {
+        if (hot_count[frame] < UINT16_MAX) {
+            hot_count[frame]++;
+        }
+    } else {
+        hot_node[frame] = (uint8_t)cpu;
+        hot_count[frame] = 1;
+    }
+}
+
+void numa_set_balancing(bool enabled) {
+    numa.balancing = enabled;
+    printf("自动NUMA平衡已%s\n", enabled ? "开启" : "关闭");
+}
+
+void numa_set_distance(uint32_t distance) {
+    if (distance < NUMA_LOCAL_DISTANCE || distance > MAX_NUMA_DISTANCE) {
+        printf("跨节点访问距离必须在 %u 到 %u 之间\n", NUMA_LOCAL_DISTANCE, MAX_NUMA_DISTANCE);
+        return;
+    }
+    numa.distance = distance;
+    printf("跨节点访问距离设置为 %u（本节点 %u）\n", distance, NUMA_LOCAL_DISTANCE);
+}
+
+// 节点内第一个空闲页框
+static uint32_t free_frame_on(uint32_t node) {
+    uint32_t first, end;
+    numa_node_range(node, &first, &end);
+    for (uint32_t i = first; i < end; i++) {
+        if (!memory_manager.frames[i].is_allocated) {
+            return i;
+        }
+    }
+    return (uint32_t)-1;
+}
+
+/**
+ * @brief 把热页迁移到访问它的节点
+ *
+ * 被同一个远端节点连续访问达到阈值的页框迁移到该节点的空闲页框，
+ * 迁移经反向映射更新所有页表项。检查过的页框热度清零。
+ *
+ * @param budget 最多迁移的页框数，0表示不限制
+ * @return uint32_t 迁移的页框数
+ */
+uint32_t numa_balance(uint32_t budget) {
+    uint32_t migrated = 0;
+    for (uint32_t frame = 0; frame < DRAM_PAGES && (budget == 0 || migrated < budget); frame++) {
+        if (hot_count[frame] < numa.hot_threshold) {
+            continue;
+        }
+        hot_count[frame] = 0;
+
+        uint32_t target = hot_node[frame];
+        if (target == numa_node_of(frame)) {
+            continue;
+        }
+        uint32_t dst = free_frame_on(target);
+        if (dst == (uint32_t)-1 || !compact_migrate_frame(frame, dst)) {
+            numa.migrate_failed++;
+            continue;
+        }
+        hot_count[dst] = 0;
+        migrated++;
+        numa.migrated++;
+    }
+    return migrated;
+}
+
+// 时间片轮转时调用，自动平衡开启时迁移热页
+void numa_tick(void) {
+    if (!numa.balancing || numa.node_count < 2) {
+        return;
+    }
+
+    uint32_t migrated = numa_balance(numa.migrate_budget);
+    if (migrated > 0) {
+        printf("自动NUMA平衡迁移 %u 个热页\n", migrated);
+    }
+}
+
+// 打印NUMA拓扑、访问统计和进程放置
+void print_numa_stats(void) {
+    printf("\n=== NUMA 统计信息 ===\n");
+    printf("节点数: %u，跨节点访问距离: %u（本节点 %u）\n", numa.node_count, numa.distance, NUMA_LOCAL_DISTANCE);
+    printf("自动平衡: %s（热页阈值 %u 次，每个时间片最多迁移 %u 个页框）\n",
+           numa.balancing ? "开启" : "关闭", numa.hot_threshold, numa.migrate_budget);
+
+    printf("\n节点  页框范围          空闲页框  分配次数  回退分配\n");
+    for (uint32_t i = 0; i < numa.node_count; i++) {
+        uint32_t first, end;
+        numa_node_range(i, &first, &end);
+        printf("%4u  %7u-%-8u  %8u  %8u  %8u\n", i, first, end - 1,
+               numa_free_frames(i), numa.nodes[i].allocations, numa.nodes[i].fallbacks);
+    }
+
+    uint64_t local = 0, total = 0;
+    printf("\n访问次数（行：进程所在节点，列：页框所在节点）\n    ");
+    for (uint32_t j = 0; j < numa.node_count; j++) {
+        printf("%10s%u", "N", j);
+    }
+    printf("\n");
+    for (uint32_t i = 0; i < numa.node_count; i++) {
+        printf("N%-3u", i);
+        for (uint32_t j = 0; j < numa.node_count; j++) {
+            printf("%11llu", (unsigned long long)numa.accesses[i][j]);
+            total += numa.accesses[i][j];
+            if (i == j) {
+                local += numa.accesses[i][j];
+            }
+        }
+        printf("\n");
+    }
+    printf("本节点访问: %llu (%.1f%%)，跨节点访问: %llu\n", (unsigned long long)local,
+           total ? (double)local * 100.0 / total : 0.0, (unsigned long long)(total - local));
+    double average = total ? (double)numa.access_cost / total : NUMA_LOCAL_DISTANCE;
+    printf("平均访问距离: %.2f（相对本节点访问延迟 %.2f 倍）\n", average, average / NUMA_LOCAL_DISTANCE);
+    printf("平衡迁移页框: %u，失败: %u\n", numa.migrated, numa.migrate_failed);
+
+    printf("\n进程放置:\n");
+    printf("PID   节点  策略        本节点访问  跨节点访问\n");
+    for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
+        PCB* process = get_process_by_index(i);
+        if (!process) {
+            continue;
+        }
+        printf("%-5u %4u  %-10s  %10u  %10u\n", process->pid, process->numa.home_node,
+               numa_policy_name(process->numa.policy),
+               process->numa.local_accesses, process->numa.remote_accesses);
+    }
+}
@@ -0,0 +1,602 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../include/pagecache.h"
+#include "../include/memory.h"
+#include "../include/vm.h"
+#include "../include/storage.h"
+
+// 存储块与页框的双向索引，-1表示不在页缓存中（存储块大小与页大小相同）
+static uint32_t* block_frames = NULL;
+static uint32_t* frame_blocks = NULL;
+
+// 文件映射记录表
+static FileMapping mappings[MAX_FILE_MAPPINGS];
+static PageCacheStats stats;
+
+// 初始化页缓存
+void pagecache_init(void) {
+    if (!block_frames) {
+        block_frames = (uint32_t*)malloc(sizeof(uint32_t) * MAX_BLOCKS);
+        frame_blocks = (uint32_t*)malloc(sizeof(uint32_t) * PHYSICAL_PAGES);
+        if (!block_frames || !frame_blocks) {
+            fprintf(stderr, "页缓存初始化失败\n");
+            exit(1);
+        }
+    }
+    memset(block_frames, 0xFF, sizeof(uint32_t) * MAX_BLOCKS);
+    memset(frame_blocks, 0xFF, sizeof(uint32_t) * PHYSICAL_PAGES);
+    memset(mappings, 0, sizeof(mappings));
+    memset(&stats, 0, sizeof(stats));
+}
+
+// 查找缓存的存储块，命中时更新访问时间参与LRU置换
+static uint32_t lookup_block(uint32_t block) {
+    if (block >= MAX_BLOCKS) {
+        return (uint32_t)-1;
+    }
+    uint32_t frame = block_frames[block];
+    if (frame != (uint32_t)-1) {
+        memory_manager.frames[frame].last_access_time = get_current_time();
+    }
+    return frame;
+}
+
+static void cache_insert(uint32_t frame, uint32_t block) {
+    block_frames[block] = frame;
+    frame_blocks[frame] = block;
+}
+
+static void cache_remove(uint32_t frame) {
+    block_frames[frame_blocks[frame]] = (uint32_t)-1;
+    frame_blocks[frame] = (uint32_t)-1;
+}
+
+// 脏页写回存储
+static bool write_back(uint32_t frame) {
+    if (!memory_manager.frames[frame].is_dirty) {
+        return true;
+    }
+    if (!storage_write(frame_blocks[frame], get_physical_address(frame))) {
+        printf("错误：页缓存页框 %u 写回存储块 %u 失败\n", frame, frame_blocks[frame]);
+        return false;
+    }
+    memory_manager.frames[frame].is_dirty = false;
+    stats.writebacks++;
+    return true;
+}
+
+// 使映射该页框的所有页表项失效，下次访问时重新缺页
+static void invalidate_mappings(uint32_t frame) {
+    FrameMapping mapping;
+    uint32_t cursor = frame_mappings_begin(frame);
+    while (frame_mappings_next(frame, &cursor, &mapping)) {
+        PageTableEntry* pte = &mapping.process->page_table[mapping.virtual_page];
+        pte->flags.present = false;
+        pte->frame_number = (uint32_t)-1;
+    }
+}
+
+/**
+ * @brief 为页缓存取得一个不属于任何进程的页框
+ *
+ * 没有空闲页框时与匿名页面一起参与LRU置换，页框由页缓存持有一次引用。
+ *
+ * @return uint32_t 页框号，失败返回-1
+ */
+static uint32_t obtain_cache_frame(void) {
+    uint32_t frame = allocate_frame(0, 0);
+    if (frame != (uint32_t)-1) {
+        return frame;
+    }
+
+    uint32_t victim = evict_victim_frame(NULL);
+    if (victim == (uint32_t)-1) {
+        return (uint32_t)-1;
+    }
+
+    FrameInfo* info = &memory_manager.frames[victim];
+    info->is_allocated = true;
+    info->process_id = 0;
+    info->virtual_page_num = 0;
+    info->last_access_time = get_current_time();
+    info->is_dirty = false;
+    info->ref_count = 1;
+    frame_update_charge(victim);
+    frame_mark_written(victim);
+    memory_manager.free_frames_count--;
+    vm_manager.stats.page_replacements++;
+    return victim;
+}
+
+// 把存储块读入新的缓存页框
+static uint32_t load_block(uint32_t block) {
+    if (!storage_is_allocated(block, 1)) {
+        printf("错误：存储块 %u 未分配\n", block);
+        return (uint32_t)-1;
+    }
+
+    uint32_t frame = obtain_cache_frame();
+    if (frame == (uint32_t)-1) {
+        printf("错误：无法为存储块 %u 获取页缓存页框\n", block);
+        return (uint32_t)-1;
+    }
+    if (!storage_read(block, get_physical_address(frame))) {
+        free_frame(frame);
+        return (uint32_t)-1;
+    }
+
+    cache_insert(frame, block);
+    stats.misses++;
+    return frame;
+}
+
+// 经页缓存读取一个存储块
+bool pagecache_read(uint32_t block, void* buffer) {
+    if (!buffer) {
+        return false;
+    }
+
+    uint32_t frame = lookup_block(block);
+    if (frame != (uint32_t)-1) {
+        stats.hits++;
+    } else {
+        frame = load_block(block);
+        if (frame == (uint32_t)-1) {
+            return false;
+        }
+    }
+    memcpy(buffer, get_physical_address(frame), BLOCK_SIZE);
+    return true;
+}
+
+/**
+ * @brief 经页缓存写入一个存储块
+ *
+ * 只修改缓存页并标记为脏，在回收、同步或写回时才写入存储；
+ * 取不到页框时直接写入存储。
+ *
+ * @param block 存储块号
+ * @param data 一个块的数据
+ * @return true 写入成功
+ */
+bool pagecache_write(uint32_t block, const void* data) {
+    if (!data) {
+        return false;
+    }
+    if (!storage_is_allocated(block, 1)) {
+        printf("错误：尝试写入未分配的块 %u\n", block);
+        return false;
+    }
+
+    uint32_t frame = lookup_block(block);
+    if (frame != (uint32_t)-1) {
+        stats.hits++;
+    } else {
+        // 整块覆盖，无需先从存储读入
+        frame = obtain_cache_frame();
+        if (frame == (uint32_t)-1) {
+            return storage_write(block, data);
+        }
+        cache_insert(frame, block);
+    }
+
+    frame_mark_written(frame);
+    memcpy(get_physical_address(frame), data, BLOCK_SIZE);
+    memory_manager.frames[frame].is_dirty = true;
+    return true;
+}
+
+/**
+ * @brief 经页缓存读取连续多块
+ *
+ * 命中的块从缓存页复制；连续未命中的块一次从存储读出，再放入页缓存。
+ *
+ * @param start_block 起始块号
+ * @param block_count 块数
+ * @param buffer 至少 block_count * BLOCK_SIZE 字节
+ * @return true 读取成功
+ */
+bool pagecache_readv(uint32_t start_block, uint32_t block_count, void* buffer) {
+    if (!buffer || !storage_is_allocated(start_block, block_count)) {
+        printf("错误：存储块 %u 起的 %u 块未全部分配\n", start_block, block_count);
+        return false;
+    }
+
+    uint8_t* out = (uint8_t*)buffer;
+    uint32_t i = 0;
+    while (i < block_count) {
+        uint32_t frame = lookup_block(start_block + i);
+        if (frame != (uint32_t)-1) {
+            memcpy(out + (size_t)i * BLOCK_SIZE, get_physical_address(frame), BLOCK_SIZE);
+            stats.hits++;
+            i++;
+            continue;
+        }
+
+        uint32_t run = 1;
+        while (i + run < block_count && block_frames[start_block + i + run] == (uint32_t)-1) {
+            run++;
+        }
+        if (!storage_readv(start_block + i, run, out + (size_t)i * BLOCK_SIZE)) {
+            return false;
+        }
+
+        // 读入的块放入页缓存，取不到页框时只返回数据
+        for (uint32_t j = 0; j < run; j++) {
+            uint32_t cached = obtain_cache_frame();
+            if (cached == (uint32_t)-1) {
+                break;
+            }
+            memcpy(get_physical_address(cached), out + (size_t)(i + j) * BLOCK_SIZE, BLOCK_SIZE);
+            cache_insert(cached, start_block + i + j);
+        }
+        stats.misses += run;
+        i += run;
+    }
+    return true;
+}
+
+// 写回所有脏页
+uint32_t pagecache_sync(void) {
+    uint32_t written = 0;
+    for (uint32_t frame = 0; frame < PHYSICAL_PAGES; frame++) {
+        if (frame_blocks[frame] == (uint32_t)-1 || !memory_manager.frames[frame].is_dirty) {
+            continue;
+        }
+        if (write_back(frame)) {
+            written++;
+        }
+    }
+    return written;
+}
+
+// 丢弃一个缓存页框：所有映射失效，释放页框
+static void drop_frame(uint32_t frame) {
+    invalidate_mappings(frame);
+    cache_remove(frame);
+    free_frame(frame);
+}
+
+// 丢弃缓存中不再属于已分配区段的块（数据已无效，不写回）
+void pagecache_drop_unallocated(void) {
+    for (uint32_t frame = 0; frame < PHYSICAL_PAGES; frame++) {
+        uint32_t block = frame_blocks[frame];
+        if (block != (uint32_t)-1 && !storage_is_allocated(block, 1)) {
+            drop_frame(frame);
+        }
+    }
+}
+
+// 写回并丢弃全部缓存
+void pagecache_invalidate_all(void) {
+    pagecache_sync();
+    for (uint32_t frame = 0; frame < PHYSICAL_PAGES; frame++) {
+        if (frame_blocks[frame] != (uint32_t)-1) {
+            drop_frame(frame);
+        }
+    }
+}
+
+// 查找覆盖某个虚拟页的文件映射记录
+static FileMapping* find_mapping(uint32_t pid, uint32_t virtual_page) {
+    for (uint32_t i = 0; i < MAX_FILE_MAPPINGS; i++) {
+        FileMapping* mapping = &mappings[i];
+        if (mapping->in_use && mapping->process_id == pid &&
+            virtual_page >= mapping->start_page &&
+            virtual_page < mapping->start_page + mapping->block_count) {
+            return mapping;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 把一段已分配的存储块映射到进程的虚拟页上
+ *
+ * 映射只建立页表项，页面在首次访问时经页缓存读入；
+ * 写入映射页面只修改缓存页，由回收或同步写回存储。
+ *
+ * @param pid 进程ID
+ * @param start_block 起始存储块号
+ * @param block_count 块数
+ * @param start_page 起始虚拟页号
+ * @return true 映射成功
+ */
+bool pagecache_map(uint32_t pid, uint32_t start_block, uint32_t block_count, uint32_t start_page) {
+    PCB* process = get_process_by_pid(pid);
+    if (!process || !process->page_table) {
+        printf("错误：找不到进程 %u\n", pid);
+        return false;
+    }
+    if (!storage_is_allocated(start_block, block_count)) {
+        printf("错误：存储块 %u 起的 %u 块未全部分配\n", start_block, block_count);
+        return false;
+    }
+
+    uint32_t end_page = start_page + block_count;
+    if (end_page > MAX_PAGES_PER_PROCESS) {
+        printf("错误：映射范围 %u-%u 超出进程最大页数 %d\n",
+               start_page, end_page - 1, MAX_PAGES_PER_PROCESS);
+        return false;
+    }
+
+    // 查找空闲映射记录
+    FileMapping* mapping = NULL;
+    for (uint32_t i = 0; i < MAX_FILE_MAPPINGS; i++) {
+        if (!mappings[i].in_use) {
+            mapping = &mappings[i];
+            break;
+        }
+    }
+    if (!mapping) {
+        printf("错误：文件映射记录已用完\n");
+        return false;
+    }
+
+    // 检查映射范围内的虚拟页是否空闲
+    for (uint32_t page = start_page; page < end_page && page < process->page_table_size; page++) {
+        PageTableEntry* pte = &process->page_table[page];
+        if (pte->flags.present || pte->flags.swapped || pte->flags.shm || pte->flags.file) {
+            printf("错误：进程 %u 的虚拟页 %u 已被使用\n", pid, page);
+            return false;
+        }
+    }
+
+    // 必要时扩展页表
+    if (end_page > process->page_table_size) {
+        PageTableEntry* page_table = (PageTableEntry*)realloc(process->page_table,
+                                                              end_page * sizeof(PageTableEntry));
+        if (!page_table) {
+            printf("内存分配失败\n");
+            return false;
+        }
+        memset(&page_table[process->page_table_size], 0,
+               (end_page - process->page_table_size) * sizeof(PageTableEntry));
+        process->page_table = page_table;
+        process->page_table_size = end_page;
+    }
+
+    for (uint32_t page = start_page; page < end_page; page++) {
+        PageTableEntry* pte = &process->page_table[page];
+        pte->frame_number = (uint32_t)-1;
+        pte->flags.file = true;
+    }
+
+    mapping->in_use = true;
+    mapping->process_id = pid;
+    mapping->start_block = start_block;
+    mapping->block_count = block_count;
+    mapping->start_page = start_page;
+
+    printf("存储块 %u-%u 已映射到进程 %u 的虚拟页 %u-%u\n",
+           start_block, start_block + block_count - 1, pid, start_page, end_page - 1);
+    return true;
+}
+
+// 解除一条映射记录，缓存页保留在页缓存中（脏页稍后写回）
+static void unmap_mapping(FileMapping* mapping) {
+    PCB* process = get_process_by_pid(mapping->process_id);
+    if (process && process->page_table) {
+        for (uint32_t i = 0; i < mapping->block_count; i++) {
+            uint32_t page = mapping->start_page + i;
+            if (page >= process->page_table_size) {
+                break;
+            }
+
+            PageTableEntry* pte = &process->page_table[page];
+            if (pte->flags.present) {
+                uint32_t frame = pte->frame_number;
+                pte->flags.present = false;
+                release_frame(frame, process->pid, page);
+            }
+            pte->frame_number = (uint32_t)-1;
+            pte->flags.file = false;
+        }
+    }
+    mapping->in_use = false;
+}
+
+// 解除进程从某个虚拟页开始的文件映射
+bool pagecache_unmap(uint32_t pid, uint32_t start_page) {
+    for (uint32_t i = 0; i < MAX_FILE_MAPPINGS; i++) {
+        if (mappings[i].in_use && mappings[i].process_id == pid &&
+            mappings[i].start_page == start_page) {
+            unmap_mapping(&mappings[i]);
+            printf("进程 %u 虚拟页 %u 起的文件映射已解除\n", pid, start_page);
+            return true;
+        }
+    }
+
+    printf("错误：进程 %u 在虚拟页 %u 没有文件映射\n", pid, start_page);
+    return false;
+}
+
+// 解除进程的所有文件映射（进程终止时调用）
+void pagecache_unmap_all(uint32_t pid) {
+    for (uint32_t i = 0; i < MAX_FILE_MAPPINGS; i++) {
+        if (mappings[i].in_use && mappings[i].process_id == pid) {
+            unmap_mapping(&mappings[i]);
+        }
+    }
+}
+
+/**
+ * @brief 为复制出的子进程复制文件映射记录
+ *
+ * 子进程页表已从父进程复制，映射的引用由调用者通过 frame_get 增加。
+ *
+ * @param parent_pid 父进程ID
+ * @param child_pid 子进程ID
+ * @return true 复制成功
+ * @return false 映射记录已用完
+ */
+bool pagecache_fork_mappings(uint32_t parent_pid, uint32_t child_pid) {
+    for (uint32_t i = 0; i < MAX_FILE_MAPPINGS; i++) {
+        if (!mappings[i].in_use || mappings[i].process_id != parent_pid) {
+            continue;
+        }
+
+        FileMapping* copy = NULL;
+        for (uint32_t j = 0; j < MAX_FILE_MAPPINGS; j++) {
+            if (!mappings[j].in_use) {
+                copy = &mappings[j];
+                break;
+            }
+        }
+        if (!copy) {
+            printf("错误：文件映射记录已用完\n");
+            return false;
+        }
+
+        *copy = mappings[i];
+        copy->process_id = child_pid;
+    }
+    return true;
+}
+
+/**
+ * @brief 处理文件映射页面的缺页
+ *
+ * 存储块已在页缓存中时直接映射缓存页框；否则按置换范围取得页框、
+ * 从存储读入，并由页缓存持有一次引用，使页框在进程解除映射后仍可命中。
+ *
+ * @param process 缺页进程
+ * @param virtual_page 缺页的虚拟页号
+ * @return true 处理成功
+ * @return false 处理失败
+ */
+bool pagecache_handle_fault(PCB* process, uint32_t virtual_page) {
+    FileMapping* mapping = find_mapping(process->pid, virtual_page);
+    if (!mapping) {
+        printf("错误：进程 %u 的虚拟页 %u 没有文件映射\n", process->pid, virtual_page);
+        return false;
+    }
+
+    uint32_t block = mapping->start_block + (virtual_page - mapping->start_page);
+    PageTableEntry* pte = &process->page_table[virtual_page];
+    stats.map_faults++;
+
+    uint32_t frame = lookup_block(block);
+    if (frame != (uint32_t)-1) {
+        if (!frame_get(frame, process->pid, virtual_page)) {
+            return false;
+        }
+        stats.hits++;
+        printf("存储块 %u 已在页缓存页框 %u 中，直接映射\n", block, frame);
+    } else {
+        if (!storage_is_allocated(block, 1)) {
+            printf("错误：映射的存储块 %u 已被释放\n", block);
+            return false;
+        }
+
+        frame = obtain_frame_for_page(process, virtual_page);
+        if (frame == (uint32_t)-1) {
+            printf("错误：无法为存储块 %u 获取页框\n", block);
+            return false;
+        }
+        if (!storage_read(block, get_physical_address(frame))) {
+            free_frame(frame);
+            return false;
+        }
+
+        // 页缓存持有一次引用
+        memory_manager.frames[frame].ref_count++;
+        frame_update_charge(frame);
+        cache_insert(frame, block);
+        stats.misses++;
+        vm_manager.stats.disk_reads++;
+        printf("存储块 %u 读入页框 %u，映射到进程 %u 的虚拟页 %u\n",
+               block, frame, process->pid, virtual_page);
+    }
+
+    pte->frame_number = frame;
+    pte->flags.present = true;
+    pte->last_access_time = get_current_time();
+    return true;
+}
+
+// 查找页框缓存的存储块
+bool pagecache_find_frame(uint32_t frame_number, uint32_t* block) {
+    if (frame_number >= PHYSICAL_PAGES || frame_blocks[frame_number] == (uint32_t)-1) {
+        return false;
+    }
+    if (block) *block = frame_blocks[frame_number];
+    return true;
+}
+
+// 内存整理把缓存页迁移到新页框后更新块与页框的索引
+void pagecache_migrate_frame(uint32_t old_frame, uint32_t new_frame) {
+    uint32_t block;
+    if (pagecache_find_frame(old_frame, &block)) {
+        cache_remove(old_frame);
+        cache_insert(new_frame, block);
+    }
+}
+
+/**
+ * @brief 页面置换回收页缓存页框
+ *
+ * 脏页先写回存储，然后所有映射失效，页框交还给置换者；
+ * 页缓存的页面不占用交换区。
+ *
+ * @param frame_number 页框号
+ * @return true 回收成功
+ * @return false 不是页缓存页框或写回失败
+ */
+bool pagecache_evict_frame(uint32_t frame_number) {
+    uint32_t block;
+    if (!pagecache_find_frame(frame_number, &block) || !write_back(frame_number)) {
+        return false;
+    }
+
+    invalidate_mappings(frame_number);
+    cache_remove(frame_number);
+
+    FrameInfo* info = &memory_manager.frames[frame_number];
+    info->is_allocated = false;
+    info->process_id = 0;
+    info->virtual_page_num = 0;
+    info->is_dirty = false;
+    info->ref_count = 0;
+    clear_frame_mappings(frame_number);
+    frame_update_charge(frame_number);
+    memory_manager.free_frames_count++;
+
+    stats.evictions++;
+    printf("页缓存页框 %u（存储块 %u）已回收\n", frame_number, block);
+    return true;
+}
+
+PageCacheStats get_pagecache_stats(void) {
+    return stats;
+}
+
+// 打印页缓存状态
+void print_pagecache_status(void) {
+    uint32_t cached = 0, dirty = 0, mapped = 0;
+    for (uint32_t frame = 0; frame < PHYSICAL_PAGES; frame++) {
+        if (frame_blocks[frame] == (uint32_t)-1) {
+            continue;
+        }
+        cached++;
+        if (memory_manager.frames[frame].is_dirty) dirty++;
+        if (memory_manager.frames[frame].process_id != 0) mapped++;
+    }
+
+    uint32_t lookups = stats.hits + stats.misses;
+    printf("\n=== 页缓存 ===\n");
+    printf("缓存页框: %u（脏页 %u，被进程映射 %u）\n", cached, dirty, mapped);
+    printf("命中: %u，未命中: %u，命中率: %.1f%%\n", stats.hits, stats.misses,
+           lookups ? (float)stats.hits * 100 / lookups : 0.0f);
+    printf("映射缺页: %u，写回块数: %u，回收页框: %u\n",
+           stats.map_faults, stats.writebacks, stats.evictions);
+
+    for (uint32_t i = 0; i < MAX_FILE_MAPPINGS; i++) {
+        if (mappings[i].in_use) {
+            printf("  进程 %u：虚拟页 %u-%u -> 存储块 %u-%u\n", mappings[i].process_id,
+                   mappings[i].start_page, mappings[i].start_page + mappings[i].block_count - 1,
+                   mappings[i].start_block, mappings[i].start_block + mappings[i].block_count - 1);
+        }
+    }
+}
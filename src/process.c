@@ -5,22 +5,50 @@
 #include "../include/process.h"
 #include "../include/memory.h"
 #include "../include/vm.h"
+#include "../include/shm.h"
+#include "../include/pagecache.h"
+#include "../include/ksm.h"
+#include "../include/swapio.h"
+#include "../include/swapalloc.h"
+#include "../include/dump.h"
+#include "../include/thp.h"
+#include "../include/compact.h"
+#include "../include/numa.h"
+#include "../include/tier.h"
+#include "../include/profile.h"
+#include "../include/trace.h"
 
-// ̱
-static PCB processes[MAX_PROCESSES];  // ̿ƿ
+// 进程表
+static PCB* processes = NULL;  // 进程控制块表（MAX_PROCESSES 项）
 
-// ȫ̵
+// 全进程调度器
 ProcessScheduler scheduler;
 
-// ʼ̵
+// 记录从当前运行进程到 next_pid 的上下文切换，0 表示 CPU 空闲
+static void trace_switch(uint32_t next_pid) {
+    uint32_t prev_pid = scheduler.running_process ? scheduler.running_process->pid : 0;
+    if (prev_pid != next_pid) {
+        trace_instant(TRACE_SWITCH, next_pid, prev_pid, next_pid, 0);
+    }
+}
+
+// 初始化进程调度器
 void scheduler_init(void) {
-    // ʼṹ
+    // 初始化调度器结构
     memset(&scheduler, 0, sizeof(ProcessScheduler));
     scheduler.next_pid = 1;
     scheduler.total_runtime = 0;
     scheduler.auto_balance = true;
+    scheduler.fault_service_ticks = DEFAULT_FAULT_SERVICE_TICKS;
 
-    // ʼ̱
+    // 初始化进程表
+    if (!processes) {
+        processes = (PCB*)calloc(MAX_PROCESSES, sizeof(PCB));
+        if (!processes) {
+            fprintf(stderr, "进程表初始化失败\n");
+            exit(1);
+        }
+    }
     for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
         processes[i].pid = 0;
         processes[i].state = PROCESS_TERMINATED;
@@ -28,7 +56,7 @@ void scheduler_init(void) {
         processes[i].page_table_size = 0;
     }
 
-    // ʼ
+    // 初始化就绪队列
     for (int i = 0; i < 3; i++) {
         scheduler.ready_queue[i] = NULL;
     }
@@ -37,9 +65,9 @@ void scheduler_init(void) {
     scheduler.total_processes = 0;
 }
 
-// رս̵
+// 关闭进程调度器
 void scheduler_shutdown(void) {
-    // 
+    // 遍历就绪队列
     for (int i = 0; i < 3; i++) {
         PCB* current = scheduler.ready_queue[i];
         while (current) {
@@ -50,7 +78,7 @@ void scheduler_shutdown(void) {
         scheduler.ready_queue[i] = NULL;
     }
 
-    // 
+    // 遍历阻塞队列
     PCB* current = scheduler.blocked_queue;
     while (current) {
         PCB* next = current->next;
@@ -59,204 +87,343 @@ void scheduler_shutdown(void) {
     }
     scheduler.blocked_queue = NULL;
 
-    // ǰн
+    // 当前运行进程
     if (scheduler.running_process) {
         process_destroy(scheduler.running_process);
         scheduler.running_process = NULL;
     }
 }
 
-// 
+// 调度前预先调入已换出的页面，直到可运行页面（驻留或可按需建立）达到下限
+static void prefault_swapped_pages(PCB* process) {
+    float runnable_ratio = calculate_runnable_pages_ratio(process);
+    printf("进程 %u 当前可运行页面比例: %.2f%%\n", process->pid, runnable_ratio);
+    if (runnable_ratio >= MIN_RUNNABLE_PAGES_RATIO) {
+        return;
+    }
+    
+    // 计算还需要调入的已换出页面数
+    uint32_t total_pages = process->page_table_size;
+    uint32_t min_required = (uint32_t)(total_pages * MIN_RUNNABLE_PAGES_RATIO / 100.0f);
+    uint32_t runnable_pages = (uint32_t)(runnable_ratio * total_pages / 100.0f);
+    uint32_t pages_to_allocate = min_required > runnable_pages ? min_required - runnable_pages : 0;
+    printf("进程 %u 的可运行页面比例低于%.0f%%，需要调入 %u 个已换出的页面\n",
+           process->pid, MIN_RUNNABLE_PAGES_RATIO, pages_to_allocate);
+    
+    // 共享内存段的页面在访问时由所属段映射
+    for (uint32_t j = 0; j < total_pages && pages_to_allocate > 0; j++) {
+        PageTableEntry* pte = &process->page_table[j];
+        if (!pte->flags.present && pte->flags.swapped && !pte->flags.shm) {
+            if (handle_page_fault(process, j, false)) {
+                pages_to_allocate--;
+            }
+        }
+    }
+}
+
+// 调度
+//
+// 就绪进程无法运行（页框不足以调入其页面）时留在就绪队列中，继续尝试下一个进程。
 void schedule(void) {
-    // ǰûн̣ȼߵĽ̿ʼ
+    // 如果当前没有运行进程，从优先级最高的进程开始调度
     if (!scheduler.running_process) {
-        printf("\nʼ̵...\n");
+        printf("\n开始进程调度...\n");
         for (int i = 0; i < 3; i++) {
-            if (scheduler.ready_queue[i]) {
-                PCB* process = scheduler.ready_queue[i];
-                
-                // ̵ҳ
-                float physical_ratio = calculate_physical_pages_ratio(process);
-                printf(" %u ǰҳ: %.2f%%\n", process->pid, physical_ratio);
+            if (!scheduler.ready_queue[i]) {
+                printf("优先级 %d 队列为空\n", i);
+                continue;
+            }
+            
+            PCB* process = scheduler.ready_queue[i];
+            while (process) {
+                PCB* next = process->next;
+                prefault_swapped_pages(process);
                 
-                if (physical_ratio < 25.0f) {
-                    printf(" %u ҳ25%%Էҳ...\n", process->pid);
-                    
-                    // Ҫҳ
-                    uint32_t total_pages = process->page_table_size;
-                    uint32_t min_required = (uint32_t)(total_pages * 0.25);
-                    uint32_t current_pages = 0;
-                    
-                    // ͳƵǰڴеҳ
-                    for (uint32_t j = 0; j < total_pages; j++) {
-                        if (process->page_table[j].flags.present) {
-                            current_pages++;
-                        }
-                    }
-                    
-                    // 㻹Ҫҳ
-                    uint32_t pages_to_allocate = min_required - current_pages;
-                    printf("Ҫ %u ҳ\n", pages_to_allocate);
-                    
-                    // Էҳ
-                    for (uint32_t j = 0; j < total_pages && pages_to_allocate > 0; j++) {
-                        if (!process->page_table[j].flags.present) {
-                            uint32_t frame = allocate_frame(process->pid, j);
-                            if (frame == (uint32_t)-1) {
-                                // ûпҳҪҳû
-                                frame = select_victim_frame();
-                                if (frame != (uint32_t)-1) {
-                                    // ҳ
-                                    process->page_table[j].frame_number = frame;
-                                    process->page_table[j].flags.present = true;
-                                    process->page_table[j].flags.swapped = false;
-                                    process->page_table[j].last_access_time = get_current_time();
-                                    pages_to_allocate--;
-                                }
-                            } else {
-                                // ֱӷҳ
-                                process->page_table[j].frame_number = frame;
-                                process->page_table[j].flags.present = true;
-                                process->page_table[j].flags.swapped = false;
-                                process->page_table[j].last_access_time = get_current_time();
-                                pages_to_allocate--;
-                            }
-                        }
-                    }
+                // 设置成功时进程已从就绪队列中移除
+                if (set_running_process(process)) {
+                    printf("调度进程 PID %u (优先级 %d) 开始运行，时间片 %u\n", 
+                           process->pid,
+                           process->priority,
+                           process->time_slice);
+                    return;
                 }
-                
-                scheduler.ready_queue[i] = process->next;
-                set_running_process(process);
-                
-                printf("Ƚ PID %u (ȼ %d) ʼУʱƬ %u\n", 
-                       process->pid,
-                       process->priority,
-                       process->time_slice);
-                return;
-            } else {
-                printf("ȼ %d Ϊ\n", i);
+                process = next;
             }
         }
-        printf("ûпеĽ\n");
+        printf("没有可运行的进程\n");
     } else {
-        // ǷиȼĽ
+        // 检查是否有更高优先级的进程
         for (int i = 0; i < scheduler.running_process->priority; i++) {
-            if (scheduler.ready_queue[i]) {
-                PCB* high_priority_process = scheduler.ready_queue[i];
+            PCB* high_priority_process = scheduler.ready_queue[i];
+            while (high_priority_process) {
+                PCB* next = high_priority_process->next;
+                prefault_swapped_pages(high_priority_process);
                 
-                // ȼ̵ҳ
-                float physical_ratio = calculate_physical_pages_ratio(high_priority_process);
-                printf("ȼ %u ǰҳ: %.2f%%\n", high_priority_process->pid, physical_ratio);
-                
-                if (physical_ratio < 25.0f) {
-                    printf("ȼ %u ҳ25%%Էҳ...\n", high_priority_process->pid);
-                    
-                    // Ҫҳ
-                    uint32_t total_pages = high_priority_process->page_table_size;
-                    uint32_t min_required = (uint32_t)(total_pages * 0.25);
-                    uint32_t current_pages = 0;
-                    
-                    // ͳƵǰڴеҳ
-                    for (uint32_t j = 0; j < total_pages; j++) {
-                        if (high_priority_process->page_table[j].flags.present) {
-                            current_pages++;
-                        }
-                    }
-                    
-                    // 㻹Ҫҳ
-                    uint32_t pages_to_allocate = min_required - current_pages;
-                    printf("Ҫ %u ҳ\n", pages_to_allocate);
-                    
-                    // Էҳ
-                    for (uint32_t j = 0; j < total_pages && pages_to_allocate > 0; j++) {
-                        if (!high_priority_process->page_table[j].flags.present) {
-                            uint32_t frame = allocate_frame(high_priority_process->pid, j);
-                            if (frame == (uint32_t)-1) {
-                                // ûпҳҪҳû
-                                frame = select_victim_frame();
-                                if (frame != (uint32_t)-1) {
-                                    // ҳ
-                                    high_priority_process->page_table[j].frame_number = frame;
-                                    high_priority_process->page_table[j].flags.present = true;
-                                    high_priority_process->page_table[j].flags.swapped = false;
-                                    high_priority_process->page_table[j].last_access_time = get_current_time();
-                                    pages_to_allocate--;
-                                }
-                            } else {
-                                // ֱӷҳ
-                                high_priority_process->page_table[j].frame_number = frame;
-                                high_priority_process->page_table[j].flags.present = true;
-                                high_priority_process->page_table[j].flags.swapped = false;
-                                high_priority_process->page_table[j].last_access_time = get_current_time();
-                                pages_to_allocate--;
-                            }
-                        }
-                    }
+                if (preempt_process(scheduler.running_process, high_priority_process)) {
+                    return;
                 }
-                
-                scheduler.ready_queue[i] = high_priority_process->next;
-                preempt_process(scheduler.running_process, high_priority_process);
-                return;
+                high_priority_process = next;
             }
         }
-        printf("ǰ PID %u Уȼ %u\n",
+        printf("当前进程 PID %u 继续运行（优先级 %u）\n",
                scheduler.running_process->pid,
                scheduler.running_process->priority);
     }
 }
 
-// ʱӵδ
+// 是否有就绪进程
+static bool has_ready_process(void) {
+    for (int i = 0; i < 3; i++) {
+        if (scheduler.ready_queue[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 从阻塞队列中移除进程
+static void remove_from_blocked_queue(PCB* process) {
+    if (scheduler.blocked_queue == process) {
+        scheduler.blocked_queue = process->next;
+    } else {
+        PCB* current = scheduler.blocked_queue;
+        while (current && current->next != process) {
+            current = current->next;
+        }
+        if (current) {
+            current->next = process->next;
+        }
+    }
+    process->next = NULL;
+}
+
+/**
+ * @brief 阻塞进程：移出运行状态或就绪队列，加入阻塞队列队尾
+ * 
+ * 运行中的进程阻塞后 CPU 空闲，由调用者决定何时调度下一个进程。
+ * 
+ * @param process 要阻塞的进程
+ */
+void block_process(PCB* process) {
+    if (!process || process->state == PROCESS_BLOCKED || process->state == PROCESS_TERMINATED) {
+        return;
+    }
+    
+    if (scheduler.running_process == process) {
+        trace_switch(0);
+        scheduler.running_process = NULL;
+    } else {
+        // 从就绪队列中移除
+        PCB** queue = &scheduler.ready_queue[process->priority];
+        if (*queue == process) {
+            *queue = process->next;
+        } else {
+            PCB* current = *queue;
+            while (current && current->next != process) {
+                current = current->next;
+            }
+            if (current) {
+                current->next = process->next;
+            }
+        }
+    }
+    
+    process->state = PROCESS_BLOCKED;
+    process->wake_tick = 0;
+    process->next = NULL;
+    
+    PCB** tail = &scheduler.blocked_queue;
+    while (*tail) {
+        tail = &(*tail)->next;
+    }
+    *tail = process;
+    
+    printf("进程 %u 进入阻塞队列\n", process->pid);
+}
+
+/**
+ * @brief 唤醒阻塞的进程，放回对应优先级的就绪队列
+ * 
+ * @param process 要唤醒的进程
+ */
+void wake_up_process(PCB* process) {
+    if (!process || process->state != PROCESS_BLOCKED) {
+        return;
+    }
+    
+    remove_from_blocked_queue(process);
+    add_to_ready_queue(process);
+    printf("进程 %u 被唤醒，加入优先级 %u 就绪队列\n", process->pid, process->priority);
+}
+
+// 获取阻塞队列
+PCB* get_blocked_queue(void) {
+    return scheduler.blocked_queue;
+}
+
+/**
+ * @brief 缺页服务阻塞：运行中的进程同步换入页面后，在服务时间内让出CPU
+ * 
+ * 页面数据已经读入，进程在 fault_service_ticks 个时钟滴答后被唤醒，
+ * 期间调度器可以运行其他就绪进程。不是当前运行进程（如命令行直接访存）
+ * 或服务时间为0时不阻塞。
+ * 
+ * @param process 发生换入缺页的进程
+ * @return 进程是否已阻塞
+ */
+bool block_for_fault_service(PCB* process) {
+    if (!process || process != scheduler.running_process || scheduler.fault_service_ticks == 0) {
+        return false;
+    }
+    
+    block_process(process);
+    // 从下一个滴答起等待 fault_service_ticks 个滴答
+    process->wake_tick = scheduler.total_runtime + scheduler.fault_service_ticks + 1;
+    scheduler.fault_blocks++;
+    printf("进程 %u 等待换入完成，%u 个时钟滴答后唤醒\n", process->pid, scheduler.fault_service_ticks);
+    return true;
+}
+
+// 设置缺页服务时间
+void set_fault_service_ticks(uint32_t ticks) {
+    scheduler.fault_service_ticks = ticks;
+    if (ticks == 0) {
+        printf("缺页服务时间已关闭，换入缺页不再阻塞进程\n");
+    } else {
+        printf("缺页服务时间设置为 %u 个时钟滴答\n", ticks);
+    }
+}
+
+// 唤醒缺页服务已完成的进程，并累计阻塞进程的等待时间
+static void wake_fault_waiters(void) {
+    PCB* process = scheduler.blocked_queue;
+    while (process) {
+        PCB* next = process->next;
+        if (process->wake_tick != 0 && scheduler.total_runtime >= process->wake_tick) {
+            wake_up_process(process);
+        } else {
+            process->stats.io_wait_ticks++;
+        }
+        process = next;
+    }
+}
+
+// 计算滴答数占比
+static float tick_percent(uint32_t ticks) {
+    return scheduler.total_runtime ? (float)ticks * 100.0f / scheduler.total_runtime : 0.0f;
+}
+
+// 打印CPU利用率与I/O等待
+void print_cpu_utilization(void) {
+    printf("\n=== CPU利用率 ===\n");
+    printf("时钟滴答: %u\n", scheduler.total_runtime);
+    printf("CPU忙碌: %u (%.1f%%)\n", scheduler.busy_ticks, tick_percent(scheduler.busy_ticks));
+    printf("I/O等待: %u (%.1f%%)\n", scheduler.iowait_ticks, tick_percent(scheduler.iowait_ticks));
+    printf("空闲: %u (%.1f%%)\n", scheduler.idle_ticks, tick_percent(scheduler.idle_ticks));
+    if (scheduler.fault_service_ticks) {
+        printf("缺页服务时间: %u 个时钟滴答\n", scheduler.fault_service_ticks);
+    } else {
+        printf("缺页服务时间: 关闭\n");
+    }
+    printf("缺页服务阻塞次数: %u\n", scheduler.fault_blocks);
+    printf("异步换入中的缺页: %u\n", swapio_pending_faults());
+}
+
+// 时钟滴答
 void time_tick(void) {
+    scheduler.total_runtime++;
+    
+    // 后台相同页合并扫描和交换区整理
+    ksm_tick();
+    thp_tick();
+    compact_tick();
+    numa_tick();
+    tier_tick();
+    swap_compact_tick();
+    
+    // 收割后台快照写入，到期时保存周期检查点
+    dump_tick();
+    
+    // 唤醒缺页服务完成的进程
+    wake_fault_waiters();
+    
+    // 收割异步换入并唤醒等待的进程；没有可运行的进程时等待页面读入
+    swapio_poll(!scheduler.running_process && !has_ready_process());
+    if (!scheduler.running_process) {
+        schedule();
+    }
+    
     if (!scheduler.running_process) {
-        printf("ǰûеĽ\n");
+        // 有进程在等待换入时CPU处于I/O等待，否则空闲
+        if (scheduler.blocked_queue) {
+            scheduler.iowait_ticks++;
+            printf("当前没有可运行的进程，等待换入完成\n");
+        } else {
+            scheduler.idle_ticks++;
+            printf("当前没有运行中的进程\n");
+        }
         return;
     }
+    scheduler.busy_ticks++;
     
-    // µǰн̵ʱƬ
+    // 更新当前运行进程的时间片
     scheduler.running_process->time_slice--;
-    printf("\n=== ʱƬת ===\n");
-    printf(" %u УʣʱƬ%u\n", 
+    printf("\n=== 时间片轮转 ===\n");
+    printf("进程 %u 正在运行（剩余时间片：%u）\n", 
            scheduler.running_process->pid, 
            scheduler.running_process->time_slice);
     
-    // ʱƬڴ5
+    // 在时间片内随机访问内存5次
     for (int i = 0; i < 5; i++) {
-        // һַڽ̵ĵַռڣ
+        // 生成一个随机的虚拟地址（在进程的地址空间内）
         uint32_t virtual_address = (rand() % scheduler.running_process->page_table_size) * PAGE_SIZE;
-        virtual_address += rand() % PAGE_SIZE;  // ҳƫ
+        virtual_address += rand() % PAGE_SIZE;  // 添加页内偏移
         
-        // Ƕд20%ĸд
+        // 随机决定是读还是写操作（20%的概率是写操作）
         bool is_write = (rand() % 5 == 0);
         
-        // ڴ
+        // 访问内存
         access_memory(scheduler.running_process, virtual_address, is_write);
+        
+        // 缺页等待交换区读取时进程已阻塞，让出CPU
+        if (!scheduler.running_process) {
+            schedule();
+            return;
+        }
     }
     
-    // ǷҪֹ
+    // 检查是否需要终止进程
     if (scheduler.running_process->time_slice <= 0) {
-        printf("\n %u ʱƬֹ꣬\n", scheduler.running_process->pid);
+        printf("\n进程 %u 时间片已用完，终止进程\n", scheduler.running_process->pid);
         
-        // ȡǰ
+        // 获取当前进程
         PCB* current = scheduler.running_process;
         
-        // ͷŽռõҳ
+        // 解除共享内存挂接和文件映射，释放进程占用的所有物理页框
+        shm_detach_all(current->pid);
+        pagecache_unmap_all(current->pid);
         for (uint32_t i = 0; i < current->page_table_size; i++) {
             if (current->page_table[i].flags.present) {
-                free_frame(current->page_table[i].frame_number);
+                current->page_table[i].flags.present = false;
+                release_frame(current->page_table[i].frame_number, current->pid, i);
+            } else if (current->page_table[i].flags.swapped && !current->page_table[i].flags.shm) {
+                free_swap_block(current->page_table[i].flags.swap_index);
+                current->page_table[i].flags.swapped = false;
             }
         }
         
-        // ֹ
+        // 终止进程
         current->state = PROCESS_TERMINATED;
+        trace_switch(0);
         scheduler.running_process = NULL;
         scheduler.total_processes--;
         
-        // һ
+        // 调度下一个进程
         schedule();
     }
 }
 
-// ȡ
+// 获取就绪队列
 PCB* get_ready_queue(ProcessPriority priority) {
     if (priority >= PRIORITY_HIGH && priority <= PRIORITY_LOW) {
         return scheduler.ready_queue[priority];
@@ -264,28 +431,28 @@ PCB* get_ready_queue(ProcessPriority priority) {
     return NULL;
 }
 
-// ȡǰн
+// 获取当前运行进程
 PCB* get_running_process(void) {
     return scheduler.running_process;
 }
 
-// ȡ
+// 获取进程总数
 uint32_t get_total_processes(void) {
     return scheduler.total_processes;
 }
 
-// ýȼ
+// 设置进程优先级
 void set_process_priority(PCB* process, ProcessPriority priority) {
     if (!process || priority < PRIORITY_HIGH || priority > PRIORITY_LOW) {
         return;
     }
     
-    // ȼܸı䣬ֱӷ
+    // 进程优先级不能改变，直接返回
     if (process->priority == priority) {
         return;
     }
     
-    // ɾ̴Ӿȼ
+    // 删除进程从旧优先级队列
     PCB** old_queue = &scheduler.ready_queue[process->priority];
     if (*old_queue == process) {
         *old_queue = process->next;
@@ -299,30 +466,30 @@ void set_process_priority(PCB* process, ProcessPriority priority) {
         }
     }
     
-    // ýȼ
+    // 设置进程优先级
     process->priority = priority;
     
-    // ӵȼеĶ
+    // 将进程添加到新优先级队列的队首
     process->next = scheduler.ready_queue[priority];
     scheduler.ready_queue[priority] = process;
 }
 
-// ӡ״̬
+// 打印调度器状态
 void print_scheduler_status(void) {
-    printf("\n=== ״̬ ===\n");
-    printf("%u\n", scheduler.total_processes);
+    printf("\n=== 调度器状态 ===\n");
+    printf("进程总数%u\n", scheduler.total_processes);
     if (scheduler.running_process) {
-        printf("еḶ̌PID %u\n", scheduler.running_process->pid);
+        printf("正在运行的进程，PID %u\n", scheduler.running_process->pid);
     } else {
-        printf("ûеĽ\n");
+        printf("没有正在运行的进程\n");
     }
     
-    // ӡ
+    // 打印就绪队列
     for (int i = 0; i < 3; i++) {
-        printf("\nȼ %d ̶У", i);
+        printf("\n优先级 %d 进程队列：", i);
         PCB* current = scheduler.ready_queue[i];
         if (!current) {
-            printf("");
+            printf("空");
         }
         while (current) {
             printf("PID %u -> ", current->pid);
@@ -330,46 +497,131 @@ void print_scheduler_status(void) {
         }
         printf("\n");
     }
+    
+    // 打印阻塞队列
+    printf("\n阻塞队列：");
+    PCB* blocked = scheduler.blocked_queue;
+    if (!blocked) {
+        printf("空");
+    }
+    while (blocked) {
+        printf("PID %u -> ", blocked->pid);
+        blocked = blocked->next;
+    }
+    printf("\n");
+    
+    printf("CPU利用率 %.1f%%，I/O等待 %.1f%%，空闲 %.1f%%（共 %u 个时钟滴答）\n",
+           tick_percent(scheduler.busy_ticks),
+           tick_percent(scheduler.iowait_ticks),
+           tick_percent(scheduler.idle_ticks),
+           scheduler.total_runtime);
 }
 
-// 
+// 创建进程
 PCB* process_create(uint32_t pid, uint32_t page_table_size) {
     PCB* process = (PCB*)malloc(sizeof(PCB));
     if (!process) return NULL;
     
-    // ʼϢ
+    // 初始化进程信息
     process->pid = pid;
     process->state = PROCESS_READY;
-    process->priority = PRIORITY_NORMAL;  // ʹöֵPRIORITY_NORMALΪĬȼ
+    process->priority = PRIORITY_NORMAL;  // 使用枚举值PRIORITY_NORMAL作为默认优先级
     process->time_slice = TIME_SLICE;
     
-    // ҳ
+    // 分配页表
     process->page_table = (PageTableEntry*)calloc(page_table_size, sizeof(PageTableEntry));
     if (!process->page_table) {
-        printf("ڴʧܣ޷ҳ\n");
+        printf("进程内存分配失败，无法分配页表\n");
         free(process);
         return NULL;
     }
     process->page_table_size = page_table_size;
     
-    // ʼͳϢ
+    // 初始化进程统计信息
     memset(&process->stats, 0, sizeof(ProcessStats));
     
     return process;
 }
 
-// ٽ
+/**
+ * @brief 把快照中的进程放回进程表
+ * 
+ * 页表由调用者分配，所有权转给进程表。按保存时的状态放回运行位置、
+ * 就绪队列或阻塞队列；快照按队列顺序保存，这里追加到队尾以保持原顺序。
+ * 等待异步换入的请求不在快照中，这类阻塞进程恢复为就绪，重新访问时再缺页。
+ * 
+ * @param image 进程信息（page_table 已分配）
+ * @return PCB* 进程表中的进程，进程表已满返回NULL
+ */
+PCB* process_restore(const PCB* image) {
+    if (!image || image->priority > PRIORITY_LOW || get_process_by_pid(image->pid)) {
+        return NULL;
+    }
+    
+    PCB* process = NULL;
+    for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
+        if (processes[i].state == PROCESS_TERMINATED || processes[i].pid == 0) {
+            process = &processes[i];
+            break;
+        }
+    }
+    if (!process) {
+        printf("进程表已满，无法恢复进程 %u\n", image->pid);
+        return NULL;
+    }
+    
+    *process = *image;
+    process->next = NULL;
+    if (process->state == PROCESS_BLOCKED && process->wake_tick == 0) {
+        process->state = PROCESS_READY;
+    }
+    if (process->state == PROCESS_RUNNING && scheduler.running_process) {
+        process->state = PROCESS_READY;
+    }
+    
+    PCB** tail = NULL;
+    switch (process->state) {
+        case PROCESS_RUNNING:
+            scheduler.running_process = process;
+            break;
+        case PROCESS_BLOCKED:
+            tail = &scheduler.blocked_queue;
+            break;
+        default:
+            process->state = PROCESS_READY;
+            tail = &scheduler.ready_queue[process->priority];
+            break;
+    }
+    if (tail) {
+        while (*tail) {
+            tail = &(*tail)->next;
+        }
+        *tail = process;
+    }
+    
+    scheduler.total_processes++;
+    return process;
+}
+
+// 销毁进程
 void process_destroy(PCB* pcb) {
     if (!pcb) return;
     
-    printf("ٽ %u\n", pcb->pid);
+    printf("销毁进程 %u\n", pcb->pid);
     
-    // 1. Ƚ̴ӵƳ
+    // 1. 先将进程从调度器中移除
     if (scheduler.running_process == pcb) {
+        trace_switch(0);
         scheduler.running_process = NULL;
     }
     
-    // 2. ӾƳ
+    // 从阻塞队列中移除，放弃尚未完成的换入
+    if (pcb->state == PROCESS_BLOCKED) {
+        remove_from_blocked_queue(pcb);
+    }
+    swapio_cancel_process(pcb->pid);
+    
+    // 2. 从就绪队列中移除
     PCB** queue = &scheduler.ready_queue[pcb->priority];
     if (*queue == pcb) {
         *queue = pcb->next;
@@ -383,20 +635,28 @@ void process_destroy(PCB* pcb) {
         }
     }
     
-    // 3. ý״̬Ϊֹ
+    // 3. 设置进程状态为终止
     pcb->state = PROCESS_TERMINATED;
     
-    // 4. ͷŽռõҳ
+    // 4. 解除共享内存挂接和文件映射，释放进程占用的页框
+    shm_detach_all(pcb->pid);
+    pagecache_unmap_all(pcb->pid);
+    profile_forget(pcb->pid);
     if (pcb->page_table) {
         for (uint32_t i = 0; i < pcb->page_table_size; i++) {
             if (pcb->page_table[i].flags.present) {
                 uint32_t frame = pcb->page_table[i].frame_number;
                 pcb->page_table[i].flags.present = false;
+                pcb->page_table[i].flags.cow = false;
                 pcb->page_table[i].frame_number = (uint32_t)-1;
-                free_frame(frame);
+                release_frame(frame, pcb->pid, i);
+            } else if (pcb->page_table[i].flags.swapped && !pcb->page_table[i].flags.shm) {
+                // 释放换出页面占用的交换区块
+                free_swap_block(pcb->page_table[i].flags.swap_index);
+                pcb->page_table[i].flags.swapped = false;
             }
         }
-        // 5. ͷҳ
+        // 5. 释放页表
         free(pcb->page_table);
         pcb->page_table = NULL;
     }
@@ -404,7 +664,7 @@ void process_destroy(PCB* pcb) {
     scheduler.total_processes--;
 }
 
-// Ϊ̷ڴ
+// 为进程分配内存
 bool process_allocate_memory(PCB* pcb, uint32_t start_page, uint32_t num_pages) {
     for (uint32_t page = start_page; page < start_page + num_pages; page++) {
         pcb->page_table[page].frame_number = (uint32_t)-1;
@@ -415,10 +675,11 @@ bool process_allocate_memory(PCB* pcb, uint32_t start_page, uint32_t num_pages)
     return true;
 }
 
-// ͷŽռõڴ
+// 释放进程占用的内存
 void process_free_memory(PCB* pcb, uint32_t start_page, uint32_t num_pages) {
     for (uint32_t page = start_page; page < start_page + num_pages; page++) {
         if (page < pcb->page_table_size) {
+            thp_split_page(pcb, page);
             pcb->page_table[page].frame_number = (uint32_t)-1;
             pcb->page_table[page].flags.present = false;
             pcb->page_table[page].flags.swapped = false;
@@ -426,9 +687,18 @@ void process_free_memory(PCB* pcb, uint32_t start_page, uint32_t num_pages) {
     }
 }
 
-// PIDȡ
+// 按进程表槽位获取进程（槽位空闲或进程已终止时返回NULL）
+PCB* get_process_by_index(uint32_t index) {
+    if (index >= MAX_PROCESSES || processes[index].pid == 0 ||
+        processes[index].state == PROCESS_TERMINATED) {
+        return NULL;
+    }
+    return &processes[index];
+}
+
+// 根据PID获取进程
 PCB* get_process_by_pid(uint32_t pid) {
-    for (int i = 0; i < MAX_PROCESSES; i++) {
+    for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
         if (processes[i].pid == pid && processes[i].state != PROCESS_TERMINATED) {
             return &processes[i];
         }
@@ -436,62 +706,63 @@ PCB* get_process_by_pid(uint32_t pid) {
     return NULL;
 }
 
-// ӡͳϢ
+// 打印进程统计信息
 void print_process_stats(PCB* process) {
     if (!process) return;
     
-    printf("\n===  %u ڴʹͳ ===\n", process->pid);
-    printf("\nڴ沼֣\n");
-    printf("Σʼҳ=%u, ҳ=%u, ״̬=%s\n",
+    printf("\n=== 进程 %u 内存使用统计 ===\n", process->pid);
+    printf("\n内存布局：\n");
+    printf("代码段：起始页=%u, 页数=%u, 状态=%s\n",
            process->memory_layout.code.start_page,
            process->memory_layout.code.num_pages,
-           process->memory_layout.code.is_allocated ? "ѷ" : "δ");
-    printf("ݶΣʼҳ=%u, ҳ=%u, ״̬=%s\n",
+           process->memory_layout.code.is_allocated ? "已分配" : "未分配");
+    printf("数据段：起始页=%u, 页数=%u, 状态=%s\n",
            process->memory_layout.data.start_page,
            process->memory_layout.data.num_pages,
-           process->memory_layout.data.is_allocated ? "ѷ" : "δ");
-    printf("ѣʼҳ=%u, ҳ=%u, ״̬=%s\n",
+           process->memory_layout.data.is_allocated ? "已分配" : "未分配");
+    printf("堆：起始页=%u, 页数=%u, 状态=%s\n",
            process->memory_layout.heap.start_page,
            process->memory_layout.heap.num_pages,
-           process->memory_layout.heap.is_allocated ? "ѷ" : "δ");
-    printf("ջʼҳ=%u, ҳ=%u, ״̬=%s\n",
+           process->memory_layout.heap.is_allocated ? "已分配" : "未分配");
+    printf("栈：起始页=%u, 页数=%u, 状态=%s\n",
            process->memory_layout.stack.start_page,
            process->memory_layout.stack.num_pages,
-           process->memory_layout.stack.is_allocated ? "ѷ" : "δ");
+           process->memory_layout.stack.is_allocated ? "已分配" : "未分配");
     
-    printf("\nڴͳƣ\n");
+    printf("\n内存访问统计：\n");
     uint32_t total_accesses = process->stats.mem_stats.total_accesses;
     if (total_accesses > 0) {
-        printf("ηʴ%u (%.1f%%)\n",
+        printf("代码段访问次数：%u次 (%.1f%%)\n",
                process->stats.mem_stats.code_accesses,
                (float)process->stats.mem_stats.code_accesses * 100.0 / total_accesses);
-        printf("ݶηʴ%u (%.1f%%)\n",
+        printf("数据段访问次数：%u次 (%.1f%%)\n",
                process->stats.mem_stats.data_accesses,
                (float)process->stats.mem_stats.data_accesses * 100.0 / total_accesses);
-        printf("ѷʴ%u (%.1f%%)\n",
+        printf("堆访问次数：%u次 (%.1f%%)\n",
                process->stats.mem_stats.heap_accesses,
                (float)process->stats.mem_stats.heap_accesses * 100.0 / total_accesses);
-        printf("ջʴ%u (%.1f%%)\n",
+        printf("栈访问次数：%u次 (%.1f%%)\n",
                process->stats.mem_stats.stack_accesses,
                (float)process->stats.mem_stats.stack_accesses * 100.0 / total_accesses);
     }
     
-    printf("\nҳͳƣ\n");
-    printf("ȱҳ%u\n", process->stats.page_faults);
-    printf("ҳ滻%u\n", process->stats.page_replacements);
-    printf("ҳ滻%u\n", process->stats.pages_swapped_in);
-    printf("ҳ滻%u\n", process->stats.pages_swapped_out);
-    printf("Ӵ̶ȡҳ%u\n", process->stats.mem_stats.reads_from_disk);
+    printf("\n页面统计：\n");
+    printf("缺页次数：%u\n", process->stats.page_faults);
+    printf("页面替换次数：%u\n", process->stats.page_replacements);
+    printf("页面换入次数：%u\n", process->stats.pages_swapped_in);
+    printf("页面换出次数：%u\n", process->stats.pages_swapped_out);
+    printf("从磁盘读取的页数：%u\n", process->stats.mem_stats.reads_from_disk);
+    printf("等待换入的时钟滴答：%u\n", process->stats.io_wait_ticks);
 }
 
-// Ӧó
+// 创建应用程序
 PCB* create_application(const char* name, AppConfig* config) {
     if (!config) return NULL;
     
     PCB* process = (PCB*)malloc(sizeof(PCB));
     if (!process) return NULL;
     
-    // ʼϢ
+    // 初始化进程信息
     process->pid = scheduler.next_pid++;
     strncpy(process->name, name, MAX_PROCESS_NAME - 1);
     process->name[MAX_PROCESS_NAME - 1] = '\0';
@@ -500,7 +771,7 @@ PCB* create_application(const char* name, AppConfig* config) {
     process->time_slice = TIME_SLICE;
     process->next = NULL;
     
-    // ýڴ沼
+    // 设置进程内存布局
     ProcessMemoryLayout proc_layout = {
         .code = {
             .start_page = 0,
@@ -529,40 +800,60 @@ PCB* create_application(const char* name, AppConfig* config) {
         return NULL;
     }
     
-    // ӦóϢ
+    // 设置应用程序信息
     process->app_config = *config;
     
     return process;
 }
 
-// ýڴ沼
+// 设置进程内存布局
 bool setup_process_memory(PCB* process, ProcessMemoryLayout* layout) {
     if (!process || !layout) return false;
     
-    // ҳ
+    // 分配页表
     uint32_t total_pages = layout->code.num_pages + layout->data.num_pages +
                            layout->heap.num_pages + layout->stack.num_pages;
     
-    // ҳ
+    // 分配页表
     process->page_table = (PageTableEntry*)calloc(total_pages, sizeof(PageTableEntry));
     if (!process->page_table) {
         return false;
     }
     process->page_table_size = total_pages;
     
-    // ڴ沼
+    // 设置内存布局
     process->memory_layout = *layout;
     
     return true;
 }
 
-// ؽ
+// 按访问的虚拟页所在的段更新进程的访问统计，不属于代码、数据和栈段的页面计入堆
+void update_process_stats(PCB* process, uint32_t virtual_page) {
+    if (!process) return;
+    
+    const ProcessMemoryLayout* layout = &process->memory_layout;
+    process->stats.mem_stats.total_accesses++;
+    if (virtual_page >= layout->code.start_page &&
+        virtual_page - layout->code.start_page < layout->code.num_pages) {
+        process->stats.mem_stats.code_accesses++;
+    } else if (virtual_page >= layout->data.start_page &&
+               virtual_page - layout->data.start_page < layout->data.num_pages) {
+        process->stats.mem_stats.data_accesses++;
+    } else if (virtual_page >= layout->stack.start_page &&
+               virtual_page - layout->stack.start_page < layout->stack.num_pages) {
+        process->stats.mem_stats.stack_accesses++;
+    } else {
+        process->stats.mem_stats.heap_accesses++;
+    }
+}
+
+// 监控进程
 void monitor_process(PCB* process) {
     if (!process) return;
     
-    printf("\n=== ؽ %u Ϣ ===\n", process->pid);
+    printf("\n=== 监控进程 %u 信息 ===\n", process->pid);
     
-    // ڴʹ
+    // 计算内存使用情况
     uint32_t present_pages = 0;
     uint32_t swapped_pages = 0;
     
@@ -575,93 +866,93 @@ void monitor_process(PCB* process) {
         }
     }
     
-    printf("\nڴʹ\n");
-    printf("ҳ%u\n", process->page_table_size);
-    printf("ڴеҳ%u\n", present_pages);
-    printf("ڴеҳ%u\n", swapped_pages);
+    printf("\n内存使用情况：\n");
+    printf("总页数：%u\n", process->page_table_size);
+    printf("在内存中的页数：%u\n", present_pages);
+    printf("在磁盘中的页数：%u\n", swapped_pages);
     
-    printf("\nڴͳƣ\n");
-    printf("ܷʴ%u\n", process->stats.mem_stats.total_accesses);
-    printf("ηʴ%u\n", process->stats.mem_stats.code_accesses);
-    printf("ݶηʴ%u\n", process->stats.mem_stats.data_accesses);
-    printf("ѷʴ%u\n", process->stats.mem_stats.heap_accesses);
-    printf("ջʴ%u\n", process->stats.mem_stats.stack_accesses);
+    printf("\n内存访问统计：\n");
+    printf("总访问次数：%u\n", process->stats.mem_stats.total_accesses);
+    printf("代码段访问次数：%u\n", process->stats.mem_stats.code_accesses);
+    printf("数据段访问次数：%u\n", process->stats.mem_stats.data_accesses);
+    printf("堆访问次数：%u\n", process->stats.mem_stats.heap_accesses);
+    printf("栈访问次数：%u\n", process->stats.mem_stats.stack_accesses);
     
-    printf("\nҳͳƣ\n");
-    printf("ȱҳ%u\n", process->stats.page_faults);
-    printf("ҳ滻%u\n", process->stats.page_replacements);
-    printf("ҳ滻%u\n", process->stats.pages_swapped_in);
-    printf("ҳ滻%u\n", process->stats.pages_swapped_out);
-    printf("Ӵ̶ȡҳ%u\n", process->stats.mem_stats.reads_from_disk);
+    printf("\n页面统计：\n");
+    printf("缺页次数：%u\n", process->stats.page_faults);
+    printf("页面替换次数：%u\n", process->stats.page_replacements);
+    printf("页面换入次数：%u\n", process->stats.pages_swapped_in);
+    printf("页面换出次数：%u\n", process->stats.pages_swapped_out);
+    printf("从磁盘读取的页数：%u\n", process->stats.mem_stats.reads_from_disk);
     
     if (process->stats.mem_stats.total_accesses > 0) {
         float fault_rate = (float)process->stats.page_faults * 100.0 / 
                           process->stats.mem_stats.total_accesses;
-        printf("\nҳʣ\n");
-        printf("ȱҳʣ%.2f%%\n", fault_rate);
+        printf("\n页面访问率：\n");
+        printf("缺页率：%.2f%%\n", fault_rate);
     }
 }
 
-// ڴʹ
+// 分析内存使用情况
 void analyze_memory_usage(PCB* process) {
     if (!process) return;
     
     uint32_t used_pages = 0;
     uint64_t current_time = get_current_time();
-    uint32_t active_pages = 0;  // ǰԾҳ
+    uint32_t active_pages = 0;  // 当前活跃页数
     
-    // ͳڴʹ
+    // 统计内存使用情况
     for (uint32_t i = 0; i < process->page_table_size; i++) {
         if (process->page_table[i].flags.present) {
             used_pages++;
-            // жǷΪԾҳ1000msڱʹ
+            // 判断是否为活跃页，1000ms内被访问过
             if (current_time - process->page_table[i].last_access_time < 1000) {
                 active_pages++;
             }
         }
     }
     
-    printf("\n===  %u ڴʹ ===\n", process->pid);
-    printf("ҳ%u\n", process->page_table_size);
-    printf("Ծҳ%u (%.1f%%)\n", 
+    printf("\n=== 进程 %u 内存使用情况 ===\n", process->pid);
+    printf("总页数：%u\n", process->page_table_size);
+    printf("活跃页数：%u (%.1f%%)\n", 
            used_pages, 
            (float)used_pages * 100 / process->page_table_size);
-    printf("Ծҳ%u (%.1f%%)\n", 
+    printf("不活跃页数：%u (%.1f%%)\n", 
            active_pages,
            (float)active_pages * 100 / used_pages);
     
-    // ڴͳ
+    // 内存访问统计
     uint32_t total_accesses = process->stats.mem_stats.total_accesses;
     if (total_accesses > 0) {
-        printf("\nڴʷֲ\n");
-        printf("Σ%.1f%%\n", 
+        printf("\n内存访问分布：\n");
+        printf("代码段：%.1f%%\n", 
                (float)process->stats.mem_stats.code_accesses * 100 / total_accesses);
-        printf("ݶΣ%.1f%%\n", 
+        printf("数据段：%.1f%%\n", 
                (float)process->stats.mem_stats.data_accesses * 100 / total_accesses);
-        printf("ѣ%.1f%%\n", 
+        printf("堆：%.1f%%\n", 
                (float)process->stats.mem_stats.heap_accesses * 100 / total_accesses);
-        printf("ջ%.1f%%\n", 
+        printf("栈：%.1f%%\n", 
                (float)process->stats.mem_stats.stack_accesses * 100 / total_accesses);
     }
     
-    // ҳͳ
-    printf("\nҳͳƣ\n");
-    printf("ȱҳ%u\n", process->stats.page_faults);
-    printf("ҳ滻%u\n", process->stats.page_replacements);
+    // 页面访问统计
+    printf("\n页面访问统计：\n");
+    printf("缺页次数：%u\n", process->stats.page_faults);
+    printf("页面替换次数：%u\n", process->stats.page_replacements);
     if (total_accesses > 0) {
-        printf("ȱҳʣ%.2f%%\n", 
+        printf("缺页率：%.2f%%\n", 
                (float)process->stats.page_faults * 100 / total_accesses);
     }
 }
 
-// Żڴ沼
+// 优化内存布局
 void optimize_memory_layout(PCB* process) {
     if (!process) return;
     
-    printf("\n=== ڴ沼Ż ===\n");
-    printf(" %u (%s)\n", process->pid, process->app_config.name);
+    printf("\n=== 内存布局优化 ===\n");
+    printf("进程 %u (%s)\n", process->pid, process->app_config.name);
     
-    // 1. ϲҳ
+    // 1. 合并空闲页
     uint32_t free_start = (uint32_t)-1;
     uint32_t free_count = 0;
     
@@ -672,18 +963,22 @@ void optimize_memory_layout(PCB* process) {
             }
             free_count++;
         } else if (free_count > 0) {
-            printf("ϲҳʼҳ=%uҳ=%u\n", free_start, free_count);
+            printf("合并空闲页，起始页=%u，页数=%u\n", free_start, free_count);
             free_start = (uint32_t)-1;
             free_count = 0;
         }
     }
     
-    // 2. ƶҳ
-    printf("\nƶҳ...\n");
-    // ʵʵҪݾʵ
+    // 2. 整理物理内存：迁移已用页框，使空闲页框集中为连续区域
+    printf("\n整理物理内存...\n");
+    uint32_t fragments = count_memory_fragments();
+    uint32_t largest = largest_free_run();
+    uint32_t migrated = compact_memory(0);
+    printf("迁移页框 %u 个，空闲碎片 %u -> %u，最长连续空闲 %u -> %u 页\n",
+           migrated, fragments, count_memory_fragments(), largest, largest_free_run());
 }
 
-// ƽڴʹ
+// 平衡内存使用
 void balance_memory_usage(void) {
     for (uint32_t pid = 1; pid <= scheduler.next_pid; pid++) {
         PCB* process = get_process_by_pid(pid);
@@ -691,10 +986,10 @@ void balance_memory_usage(void) {
         
         for (uint32_t i = 0; i < process->page_table_size; i++) {
             if (process->page_table[i].flags.present) {
-                // жǷΪδҳ
+                // 判断是否为未分配页
                 uint64_t current_time = get_current_time();
                 if (current_time - process->page_table[i].last_access_time > 1000) {
-                    // Ϊδҳ
+                    // 设置为未分配页
                     // ...
                 }
             }
@@ -702,7 +997,7 @@ void balance_memory_usage(void) {
     }
 }
 
-// ̵ҳ
+// 计算进程的物理页面比例
 float calculate_physical_pages_ratio(PCB* process) {
     if (!process || !process->page_table || process->page_table_size == 0) {
         return 0.0f;
@@ -710,102 +1005,110 @@ float calculate_physical_pages_ratio(PCB* process) {
     
     uint32_t present_pages = 0;
     
-    // ͳڴеҳ
+    // 统计在内存中的页面数
     for (uint32_t i = 0; i < process->page_table_size; i++) {
         if (process->page_table[i].flags.present) {
             present_pages++;
         }
     }
     
-    // 
+    // 计算比例
     return (float)present_pages * 100.0f / process->page_table_size;
 }
 
-// ѡһҳڴ
+// 计算进程的可运行页面比例
+//
+// 驻留的页面和不需要读交换区就能建立的页面（未写入过的按需清零页面、
+// 共享内存段和文件映射的页面）都算可运行，只有已换出的页面需要先调入。
+float calculate_runnable_pages_ratio(PCB* process) {
+    if (!process || !process->page_table || process->page_table_size == 0) {
+        return 0.0f;
+    }
+    
+    uint32_t swapped_pages = 0;
+    for (uint32_t i = 0; i < process->page_table_size; i++) {
+        const PageTableEntry* pte = &process->page_table[i];
+        if (!pte->flags.present && pte->flags.swapped && !pte->flags.shm) {
+            swapped_pages++;
+        }
+    }
+    
+    return (float)(process->page_table_size - swapped_pages) * 100.0f / process->page_table_size;
+}
+
+// 随机选择一个页面调入物理内存
 bool swap_in_random_page(PCB* process) {
     if (!process || !process->page_table) return false;
     
-    // һ洢пɵҳ
+    // 创建一个数组存储所有可调入的页面索引
     uint32_t* swapped_pages = (uint32_t*)malloc(process->page_table_size * sizeof(uint32_t));
     uint32_t swapped_count = 0;
     
-    // ռڽҳ
+    // 收集所有在交换区的页面
     for (uint32_t i = 0; i < process->page_table_size; i++) {
         if (process->page_table[i].flags.swapped && !process->page_table[i].flags.present) {
             swapped_pages[swapped_count++] = i;
         }
     }
     
-    // ûпɵҳ
+    // 如果没有可调入的页面
     if (swapped_count == 0) {
         free(swapped_pages);
         return false;
     }
     
-    // ѡһҳ
+    // 随机选择一个页面
     uint32_t random_index = rand() % swapped_count;
     uint32_t page_to_swap = swapped_pages[random_index];
     
-    // ҳ
-    uint32_t frame = allocate_frame(process->pid, page_to_swap);
-    if (frame == (uint32_t)-1) {
-        // ûпҳҪҳû
-        frame = select_victim_page(process);
-        if (frame == (uint32_t)-1) {
-            free(swapped_pages);
-            return false;
-        }
+    // 通过缺页处理从交换区调入页面内容
+    if (!handle_page_fault(process, page_to_swap, false)) {
+        free(swapped_pages);
+        return false;
     }
     
-    // ҳ
-    process->page_table[page_to_swap].frame_number = frame;
-    process->page_table[page_to_swap].flags.present = true;
-    process->page_table[page_to_swap].flags.swapped = false;
-    process->page_table[page_to_swap].last_access_time = get_current_time();
-    
-    printf(" %u ҳ %u ҳ %u\n", 
-           process->pid, page_to_swap, frame);
+    printf("将进程 %u 的页面 %u 调入物理页框 %u\n", 
+           process->pid, page_to_swap, process->page_table[page_to_swap].frame_number);
     
     free(swapped_pages);
     return true;
 }
 
-// ȷ㹻ҳ
+// 确保进程有足够的物理页框
 bool ensure_minimum_physical_pages(PCB* process) {
-    const float MINIMUM_RATIO = 25.0f;  // Сҳ
     float current_ratio;
     
     do {
-        current_ratio = calculate_physical_pages_ratio(process);
-        printf(" %u ǰҳռ: %.2f%%\n", process->pid, current_ratio);
+        current_ratio = calculate_runnable_pages_ratio(process);
+        printf("进程 %u 当前可运行页面占比: %.2f%%\n", process->pid, current_ratio);
         
-        if (current_ratio >= MINIMUM_RATIO) {
+        if (current_ratio >= MIN_RUNNABLE_PAGES_RATIO) {
             return true;
         }
         
-        // Եһҳ
+        // 尝试调入一个页面
         if (!swap_in_random_page(process)) {
-            printf("棺޷Ϊ %u ҳ\n", process->pid);
+            printf("警告：无法为进程 %u 调入更多页面\n", process->pid);
             return false;
         }
         
-    } while (current_ratio < MINIMUM_RATIO);
+    } while (current_ratio < MIN_RUNNABLE_PAGES_RATIO);
     
     return true;
 }
 
-// н
-void set_running_process(PCB* process) {
-    if (!process) return;
+// 设置运行进程，进程的页面无法调入时返回 false，进程保持原来的状态和队列
+bool set_running_process(PCB* process) {
+    if (!process) return false;
     
-    // ȷ㹻ҳ
-    printf("\n %u ҳռ...\n", process->pid);
+    // 确保进程有足够的物理页框
+    printf("\n检查进程 %u 的物理页框占比...\n", process->pid);
     if (!ensure_minimum_physical_pages(process)) {
-        printf("޷ȷ %u 㹻ҳ޷Ϊ״̬\n", process->pid);
-        return;
+        printf("错误：无法确保进程 %u 有足够的物理页框，无法设置为运行状态\n", process->pid);
+        return false;
     }
     
-    // ھУȽƳ
+    // 如果进程在就绪队列中，先将其移除
     PCB** queue = &scheduler.ready_queue[process->priority];
     if (*queue == process) {
         *queue = process->next;
@@ -819,79 +1122,81 @@ void set_running_process(PCB* process) {
         }
     }
     
-    // ý״̬
+    // 设置进程状态
     process->state = PROCESS_RUNNING;
     process->next = NULL;
+    trace_switch(process->pid);
     scheduler.running_process = process;
     
-    printf(" %u Ϊ״̬\n", process->pid);
+    printf("进程 %u 已设置为运行状态\n", process->pid);
+    return true;
 }
 
-// ӡ״̬
+// 打印进程状态
 void print_process_status(ProcessState state) {
-    printf("״̬");
+    printf("进程状态：");
     switch (state) {
         case PROCESS_NEW:
-            printf("½\n");
+            printf("新建\n");
             break;
         case PROCESS_READY:
-            printf("\n");
+            printf("就绪\n");
             break;
         case PROCESS_RUNNING:
-            printf("\n");
+            printf("运行\n");
             break;
         case PROCESS_BLOCKED:
-            printf("\n");
+            printf("阻塞\n");
             break;
         case PROCESS_TERMINATED:
-            printf("ֹ\n");
+            printf("终止\n");
             break;
         default:
-            printf("δ֪״̬\n");
+            printf("未知状态\n");
             break;
     }
 }
 
-// жϽǷѷ
+// 判断进程是否已分析
 bool is_process_analyzed(PCB* process, PCB** analyzed_list, int analyzed_count) {
     if (!process || !analyzed_list) {
         return false;
     }
     
-    // ѷб
+    // 遍历已分析进程列表
     for (int i = 0; i < analyzed_count; i++) {
         if (analyzed_list[i] == process) {
-            return true;  // ҵ̣ʾѷ
+            return true;  // 找到进程，表示已分配
         }
     }
     
-    return false;  // δҵ̣ʾδ
+    return false;  // 未找到进程，表示未分配
 }
 
-// ʼڴ
+// 初始化进程内存
 void initialize_process_memory(PCB* process) {
     if (!process) return;
     
-    // ֻʼǰ24ҳ
+    // 只初始化前24页
     for (uint32_t i = 0; i < 24; i++) {
-        uint32_t page_num = i + 1;  // 1ʼ0ҳΪ
+        uint32_t page_num = i + 1;  // 从1开始，0页为空
         uint32_t frame = allocate_frame(process->pid, page_num);
         if (frame == (uint32_t)-1) {
-            printf("ҳʧܣ̴ʧ\n");
+            printf("分配页失败，进程创建失败\n");
             return;
         }
         process->page_table[page_num].frame_number = frame;
         process->page_table[page_num].flags.present = true;
     }
-    printf("Ϊ %d  24 ҳڴ\n", process->pid);
+    printf("为进程 %d 分配了 24 页内存\n", process->pid);
 }
 
-// ʼҳ
+// 初始化页表
 void init_page_table(PCB* process, uint32_t size) {
     process->page_table = (PageTableEntry*)calloc(size, sizeof(PageTableEntry));
     process->page_table_size = size;
     
-    // ʼÿҳ
+    // 初始化每页
     for (uint32_t i = 0; i < size; i++) {
         process->page_table[i].frame_number = (uint32_t)-1;
         process->page_table[i].flags.present = false;
@@ -900,71 +1205,40 @@ void init_page_table(PCB* process, uint32_t size) {
     }
 }
 
-// ӽ̵
+// 添加进程到就绪队列
 void add_to_ready_queue(PCB* process) {
     if (!process) return;
     
-    // ѾУҪӵ
+    // 如果进程已经在运行，不要添加到就绪队列
     if (process->state == PROCESS_RUNNING) return;
     
-    // ý״̬Ϊ
+    // 设置进程状态为就绪
     process->state = PROCESS_READY;
     
-    // ӵӦȼľ
+    // 将进程添加到对应优先级的就绪队列
     process->next = scheduler.ready_queue[process->priority];
     scheduler.ready_queue[process->priority] = process;
 }
 
-// 
+// 创建进程
 PCB* create_process(uint32_t priority, uint32_t code_pages, uint32_t data_pages) {
-    printf("\n===  ===\n");
-    printf("ҳ %u (=%u, ݶ=%u)\n", code_pages + data_pages, code_pages, data_pages);
+    printf("\n=== 创建进程 ===\n");
+    printf("代码页数 %u (代码段=%u, 数据段=%u)\n", code_pages + data_pages, code_pages, data_pages);
     uint32_t free_frames = get_free_frames_count();
-    printf("ǰҳ %u\n", free_frames);
+    printf("当前空闲页数 %u\n", free_frames);
     
-    // ҳ
-    uint32_t total_pages = code_pages + data_pages + 10;  // Ԥҳ
+    // 计算总页数
+    uint32_t total_pages = code_pages + data_pages + 10;  // 预分配页数
     if (total_pages > VIRTUAL_PAGES) {
-        printf("ҳ %u ڴҳ %u\n", total_pages, VIRTUAL_PAGES);
+        printf("总页数 %u 超过虚拟内存页数 %u\n", total_pages, VIRTUAL_PAGES);
         return NULL;
     }
     
-    // Ҫҳ25%ҳҪڴУ
-    uint32_t required_frames = (total_pages * 25 + 99) / 100;  // ȡ
-    printf("Ҫҳ%uҳ25%%\n", required_frames);
-    printf("ǰõҳ%u\n", free_frames);
-    
-    if (free_frames < required_frames) {
-        printf("ͨҳûȡҳ...\n");
-        uint32_t frames_needed = required_frames - free_frames;
-        printf("Ҫû %u ҳ\n", frames_needed);
-        
-        // ͨҳûȡ㹻ҳ
-        uint32_t frames_freed = 0;
-        for (uint32_t i = 0; i < frames_needed; i++) {
-            uint32_t victim_frame = select_victim_page(NULL);
-            if (victim_frame != (uint32_t)-1) {
-                frames_freed++;
-                printf("ɹͨûҳ %u\n", victim_frame);
-            } else {
-                printf("ҳûʧܣ޷øҳ\n");
-                break;
-            }
-        }
-        
-        printf("ͨҳû %u ҳ\n", frames_freed);
-        if (frames_freed < frames_needed) {
-            printf("޷㹻ҳҪ %u ֻ %u \n", 
-                   frames_needed, frames_freed);
-            return NULL;
-        }
-    }
-    
-    // ½
+    // 创建新进程
     PCB* new_process = (PCB*)malloc(sizeof(PCB));
     if (!new_process) return NULL;
     
-    // ʼ
+    // 初始化进程
     new_process->pid = scheduler.next_pid++;
     new_process->priority = priority;
     new_process->state = PROCESS_READY;
@@ -974,58 +1248,10 @@ PCB* create_process(uint32_t priority, uint32_t code_pages, uint32_t data_pages)
     new_process->was_preempted = false;
     new_process->next = NULL;
     
-    // ʼҳ
+    // 初始化页表（页面按需清零：创建时不分配页框，首次访问时再映射或分配）
     init_page_table(new_process, total_pages);
     
-    printf("\nʼΪ %u ҳ...\n", new_process->pid);
-    
-    // ҳ
-    bool allocation_failed = false;
-    uint32_t allocated_frames = 0;
-    
-    for (uint32_t i = 0; i < required_frames; i++) {
-        printf("Ϊ %u ҳ %u ҳ\n", 
-               new_process->pid, i);
-        
-        uint32_t frame = allocate_frame(new_process->pid, i);
-        if (frame == (uint32_t)-1) {
-            printf("ֱӷʧܣҳû\n");
-            frame = select_victim_page(NULL);
-            if (frame == (uint32_t)-1) {
-                printf("ҳûʧܣ޷ȡҳ\n");
-                allocation_failed = true;
-                break;
-            }
-            printf("ͨҳûҳ %u\n", frame);
-        }
-        
-        new_process->page_table[i].frame_number = frame;
-        new_process->page_table[i].flags.present = true;
-        allocated_frames++;
-        printf("ɹΪҳ %u ҳ %u\n", i, frame);
-    }
-    
-    printf("ɹ %u ҳҪ %u \n", 
-           allocated_frames, required_frames);
-    
-    if (allocation_failed) {
-        printf("ڴʧܣͷѷԴ\n");
-        // ͷѷҳ
-        for (uint32_t i = 0; i < allocated_frames; i++) {
-            free_frame(new_process->page_table[i].frame_number);
-        }
-        free(new_process->page_table);
-        free(new_process);
-        return NULL;
-    }
-    
-    // ʣҳΪڽ
-    for (uint32_t i = required_frames; i < total_pages; i++) {
-        new_process->page_table[i].flags.swapped = true;
-        new_process->page_table[i].flags.present = false;
-    }
-    
-    // ҵн̲λ
+    // 找到空闲进程槽位
     uint32_t process_index = MAX_PROCESSES;
     for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
         if (processes[i].state == PROCESS_TERMINATED || processes[i].pid == 0) {
@@ -1035,122 +1261,124 @@ PCB* create_process(uint32_t priority, uint32_t code_pages, uint32_t data_pages)
     }
     
     if (process_index == MAX_PROCESSES) {
-        printf("̱޷½\n");
-        // ͷѷҳ
-        for (uint32_t i = 0; i < allocated_frames; i++) {
-            free_frame(new_process->page_table[i].frame_number);
-        }
+        printf("进程表已满，无法创建新进程\n");
         free(new_process->page_table);
         free(new_process);
         return NULL;
     }
     
-    // ƽ̵̱
+    // 复制进程到进程表
     processes[process_index] = *new_process;
     PCB* final_process = &processes[process_index];
     free(new_process);
+    numa_assign_home(final_process);
     
-    // ӵ
+    // 将进程添加到就绪队列
     scheduler.total_processes++;
     add_to_ready_queue(final_process);
     
-    printf("\n %u ɹ\n", final_process->pid);
-    printf("ѷ %u ҳ\n", allocated_frames);
-    printf("ʣ %u ҳڽ\n", total_pages - required_frames);
+    printf("\n进程 %u 创建成功\n", final_process->pid);
+    printf("%u 个页面按需清零，未分配物理页框\n", total_pages);
     
     return final_process;
 }
 
-// ģڴ
+// 模拟进程内存访问
 void simulate_process_memory_access(uint32_t pid, uint32_t access_count) {
     PCB* proc = get_process_by_pid(pid);
     if (!proc) {
-        printf(" %u \n", pid);
+        printf("进程 %u 不存在\n", pid);
         return;
     }
 
-    printf("ʼģ %u ڴʣʴ %u\n", pid, access_count);
+    printf("开始模拟进程 %u 内存访问，访问次数 %u\n", pid, access_count);
     
     for (uint32_t i = 0; i < access_count; i++) {
-        // ѡһҳз
+        // 随机选择一个页面进行访问
         uint32_t page_num = rand() % proc->page_table_size;
         uint32_t offset = rand() % PAGE_SIZE;
         uint32_t addr = page_num * PAGE_SIZE + offset;
         
-        // ѡд
+        // 随机选择读或写
         if (rand() % 2) {
-            // 
+            // 读
             access_memory(proc, addr, false);
-            printf(" %u ȡַ 0x%x\n", pid, addr);
+            printf("进程 %u 读取地址 0x%x\n", pid, addr);
         } else {
-            // д
+            // 写
             access_memory(proc, addr, true);
-            printf(" %u дַ 0x%x\n", pid, addr);
+            printf("进程 %u 写地址 0x%x\n", pid, addr);
+        }
+        
+        // 缺页等待交换区读取，进程阻塞后不再继续访问
+        if (proc->state == PROCESS_BLOCKED) {
+            printf("进程 %u 因缺页阻塞，已完成 %u 次访问\n", pid, i + 1);
+            break;
         }
     }
     
-    printf(" %u ڴģ\n", pid);
+    printf("进程 %u 内存访问模拟完成\n", pid);
 }
 
-// Ϊ̷ڴ
+// 为进程分配内存
 void allocate_process_memory(uint32_t pid, uint32_t size, uint32_t flags) {
     PCB* proc = get_process_by_pid(pid);
     if (!proc) {
-        printf(" %u \n", pid);
+        printf("进程 %u 不存在\n", pid);
         return;
     }
 
-    // Ҫҳ
+    // 需要分配的页数
     uint32_t pages_needed = (size + PAGE_SIZE - 1) / PAGE_SIZE;
     
-    // Ƿ񳬹ҳ
+    // 检查是否超过进程最大页数
     if (proc->page_table_size + pages_needed > MAX_PAGES_PER_PROCESS) {
-        printf("ڴ治㣬޷ %u ҳ\n", pages_needed);
+        printf("内存不足，无法分配 %u 页\n", pages_needed);
         return;
     }
 
-    printf("ʼΪ %u %sڴ棬С %u ֽڣ%u ҳ\n", 
-           pid, flags ? "" : "ݶ", size, pages_needed);
+    printf("开始为进程 %u 分配%s内存，大小 %u 字节，%u 页\n", 
+           pid, flags ? "堆" : "数据段", size, pages_needed);
 
-    // ҳ
+    // 分配页表
     for (uint32_t i = 0; i < pages_needed; i++) {
         uint32_t frame = allocate_frame(pid, proc->page_table_size);
-        if (frame == (uint32_t)-1) {  // ʹ-1ΪЧҳ
-            printf("ڴʧ\n");
+        if (frame == (uint32_t)-1) {  // 使用-1作为无效页框
+            printf("内存分配失败\n");
             return;
         }
         
-        // ҳ
+        // 分配页表项
         proc->page_table[proc->page_table_size].frame_number = frame;
         proc->page_table[proc->page_table_size].flags.present = 1;
         proc->page_table[proc->page_table_size].flags.swapped = 0;
         proc->page_table[proc->page_table_size].last_access_time = get_current_time();
         proc->page_table_size++;
 
-        // ڴ沼״̬
+        // 更新内存布局状态
         if (flags) {
-            // ڴ
+            // 堆内存
             proc->memory_layout.stack.num_pages++;
             proc->memory_layout.stack.is_allocated = true;
         } else {
-            // ݶڴ
+            // 数据段内存
             proc->memory_layout.heap.num_pages++;
             proc->memory_layout.heap.is_allocated = true;
         }
     }
 
-    printf(" %u %sڴ\n", pid, flags ? "" : "ݶ");
+    printf("进程 %u %s内存分配完成\n", pid, flags ? "堆" : "数据段");
 }
 
-// 
+// 创建进程
 PCB* create_process_with_pid(uint32_t pid, uint32_t priority, uint32_t code_pages, uint32_t data_pages) {
-    // IDǷЧ
+    // 检查进程ID是否有效
     if (pid >= MAX_PROCESSES || get_process_by_pid(pid) != NULL) {
-        printf("ЧĽID̴ʧ\n");
+        printf("无效的进程ID，进程创建失败\n");
         return NULL;
     }
     
-    // ȼǷЧ0-2
+    // 检查优先级是否有效（0-2）
     ProcessPriority proc_priority;
     switch(priority) {
         case 0: 
@@ -1163,54 +1391,54 @@ PCB* create_process_with_pid(uint32_t pid, uint32_t priority, uint32_t code_page
             proc_priority = PRIORITY_LOW;
             break;
         default:
-            printf("棺ȼ %u ЧΪȼ\n", priority);
+            printf("警告：优先级 %u 无效，设置为最低优先级\n", priority);
             proc_priority = PRIORITY_LOW;
             break;
     }
     
-    // ҳ
+    // 计算总页数
     uint32_t total_pages = code_pages + data_pages;
     if (total_pages > VIRTUAL_PAGES) {
-        printf("ҳ (%u) ڴС (%u)\n", 
+        printf("虚拟页数 (%u) 超过虚拟内存大小 (%u)\n", 
                total_pages, VIRTUAL_PAGES);
         return NULL;
     }
     
-    // Ƿ㹻Ŀҳ
+    // 检查是否有足够的空闲页框
     uint32_t free_frames = get_free_frames_count();
-    printf("\n===  %u ===\n", pid);
-    printf("ҳ %u (=%u, ݶ=%u)\n", total_pages, code_pages, data_pages);
-    printf("ǰҳ %u\n", free_frames);
+    printf("\n=== 创建进程 %u ===\n", pid);
+    printf("代码页数 %u (代码段=%u, 数据段=%u)\n", total_pages, code_pages, data_pages);
+    printf("当前空闲页数 %u\n", free_frames);
     
     //if (free_frames < MIN(total_pages, PHYSICAL_PAGES/4)) {
-    //    printf("ڴ治㣬޷\n");
+    //    printf("内存不足，进程无法创建\n");
    //     return NULL;
     //}
     
-    // PCB
+    // 创建PCB
     PCB* process = (PCB*)malloc(sizeof(PCB));
     if (!process) {
-        printf("ڴʧ\n");
+        printf("内存分配失败\n");
         return NULL;
     }
     
-    // ʼPCB
-    memset(process, 0, sizeof(PCB));  // ֶ
+    // 初始化PCB
+    memset(process, 0, sizeof(PCB));  // 清零所有字段
     process->pid = pid;
     process->priority = proc_priority;
     process->state = PROCESS_READY;
     process->page_table_size = total_pages;
     process->time_slice = TIME_SLICE;
     
-    // ҳ
+    // 分配页表
     process->page_table = (PageTableEntry*)calloc(total_pages, sizeof(PageTableEntry));
     if (!process->page_table) {
-        printf("ڴʧ\n");
+        printf("内存分配失败\n");
         free(process);
         return NULL;
     }
     
-    // ʼڴ沼
+    // 初始化内存布局
     process->memory_layout.code.start_page = 0;
     process->memory_layout.code.num_pages = code_pages;
     process->memory_layout.code.is_allocated = true;
@@ -1227,83 +1455,27 @@ PCB* create_process_with_pid(uint32_t pid, uint32_t priority, uint32_t code_page
     process->memory_layout.stack.num_pages = 0;
     process->memory_layout.stack.is_allocated = false;
     
-    // ʼͳϢ
+    // 初始化进程统计信息
     memset(&process->stats, 0, sizeof(ProcessStats));
     
-    printf("\n̴\n");
+    printf("\n进程创建完成\n");
     printf("PID: %u\n", process->pid);
-    printf("ȼ: %u\n", process->priority);
-    printf("ڴ沼֣\n");
-    printf("- Σʼҳ=%u, ҳ=%u\n", 
+    printf("优先级: %u\n", process->priority);
+    printf("内存布局：\n");
+    printf("- 代码段：起始页=%u, 页数=%u\n", 
            process->memory_layout.code.start_page,
            process->memory_layout.code.num_pages);
-    printf("- ݶΣʼҳ=%u, ҳ=%u\n",
+    printf("- 数据段：起始页=%u, 页数=%u\n",
            process->memory_layout.data.start_page,
            process->memory_layout.data.num_pages);
     
-    // Ϊ̷ҳ
+    // 页面按需清零：创建时不分配页框，首次读取映射零页框，首次写入才分配
     for (uint32_t i = 0; i < total_pages; i++) {
-        uint32_t frame = allocate_frame(process->pid, i);
-        if (frame == (uint32_t)-1) {
-            frame = select_victim_frame();
-            if (frame == (uint32_t)-1) {
-                printf("޷ѡ滻ҳ̴ʧ\n");
-                // ͷѷҳ
-                for (uint32_t j = 0; j < i; j++) {
-                    free_frame(process->page_table[j].frame_number);
-                }
-                free(process->page_table);
-                free(process);
-                return NULL;
-            }
-            
-            // ȡûҳϢ
-            FrameInfo* victim_frame = &memory_manager.frames[frame];
-            PCB* victim_process = get_process_by_pid(victim_frame->process_id);
-            if (victim_process) {
-                // ҳҪд뽻
-                if (victim_frame->is_dirty) {
-                    if (!swap_out_page(frame)) {
-                        printf("д뽻ʧܣ̴ʧ\n");
-                        // ͷѷҳ
-                        for (uint32_t j = 0; j < i; j++) {
-                            free_frame(process->page_table[j].frame_number);
-                        }
-                        free(process->page_table);
-                        free(process);
-                        return NULL;
-                    }
-                }
-                
-                // ±ûҳҳ
-                PageTableEntry* victim_pte = &victim_process->page_table[victim_frame->virtual_page_num];
-                victim_pte->flags.present = false;
-                victim_pte->flags.swapped = true;
-            }
-            
-            // ͷŲ·ҳ
-            free_frame(frame);
-            frame = allocate_frame(process->pid, i);
-            if (frame == (uint32_t)-1) {
-                printf("·ҳʧܣ̴ʧ\n");
-                // ͷѷҳ
-                for (uint32_t j = 0; j < i; j++) {
-                    free_frame(process->page_table[j].frame_number);
-                }
-                free(process->page_table);
-                free(process);
-                return NULL;
-            }
-        }
-        
-        // ҳ
-        process->page_table[i].frame_number = frame;
-        process->page_table[i].flags.present = true;
-        process->page_table[i].flags.swapped = false;
+        process->page_table[i].frame_number = (uint32_t)-1;
         process->page_table[i].last_access_time = get_current_time();
     }
     
-    // ӵ̱
+    // 将进程添加到进程表
     uint32_t process_index = MAX_PROCESSES;
     for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
         if (processes[i].state == PROCESS_TERMINATED || processes[i].pid == 0) {
@@ -1313,38 +1485,155 @@ PCB* create_process_with_pid(uint32_t pid, uint32_t priority, uint32_t code_page
     }
     
     if (process_index == MAX_PROCESSES) {
-        printf("̱޷½\n");
-        // ͷѷԴ
-        for (uint32_t i = 0; i < total_pages; i++) {
-            free_frame(process->page_table[i].frame_number);
-        }
+        printf("进程表已满，无法创建新进程\n");
+        // 释放已分配的资源
         free(process->page_table);
         free(process);
         return NULL;
     }
     
-    // ƽ̵̱
+    // 复制进程到进程表
     processes[process_index] = *process;
-    PCB* new_process = &processes[process_index];  // ½̵
-    free(process);  // ͷʱPCB
+    PCB* new_process = &processes[process_index];  // 保存新进程的引用
+    free(process);  // 释放临时PCB
+    numa_assign_home(new_process);
     
-    // ӵ
+    // 将进程添加到就绪队列
     scheduler.total_processes++;
     add_to_ready_queue(new_process);
     
-    // ǷҪռǰеĽ
+    // 检查是否需要抢占当前运行的进程
     check_preemption(new_process);
     
     return new_process;
 }
 
-// жǷӦýռ
+// 以写时复制方式复制进程
+PCB* fork_process(uint32_t parent_pid) {
+    PCB* parent = get_process_by_pid(parent_pid);
+    if (!parent) {
+        printf("找不到进程 %u\n", parent_pid);
+        return NULL;
+    }
+    
+    printf("\n=== 复制进程 %u ===\n", parent_pid);
+    
+    // 查找可用的进程ID
+    uint32_t child_pid = 0;
+    for (uint32_t pid = 1; pid < MAX_PROCESSES; pid++) {
+        if (!get_process_by_pid(pid)) {
+            child_pid = pid;
+            break;
+        }
+    }
+    
+    // 查找空闲进程槽位
+    uint32_t process_index = MAX_PROCESSES;
+    for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
+        if (processes[i].state == PROCESS_TERMINATED || processes[i].pid == 0) {
+            process_index = i;
+            break;
+        }
+    }
+    
+    if (child_pid == 0 || process_index == MAX_PROCESSES) {
+        printf("进程表已满，无法复制进程\n");
+        return NULL;
+    }
+    
+    PageTableEntry* page_table = (PageTableEntry*)calloc(parent->page_table_size, sizeof(PageTableEntry));
+    if (!page_table) {
+        printf("内存分配失败\n");
+        return NULL;
+    }
+    
+    // 大页不参与写时复制共享，复制前先拆分为普通页
+    thp_split_process(parent);
+    
+    // 1. 复制页表；已换出的页面与子进程共享交换区块，换入时各自读入私有页框
+    uint32_t swap_shared = 0;
+    for (uint32_t i = 0; i < parent->page_table_size; i++) {
+        page_table[i] = parent->page_table[i];
+        
+        PageTableEntry* pte = &parent->page_table[i];
+        if (pte->flags.present || !pte->flags.swapped || pte->flags.shm) {
+            continue;
+        }
+        swap_block_get(pte->flags.swap_index);
+        swap_shared++;
+    }
+    
+    // 2. 物理页框不复制，父子进程只读共享，首次写入时再复制；
+    //    共享内存段和文件映射的页面保持共享，不设置写时复制
+    if (!shm_fork_attachments(parent_pid, child_pid)) {
+        printf("共享内存挂接记录不足，子进程不挂接共享内存段\n");
+        shm_detach_all(child_pid);
+        for (uint32_t i = 0; i < parent->page_table_size; i++) {
+            if (page_table[i].flags.shm) {
+                page_table[i].flags.shm = false;
+                page_table[i].flags.present = false;
+            }
+        }
+    }
+    if (!pagecache_fork_mappings(parent_pid, child_pid)) {
+        printf("文件映射记录不足，子进程不继承文件映射\n");
+        pagecache_unmap_all(child_pid);
+        for (uint32_t i = 0; i < parent->page_table_size; i++) {
+            if (page_table[i].flags.file) {
+                page_table[i].flags.file = false;
+                page_table[i].flags.present = false;
+            }
+        }
+    }
+    
+    uint32_t shared_frames = 0;
+    for (uint32_t i = 0; i < parent->page_table_size; i++) {
+        if (!page_table[i].flags.present) {
+            continue;
+        }
+        if (!frame_get(parent->page_table[i].frame_number, child_pid, i)) {
+            page_table[i].flags.present = false;
+            continue;
+        }
+        if (!page_table[i].flags.shm && !page_table[i].flags.file) {
+            parent->page_table[i].flags.cow = true;
+            page_table[i].flags.cow = true;
+        }
+        shared_frames++;
+    }
+    
+    // 3. 初始化子进程PCB
+    PCB* child = &processes[process_index];
+    *child = *parent;
+    child->pid = child_pid;
+    child->state = PROCESS_READY;
+    child->time_slice = DEFAULT_TIME_SLICE;
+    child->total_time_slice = DEFAULT_TIME_SLICE;
+    child->wait_time = 0;
+    child->was_preempted = false;
+    child->page_table = page_table;
+    child->next = NULL;
+    memset(&child->stats, 0, sizeof(ProcessStats));
+    child->numa.local_accesses = 0;
+    child->numa.remote_accesses = 0;
+    child->private_frames = 0;
+    
+    scheduler.total_processes++;
+    add_to_ready_queue(child);
+    
+    printf("进程 %u 复制完成，子进程 PID=%u\n", parent_pid, child_pid);
+    printf("共享页框 %u 个，共享交换区块 %u 个\n", shared_frames, swap_shared);
+    
+    return child;
+}
+
+// 判断是否应该进行抢占
 bool should_preempt(PCB* current, PCB* new_proc) {
     if (!current || !new_proc) return false;
-    return new_proc->priority < current->priority;  // ȼԽСȼԽ
+    return new_proc->priority < current->priority;  // 优先级数字越小优先级越高
 }
 
-// ǷҪռ
+// 检查是否需要进程抢占
 void check_preemption(PCB* new_process) {
     if (!new_process || !scheduler.running_process) return;
     
@@ -1353,38 +1642,44 @@ void check_preemption(PCB* new_process) {
     }
 }
 
-// ִнռ
-void preempt_process(PCB* current, PCB* new_proc) {
-    if (!current || !new_proc) return;
+// 执行进程抢占，新进程无法运行时取消抢占，当前进程继续运行
+bool preempt_process(PCB* current, PCB* new_proc) {
+    if (!current || !new_proc) return false;
     
-    printf("\n=== ռ ===\n");
-    printf("ǰн PID %u (ȼ %u)  PID %u (ȼ %u) ռ\n",
+    printf("\n=== 进程抢占 ===\n");
+    printf("当前运行进程 PID %u (优先级 %u) 被进程 PID %u (优先级 %u) 抢占\n",
            current->pid, current->priority, new_proc->pid, new_proc->priority);
     
-    // 浱ǰн̵״̬
+    // 先设置新进程为运行进程，成功后再让出当前进程
+    if (!set_running_process(new_proc)) {
+        printf("进程 %u 无法运行，取消抢占\n", new_proc->pid);
+        return false;
+    }
+    trace_instant(TRACE_PREEMPT, new_proc->pid, current->pid, new_proc->pid, 0);
+    
+    // 保存当前运行进程的状态
     current->was_preempted = true;
     current->state = PROCESS_READY;
-    current->next = NULL;  // nextָ룬ֹ
+    current->next = NULL;  // 清除next指针，防止链表混乱
     
-    // ռ̼
+    // 将被抢占进程加入就绪队列
     add_to_ready_queue(current);
     
-    // ½Ϊн
-    set_running_process(new_proc);
-    
-    printf("л\n");
-    printf("ռ PID %u Ѽȼ %u \n", 
+    printf("进程切换完成\n");
+    printf("被抢占进程 PID %u 已加入优先级 %u 就绪队列\n", 
            current->pid, current->priority);
+    return true;
 }
 
-// ָռĽ
+// 恢复被抢占的进程
 void restore_preempted_process(PCB* process) {
     if (!process || !process->was_preempted) return;
     
-    printf("\n=== ָռ ===\n");
-    printf("ָ PID %u (ȼ %u)\n", process->pid, process->priority);
+    printf("\n=== 恢复被抢占进程 ===\n");
+    printf("恢复进程 PID %u (优先级 %u)\n", process->pid, process->priority);
     
     process->was_preempted = false;
     process->state = PROCESS_RUNNING;
+    trace_switch(process->pid);
     scheduler.running_process = process;
 }
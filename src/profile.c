@@ -0,0 +1,401 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../include/profile.h"
+#include "../include/memory.h"
+#include "../include/process.h"
+
+// 正在剖析的进程
+static ProcessProfile profiles[PROFILE_MAX_PROCESSES];
+
+static ProcessProfile* find_profile(uint32_t pid) {
+    for (uint32_t i = 0; i < PROFILE_MAX_PROCESSES; i++) {
+        if (profiles[i].active && profiles[i].pid == pid) {
+            return &profiles[i];
+        }
+    }
+    return NULL;
+}
+
+static void release_profile(ProcessProfile* profile) {
+    free(profile->access_counts);
+    free(profile->last_time);
+    free(profile->tree);
+    free(profile->histogram);
+    memset(profile, 0, sizeof(ProcessProfile));
+}
+
+// 清除所有剖析（系统重置、恢复快照时调用）
+void profile_init(void) {
+    for (uint32_t i = 0; i < PROFILE_MAX_PROCESSES; i++) {
+        if (profiles[i].active) {
+            release_profile(&profiles[i]);
+        }
+    }
+}
+
+// 树状数组：位置 index 加 delta
+static void tree_add(ProcessProfile* profile, uint32_t index, int32_t delta) {
+    for (; index <= profile->tree_size; index += index & (0u - index)) {
+        profile->tree[index] += (uint32_t)delta;
+    }
+}
+
+// 树状数组：位置 1..index 的和
+static uint32_t tree_sum(const ProcessProfile* profile, uint32_t index) {
+    uint32_t sum = 0;
+    for (; index > 0; index &= index - 1) {
+        sum += profile->tree[index];
+    }
+    return sum;
+}
+
+typedef struct {
+    uint32_t time;
+    uint32_t page;
+} TimedPage;
+
+static int compare_time(const void* a, const void* b) {
+    uint32_t ta = ((const TimedPage*)a)->time;
+    uint32_t tb = ((const TimedPage*)b)->time;
+    return (ta > tb) - (ta < tb);
+}
+
+/**
+ * @brief 时间戳窗口用尽时按最近访问顺序重新编号
+ *
+ * 树状数组中只有各页面最近一次访问的位置为 1，重新编号为 1..distinct_pages
+ * 不改变任何区间内的页面数。窗口至少是页数的4倍，均摊到每次访问为 O(log n)。
+ */
+static void renumber(ProcessProfile* profile) {
+    TimedPage* order = (TimedPage*)malloc(sizeof(TimedPage) * (profile->distinct_pages + 1));
+    if (!order) {
+        return;
+    }
+    uint32_t count = 0;
+    for (uint32_t page = 0; page < profile->pages; page++) {
+        if (profile->last_time[page] != 0) {
+            order[count].time = profile->last_time[page];
+            order[count].page = page;
+            count++;
+        }
+    }
+    qsort(order, count, sizeof(TimedPage), compare_time);
+
+    memset(profile->tree, 0, sizeof(uint32_t) * (profile->tree_size + 1));
+    for (uint32_t i = 0; i < count; i++) {
+        profile->last_time[order[i].page] = i + 1;
+        tree_add(profile, i + 1, 1);
+    }
+    profile->clock = count;
+    profile->renumbers++;
+    free(order);
+}
+
+/**
+ * @brief 开始剖析进程的内存访问
+ *
+ * 已在剖析时重新开始。
+ */
+bool profile_start(uint32_t pid) {
+    PCB* process = get_process_by_pid(pid);
+    if (!process || !process->page_table) {
+        printf("错误：进程 %u 不存在\n", pid);
+        return false;
+    }
+
+    ProcessProfile* profile = find_profile(pid);
+    if (profile) {
+        release_profile(profile);
+    } else {
+        for (uint32_t i = 0; i < PROFILE_MAX_PROCESSES && !profile; i++) {
+            if (!profiles[i].active) {
+                profile = &profiles[i];
+            }
+        }
+        if (!profile) {
+            printf("错误：最多同时剖析 %u 个进程\n", PROFILE_MAX_PROCESSES);
+            return false;
+        }
+    }
+
+    uint32_t pages = process->page_table_size;
+    profile->pages = pages;
+    profile->tree_size = pages * 4 < 64 ? 64 : pages * 4;
+    profile->access_counts = (uint32_t*)calloc(pages, sizeof(uint32_t));
+    profile->last_time = (uint32_t*)calloc(pages, sizeof(uint32_t));
+    profile->tree = (uint32_t*)calloc((size_t)profile->tree_size + 1, sizeof(uint32_t));
+    profile->histogram = (uint32_t*)calloc(pages, sizeof(uint32_t));
+    if (!profile->access_counts || !profile->last_time || !profile->tree || !profile->histogram) {
+        release_profile(profile);
+        printf("错误：剖析数据分配失败\n");
+        return false;
+    }
+    profile->active = true;
+    profile->pid = pid;
+    profile->start_faults = process->stats.page_faults;
+    printf("开始剖析进程 %u 的内存访问（%u 页）\n", pid, pages);
+    return true;
+}
+
+bool profile_stop(uint32_t pid) {
+    ProcessProfile* profile = find_profile(pid);
+    if (!profile) {
+        printf("进程 %u 没有在剖析\n", pid);
+        return false;
+    }
+    release_profile(profile);
+    printf("停止剖析进程 %u\n", pid);
+    return true;
+}
+
+// 进程退出时丢弃它的剖析
+void profile_forget(uint32_t pid) {
+    ProcessProfile* profile = find_profile(pid);
+    if (profile) {
+        release_profile(profile);
+    }
+}
+
+/**
+ * @brief 记录一次访问：更新页面访问次数和重用距离分布
+ *
+ * 在缺页处理之前调用，缺页与命中的访问都计入。
+ */
+void profile_record_access(PCB* process, uint32_t virtual_page) {
+    ProcessProfile* profile = process ? find_profile(process->pid) : NULL;
+    if (!profile || virtual_page >= profile->pages) {
+        return;
+    }
+
+    profile->accesses++;
+    profile->access_counts[virtual_page]++;
+    if (profile->clock >= profile->tree_size) {
+        renumber(profile);
+    }
+
+    uint32_t previous = profile->last_time[virtual_page];
+    if (previous == 0) {
+        profile->cold_misses++;
+        profile->distinct_pages++;
+    } else {
+        // 上次访问之后又访问过的不同页面数
+        uint32_t distance = profile->distinct_pages - tree_sum(profile, previous);
+        profile->histogram[distance]++;
+        tree_add(profile, previous, -1);
+    }
+
+    uint32_t now = ++profile->clock;
+    tree_add(profile, now, 1);
+    profile->last_time[virtual_page] = now;
+}
+
+// 重用距离不小于 frames 的访问在 frames 个页框的 LRU 下都会缺页，首次访问总会缺页
+static uint64_t predicted_misses(const ProcessProfile* profile, uint32_t frames) {
+    uint64_t misses = profile->cold_misses;
+    for (uint32_t d = frames; d < profile->pages; d++) {
+        misses += profile->histogram[d];
+    }
+    return misses;
+}
+
+uint64_t profile_predicted_misses(uint32_t pid, uint32_t frames) {
+    ProcessProfile* profile = find_profile(pid);
+    return profile ? predicted_misses(profile, frames) : 0;
+}
+
+static double rate_of(uint64_t count, uint64_t total) {
+    return total ? (double)count * 100.0 / total : 0.0;
+}
+
+/**
+ * @brief 打印重用距离分布和缺页率曲线
+ *
+ * @param pid 进程ID
+ * @param target_rate 目标缺页率（百分比），给出达到它所需的最少页框数；
+ *                    0 表示取比最低缺页率（只剩首次访问）高 1 个百分点以内
+ */
+void print_profile(uint32_t pid, double target_rate) {
+    ProcessProfile* profile = find_profile(pid);
+    if (!profile) {
+        printf("进程 %u 没有在剖析（用 profile start <pid> 开始）\n", pid);
+        return;
+    }
+    uint64_t total = profile->accesses;
+
+    printf("\n=== 进程 %u 访问剖析 ===\n", pid);
+    printf("访问次数: %llu，访问过的页面: %u，首次访问: %llu\n", (unsigned long long)total,
+           profile->distinct_pages, (unsigned long long)profile->cold_misses);
+    if (total == 0) {
+        return;
+    }
+
+    // 重用距离按2的幂分组
+    printf("\n重用距离（LRU 栈距离）分布:\n");
+    printf("  距离            次数      占比\n");
+    for (uint32_t low = 0; low < profile->pages; low = low ? low * 2 : 1) {
+        uint32_t high = low ? low * 2 - 1 : 0;
+        uint64_t count = 0;
+        for (uint32_t d = low; d <= high && d < profile->pages; d++) {
+            count += profile->histogram[d];
+        }
+        if (count == 0) {
+            continue;
+        }
+        char range[32];
+        if (low == high) {
+            snprintf(range, sizeof(range), "%u", low);
+        } else {
+            snprintf(range, sizeof(range), "%u-%u", low, high);
+        }
+        printf("  %-12s %8llu  %7.2f%%\n", range, (unsigned long long)count, rate_of(count, total));
+    }
+    printf("  %-12s %8llu  %7.2f%%\n", "首次访问", (unsigned long long)profile->cold_misses,
+           rate_of(profile->cold_misses, total));
+
+    // 页框数超过访问过的页面数后缺页率不再下降
+    uint32_t max_frames = profile->distinct_pages;
+    printf("\n缺页率曲线（进程独占 N 个页框、按 LRU 置换时的预测缺页率）:\n");
+    printf("  页框数      缺页次数    缺页率\n");
+    uint32_t last = 0;
+    for (uint32_t i = 1; i <= PROFILE_MRC_POINTS; i++) {
+        uint32_t frames = (uint32_t)(((uint64_t)max_frames * i + PROFILE_MRC_POINTS - 1) / PROFILE_MRC_POINTS);
+        if (frames == 0 || frames == last) {
+            continue;
+        }
+        last = frames;
+        uint64_t misses = predicted_misses(profile, frames);
+        printf("  %6u  %12llu  %7.2f%%\n", frames, (unsigned long long)misses, rate_of(misses, total));
+    }
+
+    double floor_rate = rate_of(profile->cold_misses, total);
+    double goal = target_rate > 0 ? target_rate : floor_rate + 1.0;
+    uint32_t needed = 0;
+    uint64_t misses = predicted_misses(profile, 1);
+    for (uint32_t frames = 1; frames <= max_frames; frames++) {
+        if (rate_of(misses, total) <= goal) {
+            needed = frames;
+            break;
+        }
+        if (frames < profile->pages) {
+            misses -= profile->histogram[frames];  // 多一个页框，重用距离为 frames 的访问变为命中
+        }
+    }
+    if (needed) {
+        printf("\n缺页率降到 %.2f%% 以下所需的最少页框数: %u（%llu KB）\n",
+               goal, needed, (unsigned long long)needed * PAGE_SIZE >> 10);
+    } else {
+        printf("\n缺页率无法降到 %.2f%%（最低为首次访问的 %.2f%%）\n", goal, floor_rate);
+    }
+
+    // 与实际运行对照：按当前驻留页框数预测
+    PCB* process = get_process_by_pid(pid);
+    if (process) {
+        uint32_t resident = get_process_resident_pages(process);
+        uint64_t predicted = predicted_misses(profile, resident);
+        uint32_t actual = process->stats.page_faults - profile->start_faults;
+        printf("当前驻留 %u 页：预测缺页率 %.2f%%，实际缺页 %u 次（%.2f%%）\n",
+               resident, rate_of(predicted, total), actual, rate_of(actual, total));
+    }
+    if (profile->renumbers) {
+        printf("时间戳重新编号 %u 次\n", profile->renumbers);
+    }
+}
+
+// 数值的二进制位数
+static uint32_t bit_length(uint32_t value) {
+    uint32_t bits = 0;
+    while (value) {
+        bits++;
+        value >>= 1;
+    }
+    return bits;
+}
+
+/**
+ * @brief 打印每页访问次数的热度图
+ *
+ * 每行 PROFILE_HEATMAP_WIDTH 页，字符按访问次数的对数分级，空格表示没有访问，
+ * 整行都没有访问的行省略。
+ */
+void print_profile_heatmap(uint32_t pid) {
+    static const char levels[] = " .:-=+*#%@";
+    ProcessProfile* profile = find_profile(pid);
+    if (!profile) {
+        printf("进程 %u 没有在剖析（用 profile start <pid> 开始）\n", pid);
+        return;
+    }
+
+    uint32_t max_count = 0;
+    for (uint32_t page = 0; page < profile->pages; page++) {
+        if (profile->access_counts[page] > max_count) {
+            max_count = profile->access_counts[page];
+        }
+    }
+    printf("\n=== 进程 %u 页面访问热度图 ===\n", pid);
+    if (max_count == 0) {
+        printf("还没有访问\n");
+        return;
+    }
+    uint32_t max_bits = bit_length(max_count);
+    printf("每个字符一页，'%c' 为 1 次，'%c' 为 %u 次（按对数分级）\n", levels[1], levels[9], max_count);
+
+    char row[PROFILE_HEATMAP_WIDTH + 1];
+    for (uint32_t start = 0; start < profile->pages; start += PROFILE_HEATMAP_WIDTH) {
+        bool touched = false;
+        uint32_t width = 0;
+        for (uint32_t page = start; page < profile->pages && width < PROFILE_HEATMAP_WIDTH; page++, width++) {
+            uint32_t count = profile->access_counts[page];
+            uint32_t level = 0;
+            if (count > 0) {
+                level = max_bits > 1 ? 1 + (bit_length(count) - 1) * 8 / (max_bits - 1) : 9;
+                touched = true;
+            }
+            row[width] = levels[level];
+        }
+        row[width] = '\0';
+        if (touched) {
+            printf("0x%08x |%s|\n", start << PAGE_SHIFT, row);
+        }
+    }
+
+    // 访问最多的页面
+    printf("\n访问最多的页面:\n");
+    uint32_t shown[PROFILE_TOP_PAGES];
+    uint32_t shown_count = 0;
+    while (shown_count < PROFILE_TOP_PAGES) {
+        uint32_t best = (uint32_t)-1;
+        for (uint32_t page = 0; page < profile->pages; page++) {
+            bool taken = false;
+            for (uint32_t j = 0; j < shown_count; j++) {
+                taken = taken || shown[j] == page;
+            }
+            if (!taken && profile->access_counts[page] > 0 &&
+                (best == (uint32_t)-1 || profile->access_counts[page] > profile->access_counts[best])) {
+                best = page;
+            }
+        }
+        if (best == (uint32_t)-1) {
+            break;
+        }
+        shown[shown_count++] = best;
+        printf("  页 %-6u (0x%08x)  %u 次\n", best, best << PAGE_SHIFT, profile->access_counts[best]);
+    }
+}
+
+// 列出正在剖析的进程
+void print_profile_list(void) {
+    printf("\n=== 访问剖析 ===\n");
+    bool any = false;
+    for (uint32_t i = 0; i < PROFILE_MAX_PROCESSES; i++) {
+        if (!profiles[i].active) {
+            continue;
+        }
+        any = true;
+        printf("进程 %u：%u 页，访问 %llu 次，访问过的页面 %u\n", profiles[i].pid, profiles[i].pages,
+               (unsigned long long)profiles[i].accesses, profiles[i].distinct_pages);
+    }
+    if (!any) {
+        printf("没有正在剖析的进程\n");
+    }
+}
@@ -0,0 +1,401 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include "../include/selftest.h"
+#include "../include/config.h"
+#include "../include/memory.h"
+#include "../include/process.h"
+#include "../include/vm.h"
+#include "../include/shm.h"
+#include "../include/ksm.h"
+#include "../include/thp.h"
+#include "../include/tlb.h"
+#include "../include/compact.h"
+#include "../include/profile.h"
+#include "../include/pagecache.h"
+#include "../include/swapio.h"
+#include "../include/dump.h"
+
+// 检查条件，不满足时打印位置并结束当前场景
+#define SCENARIO_CHECK(cond, what) do { \
+        if (!(cond)) { \
+            printf("  检查失败：%s（%s:%d）\n", what, __FILE__, __LINE__); \
+            return false; \
+        } \
+    } while (0)
+
+// 一个场景：从重置后的系统开始，返回是否通过
+typedef struct {
+    const char* name;
+    bool (*run)(void);
+} Scenario;
+
+// 与 state reset 命令相同：丢弃所有进程和内存状态
+static void reset_system(void) {
+    dump_forget_checkpoint();
+    scheduler_shutdown();
+    vm_shutdown();
+    memory_init();
+    vm_init();
+    shm_init();
+    ksm_init();
+    thp_init();
+    tlb_init();
+    compact_init();
+    profile_init();
+    pagecache_init();
+    scheduler_init();
+}
+
+// 时钟滴答直到进程运行，最多 max_ticks 个滴答
+static bool tick_until_running(PCB* process, uint32_t max_ticks) {
+    for (uint32_t i = 0; i < max_ticks; i++) {
+        time_tick();
+        if (scheduler.running_process == process) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 新建的进程没有驻留页面（按需清零），时钟滴答后应被调度运行
+static bool scenario_new_process_runs(void) {
+    PCB* process = create_process_with_pid(1, PRIORITY_HIGH, 16, 16);
+    SCENARIO_CHECK(process != NULL, "创建进程");
+    SCENARIO_CHECK(calculate_physical_pages_ratio(process) == 0.0f, "新进程没有驻留页面");
+
+    SCENARIO_CHECK(tick_until_running(process, 3), "进程在 3 个滴答内开始运行");
+    SCENARIO_CHECK(process->state == PROCESS_RUNNING, "进程状态为运行");
+    return true;
+}
+
+// 进程因同步换入阻塞，阻塞期间页框被换出，唤醒后应重新运行
+static bool scenario_blocked_process_runs_again(void) {
+    const uint32_t first = 16, last = 20;   // 数据段的前几页
+    PCB* process = create_process_with_pid(1, PRIORITY_HIGH, 16, 16);
+    SCENARIO_CHECK(process != NULL, "创建进程");
+    SCENARIO_CHECK(tick_until_running(process, 3), "进程开始运行");
+    SCENARIO_CHECK(scheduler.fault_service_ticks != 0, "缺页服务需要时钟滴答");
+
+    for (uint32_t page = first; page < last; page++) {
+        access_memory(process, page * PAGE_SIZE, true);
+        SCENARIO_CHECK(process->page_table[page].flags.present, "写入后页面驻留");
+        // 写入非零内容，否则全零页面不写交换区
+        uint8_t* data = (uint8_t*)get_physical_address(process->page_table[page].frame_number);
+        SCENARIO_CHECK(data != NULL, "取得页框地址");
+        data[0] = (uint8_t)page;
+    }
+    SCENARIO_CHECK(swap_out_page(process->page_table[first].frame_number), "换出页面");
+    SCENARIO_CHECK(process->page_table[first].flags.swapped, "页面在交换区中");
+
+    // 同步换入后进程阻塞到缺页服务完成
+    access_memory(process, first * PAGE_SIZE, false);
+    SCENARIO_CHECK(process->state == PROCESS_BLOCKED, "换入后进程阻塞");
+    SCENARIO_CHECK(scheduler.running_process == NULL, "没有运行的进程");
+
+    // 阻塞期间所有页框被其他进程抢走
+    for (uint32_t page = first; page < last; page++) {
+        if (process->page_table[page].flags.present) {
+            SCENARIO_CHECK(swap_out_page(process->page_table[page].frame_number), "换出阻塞进程的页面");
+        }
+    }
+
+    // 唤醒时刻已定；之后的同步换入不再阻塞，进程运行后不会因模拟访问再次阻塞
+    uint32_t service_ticks = scheduler.fault_service_ticks;
+    set_fault_service_ticks(0);
+    SCENARIO_CHECK(tick_until_running(process, service_ticks + 3), "唤醒后重新运行");
+    SCENARIO_CHECK(process->state == PROCESS_RUNNING, "进程状态为运行");
+
+    // 被抢走的页面重新换入后内容不变
+    for (uint32_t page = first; page < last; page++) {
+        access_memory(process, page * PAGE_SIZE, false);
+        swapio_finish_fault(process, page);
+        SCENARIO_CHECK(process->page_table[page].flags.present, "页面重新驻留");
+        uint8_t* data = (uint8_t*)get_physical_address(process->page_table[page].frame_number);
+        SCENARIO_CHECK(data != NULL && data[0] == (uint8_t)page, "页面内容不变");
+    }
+    return true;
+}
+
+// 被所有进程写时复制共享的页框换出后，每个映射都失效并指向交换区
+static bool scenario_shared_frame_evicted(void) {
+    const uint32_t page = 16;
+    PCB* parent = create_process_with_pid(1, PRIORITY_HIGH, 16, 16);
+    SCENARIO_CHECK(parent != NULL, "创建进程");
+    access_memory(parent, page * PAGE_SIZE, true);
+    uint32_t frame = parent->page_table[page].frame_number;
+    uint8_t* data = (uint8_t*)get_physical_address(frame);
+    SCENARIO_CHECK(data != NULL, "取得页框地址");
+    data[0] = 0x5a;
+
+    // 复制进程直到进程表填满，映射数随 max_processes 增长
+    uint32_t children = 0;
+    while (fork_process(parent->pid)) {
+        children++;
+    }
+    SCENARIO_CHECK(children > 0, "复制进程");
+    SCENARIO_CHECK(memory_manager.frames[frame].ref_count == children + 1, "所有进程共享页框");
+
+    // 页面只写一次，所有映射共享一个交换区块
+    uint32_t free_blocks = vm_manager.swap_free_blocks;
+    SCENARIO_CHECK(swap_out_page(frame), "换出共享页框");
+    SCENARIO_CHECK(vm_manager.swap_free_blocks == free_blocks - 1, "只占用一个交换区块");
+    uint32_t swap_index = parent->page_table[page].flags.swap_index;
+    SCENARIO_CHECK(vm_manager.swap_blocks[swap_index].ref_count == children + 1, "交换区块引用数等于映射数");
+    for (uint32_t pid = 1; pid < MAX_PROCESSES; pid++) {
+        PCB* process = get_process_by_pid(pid);
+        if (process) {
+            SCENARIO_CHECK(!process->page_table[page].flags.present, "映射已失效");
+            SCENARIO_CHECK(process->page_table[page].flags.swapped &&
+                           process->page_table[page].flags.swap_index == swap_index, "映射指向共享的交换区块");
+        }
+    }
+
+    // 每个映射换入时释放一个引用，最后一个引用释放时回收块
+    access_memory(parent, page * PAGE_SIZE, false);
+    swapio_finish_fault(parent, page);
+    data = (uint8_t*)get_physical_address(parent->page_table[page].frame_number);
+    SCENARIO_CHECK(data != NULL && data[0] == 0x5a, "换入后内容不变");
+    SCENARIO_CHECK(vm_manager.swap_blocks[swap_index].ref_count == children, "换入释放一个引用");
+    for (uint32_t pid = 2; pid < MAX_PROCESSES; pid++) {
+        if (get_process_by_pid(pid)) {
+            process_destroy(get_process_by_pid(pid));
+        }
+    }
+    SCENARIO_CHECK(!vm_manager.swap_blocks[swap_index].is_used, "最后一个引用释放后回收块");
+    SCENARIO_CHECK(vm_manager.swap_free_blocks == free_blocks, "交换区块全部归还");
+    return true;
+}
+
+// 交换区已满时，脏页无法换出，置换改选不需要交换区块的全零页面
+static bool scenario_eviction_falls_back(void) {
+    const uint32_t dirty_pages = 3, data_pages = 64;
+    PCB* process = create_process_with_pid(1, PRIORITY_HIGH, 16, data_pages);
+    SCENARIO_CHECK(process != NULL, "创建进程");
+
+    // 最久未访问的几个页面有内容，之后写入的页面内容全零，直到页框用完
+    uint32_t page = 16;
+    for (; page < 16 + dirty_pages; page++) {
+        access_memory(process, page * PAGE_SIZE, true);
+        ((uint8_t*)get_physical_address(process->page_table[page].frame_number))[0] = 0x5a;
+    }
+    PCB* filler = process;
+    for (uint32_t pid = 2; memory_manager.free_frames_count > 0; ) {
+        if (page == 16 + data_pages) {
+            filler = create_process_with_pid(pid++, PRIORITY_LOW, 16, data_pages);
+            SCENARIO_CHECK(filler != NULL, "创建填充页框的进程");
+            page = 16;
+        }
+        access_memory(filler, page * PAGE_SIZE, true);
+        page++;
+    }
+    SCENARIO_CHECK(memory_manager.free_frames_count == 0, "页框已用完");
+    if (page == 16 + data_pages) {
+        filler = create_process_with_pid(filler->pid + 1, PRIORITY_LOW, 16, data_pages);
+        SCENARIO_CHECK(filler != NULL, "创建缺页的进程");
+        page = 16;
+    }
+
+    // 占满交换区
+    while (allocate_swap_block(0, 0) != (uint32_t)-1) {
+    }
+    SCENARIO_CHECK(vm_manager.swap_free_blocks == 0, "交换区已满");
+
+    access_memory(filler, page * PAGE_SIZE, true);
+    SCENARIO_CHECK(filler->page_table[page].flags.present, "改选其他牺牲页框后缺页成功");
+    for (uint32_t i = 16; i < 16 + dirty_pages; i++) {
+        SCENARIO_CHECK(process->page_table[i].flags.present, "无法换出的页面保持驻留");
+        SCENARIO_CHECK(!memory_manager.frames[process->page_table[i].frame_number].is_swapping,
+                       "跳过的页框已解除锁定");
+    }
+    return true;
+}
+
+// 被所有进程共享的页框迁移后，每个映射都指向新页框
+static bool scenario_shared_frame_migrated(void) {
+    const uint32_t page = 16;
+    PCB* parent = create_process_with_pid(1, PRIORITY_HIGH, 16, 16);
+    SCENARIO_CHECK(parent != NULL, "创建进程");
+    access_memory(parent, page * PAGE_SIZE, true);
+    uint32_t src = parent->page_table[page].frame_number;
+    ((uint8_t*)get_physical_address(src))[0] = 0x5a;
+
+    uint32_t children = 0;
+    while (fork_process(parent->pid)) {
+        children++;
+    }
+    SCENARIO_CHECK(children > 0, "复制进程");
+
+    uint32_t dst = (uint32_t)-1;
+    for (uint32_t frame = 0; frame < PHYSICAL_PAGES && dst == (uint32_t)-1; frame++) {
+        if (!memory_manager.frames[frame].is_allocated) {
+            dst = frame;
+        }
+    }
+    SCENARIO_CHECK(dst != (uint32_t)-1, "找到空闲页框");
+    SCENARIO_CHECK(compact_frame_movable(src), "共享页框可迁移");
+    SCENARIO_CHECK(compact_migrate_frame(src, dst), "迁移共享页框");
+    SCENARIO_CHECK(memory_manager.frames[dst].ref_count == children + 1, "引用计数随页框迁移");
+    SCENARIO_CHECK(count_frame_mappings(dst) == children + 1, "反向映射随页框迁移");
+
+    for (uint32_t pid = 1; pid < MAX_PROCESSES; pid++) {
+        PCB* process = get_process_by_pid(pid);
+        if (process) {
+            SCENARIO_CHECK(process->page_table[page].flags.present &&
+                           process->page_table[page].frame_number == dst, "映射指向新页框");
+        }
+    }
+    SCENARIO_CHECK(((uint8_t*)get_physical_address(dst))[0] == 0x5a, "迁移后内容不变");
+    return true;
+}
+
+// 改写快照文件中页框数据段的一个字节：in_table 为真时改记录表，否则改页面数据
+static bool corrupt_frame_section(const char* path, bool in_table) {
+    FILE* fp = fopen(path, "r+b");
+    if (!fp) {
+        return false;
+    }
+    SnapshotFileHeader header;
+    SnapshotSection sections[SNAPSHOT_MAX_SECTIONS];
+    bool ok = fread(&header, sizeof(header), 1, fp) == 1 && header.section_count <= SNAPSHOT_MAX_SECTIONS &&
+              fread(sections, sizeof(SnapshotSection), header.section_count, fp) == header.section_count;
+    long offset = -1;
+    for (uint32_t i = 0; ok && i < header.section_count; i++) {
+        size_t table_size = sizeof(SnapshotPageRecord) * sections[i].item_count;
+        if (sections[i].type == SECTION_FRAME_DATA && sections[i].stored_size > table_size) {
+            offset = (long)(sections[i].offset + (in_table ? 0 : table_size));
+        }
+    }
+    uint8_t byte;
+    ok = ok && offset >= 0 && fseek(fp, offset, SEEK_SET) == 0 && fread(&byte, 1, 1, fp) == 1;
+    byte ^= 0xff;
+    ok = ok && fseek(fp, offset, SEEK_SET) == 0 && fwrite(&byte, 1, 1, fp) == 1;
+    fclose(fp);
+    return ok;
+}
+
+// 损坏的快照恢复失败时，当前系统保持不变
+static bool scenario_corrupt_restore_keeps_state(void) {
+    const char* path = "selftest_snapshot.bin";
+    const uint32_t page = 16;
+    PCB* process = create_process_with_pid(1, PRIORITY_HIGH, 16, 16);
+    SCENARIO_CHECK(process != NULL, "创建进程");
+    access_memory(process, page * PAGE_SIZE, true);
+    uint32_t frame = process->page_table[page].frame_number;
+    ((uint8_t*)get_physical_address(frame))[0] = 0x5a;
+
+    for (int in_table = 0; in_table < 2; in_table++) {
+        SCENARIO_CHECK(dump_system_state(path), "保存快照");
+        SCENARIO_CHECK(corrupt_frame_section(path, in_table != 0), "改写快照文件");
+        uint32_t free_frames = memory_manager.free_frames_count;
+
+        SCENARIO_CHECK(!restore_system_state(path), "损坏的快照恢复失败");
+        SCENARIO_CHECK(get_process_by_pid(1) == process, "进程仍然存在");
+        SCENARIO_CHECK(process->page_table[page].flags.present &&
+                       process->page_table[page].frame_number == frame, "页表项不变");
+        SCENARIO_CHECK(memory_manager.frames[frame].is_allocated &&
+                       memory_manager.frames[frame].ref_count == 1, "页框仍由进程占用");
+        SCENARIO_CHECK(memory_manager.free_frames_count == free_frames, "空闲页框数不变");
+        SCENARIO_CHECK(((uint8_t*)get_physical_address(frame))[0] == 0x5a, "页面内容不变");
+    }
+    remove(path);
+    return true;
+}
+
+// 写入页面并在页框中留下标记字节
+static bool write_marker(PCB* process, uint32_t page, uint8_t marker) {
+    access_memory(process, page * PAGE_SIZE, true);
+    if (!process->page_table[page].flags.present) {
+        return false;
+    }
+    ((uint8_t*)get_physical_address(process->page_table[page].frame_number))[0] = marker;
+    return true;
+}
+
+// 读取页面中的标记字节
+static uint8_t read_marker(PCB* process, uint32_t page) {
+    access_memory(process, page * PAGE_SIZE, false);
+    swapio_finish_fault(process, page);
+    return ((uint8_t*)get_physical_address(process->page_table[page].frame_number))[0];
+}
+
+// 增量快照保存检查点之后写入的页框，沿快照链恢复出最新内容
+static bool scenario_incremental_chain_restores(void) {
+    const char* base = "selftest_base.bin";
+    const char* incr = "selftest_incr.bin";
+    PCB* process = create_process_with_pid(1, PRIORITY_HIGH, 16, 16);
+    SCENARIO_CHECK(process != NULL, "创建进程");
+    SCENARIO_CHECK(write_marker(process, 16, 0x11) && write_marker(process, 17, 0x22), "写入页面");
+    SCENARIO_CHECK(dump_system_state(base), "保存完整快照");
+
+    SCENARIO_CHECK(write_marker(process, 17, 0x33), "检查点之后写入页面");
+    SCENARIO_CHECK(dump_incremental_state(incr), "保存增量快照");
+    SCENARIO_CHECK(write_marker(process, 16, 0x44), "增量快照之后写入页面");
+
+    SCENARIO_CHECK(restore_system_state(incr), "恢复增量快照");
+    process = get_process_by_pid(1);
+    SCENARIO_CHECK(process != NULL, "进程已恢复");
+    SCENARIO_CHECK(read_marker(process, 16) == 0x11, "未改写的页面来自完整快照");
+    SCENARIO_CHECK(read_marker(process, 17) == 0x33, "改写的页面来自增量快照");
+    remove(base);
+    remove(incr);
+    return true;
+}
+
+// 私有页框数只包含进程独占的页框：零页框和写时复制共享的页框不计入
+static bool scenario_private_frames_counted(void) {
+    const uint32_t first = 16, last = 20;
+    PCB* parent = create_process_with_pid(1, PRIORITY_HIGH, 16, 16);
+    SCENARIO_CHECK(parent != NULL, "创建进程");
+    for (uint32_t page = first; page < last; page++) {
+        access_memory(parent, page * PAGE_SIZE, true);
+        SCENARIO_CHECK(parent->page_table[page].flags.present, "写入后页面驻留");
+    }
+    access_memory(parent, last * PAGE_SIZE, false);
+    SCENARIO_CHECK(is_zero_frame(parent->page_table[last].frame_number), "只读的页面映射零页框");
+    SCENARIO_CHECK(get_process_private_frames(parent) == last - first, "写入的页框计入进程");
+
+    PCB* child = fork_process(parent->pid);
+    SCENARIO_CHECK(child != NULL, "复制进程");
+    SCENARIO_CHECK(get_process_private_frames(parent) == 0, "共享后父进程没有私有页框");
+    SCENARIO_CHECK(get_process_private_frames(child) == 0, "子进程没有私有页框");
+
+    // 子进程写入时复制出私有页框，原页框只剩父进程映射
+    access_memory(child, first * PAGE_SIZE, true);
+    SCENARIO_CHECK(!child->page_table[first].flags.cow, "写时复制完成");
+    SCENARIO_CHECK(get_process_private_frames(child) == 1, "复制的页框计入子进程");
+    SCENARIO_CHECK(get_process_private_frames(parent) == 1, "原页框重新计入父进程");
+
+    process_destroy(child);
+    SCENARIO_CHECK(get_process_private_frames(parent) == last - first, "子进程结束后页框重新计入父进程");
+    return true;
+}
+
+static const Scenario scenarios[] = {
+    {"新进程被调度运行", scenario_new_process_runs},
+    {"阻塞的进程唤醒后重新运行", scenario_blocked_process_runs_again},
+    {"共享页框换出时所有映射失效", scenario_shared_frame_evicted},
+    {"共享页框迁移时所有映射更新", scenario_shared_frame_migrated},
+    {"交换区满时改选其他牺牲页框", scenario_eviction_falls_back},
+    {"损坏的快照不改变当前系统", scenario_corrupt_restore_keeps_state},
+    {"私有页框数不包含共享页框", scenario_private_frames_counted},
+    {"增量快照链恢复最新内容", scenario_incremental_chain_restores},
+};
+
+int run_scenario_tests(void) {
+    int count = (int)(sizeof(scenarios) / sizeof(scenarios[0]));
+    int failed = 0;
+
+    for (int i = 0; i < count; i++) {
+        reset_system();
+        printf("场景 %d/%d：%s\n", i + 1, count, scenarios[i].name);
+        bool passed = scenarios[i].run();
+        printf("场景 %d/%d：%s\n", i + 1, count, passed ? "通过" : "失败");
+        if (!passed) {
+            failed++;
+        }
+    }
+    reset_system();
+
+    printf("场景测试完成：%d 个通过，%d 个失败\n", count - failed, failed);
+    return failed;
+}
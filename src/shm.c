@@ -0,0 +1,513 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../include/shm.h"
+#include "../include/memory.h"
+#include "../include/vm.h"
+
+// 共享内存段表和挂接记录表
+static ShmSegment segments[MAX_SHM_SEGMENTS];
+static ShmAttachment attachments[MAX_SHM_ATTACHMENTS];
+
+// 初始化共享内存管理
+void shm_init(void) {
+    memset(segments, 0, sizeof(segments));
+    memset(attachments, 0, sizeof(attachments));
+}
+
+// 按名称查找共享内存段
+static int find_segment(const char* name) {
+    if (!name) return -1;
+
+    for (int i = 0; i < MAX_SHM_SEGMENTS; i++) {
+        if (segments[i].in_use && strcmp(segments[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// 查找覆盖某个虚拟页的挂接记录
+static ShmAttachment* find_attachment(uint32_t pid, uint32_t virtual_page) {
+    for (uint32_t i = 0; i < MAX_SHM_ATTACHMENTS; i++) {
+        ShmAttachment* attachment = &attachments[i];
+        if (!attachment->in_use || attachment->process_id != pid) {
+            continue;
+        }
+
+        ShmSegment* segment = &segments[attachment->segment_id];
+        if (virtual_page >= attachment->start_page &&
+            virtual_page < attachment->start_page + segment->page_count) {
+            return attachment;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 创建共享内存段
+ *
+ * 段的页面在首次被访问时才分配页框并清零。
+ *
+ * @param name 段名称
+ * @param page_count 页数
+ * @return int 段下标，失败返回-1
+ */
+int shm_create(const char* name, uint32_t page_count) {
+    if (!name || strlen(name) == 0 || strlen(name) >= MAX_SHM_NAME) {
+        printf("错误：共享内存段名称无效\n");
+        return -1;
+    }
+
+    if (page_count == 0 || page_count > MAX_SHM_PAGES) {
+        printf("错误：共享内存段页数必须在 1-%d 之间\n", MAX_SHM_PAGES);
+        return -1;
+    }
+
+    if (find_segment(name) >= 0) {
+        printf("错误：共享内存段 %s 已存在\n", name);
+        return -1;
+    }
+
+    for (int i = 0; i < MAX_SHM_SEGMENTS; i++) {
+        if (!segments[i].in_use) {
+            ShmSegment* segment = &segments[i];
+            memset(segment, 0, sizeof(ShmSegment));
+            segment->in_use = true;
+            strcpy(segment->name, name);
+            segment->page_count = page_count;
+            for (uint32_t j = 0; j < MAX_SHM_PAGES; j++) {
+                segment->frames[j] = (uint32_t)-1;
+                segment->swap_blocks[j] = (uint32_t)-1;
+            }
+
+            printf("共享内存段 %s 创建成功，页数=%u\n", name, page_count);
+            return i;
+        }
+    }
+
+    printf("错误：共享内存段数已达上限 %d\n", MAX_SHM_SEGMENTS);
+    return -1;
+}
+
+/**
+ * @brief 销毁共享内存段，释放其页框和交换区块
+ *
+ * @param name 段名称
+ * @return true 销毁成功
+ * @return false 段不存在或仍被挂接
+ */
+bool shm_destroy(const char* name) {
+    int segment_id = find_segment(name);
+    if (segment_id < 0) {
+        printf("错误：找不到共享内存段 %s\n", name ? name : "");
+        return false;
+    }
+
+    ShmSegment* segment = &segments[segment_id];
+    if (segment->attach_count > 0) {
+        printf("错误：共享内存段 %s 仍被挂接 %u 次\n", name, segment->attach_count);
+        return false;
+    }
+
+    for (uint32_t i = 0; i < segment->page_count; i++) {
+        if (segment->frames[i] != (uint32_t)-1) {
+            release_frame(segment->frames[i], 0, 0);
+        }
+        if (segment->swap_blocks[i] != (uint32_t)-1) {
+            free_swap_block(segment->swap_blocks[i]);
+        }
+    }
+
+    segment->in_use = false;
+    printf("共享内存段 %s 已销毁\n", name);
+    return true;
+}
+
+/**
+ * @brief 把共享内存段挂接到进程的虚拟页上
+ *
+ * 挂接范围超出页表时扩展页表。段中已在内存的页面立即映射，
+ * 其余页面在首次访问时通过缺页处理映射。
+ *
+ * @param pid 进程ID
+ * @param name 段名称
+ * @param start_page 起始虚拟页号
+ * @return true 挂接成功
+ * @return false 挂接失败
+ */
+bool shm_attach(uint32_t pid, const char* name, uint32_t start_page) {
+    PCB* process = get_process_by_pid(pid);
+    if (!process || !process->page_table) {
+        printf("错误：找不到进程 %u\n", pid);
+        return false;
+    }
+
+    int segment_id = find_segment(name);
+    if (segment_id < 0) {
+        printf("错误：找不到共享内存段 %s\n", name ? name : "");
+        return false;
+    }
+
+    ShmSegment* segment = &segments[segment_id];
+    uint32_t end_page = start_page + segment->page_count;
+    if (end_page > MAX_PAGES_PER_PROCESS) {
+        printf("错误：挂接范围 %u-%u 超出进程最大页数 %d\n",
+               start_page, end_page - 1, MAX_PAGES_PER_PROCESS);
+        return false;
+    }
+
+    // 查找空闲挂接记录
+    ShmAttachment* attachment = NULL;
+    for (uint32_t i = 0; i < MAX_SHM_ATTACHMENTS; i++) {
+        if (!attachments[i].in_use) {
+            attachment = &attachments[i];
+            break;
+        }
+    }
+    if (!attachment) {
+        printf("错误：共享内存挂接记录已用完\n");
+        return false;
+    }
+
+    // 检查挂接范围内的虚拟页是否空闲
+    for (uint32_t page = start_page; page < end_page && page < process->page_table_size; page++) {
+        PageTableEntry* pte = &process->page_table[page];
+        if (pte->flags.present || pte->flags.swapped || pte->flags.shm) {
+            printf("错误：进程 %u 的虚拟页 %u 已被使用\n", pid, page);
+            return false;
+        }
+    }
+
+    // 必要时扩展页表
+    if (end_page > process->page_table_size) {
+        PageTableEntry* page_table = (PageTableEntry*)realloc(process->page_table,
+                                                              end_page * sizeof(PageTableEntry));
+        if (!page_table) {
+            printf("内存分配失败\n");
+            return false;
+        }
+        memset(&page_table[process->page_table_size], 0,
+               (end_page - process->page_table_size) * sizeof(PageTableEntry));
+        process->page_table = page_table;
+        process->page_table_size = end_page;
+    }
+
+    // 建立映射
+    uint32_t mapped = 0;
+    for (uint32_t i = 0; i < segment->page_count; i++) {
+        PageTableEntry* pte = &process->page_table[start_page + i];
+        pte->frame_number = (uint32_t)-1;
+        pte->flags.shm = true;
+
+        uint32_t frame = segment->frames[i];
+        if (frame != (uint32_t)-1 && frame_get(frame, pid, start_page + i)) {
+            pte->frame_number = frame;
+            pte->flags.present = true;
+            pte->last_access_time = get_current_time();
+            mapped++;
+        }
+    }
+
+    attachment->in_use = true;
+    attachment->process_id = pid;
+    attachment->segment_id = (uint32_t)segment_id;
+    attachment->start_page = start_page;
+    segment->attach_count++;
+
+    printf("共享内存段 %s 已挂接到进程 %u 的虚拟页 %u-%u，立即映射 %u 页\n",
+           name, pid, start_page, end_page - 1, mapped);
+    return true;
+}
+
+// 解除一条挂接记录的所有映射
+static void detach_attachment(ShmAttachment* attachment) {
+    ShmSegment* segment = &segments[attachment->segment_id];
+    PCB* process = get_process_by_pid(attachment->process_id);
+
+    if (process && process->page_table) {
+        for (uint32_t i = 0; i < segment->page_count; i++) {
+            uint32_t page = attachment->start_page + i;
+            if (page >= process->page_table_size) {
+                break;
+            }
+
+            PageTableEntry* pte = &process->page_table[page];
+            if (pte->flags.present) {
+                uint32_t frame = pte->frame_number;
+                pte->flags.present = false;
+                release_frame(frame, process->pid, page);
+            }
+            pte->frame_number = (uint32_t)-1;
+            pte->flags.shm = false;
+        }
+    }
+
+    segment->attach_count--;
+    attachment->in_use = false;
+}
+
+// 把共享内存段从进程中解除挂接
+bool shm_detach(uint32_t pid, const char* name) {
+    int segment_id = find_segment(name);
+    if (segment_id < 0) {
+        printf("错误：找不到共享内存段 %s\n", name ? name : "");
+        return false;
+    }
+
+    for (uint32_t i = 0; i < MAX_SHM_ATTACHMENTS; i++) {
+        if (attachments[i].in_use && attachments[i].process_id == pid &&
+            attachments[i].segment_id == (uint32_t)segment_id) {
+            uint32_t start_page = attachments[i].start_page;
+            detach_attachment(&attachments[i]);
+            printf("共享内存段 %s 已从进程 %u 的虚拟页 %u 解除挂接\n", name, pid, start_page);
+            return true;
+        }
+    }
+
+    printf("错误：进程 %u 未挂接共享内存段 %s\n", pid, name);
+    return false;
+}
+
+// 解除进程的所有挂接（进程终止时调用）
+void shm_detach_all(uint32_t pid) {
+    for (uint32_t i = 0; i < MAX_SHM_ATTACHMENTS; i++) {
+        if (attachments[i].in_use && attachments[i].process_id == pid) {
+            detach_attachment(&attachments[i]);
+        }
+    }
+}
+
+/**
+ * @brief 为复制出的子进程复制挂接记录
+ *
+ * 子进程页表已从父进程复制，这里只补上挂接记录和挂接计数，
+ * 映射的引用由调用者通过 frame_get 增加。
+ *
+ * @param parent_pid 父进程ID
+ * @param child_pid 子进程ID
+ * @return true 复制成功
+ * @return false 挂接记录已用完
+ */
+bool shm_fork_attachments(uint32_t parent_pid, uint32_t child_pid) {
+    bool ok = true;
+    for (uint32_t i = 0; i < MAX_SHM_ATTACHMENTS; i++) {
+        if (!attachments[i].in_use || attachments[i].process_id != parent_pid) {
+            continue;
+        }
+
+        ShmAttachment* copy = NULL;
+        for (uint32_t j = 0; j < MAX_SHM_ATTACHMENTS; j++) {
+            if (!attachments[j].in_use) {
+                copy = &attachments[j];
+                break;
+            }
+        }
+        if (!copy) {
+            printf("错误：共享内存挂接记录已用完\n");
+            ok = false;
+            break;
+        }
+
+        *copy = attachments[i];
+        copy->process_id = child_pid;
+        segments[copy->segment_id].attach_count++;
+    }
+    return ok;
+}
+
+/**
+ * @brief 处理共享内存页面的缺页
+ *
+ * 页面已在内存中时直接映射段的页框；否则分配页框，从交换区调入或清零，
+ * 并由段持有一次引用，使页框在所有进程解除映射后仍保留。
+ *
+ * @param process 缺页进程
+ * @param virtual_page 缺页的虚拟页号
+ * @return true 处理成功
+ * @return false 处理失败
+ */
+bool shm_handle_fault(PCB* process, uint32_t virtual_page) {
+    ShmAttachment* attachment = find_attachment(process->pid, virtual_page);
+    if (!attachment) {
+        printf("错误：进程 %u 的虚拟页 %u 未挂接共享内存段\n", process->pid, virtual_page);
+        return false;
+    }
+
+    ShmSegment* segment = &segments[attachment->segment_id];
+    uint32_t page_index = virtual_page - attachment->start_page;
+    PageTableEntry* pte = &process->page_table[virtual_page];
+    uint32_t frame = segment->frames[page_index];
+
+    if (frame != (uint32_t)-1) {
+        if (!frame_get(frame, process->pid, virtual_page)) {
+            return false;
+        }
+        printf("共享内存段 %s 的页面 %u 已在页框 %u 中，直接映射\n",
+               segment->name, page_index, frame);
+    } else {
+        frame = obtain_frame_for_page(process, virtual_page);
+        if (frame == (uint32_t)-1) {
+            printf("错误：无法为共享内存段 %s 的页面 %u 获取页框\n", segment->name, page_index);
+            return false;
+        }
+
+        uint8_t* data = (uint8_t*)get_physical_address(frame);
+        uint32_t swap_index = segment->swap_blocks[page_index];
+        if (swap_index != (uint32_t)-1) {
+            if (!read_from_swap(swap_index, data)) {
+                printf("错误：无法从交换区调入共享内存页面\n");
+                free_frame(frame);
+                return false;
+            }
+            free_swap_block(swap_index);
+            segment->swap_blocks[page_index] = (uint32_t)-1;
+            vm_manager.stats.disk_reads++;
+            vm_manager.stats.pages_swapped_in++;
+            process->stats.pages_swapped_in++;
+            printf("共享内存段 %s 的页面 %u 从交换区块 %u 调入页框 %u\n",
+                   segment->name, page_index, swap_index, frame);
+        } else {
+            memset(data, 0, PAGE_SIZE);
+            printf("共享内存段 %s 的页面 %u 首次访问，分配页框 %u\n",
+                   segment->name, page_index, frame);
+        }
+
+        // 段持有一次引用
+        memory_manager.frames[frame].ref_count++;
+        frame_update_charge(frame);
+        segment->frames[page_index] = frame;
+    }
+
+    pte->frame_number = frame;
+    pte->flags.present = true;
+    pte->flags.swapped = false;
+    pte->last_access_time = get_current_time();
+    return true;
+}
+
+// 查找页框所属的共享内存段页面
+bool shm_find_frame(uint32_t frame_number, uint32_t* segment_id, uint32_t* page_index) {
+    if (frame_number >= PHYSICAL_PAGES) return false;
+
+    for (uint32_t i = 0; i < MAX_SHM_SEGMENTS; i++) {
+        if (!segments[i].in_use) continue;
+
+        for (uint32_t j = 0; j < segments[i].page_count; j++) {
+            if (segments[i].frames[j] == frame_number) {
+                if (segment_id) *segment_id = i;
+                if (page_index) *page_index = j;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// 内存整理把段持有的页框迁移到新页框后更新段记录
+void shm_migrate_frame(uint32_t old_frame, uint32_t new_frame) {
+    uint32_t segment_id, page_index;
+    if (shm_find_frame(old_frame, &segment_id, &page_index)) {
+        segments[segment_id].frames[page_index] = new_frame;
+    }
+}
+
+/**
+ * @brief 把共享内存段的一个页面写入交换区
+ *
+ * 无论有多少进程映射，页面只在交换区保存一份，由段记录交换区块；
+ * 页表项的失效和页框的回收由 swap_out_page 完成。
+ *
+ * @param segment_id 段下标
+ * @param page_index 段内页号
+ * @param frame_number 页面所在页框
+ * @return true 写入成功
+ * @return false 写入失败
+ */
+bool shm_swap_out_page(uint32_t segment_id, uint32_t page_index, uint32_t frame_number) {
+    ShmSegment* segment = &segments[segment_id];
+    segment->frames[page_index] = (uint32_t)-1;
+
+    // 全零页面不写交换区，下次访问时重新清零
+    if (is_zero_page(get_physical_address(frame_number))) {
+        vm_manager.stats.zero_swap_skips++;
+        printf("共享内存段 %s 的页面 %u 内容全零，跳过交换区写入\n", segment->name, page_index);
+        return true;
+    }
+
+    // 以段内页的全局编号分配，同一段相邻的页面落在同一个交换区簇中
+    uint32_t swap_index = allocate_swap_block(0, segment_id * MAX_SHM_PAGES + page_index);
+    if (swap_index == (uint32_t)-1) {
+        printf("错误：无法分配交换区块\n");
+        segment->frames[page_index] = frame_number;
+        return false;
+    }
+
+    if (!write_to_swap(swap_index, get_physical_address(frame_number))) {
+        printf("错误：写入交换区失败\n");
+        free_swap_block(swap_index);
+        segment->frames[page_index] = frame_number;
+        return false;
+    }
+
+    segment->swap_blocks[page_index] = swap_index;
+
+    printf("共享内存段 %s 的页面 %u 已写入交换区，交换区块索引: %u\n",
+           segment->name, page_index, swap_index);
+    return true;
+}
+
+/**
+ * @brief 交换区整理迁移块后更新段中记录的交换区块索引
+ * 
+ * @param old_index 原交换区块索引
+ * @param new_index 新交换区块索引
+ * @return true 找到并更新了引用
+ */
+bool shm_relocate_swap_block(uint32_t old_index, uint32_t new_index) {
+    for (uint32_t i = 0; i < MAX_SHM_SEGMENTS; i++) {
+        if (!segments[i].in_use) {
+            continue;
+        }
+        for (uint32_t j = 0; j < segments[i].page_count; j++) {
+            if (segments[i].swap_blocks[j] == old_index) {
+                segments[i].swap_blocks[j] = new_index;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// 打印共享内存段状态
+void print_shm_status(void) {
+    printf("\n=== 共享内存段 ===\n");
+
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < MAX_SHM_SEGMENTS; i++) {
+        ShmSegment* segment = &segments[i];
+        if (!segment->in_use) continue;
+
+        uint32_t resident = 0, swapped = 0;
+        for (uint32_t j = 0; j < segment->page_count; j++) {
+            if (segment->frames[j] != (uint32_t)-1) resident++;
+            if (segment->swap_blocks[j] != (uint32_t)-1) swapped++;
+        }
+
+        printf("%-16s 页数=%-3u 驻留=%-3u 换出=%-3u 挂接=%u\n",
+               segment->name, segment->page_count, resident, swapped, segment->attach_count);
+
+        for (uint32_t j = 0; j < MAX_SHM_ATTACHMENTS; j++) {
+            if (attachments[j].in_use && attachments[j].segment_id == i) {
+                printf("  进程 %u：虚拟页 %u-%u\n", attachments[j].process_id,
+                       attachments[j].start_page,
+                       attachments[j].start_page + segment->page_count - 1);
+            }
+        }
+        count++;
+    }
+
+    if (count == 0) {
+        printf("没有共享内存段\n");
+    }
+}
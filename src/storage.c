@@ -1,191 +1,793 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 #include "../include/storage.h"
 
 static StorageManager storage_manager;
 
-// ʼ洢
+#define NODE(i) (storage_manager.blocks[i])
+
+// 区段节点池大小：空闲和已分配区段各至少占一块，总数不超过块数
+#define MAX_EXTENTS (MAX_BLOCKS + 1)
+
+#define BITMAP_WORDS ((MAX_BLOCKS + 31) / 32)
+
+#define STORAGE_MAGIC   "VMSTORE1"
+#define STORAGE_VERSION 1
+
+// 存储映像头部，位于整块空间开头；区段节点池和分配位图紧随其后，块数据从页边界开始
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t block_size;
+    uint32_t total_blocks;
+    uint32_t max_extents;
+    uint32_t node_size;       // 区段节点大小，布局不同的映像拒绝加载
+    uint32_t free_root;
+    uint32_t used_root;
+    uint32_t free_node;
+    uint32_t free_extents;
+    uint32_t used_extents;
+    uint32_t free_blocks;
+} StorageHeader;
+
+#define REGION_ALIGN(x, a) (((x) + (a) - 1) / (a) * (a))
+#define NODES_OFFSET   REGION_ALIGN(sizeof(StorageHeader), 64)
+#define BITMAP_OFFSET  (NODES_OFFSET + (size_t)MAX_EXTENTS * sizeof(StorageBlock))
+#define DATA_OFFSET    REGION_ALIGN(BITMAP_OFFSET + BITMAP_WORDS * sizeof(uint32_t), 4096)
+#define REGION_SIZE    (DATA_OFFSET + (size_t)STORAGE_SIZE)
+
+// ---------------- 区段节点池 ----------------
+
+static uint32_t new_extent(uint32_t start_block, uint32_t block_count, bool is_free) {
+    uint32_t node = storage_manager.free_node;
+    if (node == STORAGE_NIL) {
+        return STORAGE_NIL;
+    }
+    storage_manager.free_node = NODE(node).left;
+
+    NODE(node).start_block = start_block;
+    NODE(node).block_count = block_count;
+    NODE(node).is_free = is_free;
+    NODE(node).process_id = 0;
+    NODE(node).left = STORAGE_NIL;
+    NODE(node).right = STORAGE_NIL;
+    NODE(node).height = 1;
+    NODE(node).max_count = block_count;
+    return node;
+}
+
+static void release_extent(uint32_t node) {
+    NODE(node).block_count = 0;
+    NODE(node).left = storage_manager.free_node;
+    storage_manager.free_node = node;
+}
+
+// 节点重新插入树之前清除旧的链接
+static void reset_links(uint32_t node) {
+    NODE(node).left = STORAGE_NIL;
+    NODE(node).right = STORAGE_NIL;
+    NODE(node).height = 1;
+    NODE(node).max_count = NODE(node).block_count;
+}
+
+// ---------------- 按起始块号排序的AVL树 ----------------
+
+static uint32_t node_height(uint32_t node) {
+    return node == STORAGE_NIL ? 0 : NODE(node).height;
+}
+
+static uint32_t node_max(uint32_t node) {
+    return node == STORAGE_NIL ? 0 : NODE(node).max_count;
+}
+
+static void update_node(uint32_t node) {
+    uint32_t lh = node_height(NODE(node).left);
+    uint32_t rh = node_height(NODE(node).right);
+    NODE(node).height = 1 + (lh > rh ? lh : rh);
+
+    uint32_t max_count = NODE(node).block_count;
+    if (node_max(NODE(node).left) > max_count) max_count = node_max(NODE(node).left);
+    if (node_max(NODE(node).right) > max_count) max_count = node_max(NODE(node).right);
+    NODE(node).max_count = max_count;
+}
+
+static uint32_t rotate_right(uint32_t node) {
+    uint32_t left = NODE(node).left;
+    NODE(node).left = NODE(left).right;
+    NODE(left).right = node;
+    update_node(node);
+    update_node(left);
+    return left;
+}
+
+static uint32_t rotate_left(uint32_t node) {
+    uint32_t right = NODE(node).right;
+    NODE(node).right = NODE(right).left;
+    NODE(right).left = node;
+    update_node(node);
+    update_node(right);
+    return right;
+}
+
+static uint32_t rebalance(uint32_t node) {
+    update_node(node);
+    int balance = (int)node_height(NODE(node).left) - (int)node_height(NODE(node).right);
+
+    if (balance > 1) {
+        uint32_t left = NODE(node).left;
+        if (node_height(NODE(left).left) < node_height(NODE(left).right)) {
+            NODE(node).left = rotate_left(left);
+        }
+        return rotate_right(node);
+    }
+    if (balance < -1) {
+        uint32_t right = NODE(node).right;
+        if (node_height(NODE(right).right) < node_height(NODE(right).left)) {
+            NODE(node).right = rotate_right(right);
+        }
+        return rotate_left(node);
+    }
+    return node;
+}
+
+static uint32_t tree_insert(uint32_t root, uint32_t node) {
+    if (root == STORAGE_NIL) {
+        return node;
+    }
+    if (NODE(node).start_block < NODE(root).start_block) {
+        NODE(root).left = tree_insert(NODE(root).left, node);
+    } else {
+        NODE(root).right = tree_insert(NODE(root).right, node);
+    }
+    return rebalance(root);
+}
+
+static uint32_t tree_remove_min(uint32_t root, uint32_t* min) {
+    if (NODE(root).left == STORAGE_NIL) {
+        *min = root;
+        return NODE(root).right;
+    }
+    NODE(root).left = tree_remove_min(NODE(root).left, min);
+    return rebalance(root);
+}
+
+// 从树中摘下起始块号为 start_block 的节点，*removed 返回被摘下的节点
+static uint32_t tree_remove(uint32_t root, uint32_t start_block, uint32_t* removed) {
+    if (root == STORAGE_NIL) {
+        return STORAGE_NIL;
+    }
+
+    if (start_block < NODE(root).start_block) {
+        NODE(root).left = tree_remove(NODE(root).left, start_block, removed);
+    } else if (start_block > NODE(root).start_block) {
+        NODE(root).right = tree_remove(NODE(root).right, start_block, removed);
+    } else {
+        *removed = root;
+        uint32_t left = NODE(root).left;
+        uint32_t right = NODE(root).right;
+        if (right == STORAGE_NIL) {
+            return left;
+        }
+        uint32_t min;
+        right = tree_remove_min(right, &min);
+        NODE(min).left = left;
+        NODE(min).right = right;
+        return rebalance(min);
+    }
+    return rebalance(root);
+}
+
+// 起始块号不大于 block 的最后一个区段
+static uint32_t tree_floor(uint32_t root, uint32_t block) {
+    uint32_t found = STORAGE_NIL;
+    while (root != STORAGE_NIL) {
+        if (NODE(root).start_block <= block) {
+            found = root;
+            root = NODE(root).right;
+        } else {
+            root = NODE(root).left;
+        }
+    }
+    return found;
+}
+
+// 起始块号不小于 block 的第一个区段
+static uint32_t tree_ceil(uint32_t root, uint32_t block) {
+    uint32_t found = STORAGE_NIL;
+    while (root != STORAGE_NIL) {
+        if (NODE(root).start_block >= block) {
+            found = root;
+            root = NODE(root).left;
+        } else {
+            root = NODE(root).right;
+        }
+    }
+    return found;
+}
+
+// 地址最低的、不少于 count 块的区段（首次适应），借助子树最大区段剪枝
+static uint32_t tree_first_fit(uint32_t root, uint32_t count) {
+    while (root != STORAGE_NIL && NODE(root).max_count >= count) {
+        if (node_max(NODE(root).left) >= count) {
+            root = NODE(root).left;
+        } else if (NODE(root).block_count >= count) {
+            return root;
+        } else {
+            root = NODE(root).right;
+        }
+    }
+    return STORAGE_NIL;
+}
+
+// ---------------- 块分配位图 ----------------
+
+// 标记一段块为已分配或空闲，整字范围一次写入
+static void mark_blocks(uint32_t start_block, uint32_t block_count, bool allocated) {
+    uint32_t* bitmap = storage_manager.alloc_bitmap;
+    uint32_t block = start_block;
+    uint32_t end = start_block + block_count;
+    while (block < end) {
+        if (block % 32 == 0 && end - block >= 32) {
+            bitmap[block / 32] = allocated ? 0xFFFFFFFFu : 0;
+            block += 32;
+            continue;
+        }
+        if (allocated) {
+            bitmap[block / 32] |= 1u << (block % 32);
+        } else {
+            bitmap[block / 32] &= ~(1u << (block % 32));
+        }
+        block++;
+    }
+}
+
+// 查找范围内第一个未分配的块，全部已分配时返回 STORAGE_NIL
+static uint32_t find_unallocated(uint32_t start_block, uint32_t block_count) {
+    const uint32_t* bitmap = storage_manager.alloc_bitmap;
+    uint32_t block = start_block;
+    uint32_t end = start_block + block_count;
+    while (block < end) {
+        if (block % 32 == 0 && end - block >= 32 && bitmap[block / 32] == 0xFFFFFFFFu) {
+            block += 32;
+            continue;
+        }
+        if (!(bitmap[block / 32] & (1u << (block % 32)))) {
+            return block;
+        }
+        block++;
+    }
+    return STORAGE_NIL;
+}
+
+// ---------------- 存储空间布局 ----------------
+
+// 让节点池、位图和磁盘空间指向整块空间中的对应区域
+static void bind_region(uint8_t* region) {
+    storage_manager.region = region;
+    storage_manager.blocks = (StorageBlock*)(region + NODES_OFFSET);
+    storage_manager.alloc_bitmap = (uint32_t*)(region + BITMAP_OFFSET);
+    storage_manager.disk_space = region + DATA_OFFSET;
+}
+
+// 把分配状态写入头部，映像文件随时保持一致
+static void save_header(void) {
+    StorageHeader* header = (StorageHeader*)storage_manager.region;
+    memcpy(header->magic, STORAGE_MAGIC, sizeof(header->magic));
+    header->version = STORAGE_VERSION;
+    header->block_size = BLOCK_SIZE;
+    header->total_blocks = MAX_BLOCKS;
+    header->max_extents = MAX_EXTENTS;
+    header->node_size = sizeof(StorageBlock);
+    header->free_root = storage_manager.free_root;
+    header->used_root = storage_manager.used_root;
+    header->free_node = storage_manager.free_node;
+    header->free_extents = storage_manager.free_extents;
+    header->used_extents = storage_manager.used_extents;
+    header->free_blocks = storage_manager.free_blocks;
+}
+
+static bool header_valid(const StorageHeader* header) {
+    return memcmp(header->magic, STORAGE_MAGIC, sizeof(header->magic)) == 0 &&
+           header->version == STORAGE_VERSION &&
+           header->block_size == BLOCK_SIZE &&
+           header->total_blocks == MAX_BLOCKS &&
+           header->max_extents == MAX_EXTENTS &&
+           header->node_size == sizeof(StorageBlock);
+}
+
+static void load_header(void) {
+    const StorageHeader* header = (const StorageHeader*)storage_manager.region;
+    storage_manager.free_root = header->free_root;
+    storage_manager.used_root = header->used_root;
+    storage_manager.free_node = header->free_node;
+    storage_manager.free_extents = header->free_extents;
+    storage_manager.used_extents = header->used_extents;
+    storage_manager.free_blocks = header->free_blocks;
+}
+
+// 格式化为一个大的空闲区段
+static void format_region(void) {
+    memset(storage_manager.region, 0, DATA_OFFSET);
+
+    // 所有节点串成未使用链表
+    for (uint32_t i = 0; i < MAX_EXTENTS; i++) {
+        NODE(i).left = (i + 1 < MAX_EXTENTS) ? i + 1 : STORAGE_NIL;
+    }
+    storage_manager.free_node = 0;
+    storage_manager.used_root = STORAGE_NIL;
+    storage_manager.used_extents = 0;
+    storage_manager.free_blocks = MAX_BLOCKS;
+
+    storage_manager.free_root = new_extent(0, MAX_BLOCKS, true);
+    storage_manager.free_extents = 1;
+    save_header();
+}
+
+// 把当前空间的元数据和已分配的块复制到新空间（空闲块不复制，映像文件保持稀疏）
+static void copy_region(uint8_t* dest) {
+    save_header();
+    memcpy(dest, storage_manager.region, DATA_OFFSET);
+
+    uint32_t block = 0;
+    while (block < MAX_BLOCKS) {
+        uint32_t start = block;
+        while (block < MAX_BLOCKS &&
+               (storage_manager.alloc_bitmap[block / 32] & (1u << (block % 32)))) {
+            block++;
+        }
+        if (block > start) {
+            size_t offset = DATA_OFFSET + (size_t)start * BLOCK_SIZE;
+            memcpy(dest + offset, storage_manager.region + offset, (size_t)(block - start) * BLOCK_SIZE);
+        } else {
+            block++;
+        }
+    }
+}
+
+// 释放当前后端的空间
+static void release_region(void) {
+    if (!storage_manager.region) {
+        return;
+    }
+#ifndef _WIN32
+    if (storage_manager.mapped) {
+        save_header();
+        msync(storage_manager.region, REGION_SIZE, MS_SYNC);
+        munmap(storage_manager.region, REGION_SIZE);
+        close(storage_manager.fd);
+        storage_manager.fd = -1;
+        storage_manager.mapped = false;
+        storage_manager.region = NULL;
+        return;
+    }
+#endif
+    free(storage_manager.region);
+    storage_manager.region = NULL;
+}
+
+#ifndef _WIN32
+/**
+ * @brief 打开并映射存储映像文件
+ *
+ * 文件不存在或为空时创建为稀疏文件（内容由调用者写入）；
+ * 已有内容的文件必须是布局相同的存储映像，避免覆盖其他文件。
+ *
+ * @param path 存储映像文件路径
+ * @param fd 输出：文件描述符
+ * @param existing 输出：文件是否已是存储映像
+ * @return uint8_t* 映射地址，失败返回 NULL
+ */
+static uint8_t* map_image(const char* path, int* fd, bool* existing) {
+    if (!path || strlen(path) >= STORAGE_PATH_MAX) {
+        printf("存储映像路径无效\n");
+        return NULL;
+    }
+
+    *fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (*fd < 0) {
+        printf("无法打开存储映像 %s：%s\n", path, strerror(errno));
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(*fd, &st) != 0) {
+        printf("无法获取存储映像 %s 的大小：%s\n", path, strerror(errno));
+        close(*fd);
+        return NULL;
+    }
+
+    *existing = st.st_size > 0;
+    if (*existing) {
+        StorageHeader header;
+        if ((size_t)st.st_size < REGION_SIZE ||
+            pread(*fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+            !header_valid(&header)) {
+            printf("%s 不是有效的存储映像\n", path);
+            close(*fd);
+            return NULL;
+        }
+    } else if (ftruncate(*fd, (off_t)REGION_SIZE) != 0) {
+        printf("无法设置存储映像 %s 的大小：%s\n", path, strerror(errno));
+        close(*fd);
+        return NULL;
+    }
+
+    uint8_t* region = (uint8_t*)mmap(NULL, REGION_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, *fd, 0);
+    if (region == MAP_FAILED) {
+        printf("无法映射存储映像 %s：%s\n", path, strerror(errno));
+        close(*fd);
+        return NULL;
+    }
+    return region;
+}
+
+// 以映射的存储映像作为磁盘空间
+static void bind_image(uint8_t* region, int fd, const char* path) {
+    bind_region(region);
+    storage_manager.mapped = true;
+    storage_manager.fd = fd;
+    strcpy(storage_manager.path, path);
+}
+#endif
+
+// ---------------- 存储管理接口 ----------------
+
+/**
+ * @brief 初始化存储管理器
+ *
+ * 启动时配置了存储映像（--storage-image）时直接映射该文件，不分配内存存储的空间；
+ * 否则在内存中分配整块空间并格式化。
+ */
 void storage_init(void) {
-    // ģ̿ռ
-    storage_manager.disk_space = malloc(STORAGE_SIZE);
-    storage_manager.blocks = (StorageBlock*)calloc(MAX_BLOCKS, sizeof(StorageBlock));
+    memset(&storage_manager, 0, sizeof(storage_manager));
+    storage_manager.fd = -1;
     storage_manager.total_blocks = MAX_BLOCKS;
-    storage_manager.free_blocks = MAX_BLOCKS;
     storage_manager.block_size = BLOCK_SIZE;
 
-    if (!storage_manager.disk_space || !storage_manager.blocks) {
-        fprintf(stderr, "洢ռʼʧܣ\n");
-        exit(1);
+    const char* image = system_config.storage_image;
+    if (image[0]) {
+#ifdef _WIN32
+        printf("当前平台不支持映射文件存储，使用内存存储\n");
+#else
+        int fd;
+        bool existing;
+        uint8_t* region = map_image(image, &fd, &existing);
+        if (!region) {
+            fprintf(stderr, "存储空间初始化失败！\n");
+            exit(1);
+        }
+        bind_image(region, fd, image);
+        if (existing) {
+            load_header();
+            printf("已加载存储映像 %s：%u 个已分配区段，%u 个空闲块\n",
+                   image, storage_manager.used_extents, storage_manager.free_blocks);
+        } else {
+            format_region();
+            msync(region, REGION_SIZE, MS_SYNC);
+            printf("已创建存储映像 %s（%zu 字节，稀疏文件）\n", image, (size_t)REGION_SIZE);
+        }
+        return;
+#endif
     }
 
-    // ʼΪһĿп
-    storage_manager.blocks[0].start_block = 0;
-    storage_manager.blocks[0].block_count = MAX_BLOCKS;
-    storage_manager.blocks[0].is_free = true;
-    storage_manager.blocks[0].process_id = 0;
+    // 分配模拟磁盘空间（头部、区段节点池、分配位图和块数据）
+    uint8_t* region = (uint8_t*)malloc(REGION_SIZE);
+    if (!region) {
+        fprintf(stderr, "存储空间初始化失败！\n");
+        exit(1);
+    }
+    bind_region(region);
+    format_region();
 }
 
-// 洢
+// 清理存储管理器，映射的存储映像在关闭前同步
 void storage_shutdown(void) {
-    free(storage_manager.disk_space);
-    free(storage_manager.blocks);
+    release_region();
+}
+
+// 切换回内存存储，已分配的块复制到内存
+bool storage_use_memory(void) {
+    if (!storage_manager.mapped) {
+        printf("当前已使用内存存储\n");
+        return true;
+    }
+
+    uint8_t* region = (uint8_t*)malloc(REGION_SIZE);
+    if (!region) {
+        printf("内存不足，无法切换到内存存储\n");
+        return false;
+    }
+    copy_region(region);
+    release_region();
+    bind_region(region);
+    storage_manager.path[0] = '\0';
+    printf("已切换到内存存储\n");
+    return true;
 }
 
-// 洢ռ䣨״Ӧ㷨
+/**
+ * @brief 使用映射的存储映像文件作为磁盘空间
+ *
+ * 文件不存在或为空时创建稀疏文件，并把当前的分配状态和已分配的块写入；
+ * 文件是有效的存储映像时直接映射，沿用其中的分配状态（当前内容被替换）。
+ *
+ * @param path 存储映像文件路径
+ * @return true 切换成功
+ * @return false 打开、映射失败或文件不是有效的存储映像
+ */
+bool storage_use_file(const char* path) {
+#ifdef _WIN32
+    (void)path;
+    printf("当前平台不支持映射文件存储\n");
+    return false;
+#else
+    int fd;
+    bool existing;
+    uint8_t* region = map_image(path, &fd, &existing);
+    if (!region) {
+        return false;
+    }
+
+    if (!existing) {
+        copy_region(region);
+    }
+    release_region();
+
+    bind_image(region, fd, path);
+    load_header();
+
+    if (existing) {
+        printf("已加载存储映像 %s：%u 个已分配区段，%u 个空闲块\n",
+               path, storage_manager.used_extents, storage_manager.free_blocks);
+    } else {
+        msync(region, REGION_SIZE, MS_SYNC);
+        printf("已创建存储映像 %s（%zu 字节，稀疏文件）\n", path, (size_t)REGION_SIZE);
+    }
+    return true;
+#endif
+}
+
+// 检查点：把分配状态写入头部并同步映像文件
+bool storage_sync(void) {
+    save_header();
+    if (!storage_manager.mapped) {
+        printf("内存存储无需同步\n");
+        return true;
+    }
+#ifdef _WIN32
+    return false;
+#else
+    if (msync(storage_manager.region, REGION_SIZE, MS_SYNC) != 0) {
+        printf("同步存储映像失败：%s\n", strerror(errno));
+        return false;
+    }
+    storage_manager.syncs++;
+    printf("存储映像 %s 已同步\n", storage_manager.path);
+    return true;
+#endif
+}
+
+/**
+ * @brief 分配存储空间（首次适应算法）
+ *
+ * 空闲区段按地址组织成AVL树，每个节点记录子树中最大区段的块数，
+ * 查找地址最低的足够大区段、分割和登记都是 O(log n)。
+ *
+ * @param size 字节数
+ * @return uint32_t 起始块号，失败返回-1
+ */
 uint32_t storage_allocate(uint32_t size) {
     uint32_t blocks_needed = (size + BLOCK_SIZE - 1) / BLOCK_SIZE;
-    
-    if (blocks_needed > storage_manager.free_blocks) {
+
+    if (blocks_needed == 0 || blocks_needed > storage_manager.free_blocks) {
         return (uint32_t)-1;
     }
 
-    // 㹻Ŀп
-    for (uint32_t i = 0; i < storage_manager.total_blocks; i++) {
-        StorageBlock* block = &storage_manager.blocks[i];
-        if (block->is_free && block->block_count >= blocks_needed) {
-            // ҵʵĿ
-            uint32_t start_block = block->start_block;
-            
-            // Сãֱӷ
-            if (block->block_count == blocks_needed) {
-                block->is_free = false;
-            } else {
-                // ָ
-                StorageBlock new_block = {
-                    .start_block = start_block + blocks_needed,
-                    .block_count = block->block_count - blocks_needed,
-                    .is_free = true,
-                    .process_id = 0
-                };
-                
-                block->block_count = blocks_needed;
-                block->is_free = false;
-                
-                // µĿп
-                memmove(&storage_manager.blocks[i + 2], 
-                       &storage_manager.blocks[i + 1],
-                       (storage_manager.total_blocks - i - 2) * sizeof(StorageBlock));
-                storage_manager.blocks[i + 1] = new_block;
-            }
-            
-            storage_manager.free_blocks -= blocks_needed;
-            return start_block;
-        }
-    }
-    
-    return (uint32_t)-1;
-}
-
-// ͷŴ洢ռ
-void storage_free(uint32_t start_block) {
-    // ҶӦĿ
-    for (uint32_t i = 0; i < storage_manager.total_blocks; i++) {
-        StorageBlock* block = &storage_manager.blocks[i];
-        if (block->start_block == start_block && !block->is_free) {
-            // ͷſ
-            block->is_free = true;
-            block->process_id = 0;
-            storage_manager.free_blocks += block->block_count;
-            
-            // ԺϲڵĿп
-            // һϲ
-            if (i + 1 < storage_manager.total_blocks && 
-                storage_manager.blocks[i + 1].is_free) {
-                block->block_count += storage_manager.blocks[i + 1].block_count;
-                memmove(&storage_manager.blocks[i + 1], 
-                       &storage_manager.blocks[i + 2],
-                       (storage_manager.total_blocks - i - 2) * sizeof(StorageBlock));
-            }
-            
-            // ǰһϲ
-            if (i > 0 && storage_manager.blocks[i - 1].is_free) {
-                storage_manager.blocks[i - 1].block_count += block->block_count;
-                memmove(&storage_manager.blocks[i], 
-                       &storage_manager.blocks[i + 1],
-                       (storage_manager.total_blocks - i - 1) * sizeof(StorageBlock));
-            }
-            
-            break;
+    // 查找足够大的空闲区段
+    uint32_t node = tree_first_fit(storage_manager.free_root, blocks_needed);
+    if (node == STORAGE_NIL) {
+        return (uint32_t)-1;
+    }
+    uint32_t start_block = NODE(node).start_block;
+
+    // 已分配区段的节点（区段正好用完时复用空闲区段的节点）
+    uint32_t used = STORAGE_NIL;
+    if (NODE(node).block_count > blocks_needed) {
+        used = new_extent(start_block, blocks_needed, false);
+        if (used == STORAGE_NIL) {
+            return (uint32_t)-1;
         }
     }
+
+    storage_manager.free_root = tree_remove(storage_manager.free_root, start_block, &node);
+    if (used == STORAGE_NIL) {
+        // 区段大小正好，整体转为已分配
+        used = node;
+        NODE(used).is_free = false;
+        storage_manager.free_extents--;
+    } else {
+        // 分割区段，剩余部分留在空闲树中
+        NODE(node).start_block += blocks_needed;
+        NODE(node).block_count -= blocks_needed;
+        reset_links(node);
+        storage_manager.free_root = tree_insert(storage_manager.free_root, node);
+    }
+
+    reset_links(used);
+    storage_manager.used_root = tree_insert(storage_manager.used_root, used);
+    storage_manager.used_extents++;
+    storage_manager.free_blocks -= blocks_needed;
+    mark_blocks(start_block, blocks_needed, true);
+    save_header();
+    return start_block;
 }
 
-// ȡ洢
-bool storage_read(uint32_t block_num, void* buffer) {
-    if (block_num >= storage_manager.total_blocks || !buffer) {
-        return false;
+/**
+ * @brief 释放存储空间，与地址相邻的空闲区段合并
+ *
+ * @param start_block 分配时返回的起始块号
+ */
+void storage_free(uint32_t start_block) {
+    // 查找对应的区段
+    uint32_t node = STORAGE_NIL;
+    storage_manager.used_root = tree_remove(storage_manager.used_root, start_block, &node);
+    if (node == STORAGE_NIL) {
+        return;
     }
+    storage_manager.used_extents--;
 
-    // ҿǷѷ
-    bool block_found = false;
-    for (uint32_t i = 0; i < storage_manager.total_blocks; i++) {
-        StorageBlock* block = &storage_manager.blocks[i];
-        if (!block->is_free && 
-            block_num >= block->start_block && 
-            block_num < block->start_block + block->block_count) {
-            block_found = true;
-            break;
-        }
+    // 释放区段
+    NODE(node).is_free = true;
+    NODE(node).process_id = 0;
+    storage_manager.free_blocks += NODE(node).block_count;
+    mark_blocks(start_block, NODE(node).block_count, false);
+
+    // 与前一个空闲区段合并
+    uint32_t prev = tree_floor(storage_manager.free_root, start_block);
+    if (prev != STORAGE_NIL &&
+        NODE(prev).start_block + NODE(prev).block_count == start_block) {
+        storage_manager.free_root = tree_remove(storage_manager.free_root, NODE(prev).start_block, &prev);
+        NODE(node).start_block = NODE(prev).start_block;
+        NODE(node).block_count += NODE(prev).block_count;
+        release_extent(prev);
+        storage_manager.free_extents--;
+    }
+
+    // 与后一个空闲区段合并
+    uint32_t end_block = NODE(node).start_block + NODE(node).block_count;
+    uint32_t next = tree_ceil(storage_manager.free_root, end_block);
+    if (next != STORAGE_NIL && NODE(next).start_block == end_block) {
+        storage_manager.free_root = tree_remove(storage_manager.free_root, end_block, &next);
+        NODE(node).block_count += NODE(next).block_count;
+        release_extent(next);
+        storage_manager.free_extents--;
+    }
+
+    reset_links(node);
+    storage_manager.free_root = tree_insert(storage_manager.free_root, node);
+    storage_manager.free_extents++;
+    save_header();
+}
+
+// 检查块范围有效且已全部分配
+static bool check_block_range(uint32_t start_block, uint32_t block_count, const char* op) {
+    if (block_count == 0 || start_block >= storage_manager.total_blocks ||
+        block_count > storage_manager.total_blocks - start_block) {
+        return false;
     }
 
-    if (!block_found) {
-        printf("󣺳ԶȡδĿ %u\n", block_num);
+    uint32_t block = find_unallocated(start_block, block_count);
+    if (block != STORAGE_NIL) {
+        printf("错误：尝试%s未分配的块 %u\n", op, block);
         return false;
     }
-    
-    uint8_t* src = (uint8_t*)storage_manager.disk_space + (block_num * BLOCK_SIZE);
-    memcpy(buffer, src, BLOCK_SIZE);
     return true;
 }
 
-// д洢
-bool storage_write(uint32_t block_num, const void* data) {
-    if (block_num >= storage_manager.total_blocks || !data) {
+// 范围内的块是否都已分配
+bool storage_is_allocated(uint32_t start_block, uint32_t block_count) {
+    if (block_count == 0 || start_block >= storage_manager.total_blocks ||
+        block_count > storage_manager.total_blocks - start_block) {
         return false;
     }
+    return find_unallocated(start_block, block_count) == STORAGE_NIL;
+}
 
-    // ҿǷѷ
-    bool block_found = false;
-    for (uint32_t i = 0; i < storage_manager.total_blocks; i++) {
-        StorageBlock* block = &storage_manager.blocks[i];
-        if (!block->is_free && 
-            block_num >= block->start_block && 
-            block_num < block->start_block + block->block_count) {
-            block_found = true;
-            break;
-        }
+// 读取存储块
+bool storage_read(uint32_t block_num, void* buffer) {
+    return storage_readv(block_num, 1, buffer);
+}
+
+// 写入存储块
+bool storage_write(uint32_t block_num, const void* data) {
+    return storage_writev(block_num, 1, data);
+}
+
+/**
+ * @brief 读取连续多块
+ *
+ * @param start_block 起始块号
+ * @param block_count 块数
+ * @param buffer 至少 block_count * BLOCK_SIZE 字节的缓冲区
+ * @return true 读取成功
+ * @return false 范围无效或包含未分配的块
+ */
+bool storage_readv(uint32_t start_block, uint32_t block_count, void* buffer) {
+    if (!buffer || !check_block_range(start_block, block_count, "读取")) {
+        return false;
     }
 
-    if (!block_found) {
-        printf("󣺳дδĿ %u\n", block_num);
+    uint8_t* src = (uint8_t*)storage_manager.disk_space + ((size_t)start_block * BLOCK_SIZE);
+    memcpy(buffer, src, (size_t)block_count * BLOCK_SIZE);
+    return true;
+}
+
+/**
+ * @brief 写入连续多块
+ *
+ * @param start_block 起始块号
+ * @param block_count 块数
+ * @param data 至少 block_count * BLOCK_SIZE 字节的数据
+ * @return true 写入成功
+ * @return false 范围无效或包含未分配的块
+ */
+bool storage_writev(uint32_t start_block, uint32_t block_count, const void* data) {
+    if (!data || !check_block_range(start_block, block_count, "写入")) {
         return false;
     }
-    
-    uint8_t* dest = (uint8_t*)storage_manager.disk_space + (block_num * BLOCK_SIZE);
-    memcpy(dest, data, BLOCK_SIZE);
+
+    uint8_t* dest = (uint8_t*)storage_manager.disk_space + ((size_t)start_block * BLOCK_SIZE);
+    memcpy(dest, data, (size_t)block_count * BLOCK_SIZE);
     return true;
 }
 
-// ȡп
+// 获取空闲块数量
 uint32_t get_free_blocks_count(void) {
     return storage_manager.free_blocks;
 }
 
-// ӡ洢״̬
+// 打印存储状态
 void print_storage_status(void) {
-    printf("\n=== 洢״̬ ===\n");
-    printf("ܿ: %u\n", storage_manager.total_blocks);
-    printf("п: %u\n", storage_manager.free_blocks);
-    printf("С: %u bytes\n", storage_manager.block_size);
-    
-    printf("\nб:\n");
-    for (uint32_t i = 0; i < storage_manager.total_blocks; i++) {
-        StorageBlock* block = &storage_manager.blocks[i];
-        if (block->block_count > 0) {
-            printf(" %u: ʼ=%u, С=%u blocks, %s\n",
-                   i, block->start_block, block->block_count,
-                   block->is_free ? "" : "");
-        }
-    }
-} 
\ No newline at end of file
+    printf("\n=== 存储状态 ===\n");
+    printf("总块数: %u\n", storage_manager.total_blocks);
+    printf("空闲块数: %u\n", storage_manager.free_blocks);
+    printf("块大小: %u bytes\n", storage_manager.block_size);
+    if (storage_manager.mapped) {
+        printf("存储后端: 映像文件 %s（检查点 %u 次）\n", storage_manager.path, storage_manager.syncs);
+    } else {
+        printf("存储后端: 内存\n");
+    }
+    printf("空闲区段数: %u（最大 %u 块，树高 %u）\n",
+           storage_manager.free_extents,
+           node_max(storage_manager.free_root),
+           node_height(storage_manager.free_root));
+    printf("已分配区段数: %u（树高 %u）\n",
+           storage_manager.used_extents,
+           node_height(storage_manager.used_root));
+
+    // 按地址顺序交替取两棵树中的区段
+    printf("\n区段列表:\n");
+    uint32_t index = 0;
+    uint32_t block = 0;
+    while (block < storage_manager.total_blocks) {
+        uint32_t node = tree_ceil(storage_manager.free_root, block);
+        if (node == STORAGE_NIL || NODE(node).start_block != block) {
+            node = tree_ceil(storage_manager.used_root, block);
+        }
+        if (node == STORAGE_NIL || NODE(node).start_block != block) {
+            break;
+        }
+        printf("区段 %u: 起始=%u, 大小=%u blocks, %s\n",
+               index++, NODE(node).start_block, NODE(node).block_count,
+               NODE(node).is_free ? "空闲" : "已用");
+        block += NODE(node).block_count;
+    }
+}
@@ -0,0 +1,337 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../include/swapalloc.h"
+#include "../include/vm.h"
+#include "../include/swapio.h"
+
+// 交换区簇状态
+static SwapCluster* clusters = NULL;   // SWAP_CLUSTERS 项
+static SwapAllocStats stats;
+static uint32_t compact_cursor = 0;   // 后台整理下次开始检查的块
+
+// 已预留的簇按（所属进程，虚拟页组）分桶（链地址法），分配时只检查同一桶
+static uint32_t* cluster_buckets = NULL;  // 桶中第一个簇，-1表示空桶
+static uint32_t* cluster_next = NULL;     // 同一桶中的下一个簇（SWAP_CLUSTERS 项）
+static uint32_t cluster_mask = 0;         // 桶数减1，桶数为不小于簇数的2的幂
+static uint32_t free_hint = 0;            // 编号小于它的簇都已预留或仍有块
+
+// 每个块分配时是否落在所属簇的对应槽位之外，以及这类块的数量（后台整理据此判断是否需要运行）
+static bool* misplaced = NULL;            // SWAP_SIZE 项
+static uint32_t misplaced_count = 0;
+
+static uint32_t bucket_of(uint32_t owner, uint32_t group) {
+    return (owner * 0x9E3779B1u ^ group) & cluster_mask;
+}
+
+// 预留簇并加入索引
+static void reserve_cluster(uint32_t c, uint32_t owner, uint32_t group) {
+    uint32_t bucket = bucket_of(owner, group);
+    clusters[c].reserved = true;
+    clusters[c].owner = owner;
+    clusters[c].group = group;
+    cluster_next[c] = cluster_buckets[bucket];
+    cluster_buckets[bucket] = c;
+}
+
+// 簇内块全部释放：取消预留并从索引中删除
+static void release_cluster(uint32_t c) {
+    if (clusters[c].reserved) {
+        clusters[c].reserved = false;
+        uint32_t* link = &cluster_buckets[bucket_of(clusters[c].owner, clusters[c].group)];
+        while (*link != (uint32_t)-1) {
+            if (*link == c) {
+                *link = cluster_next[c];
+                break;
+            }
+            link = &cluster_next[*link];
+        }
+    }
+    if (c < free_hint) {
+        free_hint = c;
+    }
+}
+
+// 清空簇状态和索引
+static void reset_clusters(void) {
+    memset(clusters, 0, sizeof(SwapCluster) * SWAP_CLUSTERS);
+    memset(cluster_buckets, 0xff, sizeof(uint32_t) * ((size_t)cluster_mask + 1));
+    memset(misplaced, 0, sizeof(bool) * SWAP_SIZE);
+    misplaced_count = 0;
+    free_hint = 0;
+    compact_cursor = 0;
+}
+
+// 初始化交换区分配器
+void swapalloc_init(void) {
+    uint32_t buckets = 1;
+    while (buckets < SWAP_CLUSTERS) {
+        buckets <<= 1;
+    }
+    cluster_mask = buckets - 1;
+
+    free(clusters);
+    free(cluster_buckets);
+    free(cluster_next);
+    free(misplaced);
+    clusters = (SwapCluster*)malloc(sizeof(SwapCluster) * SWAP_CLUSTERS);
+    cluster_buckets = (uint32_t*)malloc(sizeof(uint32_t) * buckets);
+    cluster_next = (uint32_t*)malloc(sizeof(uint32_t) * SWAP_CLUSTERS);
+    misplaced = (bool*)malloc(sizeof(bool) * SWAP_SIZE);
+    if (!clusters || !cluster_buckets || !cluster_next || !misplaced) {
+        fprintf(stderr, "交换区分配器初始化失败\n");
+        exit(1);
+    }
+    memset(&stats, 0, sizeof(stats));
+    reset_clusters();
+}
+
+// 块是否位于给定进程虚拟页所属簇的对应槽位
+static bool slot_matches(uint32_t swap_index, uint32_t process_id, uint32_t virtual_page) {
+    SwapCluster* cluster = &clusters[swap_index / SWAP_CLUSTER_SIZE];
+    return cluster->reserved &&
+           cluster->owner == process_id &&
+           cluster->group == virtual_page / SWAP_CLUSTER_SIZE &&
+           swap_index % SWAP_CLUSTER_SIZE == virtual_page % SWAP_CLUSTER_SIZE;
+}
+
+// 按交换区块信息重建簇状态，簇的所属取簇内第一个已使用块
+void swapalloc_rebuild(void) {
+    reset_clusters();
+    for (uint32_t i = 0; i < SWAP_SIZE; i++) {
+        SwapBlockInfo* block = &vm_manager.swap_blocks[i];
+        if (!block->is_used) {
+            continue;
+        }
+        uint32_t c = i / SWAP_CLUSTER_SIZE;
+        if (!clusters[c].reserved) {
+            reserve_cluster(c, block->process_id, block->virtual_page / SWAP_CLUSTER_SIZE);
+        }
+        clusters[c].used++;
+        if (!slot_matches(i, block->process_id, block->virtual_page)) {
+            misplaced[i] = true;
+            misplaced_count++;
+        }
+    }
+}
+
+// 块是否位于所属簇的对应槽位（共享的块不迁移，视为已就位）
+static bool block_in_place(uint32_t swap_index) {
+    SwapBlockInfo* block = &vm_manager.swap_blocks[swap_index];
+    if (block->ref_count > 1) {
+        return true;
+    }
+    return slot_matches(swap_index, block->process_id, block->virtual_page);
+}
+
+// 在所属簇（或新预留的空闲簇）中查找虚拟页对应的空闲槽位
+static uint32_t find_cluster_slot(uint32_t process_id, uint32_t virtual_page) {
+    uint32_t group = virtual_page / SWAP_CLUSTER_SIZE;
+    uint32_t slot = virtual_page % SWAP_CLUSTER_SIZE;
+
+    // 已预留的簇中对应槽位空闲
+    for (uint32_t c = cluster_buckets[bucket_of(process_id, group)]; c != (uint32_t)-1; c = cluster_next[c]) {
+        uint32_t index = c * SWAP_CLUSTER_SIZE + slot;
+        if (clusters[c].owner == process_id && clusters[c].group == group &&
+            !vm_manager.swap_blocks[index].is_used) {
+            stats.cluster_allocs++;
+            return index;
+        }
+    }
+
+    // 预留编号最小的完全空闲簇
+    for (; free_hint < SWAP_CLUSTERS; free_hint++) {
+        uint32_t c = free_hint;
+        if (!clusters[c].reserved && clusters[c].used == 0) {
+            reserve_cluster(c, process_id, group);
+            free_hint++;
+            stats.cluster_reserves++;
+            stats.cluster_allocs++;
+            return c * SWAP_CLUSTER_SIZE + slot;
+        }
+    }
+    return (uint32_t)-1;
+}
+
+// 没有可用簇时首次适应：优先同一进程的簇，其次任意空闲块
+static uint32_t find_fallback_slot(uint32_t process_id) {
+    uint32_t any = (uint32_t)-1;
+    for (uint32_t i = 0; i < SWAP_SIZE; i++) {
+        if (vm_manager.swap_blocks[i].is_used) {
+            continue;
+        }
+        if (clusters[i / SWAP_CLUSTER_SIZE].owner == process_id) {
+            return i;
+        }
+        if (any == (uint32_t)-1) {
+            any = i;
+        }
+    }
+    return any;
+}
+
+/**
+ * @brief 为进程虚拟页选择交换区块
+ *
+ * 同一进程虚拟上相邻的页面落在同一个簇的相邻槽位，换入时可以连续读取。
+ * 簇用尽后退化为首次适应，由后台整理逐步恢复连续性。
+ *
+ * @param process_id 进程ID（共享内存段为0）
+ * @param virtual_page 虚拟页号
+ * @return uint32_t 交换区块索引，交换区已满返回-1
+ */
+uint32_t swapalloc_alloc(uint32_t process_id, uint32_t virtual_page) {
+    uint32_t index = find_cluster_slot(process_id, virtual_page);
+    if (index == (uint32_t)-1) {
+        index = find_fallback_slot(process_id);
+        if (index == (uint32_t)-1) {
+            return (uint32_t)-1;
+        }
+        stats.fallback_allocs++;
+        misplaced[index] = true;
+        misplaced_count++;
+    }
+    clusters[index / SWAP_CLUSTER_SIZE].used++;
+    return index;
+}
+
+// 释放交换区块，簇内块全部释放后取消预留
+void swapalloc_free(uint32_t swap_index) {
+    SwapCluster* cluster = &clusters[swap_index / SWAP_CLUSTER_SIZE];
+    if (misplaced[swap_index]) {
+        misplaced[swap_index] = false;
+        misplaced_count--;
+    }
+    if (cluster->used > 0) {
+        cluster->used--;
+    }
+    if (cluster->used == 0) {
+        release_cluster(swap_index / SWAP_CLUSTER_SIZE);
+    }
+}
+
+// 从上次停止的位置检查最多 max_scan 个块，把错位的块迁移到所属簇的对应槽位
+static uint32_t compact_blocks(uint32_t max_moves, uint32_t max_scan) {
+    swapio_drain();
+    stats.compact_runs++;
+
+    uint32_t moves = 0;
+    for (uint32_t scanned = 0; scanned < max_scan && moves < max_moves; scanned++) {
+        uint32_t index = compact_cursor;
+        compact_cursor = (compact_cursor + 1) % SWAP_SIZE;
+
+        SwapBlockInfo* block = &vm_manager.swap_blocks[index];
+        if (!block->is_used || block_in_place(index)) {
+            continue;
+        }
+
+        uint32_t target = find_cluster_slot(block->process_id, block->virtual_page);
+        if (target == (uint32_t)-1) {
+            continue;
+        }
+        clusters[target / SWAP_CLUSTER_SIZE].used++;
+
+        if (relocate_swap_block(index, target)) {
+            moves++;
+            stats.compact_moves++;
+        } else {
+            stats.compact_failures++;
+        }
+    }
+    return moves;
+}
+
+/**
+ * @brief 交换区整理：把错位的块迁移到所属簇的对应槽位
+ *
+ * 先等待异步交换I/O完成，迁移时保留块所在的层级（压缩池或交换设备）。
+ * 从上次停止的位置继续检查，可以分多次完成。
+ *
+ * @param max_moves 最多迁移的块数
+ * @return uint32_t 实际迁移的块数
+ */
+uint32_t swap_compact(uint32_t max_moves) {
+    return compact_blocks(max_moves, SWAP_SIZE);
+}
+
+// 时钟滴答时的后台整理：没有错位块或有缺页换入在途时跳过，每次只检查一小段交换区
+void swap_compact_tick(void) {
+    if (misplaced_count == 0 || swapio_pending_faults() > 0) {
+        return;
+    }
+    compact_blocks(SWAP_COMPACT_BATCH, SWAP_COMPACT_SCAN);
+}
+
+// 统计交换区碎片
+SwapFragInfo get_swap_fragmentation(void) {
+    SwapFragInfo info;
+    memset(&info, 0, sizeof(info));
+
+    uint32_t run = 0;
+    for (uint32_t i = 0; i < SWAP_SIZE; i++) {
+        if (!vm_manager.swap_blocks[i].is_used) {
+            if (run == 0) {
+                info.free_extents++;
+            }
+            run++;
+            info.free_blocks++;
+            if (run > info.largest_free) {
+                info.largest_free = run;
+            }
+        } else {
+            run = 0;
+            if (!block_in_place(i)) {
+                info.misplaced_blocks++;
+            }
+        }
+    }
+
+    for (uint32_t c = 0; c < SWAP_CLUSTERS; c++) {
+        if (!clusters[c].reserved && clusters[c].used == 0) {
+            info.free_clusters++;
+        }
+    }
+
+    // 虚拟相邻的换出页面在交换区中是否也相邻
+    for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
+        PCB* process = get_process_by_index(i);
+        if (!process || !process->page_table) {
+            continue;
+        }
+        for (uint32_t page = 0; page + 1 < process->page_table_size; page++) {
+            PageTableEntry* pte = &process->page_table[page];
+            PageTableEntry* next = &process->page_table[page + 1];
+            if (pte->flags.swapped && !pte->flags.shm && next->flags.swapped && !next->flags.shm) {
+                info.adjacent_pairs++;
+                if (next->flags.swap_index == pte->flags.swap_index + 1) {
+                    info.contiguous_pairs++;
+                }
+            }
+        }
+    }
+    return info;
+}
+
+SwapAllocStats get_swapalloc_stats(void) {
+    return stats;
+}
+
+// 打印交换区碎片统计
+void print_swap_fragmentation(void) {
+    SwapFragInfo info = get_swap_fragmentation();
+
+    printf("\n=== 交换区碎片统计信息 ===\n");
+    printf("空闲交换区块数: %u\n", info.free_blocks);
+    printf("交换区碎片数: %u（最大空闲区段 %u 块）\n", info.free_extents, info.largest_free);
+    printf("交换区碎片率: %.1f%%\n",
+           info.free_blocks ? (float)info.free_extents * 100 / info.free_blocks : 0.0f);
+    printf("空闲簇: %u/%u（每簇 %u 块）\n", info.free_clusters, SWAP_CLUSTERS, SWAP_CLUSTER_SIZE);
+    printf("错位交换区块: %u\n", info.misplaced_blocks);
+    printf("虚拟相邻页面的交换区连续率: %.1f%% (%u/%u)\n",
+           info.adjacent_pairs ? (float)info.contiguous_pairs * 100 / info.adjacent_pairs : 0.0f,
+           info.contiguous_pairs, info.adjacent_pairs);
+    printf("簇内分配: %u，预留簇: %u，首次适应分配: %u\n",
+           stats.cluster_allocs, stats.cluster_reserves, stats.fallback_allocs);
+    printf("整理次数: %u，迁移块数: %u，迁移失败: %u\n",
+           stats.compact_runs, stats.compact_moves, stats.compact_failures);
+}
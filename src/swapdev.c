@@ -0,0 +1,397 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+#include "../include/swapdev.h"
+#include "../include/vm.h"
+#include "../include/swapio.h"
+#include "../include/metrics.h"
+#include "../include/trace.h"
+
+// 交换设备（配置及打开后的句柄）
+typedef struct {
+    SwapDevType type;
+    bool direct_io;                // 是否绕过页缓存（O_DIRECT）
+    SwapDevSync sync;              // 写入同步方式
+    char path[SWAPDEV_PATH_MAX];   // 交换文件或块设备路径
+    int fd;                        // 文件描述符，未打开时为-1
+    uint8_t* area;                 // 内存交换区
+} SwapDevice;
+
+static SwapDevice device = { .type = SWAPDEV_MEMORY, .sync = SWAPDEV_SYNC_NONE, .fd = -1 };
+static uint8_t* bounce = NULL;     // O_DIRECT 使用的对齐缓冲区
+static SwapDevStats stats;
+
+#ifndef _WIN32
+// 打开交换文件并确认容量，truncate 为 false 时保留原有内容
+static bool file_open(SwapDevice* dev, bool truncate) {
+    int flags = O_RDWR | O_CREAT | (truncate ? O_TRUNC : 0);
+    if (dev->sync == SWAPDEV_SYNC_DSYNC) {
+        flags |= O_DSYNC;
+    }
+
+    // 块大小不是对齐要求的整数倍时块偏移无法对齐
+    if (dev->direct_io && SWAP_BLOCK_SIZE % SWAPDEV_ALIGNMENT != 0) {
+        printf("页大小 %u 不满足 O_DIRECT 的 %u 字节对齐，改用缓冲 I/O\n", SWAP_BLOCK_SIZE, SWAPDEV_ALIGNMENT);
+        dev->direct_io = false;
+    }
+
+    int fd = -1;
+    if (dev->direct_io) {
+#ifdef O_DIRECT
+        fd = open(dev->path, flags | O_DIRECT, 0600);
+        if (fd < 0 && errno != EINVAL) {
+            printf("无法打开交换文件 %s: %s\n", dev->path, strerror(errno));
+            return false;
+        }
+#endif
+        if (fd < 0) {
+            printf("%s 不支持 O_DIRECT，改用缓冲 I/O\n", dev->path);
+            dev->direct_io = false;
+        }
+    }
+    if (fd < 0) {
+        fd = open(dev->path, flags, 0600);
+    }
+    if (fd < 0) {
+        printf("无法打开交换文件 %s: %s\n", dev->path, strerror(errno));
+        return false;
+    }
+
+    // 普通文件预设为交换区大小（稀疏文件，不实际占用磁盘），块设备检查容量
+    off_t required = (off_t)SWAP_SIZE * SWAP_BLOCK_SIZE;
+    struct stat st;
+    bool size_ok;
+    if (fstat(fd, &st) == 0 && S_ISBLK(st.st_mode)) {
+        size_ok = lseek(fd, 0, SEEK_END) >= required;
+    } else {
+        size_ok = ftruncate(fd, required) == 0;
+    }
+    if (!size_ok) {
+        printf("交换文件 %s 容量不足 %lld 字节\n", dev->path, (long long)required);
+        close(fd);
+        return false;
+    }
+
+    if (dev->direct_io && !bounce) {
+        void* buffer = NULL;
+        if (posix_memalign(&buffer, SWAPDEV_ALIGNMENT, SWAP_BLOCK_SIZE) != 0) {
+            printf("分配对齐缓冲区失败\n");
+            close(fd);
+            return false;
+        }
+        bounce = (uint8_t*)buffer;
+    }
+
+    dev->fd = fd;
+    return true;
+}
+
+// 完整写入一个块（pwrite 可能只写入一部分）
+static bool file_write(SwapDevice* dev, uint32_t swap_index, const void* data) {
+    const uint8_t* src = (const uint8_t*)data;
+    if (dev->direct_io) {
+        memcpy(bounce, data, SWAP_BLOCK_SIZE);
+        src = bounce;
+    }
+
+    off_t offset = (off_t)swap_index * SWAP_BLOCK_SIZE;
+    size_t done = 0;
+    while (done < SWAP_BLOCK_SIZE) {
+        ssize_t n = pwrite(dev->fd, src + done, SWAP_BLOCK_SIZE - done, offset + (off_t)done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            printf("写入交换文件失败（块 %u）: %s\n", swap_index, strerror(errno));
+            return false;
+        }
+        done += (size_t)n;
+    }
+
+    if (dev->sync == SWAPDEV_SYNC_WRITE && fdatasync(dev->fd) != 0) {
+        printf("同步交换文件失败: %s\n", strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+// 完整读取一个块
+static bool file_read(SwapDevice* dev, uint32_t swap_index, void* buffer) {
+    uint8_t* dst = dev->direct_io ? bounce : (uint8_t*)buffer;
+
+    off_t offset = (off_t)swap_index * SWAP_BLOCK_SIZE;
+    size_t done = 0;
+    while (done < SWAP_BLOCK_SIZE) {
+        ssize_t n = pread(dev->fd, dst + done, SWAP_BLOCK_SIZE - done, offset + (off_t)done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            printf("读取交换文件失败（块 %u）: %s\n", swap_index, n < 0 ? strerror(errno) : "文件过短");
+            return false;
+        }
+        done += (size_t)n;
+    }
+
+    if (dev->direct_io) {
+        memcpy(buffer, bounce, SWAP_BLOCK_SIZE);
+    }
+    return true;
+}
+#endif
+
+static bool device_open(SwapDevice* dev, bool truncate) {
+    dev->fd = -1;
+    dev->area = NULL;
+
+    if (dev->type == SWAPDEV_MEMORY) {
+        dev->area = (uint8_t*)malloc((size_t)SWAP_SIZE * SWAP_BLOCK_SIZE);
+        return dev->area != NULL;
+    }
+
+#ifdef _WIN32
+    (void)truncate;
+    printf("当前平台不支持文件交换设备\n");
+    return false;
+#else
+    return file_open(dev, truncate);
+#endif
+}
+
+static void device_close(SwapDevice* dev) {
+    if (dev->type == SWAPDEV_MEMORY) {
+        free(dev->area);
+        dev->area = NULL;
+        return;
+    }
+#ifndef _WIN32
+    if (dev->fd >= 0) {
+        close(dev->fd);
+    }
+#endif
+    dev->fd = -1;
+}
+
+static bool device_write(SwapDevice* dev, uint32_t swap_index, const void* data) {
+    if (dev->type == SWAPDEV_MEMORY) {
+        memcpy(dev->area + (size_t)swap_index * SWAP_BLOCK_SIZE, data, SWAP_BLOCK_SIZE);
+        return true;
+    }
+#ifdef _WIN32
+    return false;
+#else
+    return file_write(dev, swap_index, data);
+#endif
+}
+
+static bool device_read(SwapDevice* dev, uint32_t swap_index, void* buffer) {
+    if (dev->type == SWAPDEV_MEMORY) {
+        memcpy(buffer, dev->area + (size_t)swap_index * SWAP_BLOCK_SIZE, SWAP_BLOCK_SIZE);
+        return true;
+    }
+#ifdef _WIN32
+    return false;
+#else
+    return file_read(dev, swap_index, buffer);
+#endif
+}
+
+/**
+ * @brief 按当前配置打开交换设备
+ *
+ * 文件设备打开失败时退回内存交换区，只有内存交换区也无法分配时返回 false。
+ */
+bool swapdev_init(void) {
+    memset(&stats, 0, sizeof(stats));
+
+    if (!device_open(&device, true)) {
+        if (device.type == SWAPDEV_MEMORY) {
+            return false;
+        }
+        printf("交换文件不可用，改用内存交换区\n");
+        device.type = SWAPDEV_MEMORY;
+        if (!device_open(&device, true)) {
+            return false;
+        }
+    }
+
+    vm_manager.swap_area = device.area;
+    return true;
+}
+
+// 关闭交换设备，保留设备配置供下次 swapdev_init 使用
+void swapdev_shutdown(void) {
+    device_close(&device);
+    vm_manager.swap_area = NULL;
+    free(bounce);
+    bounce = NULL;
+}
+
+/**
+ * @brief 切换到新的交换设备
+ *
+ * 先打开新设备，再把所有已使用的交换区块逐块复制过去，全部成功后才关闭旧设备；
+ * 任一步失败时保持原设备不变。
+ *
+ * @param next 新设备配置
+ * @param migrate 是否迁移已使用的交换区块
+ */
+static bool switch_device(SwapDevice* next, bool migrate) {
+    // 等待异步请求完成，之后旧设备的描述符才能关闭
+    swapio_drain();
+
+    if (!device_open(next, migrate)) {
+        return false;
+    }
+
+    uint32_t migrated = 0;
+    if (migrate) {
+        uint8_t buffer[SWAP_BLOCK_SIZE];
+        for (uint32_t i = 0; i < SWAP_SIZE; i++) {
+            if (!vm_manager.swap_blocks || !vm_manager.swap_blocks[i].is_used) {
+                continue;
+            }
+            if (!device_read(&device, i, buffer) || !device_write(next, i, buffer)) {
+                printf("迁移交换区块 %u 失败，保持原交换设备\n", i);
+                device_close(next);
+                return false;
+            }
+            migrated++;
+        }
+    }
+
+    device_close(&device);
+    device = *next;
+    vm_manager.swap_area = device.area;
+    printf("已迁移 %u 个交换区块\n", migrated);
+    return true;
+}
+
+bool swapdev_use_memory(void) {
+    if (device.type == SWAPDEV_MEMORY) {
+        printf("已在使用内存交换区\n");
+        return true;
+    }
+
+    SwapDevice next = { .type = SWAPDEV_MEMORY, .sync = SWAPDEV_SYNC_NONE, .fd = -1 };
+    if (!switch_device(&next, true)) {
+        return false;
+    }
+    printf("交换设备已切换为内存交换区\n");
+    return true;
+}
+
+bool swapdev_use_file(const char* path, bool direct_io, SwapDevSync sync) {
+    if (!path || path[0] == '\0' || strlen(path) >= SWAPDEV_PATH_MAX) {
+        printf("无效的交换文件路径\n");
+        return false;
+    }
+
+    SwapDevice next = { .type = SWAPDEV_FILE, .direct_io = direct_io, .sync = sync, .fd = -1 };
+    strcpy(next.path, path);
+
+    // 同一文件只更换打开方式，不截断也不迁移
+    bool same_file = device.type == SWAPDEV_FILE && strcmp(device.path, path) == 0;
+    if (!switch_device(&next, !same_file)) {
+        return false;
+    }
+    printf("交换设备已切换为文件 %s（%s，同步方式：%s）\n", device.path,
+           device.direct_io ? "O_DIRECT" : "缓冲 I/O", get_swapdev_sync_name(device.sync));
+    return true;
+}
+
+// 写入一个交换区块，统计耗时
+bool swapdev_write(uint32_t swap_index, const void* data) {
+    if (swap_index >= SWAP_SIZE || !data) {
+        return false;
+    }
+
+    uint64_t start = metrics_now_ns();
+    bool ok = device_write(&device, swap_index, data);
+    uint64_t elapsed_ns = metrics_now_ns() - start;
+    uint64_t elapsed = elapsed_ns / 1000;
+
+    if (!ok) {
+        stats.errors++;
+        return false;
+    }
+    stats.writes++;
+    stats.write_time_us += elapsed;
+    metrics_observe_ns(METRIC_SWAP_WRITE, elapsed_ns);
+    trace_complete(TRACE_SWAP_WRITE, start, 0, swap_index, 0, 0);
+    if (elapsed > stats.max_write_us) {
+        stats.max_write_us = elapsed;
+    }
+    return true;
+}
+
+// 读取一个交换区块，统计耗时
+bool swapdev_read(uint32_t swap_index, void* buffer) {
+    if (swap_index >= SWAP_SIZE || !buffer) {
+        return false;
+    }
+
+    uint64_t start = metrics_now_ns();
+    bool ok = device_read(&device, swap_index, buffer);
+    uint64_t elapsed_ns = metrics_now_ns() - start;
+    uint64_t elapsed = elapsed_ns / 1000;
+
+    if (!ok) {
+        stats.errors++;
+        return false;
+    }
+    stats.reads++;
+    stats.read_time_us += elapsed;
+    metrics_observe_ns(METRIC_SWAP_READ, elapsed_ns);
+    trace_complete(TRACE_SWAP_READ, start, 0, swap_index, 0, 0);
+    if (elapsed > stats.max_read_us) {
+        stats.max_read_us = elapsed;
+    }
+    return true;
+}
+
+int swapdev_get_fd(void) {
+    return device.type == SWAPDEV_FILE ? device.fd : -1;
+}
+
+SwapDevSync swapdev_get_sync(void) {
+    return device.sync;
+}
+
+const char* get_swapdev_sync_name(SwapDevSync sync) {
+    switch (sync) {
+        case SWAPDEV_SYNC_WRITE: return "每次写入后 fdatasync";
+        case SWAPDEV_SYNC_DSYNC: return "O_DSYNC";
+        default: return "不同步";
+    }
+}
+
+SwapDevStats get_swapdev_stats(void) {
+    return stats;
+}
+
+// 打印交换设备配置和读写统计
+void print_swapdev_stats(void) {
+    printf("\n=== 交换设备统计信息 ===\n");
+    if (device.type == SWAPDEV_MEMORY) {
+        printf("交换设备: 内存交换区\n");
+    } else {
+        printf("交换设备: 文件 %s\n", device.path);
+        printf("I/O 方式: %s\n", device.direct_io ? "O_DIRECT" : "缓冲 I/O");
+        printf("同步方式: %s\n", get_swapdev_sync_name(device.sync));
+    }
+    printf("交换区容量: %llu KB\n", (unsigned long long)SWAP_SIZE * SWAP_BLOCK_SIZE / 1024);
+    printf("读取块数: %u，平均耗时: %.2f 微秒，最大耗时: %llu 微秒\n", stats.reads,
+           stats.reads > 0 ? (double)stats.read_time_us / stats.reads : 0.0,
+           (unsigned long long)stats.max_read_us);
+    printf("写入块数: %u，平均耗时: %.2f 微秒，最大耗时: %llu 微秒\n", stats.writes,
+           stats.writes > 0 ? (double)stats.write_time_us / stats.writes : 0.0,
+           (unsigned long long)stats.max_write_us);
+    printf("读写失败次数: %u\n", stats.errors);
+}
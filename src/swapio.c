@@ -0,0 +1,850 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#ifndef _WIN32
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/uio.h>
+#endif
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#define SWAPIO_HAVE_URING 1
+#endif
+#endif
+#include "../include/swapio.h"
+#include "../include/swapdev.h"
+#include "../include/zswap.h"
+#include "../include/memory.h"
+#include "../include/vm.h"
+#include "../include/dump.h"
+#include "../include/metrics.h"
+#include "../include/trace.h"
+
+// 请求状态
+typedef enum {
+    REQ_FREE,       // 空闲
+    REQ_QUEUED,     // 已排队，等待批量提交
+    REQ_INFLIGHT,   // 已提交给引擎
+    REQ_DONE        // 引擎已完成，等待收割
+} RequestState;
+
+// 一个交换区块的读写请求
+typedef struct {
+    RequestState state;
+    bool is_write;
+    bool claimed;           // 线程池：已被工作线程取走
+    bool cancelled;         // 读请求所属进程已销毁
+    uint32_t swap_index;
+    uint32_t pid;           // 读请求：缺页进程
+    uint32_t virtual_page;  // 读请求：缺页的虚拟页号
+    uint32_t frame;         // 读请求：预留的页框
+    int fd;
+    int result;             // 完成的字节数，失败时为负的错误码
+    uint64_t queue_time;
+    uint8_t* buffer;        // 对齐的页面缓冲区（满足 O_DIRECT）
+#ifndef _WIN32
+    struct iovec iov;
+#endif
+} SwapIoRequest;
+
+static SwapIoRequest requests[SWAPIO_QUEUE_DEPTH];
+static uint8_t* buffers = NULL;
+static SwapIoEngine engine = SWAPIO_ENGINE_SYNC;
+static bool enabled = true;
+static bool initialized = false;
+static SwapIoStats stats;
+
+#ifdef _WIN32
+#define SWAPIO_LOCK()
+#define SWAPIO_UNLOCK()
+#else
+// 线程池引擎中请求状态由工作线程修改，主线程访问时同样加锁
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t work_ready = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t work_done = PTHREAD_COND_INITIALIZER;
+static pthread_t workers[SWAPIO_WORKERS];
+static uint32_t worker_count = 0;
+static bool stopping = false;
+#define SWAPIO_LOCK()   pthread_mutex_lock(&lock)
+#define SWAPIO_UNLOCK() pthread_mutex_unlock(&lock)
+#endif
+
+// 同步执行一个请求（同步引擎、工作线程）
+static int do_io(SwapIoRequest* req) {
+#ifdef _WIN32
+    (void)req;
+    return -ENOSYS;
+#else
+    off_t offset = (off_t)req->swap_index * SWAP_BLOCK_SIZE;
+    uint64_t start = metrics_now_ns();
+    size_t done = 0;
+    while (done < SWAP_BLOCK_SIZE) {
+        ssize_t n = req->is_write ?
+            pwrite(req->fd, req->buffer + done, SWAP_BLOCK_SIZE - done, offset + (off_t)done) :
+            pread(req->fd, req->buffer + done, SWAP_BLOCK_SIZE - done, offset + (off_t)done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            return -errno;
+        }
+        if (n == 0) {
+            break;
+        }
+        done += (size_t)n;
+    }
+    // 工作线程各自写入自己的指标分片和事件缓冲区
+    metrics_observe_ns(req->is_write ? METRIC_SWAP_WRITE : METRIC_SWAP_READ, metrics_now_ns() - start);
+    trace_complete(req->is_write ? TRACE_SWAP_WRITE : TRACE_SWAP_READ, start,
+                   req->is_write ? 0 : req->pid, req->swap_index, 0, 0);
+    return (int)done;
+#endif
+}
+
+#ifdef SWAPIO_HAVE_URING
+// io_uring 提交队列和完成队列（直接使用系统调用，不依赖 liburing）
+typedef struct {
+    int fd;
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    struct io_uring_sqe* sqes;
+    struct io_uring_cqe* cqes;
+    void* sq_ptr;
+    void* cq_ptr;
+    size_t sq_size;
+    size_t cq_size;
+    size_t sqes_size;
+} UringRing;
+
+static UringRing ring = { .fd = -1 };
+
+static void uring_teardown(void) {
+    if (ring.sqes) munmap(ring.sqes, ring.sqes_size);
+    if (ring.cq_ptr && ring.cq_ptr != ring.sq_ptr) munmap(ring.cq_ptr, ring.cq_size);
+    if (ring.sq_ptr) munmap(ring.sq_ptr, ring.sq_size);
+    if (ring.fd >= 0) close(ring.fd);
+    memset(&ring, 0, sizeof(ring));
+    ring.fd = -1;
+}
+
+static bool uring_setup(void) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ring.fd = (int)syscall(__NR_io_uring_setup, SWAPIO_QUEUE_DEPTH, &params);
+    if (ring.fd < 0) {
+        ring.fd = -1;
+        return false;
+    }
+
+    ring.sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring.cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        if (ring.cq_size > ring.sq_size) ring.sq_size = ring.cq_size;
+        ring.cq_size = ring.sq_size;
+    }
+
+    ring.sq_ptr = mmap(NULL, ring.sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       ring.fd, IORING_OFF_SQ_RING);
+    if (ring.sq_ptr == MAP_FAILED) {
+        ring.sq_ptr = NULL;
+        uring_teardown();
+        return false;
+    }
+    ring.cq_ptr = single_mmap ? ring.sq_ptr :
+        mmap(NULL, ring.cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+             ring.fd, IORING_OFF_CQ_RING);
+    if (ring.cq_ptr == MAP_FAILED) {
+        ring.cq_ptr = NULL;
+        uring_teardown();
+        return false;
+    }
+    ring.sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring.sqes = mmap(NULL, ring.sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                     ring.fd, IORING_OFF_SQES);
+    if (ring.sqes == MAP_FAILED) {
+        ring.sqes = NULL;
+        uring_teardown();
+        return false;
+    }
+
+    uint8_t* sq = (uint8_t*)ring.sq_ptr;
+    uint8_t* cq = (uint8_t*)ring.cq_ptr;
+    ring.sq_tail = (unsigned*)(sq + params.sq_off.tail);
+    ring.sq_mask = (unsigned*)(sq + params.sq_off.ring_mask);
+    ring.sq_array = (unsigned*)(sq + params.sq_off.array);
+    ring.cq_head = (unsigned*)(cq + params.cq_off.head);
+    ring.cq_tail = (unsigned*)(cq + params.cq_off.tail);
+    ring.cq_mask = (unsigned*)(cq + params.cq_off.ring_mask);
+    ring.cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+    return true;
+}
+
+// 把请求放入提交队列（请求数不超过队列深度，提交队列不会溢出）
+static void uring_push(SwapIoRequest* req, uint32_t id) {
+    unsigned tail = *ring.sq_tail;
+    unsigned index = tail & *ring.sq_mask;
+    struct io_uring_sqe* sqe = &ring.sqes[index];
+
+    req->iov.iov_base = req->buffer;
+    req->iov.iov_len = SWAP_BLOCK_SIZE;
+
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = req->is_write ? IORING_OP_WRITEV : IORING_OP_READV;
+    sqe->fd = req->fd;
+    sqe->addr = (uint64_t)(uintptr_t)&req->iov;
+    sqe->len = 1;
+    sqe->off = (uint64_t)req->swap_index * SWAP_BLOCK_SIZE;
+    sqe->user_data = id;
+
+    ring.sq_array[index] = index;
+    __atomic_store_n(ring.sq_tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+static int uring_enter(unsigned to_submit, unsigned min_complete) {
+    unsigned flags = min_complete > 0 ? IORING_ENTER_GETEVENTS : 0;
+    return (int)syscall(__NR_io_uring_enter, ring.fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+// 把完成队列中的事件转换为请求状态
+static uint32_t uring_collect(void) {
+    unsigned head = *ring.cq_head;
+    uint32_t count = 0;
+    while (head != __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE)) {
+        struct io_uring_cqe* cqe = &ring.cqes[head & *ring.cq_mask];
+        SwapIoRequest* req = &requests[cqe->user_data];
+        req->result = cqe->res;
+        req->state = REQ_DONE;
+        head++;
+        count++;
+    }
+    __atomic_store_n(ring.cq_head, head, __ATOMIC_RELEASE);
+    return count;
+}
+#endif
+
+#ifndef _WIN32
+// 工作线程：取出已提交的请求执行 pread/pwrite
+static void* worker_main(void* arg) {
+    (void)arg;
+    pthread_mutex_lock(&lock);
+    while (!stopping) {
+        SwapIoRequest* req = NULL;
+        for (uint32_t i = 0; i < SWAPIO_QUEUE_DEPTH; i++) {
+            if (requests[i].state == REQ_INFLIGHT && !requests[i].claimed) {
+                req = &requests[i];
+                req->claimed = true;
+                break;
+            }
+        }
+        if (!req) {
+            pthread_cond_wait(&work_ready, &lock);
+            continue;
+        }
+
+        pthread_mutex_unlock(&lock);
+        int result = do_io(req);
+        pthread_mutex_lock(&lock);
+
+        req->result = result;
+        req->state = REQ_DONE;
+        pthread_cond_signal(&work_done);
+    }
+    pthread_mutex_unlock(&lock);
+    trace_thread_exit();
+    return NULL;
+}
+
+static bool threads_start(void) {
+    stopping = false;
+    for (worker_count = 0; worker_count < SWAPIO_WORKERS; worker_count++) {
+        if (pthread_create(&workers[worker_count], NULL, worker_main, NULL) != 0) {
+            break;
+        }
+    }
+    return worker_count > 0;
+}
+
+static void threads_stop(void) {
+    pthread_mutex_lock(&lock);
+    stopping = true;
+    pthread_cond_broadcast(&work_ready);
+    pthread_mutex_unlock(&lock);
+    for (uint32_t i = 0; i < worker_count; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    worker_count = 0;
+}
+#endif
+
+// 初始化异步I/O引擎：优先 io_uring，其次线程池，都不可用时同步执行
+void swapio_init(void) {
+    if (initialized) {
+        return;
+    }
+
+    memset(requests, 0, sizeof(requests));
+    memset(&stats, 0, sizeof(stats));
+
+#ifdef _WIN32
+    buffers = (uint8_t*)malloc(SWAPIO_QUEUE_DEPTH * SWAP_BLOCK_SIZE);
+#else
+    void* memory = NULL;
+    if (posix_memalign(&memory, SWAPDEV_ALIGNMENT, SWAPIO_QUEUE_DEPTH * SWAP_BLOCK_SIZE) != 0) {
+        memory = NULL;
+    }
+    buffers = (uint8_t*)memory;
+#endif
+    if (!buffers) {
+        printf("异步交换I/O缓冲区分配失败，交换区读写保持同步\n");
+        return;
+    }
+    for (uint32_t i = 0; i < SWAPIO_QUEUE_DEPTH; i++) {
+        requests[i].buffer = buffers + (size_t)i * SWAP_BLOCK_SIZE;
+    }
+
+    engine = SWAPIO_ENGINE_SYNC;
+#ifdef SWAPIO_HAVE_URING
+    if (uring_setup()) {
+        engine = SWAPIO_ENGINE_URING;
+    }
+#endif
+#ifndef _WIN32
+    if (engine == SWAPIO_ENGINE_SYNC && threads_start()) {
+        engine = SWAPIO_ENGINE_THREADS;
+    }
+#endif
+    initialized = true;
+}
+
+void swapio_shutdown(void) {
+    if (!initialized) {
+        return;
+    }
+    swapio_drain();
+
+#ifdef SWAPIO_HAVE_URING
+    if (engine == SWAPIO_ENGINE_URING) {
+        uring_teardown();
+    }
+#endif
+#ifndef _WIN32
+    if (engine == SWAPIO_ENGINE_THREADS) {
+        threads_stop();
+    }
+#endif
+    free(buffers);
+    buffers = NULL;
+    initialized = false;
+}
+
+// 只有交换设备是文件时才走异步路径，内存交换区直接复制更快
+bool swapio_is_active(void) {
+    return initialized && enabled && swapdev_get_fd() >= 0;
+}
+
+void swapio_set_enabled(bool enable) {
+    if (!enable) {
+        swapio_drain();
+    }
+    enabled = enable;
+    printf("异步交换I/O已%s（引擎：%s）\n", enable ? "开启" : "关闭", get_swapio_engine_name());
+}
+
+// 查找交换区块上未完成的请求
+static int find_request(uint32_t swap_index) {
+    int id = -1;
+    SWAPIO_LOCK();
+    for (uint32_t i = 0; i < SWAPIO_QUEUE_DEPTH && id < 0; i++) {
+        if (requests[i].state != REQ_FREE && requests[i].swap_index == swap_index) {
+            id = (int)i;
+        }
+    }
+    SWAPIO_UNLOCK();
+    return id;
+}
+
+// 查找进程页面上未完成的换入请求
+static int find_fault(uint32_t pid, uint32_t virtual_page) {
+    int id = -1;
+    SWAPIO_LOCK();
+    for (uint32_t i = 0; i < SWAPIO_QUEUE_DEPTH && id < 0; i++) {
+        SwapIoRequest* req = &requests[i];
+        if (req->state != REQ_FREE && !req->is_write && !req->cancelled &&
+            req->pid == pid && req->virtual_page == virtual_page) {
+            id = (int)i;
+        }
+    }
+    SWAPIO_UNLOCK();
+    return id;
+}
+
+// 批量提交所有排队的请求
+static void submit_queued(void) {
+    uint32_t submitted = 0;
+    uint32_t outstanding = 0;
+    int fd = swapdev_get_fd();
+
+    SWAPIO_LOCK();
+    for (uint32_t i = 0; i < SWAPIO_QUEUE_DEPTH; i++) {
+        SwapIoRequest* req = &requests[i];
+        if (req->state != REQ_FREE) {
+            outstanding++;
+        }
+        if (req->state != REQ_QUEUED) {
+            continue;
+        }
+
+        req->fd = fd;
+        req->claimed = false;
+        req->state = REQ_INFLIGHT;
+        submitted++;
+
+#ifdef SWAPIO_HAVE_URING
+        if (engine == SWAPIO_ENGINE_URING) {
+            uring_push(req, i);
+            continue;
+        }
+#endif
+        if (engine == SWAPIO_ENGINE_SYNC) {
+            req->result = do_io(req);
+            req->state = REQ_DONE;
+        }
+    }
+#ifndef _WIN32
+    if (submitted > 0 && engine == SWAPIO_ENGINE_THREADS) {
+        pthread_cond_broadcast(&work_ready);
+    }
+#endif
+    SWAPIO_UNLOCK();
+
+    if (submitted == 0) {
+        return;
+    }
+
+#ifdef SWAPIO_HAVE_URING
+    if (engine == SWAPIO_ENGINE_URING) {
+        uint32_t remaining = submitted;
+        while (remaining > 0) {
+            int n = uring_enter(remaining, 0);
+            if (n < 0 && (errno == EINTR || errno == EAGAIN || errno == EBUSY)) {
+                continue;
+            }
+            if (n <= 0) {
+                printf("io_uring 提交失败: %s\n", strerror(errno));
+                break;
+            }
+            remaining -= (uint32_t)n;
+        }
+    }
+#endif
+
+    stats.submit_batches++;
+    if (outstanding > stats.max_inflight) {
+        stats.max_inflight = outstanding;
+    }
+}
+
+// 等待至少一个已提交的请求完成
+static void wait_for_completion(void) {
+    bool has_inflight = false;
+    bool has_done = false;
+    SWAPIO_LOCK();
+    for (uint32_t i = 0; i < SWAPIO_QUEUE_DEPTH; i++) {
+        if (requests[i].state == REQ_INFLIGHT) has_inflight = true;
+        if (requests[i].state == REQ_DONE) has_done = true;
+    }
+    SWAPIO_UNLOCK();
+    if (has_done || !has_inflight) {
+        return;
+    }
+
+#ifdef SWAPIO_HAVE_URING
+    if (engine == SWAPIO_ENGINE_URING) {
+        while (uring_collect() == 0) {
+            if (uring_enter(0, 1) < 0 && errno != EINTR) {
+                printf("io_uring 等待失败: %s\n", strerror(errno));
+                return;
+            }
+        }
+        return;
+    }
+#endif
+#ifndef _WIN32
+    if (engine == SWAPIO_ENGINE_THREADS) {
+        pthread_mutex_lock(&lock);
+        for (;;) {
+            bool done = false;
+            for (uint32_t i = 0; i < SWAPIO_QUEUE_DEPTH && !done; i++) {
+                done = requests[i].state == REQ_DONE;
+            }
+            if (done) break;
+            pthread_cond_wait(&work_done, &lock);
+        }
+        pthread_mutex_unlock(&lock);
+    }
+#endif
+}
+
+// 换入完成：把数据放入预留的页框，更新页表项并唤醒进程
+static void complete_fault(SwapIoRequest* req, bool ok) {
+    PCB* process = get_process_by_pid(req->pid);
+    FrameInfo* info = &memory_manager.frames[req->frame];
+    info->is_swapping = false;
+
+    if (!process || !process->page_table || req->virtual_page >= process->page_table_size) {
+        release_frame(req->frame, req->pid, req->virtual_page);
+        return;
+    }
+
+    PageTableEntry* pte = &process->page_table[req->virtual_page];
+    if (!ok || !write_physical_memory(req->frame, 0, req->buffer, PAGE_SIZE)) {
+        printf("错误：进程 %u 的页面 %u 换入失败，页面仍在交换区\n", req->pid, req->virtual_page);
+        trace_complete(TRACE_FAULT, req->queue_time * 1000, req->pid, req->virtual_page, TRACE_FAULT_ASYNC, 0);
+        release_frame(req->frame, req->pid, req->virtual_page);
+        wake_up_process(process);
+        return;
+    }
+
+    free_swap_block(req->swap_index);
+    info->is_dirty = false;
+    info->last_access_time = get_current_time();
+
+    pte->frame_number = req->frame;
+    pte->flags.present = true;
+    pte->flags.swapped = false;
+    pte->last_access_time = info->last_access_time;
+
+    vm_manager.stats.disk_reads++;
+    vm_manager.stats.pages_swapped_in++;
+    vm_manager.stats.major_faults++;
+    vm_manager.stats.major_fault_time_us += get_current_time() - req->queue_time;
+    process->stats.pages_swapped_in++;
+    metrics_observe_ns(METRIC_FAULT_SERVICE, (get_current_time() - req->queue_time) * 1000);
+    trace_complete(TRACE_FAULT, req->queue_time * 1000, req->pid, req->virtual_page, TRACE_FAULT_ASYNC, 1);
+
+    printf("进程 %u 的页面 %u 已从交换区块 %u 读入页框 %u\n",
+           req->pid, req->virtual_page, req->swap_index, req->frame);
+    wake_up_process(process);
+}
+
+// 收割所有已完成的请求，返回完成的换入数
+static uint32_t reap_completed(void) {
+#ifdef SWAPIO_HAVE_URING
+    if (engine == SWAPIO_ENGINE_URING) {
+        uring_collect();
+    }
+#endif
+
+    uint32_t completed = 0, faults = 0;
+    bool wrote = false;
+    for (uint32_t i = 0; i < SWAPIO_QUEUE_DEPTH; i++) {
+        SwapIoRequest* req = &requests[i];
+        SWAPIO_LOCK();
+        bool done = req->state == REQ_DONE;
+        SWAPIO_UNLOCK();
+        if (!done) {
+            continue;
+        }
+
+        uint64_t latency = get_current_time() - req->queue_time;
+        bool ok = req->result == (int)SWAP_BLOCK_SIZE;
+        completed++;
+#ifdef SWAPIO_HAVE_URING
+        // io_uring 请求不经过 do_io，按提交到完成的延迟记录
+        if (engine == SWAPIO_ENGINE_URING && ok) {
+            metrics_observe_ns(req->is_write ? METRIC_SWAP_WRITE : METRIC_SWAP_READ, latency * 1000);
+            trace_complete(req->is_write ? TRACE_SWAP_WRITE : TRACE_SWAP_READ, req->queue_time * 1000,
+                           req->is_write ? 0 : req->pid, req->swap_index, 0, 0);
+        }
+#endif
+
+        if (req->is_write) {
+            // 异步写入失败时用同步方式重试，缓冲区中的数据是页面的唯一副本
+            if (!ok) {
+                stats.retries++;
+                if (!swapdev_write(req->swap_index, req->buffer)) {
+                    printf("错误：交换区块 %u 写入失败，页面数据丢失\n", req->swap_index);
+                }
+            }
+            stats.write_latency_us += latency;
+            wrote = true;
+        } else {
+            stats.read_latency_us += latency;
+            if (!req->cancelled) {
+                if (!ok) {
+                    stats.retries++;
+                    ok = swapdev_read(req->swap_index, req->buffer);
+                }
+                complete_fault(req, ok);
+                faults++;
+            }
+        }
+
+        SWAPIO_LOCK();
+        req->state = REQ_FREE;
+        SWAPIO_UNLOCK();
+    }
+
+    if (completed > 0) {
+        stats.completions += completed;
+        stats.reap_batches++;
+    }
+
+    // 按批同步：一批写入完成后只调用一次 fdatasync
+#ifndef _WIN32
+    if (wrote && swapdev_get_sync() == SWAPDEV_SYNC_WRITE && swapdev_get_fd() >= 0) {
+        fdatasync(swapdev_get_fd());
+        stats.syncs++;
+    }
+#else
+    (void)wrote;
+#endif
+    return faults;
+}
+
+// 取得一个空闲请求槽位，队列已满时提交并等待请求完成
+static int get_free_request(void) {
+    for (;;) {
+        SWAPIO_LOCK();
+        for (uint32_t i = 0; i < SWAPIO_QUEUE_DEPTH; i++) {
+            if (requests[i].state == REQ_FREE) {
+                requests[i].state = REQ_QUEUED;
+                SWAPIO_UNLOCK();
+                return (int)i;
+            }
+        }
+        SWAPIO_UNLOCK();
+
+        submit_queued();
+        wait_for_completion();
+        reap_completed();
+    }
+}
+
+// 等待交换区块上未完成的请求，保证同一块的读写按顺序执行
+static void wait_index(uint32_t swap_index) {
+    while (find_request(swap_index) >= 0) {
+        submit_queued();
+        wait_for_completion();
+        reap_completed();
+    }
+}
+
+bool swapio_queue_write(uint32_t swap_index, const void* data) {
+    if (!swapio_is_active() || swap_index >= SWAP_SIZE || !data) {
+        return false;
+    }
+
+    wait_index(swap_index);
+
+    int id = get_free_request();
+    SwapIoRequest* req = &requests[id];
+    req->is_write = true;
+    req->cancelled = false;
+    req->swap_index = swap_index;
+    req->pid = 0;
+    req->virtual_page = 0;
+    req->frame = (uint32_t)-1;
+    req->queue_time = get_current_time();
+    memcpy(req->buffer, data, SWAP_BLOCK_SIZE);
+    stats.writes++;
+    return true;
+}
+
+bool swapio_read_pending(uint32_t swap_index, void* buffer) {
+    if (!initialized) {
+        return false;
+    }
+
+    bool found = false;
+    SWAPIO_LOCK();
+    for (uint32_t i = 0; i < SWAPIO_QUEUE_DEPTH && !found; i++) {
+        SwapIoRequest* req = &requests[i];
+        if (req->state != REQ_FREE && req->is_write && req->swap_index == swap_index) {
+            memcpy(buffer, req->buffer, SWAP_BLOCK_SIZE);
+            stats.pending_write_hits++;
+            found = true;
+        }
+    }
+    SWAPIO_UNLOCK();
+    return found;
+}
+
+/**
+ * @brief 发起异步换入：预留页框、提交读请求，并把进程移入阻塞队列
+ *
+ * 页面在压缩池、尚未落盘的写请求或恢复后的快照文件中时返回 false，
+ * 由调用者同步处理（这些情况不需要访问交换设备）。
+ *
+ * @return true 进程已阻塞，等待换入完成
+ */
+bool swapio_start_fault(PCB* process, uint32_t virtual_page) {
+    if (!swapio_is_active() || !process || virtual_page >= process->page_table_size) {
+        return false;
+    }
+
+    if (find_fault(process->pid, virtual_page) >= 0) {
+        printf("进程 %u 的页面 %u 正在换入，继续等待\n", process->pid, virtual_page);
+        return true;
+    }
+
+    uint32_t swap_index = find_swap_block(process->pid, virtual_page);
+    if (swap_index == (uint32_t)-1 || zswap_contains(swap_index) || dump_swap_is_lazy(swap_index) ||
+        find_request(swap_index) >= 0) {
+        return false;
+    }
+
+    uint32_t frame = obtain_frame_for_page(process, virtual_page);
+    if (frame == (uint32_t)-1) {
+        return false;
+    }
+    // 读取期间锁定页框，防止被选为牺牲页框
+    memory_manager.frames[frame].is_swapping = true;
+
+    int id = get_free_request();
+    SwapIoRequest* req = &requests[id];
+    req->is_write = false;
+    req->cancelled = false;
+    req->swap_index = swap_index;
+    req->pid = process->pid;
+    req->virtual_page = virtual_page;
+    req->frame = frame;
+    req->queue_time = get_current_time();
+    stats.reads++;
+
+    // 有进程在等待，立即提交（连同已排队的写请求一起）
+    submit_queued();
+
+    printf("进程 %u 的页面 %u 开始从交换区块 %u 读入页框 %u，进程阻塞等待\n",
+           process->pid, virtual_page, swap_index, frame);
+    block_process(process);
+    return true;
+}
+
+bool swapio_finish_fault(PCB* process, uint32_t virtual_page) {
+    if (!initialized || !process) {
+        return false;
+    }
+
+    int id = find_fault(process->pid, virtual_page);
+    if (id < 0) {
+        return false;
+    }
+
+    while (find_fault(process->pid, virtual_page) == id) {
+        submit_queued();
+        wait_for_completion();
+        reap_completed();
+    }
+    return process->page_table[virtual_page].flags.present;
+}
+
+void swapio_cancel_process(uint32_t pid) {
+    if (!initialized) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < SWAPIO_QUEUE_DEPTH; i++) {
+        SwapIoRequest* req = &requests[i];
+        SWAPIO_LOCK();
+        bool match = req->state != REQ_FREE && !req->is_write && !req->cancelled && req->pid == pid;
+        if (match) {
+            req->cancelled = true;
+            // 尚未提交的请求直接丢弃
+            if (req->state == REQ_QUEUED) {
+                req->state = REQ_FREE;
+            }
+        }
+        SWAPIO_UNLOCK();
+
+        if (match) {
+            memory_manager.frames[req->frame].is_swapping = false;
+            release_frame(req->frame, pid, req->virtual_page);
+        }
+    }
+}
+
+uint32_t swapio_poll(bool wait) {
+    if (!initialized) {
+        return 0;
+    }
+
+    submit_queued();
+    if (wait && swapio_pending_faults() > 0) {
+        wait_for_completion();
+    }
+    return reap_completed();
+}
+
+uint32_t swapio_pending_faults(void) {
+    uint32_t count = 0;
+    SWAPIO_LOCK();
+    for (uint32_t i = 0; i < SWAPIO_QUEUE_DEPTH; i++) {
+        if (requests[i].state != REQ_FREE && !requests[i].is_write && !requests[i].cancelled) {
+            count++;
+        }
+    }
+    SWAPIO_UNLOCK();
+    return count;
+}
+
+void swapio_drain(void) {
+    if (!initialized) {
+        return;
+    }
+
+    for (;;) {
+        bool busy = false;
+        SWAPIO_LOCK();
+        for (uint32_t i = 0; i < SWAPIO_QUEUE_DEPTH && !busy; i++) {
+            busy = requests[i].state != REQ_FREE;
+        }
+        SWAPIO_UNLOCK();
+        if (!busy) {
+            break;
+        }
+        submit_queued();
+        wait_for_completion();
+        reap_completed();
+    }
+}
+
+const char* get_swapio_engine_name(void) {
+    switch (engine) {
+        case SWAPIO_ENGINE_URING: return "io_uring";
+        case SWAPIO_ENGINE_THREADS: return "线程池";
+        default: return "同步";
+    }
+}
+
+SwapIoStats get_swapio_stats(void) {
+    return stats;
+}
+
+// 打印异步交换I/O统计信息
+void print_swapio_stats(void) {
+    uint32_t submitted = stats.reads + stats.writes;
+    printf("\n=== 异步交换I/O统计信息 ===\n");
+    printf("引擎: %s，状态: %s\n", get_swapio_engine_name(),
+           swapio_is_active() ? "生效" : (enabled ? "开启（交换设备不是文件，未生效）" : "关闭"));
+    printf("读请求数: %u，写请求数: %u\n", stats.reads, stats.writes);
+    printf("批量提交次数: %u，平均每批 %.2f 个请求\n", stats.submit_batches,
+           stats.submit_batches > 0 ? (double)submitted / stats.submit_batches : 0.0);
+    printf("完成收割批次: %u，平均每批 %.2f 个完成事件\n", stats.reap_batches,
+           stats.reap_batches > 0 ? (double)stats.completions / stats.reap_batches : 0.0);
+    printf("在途请求峰值: %u / %u\n", stats.max_inflight, SWAPIO_QUEUE_DEPTH);
+    printf("平均读延迟: %.2f 微秒，平均写延迟: %.2f 微秒\n",
+           stats.reads > 0 ? (double)stats.read_latency_us / stats.reads : 0.0,
+           stats.writes > 0 ? (double)stats.write_latency_us / stats.writes : 0.0);
+    printf("命中未落盘写请求次数: %u\n", stats.pending_write_hits);
+    printf("同步重试次数: %u，批量同步次数: %u\n", stats.retries, stats.syncs);
+}
@@ -0,0 +1,462 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../include/thp.h"
+#include "../include/tlb.h"
+#include "../include/memory.h"
+#include "../include/process.h"
+#include "../include/compact.h"
+
+// 透明大页管理器
+static ThpManager thp;
+
+// 每个大页对齐页框块中尚未写入的子页数，内存紧张时据此选择拆分的大页
+static uint32_t* untouched_counts = NULL;
+static uint32_t untouched_blocks = 0;
+
+// 初始化透明大页管理器（在 memory_init 之后调用，页框表中没有未写入子页标记）
+void thp_init(void) {
+    memset(&thp, 0, sizeof(ThpManager));
+    free(untouched_counts);
+    untouched_blocks = PHYSICAL_PAGES / HUGE_PAGE_PAGES;
+    untouched_counts = (uint32_t*)calloc(untouched_blocks + 1, sizeof(uint32_t));
+    if (!untouched_counts) {
+        printf("错误：透明大页子页计数表分配失败\n");
+        exit(1);
+    }
+    thp.scan_interval = THP_DEFAULT_SCAN_INTERVAL;
+    thp.regions_to_scan = THP_DEFAULT_REGIONS_TO_SCAN;
+    thp.max_ptes_none = HUGE_PAGE_PAGES / THP_MAX_PTES_NONE_DIVISOR;
+}
+
+void thp_set_enabled(bool enabled) {
+    thp.enabled = enabled;
+    thp.ticks = 0;
+    printf("透明大页已%s\n", enabled ? "开启" : "关闭");
+    if (enabled && HUGE_PAGE_PAGES > DRAM_PAGES) {
+        printf("注意：物理内存（%u 页）小于一个大页（%u 页），无法分配大页\n",
+               PHYSICAL_PAGES, HUGE_PAGE_PAGES);
+    }
+}
+
+// 配额模式下进程再占用 extra 个页框是否超过上限
+static bool quota_allows(PCB* process, uint32_t extra) {
+    if (get_replacement_scope() != REPLACE_QUOTA) {
+        return true;
+    }
+    uint32_t max_frames = get_process_max_frames(process);
+    return max_frames == 0 || get_process_private_frames(process) + extra <= max_frames;
+}
+
+// 大页子页刚被清零：标记为未写入，计入所在页框块
+static void mark_untouched(uint32_t frame) {
+    FrameInfo* info = &memory_manager.frames[frame];
+    if (!info->thp_untouched) {
+        info->thp_untouched = true;
+        untouched_counts[frame / HUGE_PAGE_PAGES]++;
+        thp.untouched++;
+    }
+}
+
+void thp_subpage_written(uint32_t frame) {
+    if (frame >= PHYSICAL_PAGES || !memory_manager.frames[frame].thp_untouched) {
+        return;
+    }
+    memory_manager.frames[frame].thp_untouched = false;
+    untouched_counts[frame / HUGE_PAGE_PAGES]--;
+    thp.untouched--;
+}
+
+// 把区域内的页表项映射到从 first 开始的连续页框，并标记为大页
+static void map_region(PCB* process, uint32_t base, uint32_t first) {
+    uint64_t now = get_current_time();
+    for (uint32_t i = 0; i < HUGE_PAGE_PAGES; i++) {
+        PageTableEntry* pte = &process->page_table[base + i];
+        frame_get(first + i, process->pid, base + i);
+        pte->frame_number = first + i;
+        pte->flags.present = true;
+        pte->flags.cow = false;
+        pte->flags.huge = true;
+        pte->last_access_time = now;
+    }
+}
+
+/**
+ * @brief 缺页时直接映射一个大页
+ *
+ * 缺页地址所在的对齐区域完全未被映射（没有驻留、换出、共享内存或文件映射的页面）时，
+ * 分配连续对齐的页框并清零，一次缺页映射整个区域。没有连续页框时退回普通页。
+ *
+ * @param process 缺页进程
+ * @param virtual_page 缺页的虚拟页号
+ * @return true 已映射大页
+ */
+bool thp_handle_fault(PCB* process, uint32_t virtual_page) {
+    if (!thp.enabled || !process || !process->page_table) {
+        return false;
+    }
+
+    uint32_t base = virtual_page & ~(HUGE_PAGE_PAGES - 1);
+    if ((uint64_t)base + HUGE_PAGE_PAGES > process->page_table_size) {
+        return false;
+    }
+    for (uint32_t i = 0; i < HUGE_PAGE_PAGES; i++) {
+        PageFlags* flags = &process->page_table[base + i].flags;
+        if (flags->present || flags->swapped || flags->shm || flags->file) {
+            return false;
+        }
+    }
+    if (!quota_allows(process, HUGE_PAGE_PAGES)) {
+        return false;
+    }
+
+    uint32_t first = compact_allocate_contiguous(HUGE_PAGE_PAGES, HUGE_PAGE_PAGES);
+    if (first == (uint32_t)-1) {
+        thp.fault_fallback++;
+        return false;
+    }
+    memset(get_physical_address(first), 0, (size_t)HUGE_PAGE_PAGES * PAGE_SIZE);
+    map_region(process, base, first);
+    for (uint32_t i = 0; i < HUGE_PAGE_PAGES; i++) {
+        mark_untouched(first + i);
+    }
+
+    thp.fault_alloc++;
+    printf("透明大页：进程 %u 的页面 %u-%u 映射到连续页框 %u-%u\n", process->pid,
+           base, base + HUGE_PAGE_PAGES - 1, first, first + HUGE_PAGE_PAGES - 1);
+    return true;
+}
+
+/**
+ * @brief 尝试把一个对齐区域合并为大页
+ *
+ * 区域内的页面必须是私有匿名页（不是写时复制共享、共享内存、文件映射，也没有换出），
+ * 未映射和映射零页框的页面不超过 max_ptes_none 个。页框本已连续对齐时原地标记，
+ * 否则分配新的连续页框，复制驻留页面、其余清零，再释放原页框。
+ *
+ * @return true 区域已合并为大页
+ */
+static bool collapse_region(PCB* process, uint32_t base) {
+    PageTableEntry* table = &process->page_table[base];
+    if (table[0].flags.huge) {
+        return false;
+    }
+
+    uint32_t resident = 0, none = 0;
+    bool in_place = table[0].flags.present && table[0].frame_number % HUGE_PAGE_PAGES == 0;
+    for (uint32_t i = 0; i < HUGE_PAGE_PAGES; i++) {
+        PageTableEntry* pte = &table[i];
+        if (pte->flags.shm || pte->flags.file || pte->flags.swapped) {
+            return false;
+        }
+        if (!pte->flags.present || is_zero_frame(pte->frame_number)) {
+            none++;
+            in_place = false;
+            continue;
+        }
+        FrameInfo* info = &memory_manager.frames[pte->frame_number];
+        if (pte->flags.cow || info->ref_count != 1 || info->is_swapping) {
+            return false;
+        }
+        if (pte->frame_number != table[0].frame_number + i) {
+            in_place = false;
+        }
+        resident++;
+    }
+    if (resident == 0 || none > thp.max_ptes_none) {
+        return false;
+    }
+
+    if (in_place) {
+        for (uint32_t i = 0; i < HUGE_PAGE_PAGES; i++) {
+            table[i].flags.huge = true;
+        }
+        thp.collapsed++;
+        thp.collapsed_in_place++;
+        printf("透明大页：进程 %u 的页面 %u-%u 已在连续页框中，原地合并为大页\n",
+               process->pid, base, base + HUGE_PAGE_PAGES - 1);
+        return true;
+    }
+
+    if (!quota_allows(process, none)) {
+        return false;
+    }
+    uint32_t first = compact_allocate_contiguous(HUGE_PAGE_PAGES, HUGE_PAGE_PAGES);
+    if (first == (uint32_t)-1) {
+        thp.collapse_failed++;
+        return false;
+    }
+
+    // 复制驻留页面并解除原映射，未映射的页面补零
+    for (uint32_t i = 0; i < HUGE_PAGE_PAGES; i++) {
+        PageTableEntry* pte = &table[i];
+        FrameInfo* dst = &memory_manager.frames[first + i];
+        if (!pte->flags.present) {
+            memset(get_physical_address(first + i), 0, PAGE_SIZE);
+            mark_untouched(first + i);
+            continue;
+        }
+        uint32_t old = pte->frame_number;
+        if (is_zero_frame(old)) {
+            memset(get_physical_address(first + i), 0, PAGE_SIZE);
+            mark_untouched(first + i);
+        } else {
+            memcpy(get_physical_address(first + i), get_physical_address(old), PAGE_SIZE);
+            dst->is_dirty = memory_manager.frames[old].is_dirty;
+        }
+        pte->flags.present = false;
+        release_frame(old, process->pid, base + i);
+    }
+    map_region(process, base, first);
+
+    thp.collapsed++;
+    printf("透明大页：进程 %u 的页面 %u-%u 合并到连续页框 %u-%u（复制 %u 页，补零 %u 页）\n",
+           process->pid, base, base + HUGE_PAGE_PAGES - 1, first, first + HUGE_PAGE_PAGES - 1,
+           resident, none);
+    return true;
+}
+
+/**
+ * @brief 扫描一批对齐区域，把满足条件的区域合并为大页
+ *
+ * 按进程表槽位和区域顺序从上次停止的位置继续。
+ *
+ * @param regions_to_scan 本次扫描的区域数，0表示从头扫描所有进程
+ * @return uint32_t 本次合并的大页数
+ */
+uint32_t thp_scan(uint32_t regions_to_scan) {
+    bool full = regions_to_scan == 0;
+    if (full) {
+        regions_to_scan = UINT32_MAX;
+        thp.scan_slot = 0;
+        thp.scan_region = 0;
+    }
+
+    uint32_t collapsed = 0, scanned = 0, wraps = 0;
+    while (scanned < regions_to_scan) {
+        PCB* process = get_process_by_index(thp.scan_slot);
+        if (!process || !process->page_table ||
+            (uint64_t)thp.scan_region + HUGE_PAGE_PAGES > process->page_table_size) {
+            // 当前槽位扫描完毕，转到下一个槽位；转满一轮仍没有可扫描区域时停止
+            thp.scan_region = 0;
+            if (++thp.scan_slot >= MAX_PROCESSES) {
+                thp.scan_slot = 0;
+                thp.full_scans++;
+                if (++wraps >= (full ? 1u : 2u)) {
+                    break;
+                }
+            }
+            continue;
+        }
+
+        if (collapse_region(process, thp.scan_region)) {
+            collapsed++;
+        }
+        thp.scan_region += HUGE_PAGE_PAGES;
+        thp.regions_scanned++;
+        scanned++;
+    }
+    return collapsed;
+}
+
+// 大页页框所属的进程和虚拟页号（页框不属于大页时返回NULL）
+static PCB* huge_frame_owner(uint32_t frame, uint32_t* virtual_page) {
+    if (frame >= PHYSICAL_PAGES || !memory_manager.frames[frame].is_allocated) {
+        return NULL;
+    }
+    FrameInfo* info = &memory_manager.frames[frame];
+    PCB* process = get_process_by_pid(info->process_id);
+    if (!process || !process->page_table || info->virtual_page_num >= process->page_table_size) {
+        return NULL;
+    }
+    PageTableEntry* pte = &process->page_table[info->virtual_page_num];
+    if (!pte->flags.present || !pte->flags.huge || pte->frame_number != frame) {
+        return NULL;
+    }
+    *virtual_page = info->virtual_page_num;
+    return process;
+}
+
+bool thp_frame_is_huge(uint32_t frame) {
+    uint32_t virtual_page;
+    return huge_frame_owner(frame, &virtual_page) != NULL;
+}
+
+/**
+ * @brief 把页面所在的大页拆分为普通页
+ *
+ * 页框保持不变，只清除整个区域的大页标志和子页的未写入标记；
+ * 之后各页可以单独换出、共享或解除映射。
+ */
+void thp_split_page(PCB* process, uint32_t virtual_page) {
+    if (!process || !process->page_table || virtual_page >= process->page_table_size ||
+        !process->page_table[virtual_page].flags.huge) {
+        return;
+    }
+
+    uint32_t base = virtual_page & ~(HUGE_PAGE_PAGES - 1);
+    for (uint32_t i = base; i < base + HUGE_PAGE_PAGES && i < process->page_table_size; i++) {
+        PageTableEntry* pte = &process->page_table[i];
+        pte->flags.huge = false;
+        if (pte->flags.present) {
+            thp_subpage_written(pte->frame_number);
+        }
+    }
+    thp.splits++;
+    printf("透明大页：进程 %u 的页面 %u-%u 拆分为普通页\n",
+           process->pid, base, base + HUGE_PAGE_PAGES - 1);
+}
+
+void thp_split_frame(uint32_t frame) {
+    uint32_t virtual_page;
+    PCB* process = huge_frame_owner(frame, &virtual_page);
+    if (process) {
+        thp_split_page(process, virtual_page);
+    }
+}
+
+// 拆分进程的所有大页
+uint32_t thp_split_process(PCB* process) {
+    uint32_t count = 0;
+    if (!process || !process->page_table) {
+        return 0;
+    }
+    for (uint32_t base = 0; (uint64_t)base + HUGE_PAGE_PAGES <= process->page_table_size;
+         base += HUGE_PAGE_PAGES) {
+        if (process->page_table[base].flags.huge) {
+            thp_split_page(process, base);
+            count++;
+        }
+    }
+    return count;
+}
+
+uint32_t thp_split_all(void) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
+        count += thp_split_process(get_process_by_index(i));
+    }
+    return count;
+}
+
+uint32_t thp_count_huge_pages(void) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
+        PCB* process = get_process_by_index(i);
+        if (!process || !process->page_table) {
+            continue;
+        }
+        for (uint32_t base = 0; (uint64_t)base + HUGE_PAGE_PAGES <= process->page_table_size;
+             base += HUGE_PAGE_PAGES) {
+            if (process->page_table[base].flags.huge) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief 内存紧张时拆分大页，回收其中内容全零的子页
+ *
+ * 缺页时整块分配的大页中常有从未写入的子页。清零的子页带有未写入标记，
+ * 写入或释放时清除，并按页框块计数；每次选择未写入子页最多的大页拆分，
+ * 这些子页解除映射并释放页框，之后再访问时按需清零。没有未写入子页时直接返回，
+ * 不读取页面内容；没有未写入子页的大页不拆分，由页面置换换出时再逐页拆分。
+ *
+ * @param target 需要回收的页框数
+ * @return uint32_t 实际回收的页框数
+ */
+uint32_t thp_shrink(uint32_t target) {
+    uint32_t reclaimed = 0;
+    while (reclaimed < target && thp.untouched > 0) {
+        uint32_t block = 0;
+        for (uint32_t b = 1; b < untouched_blocks; b++) {
+            if (untouched_counts[b] > untouched_counts[block]) {
+                block = b;
+            }
+        }
+        uint32_t first = block * HUGE_PAGE_PAGES;
+        uint32_t base;
+        PCB* process = huge_frame_owner(first, &base);
+        if (!process || base % HUGE_PAGE_PAGES != 0) {
+            // 页框块已不是完整的大页，清除残留标记
+            for (uint32_t i = first; i < first + HUGE_PAGE_PAGES; i++) {
+                thp_subpage_written(i);
+            }
+            continue;
+        }
+
+        // 先解除并释放未写入的子页，再把剩余子页拆分为普通页
+        uint32_t freed = 0;
+        for (uint32_t i = 0; i < HUGE_PAGE_PAGES; i++) {
+            uint32_t frame = first + i;
+            if (!memory_manager.frames[frame].thp_untouched ||
+                !is_zero_page(get_physical_address(frame))) {
+                continue;
+            }
+            PageTableEntry* pte = &process->page_table[base + i];
+            pte->flags.present = false;
+            pte->flags.dirty = false;
+            pte->frame_number = (uint32_t)-1;
+            release_frame(frame, process->pid, base + i);
+            freed++;
+        }
+        thp_split_page(process, base);
+        reclaimed += freed;
+        printf("透明大页：拆分进程 %u 的大页，回收 %u 个全零子页\n", process->pid, freed);
+    }
+
+    thp.split_reclaimed += reclaimed;
+    return reclaimed;
+}
+
+// 时间片轮转时调用：空闲页框不足时拆分大页回收内存，否则按间隔后台合并
+void thp_tick(void) {
+    if (!thp.enabled) {
+        return;
+    }
+
+    uint32_t low = DRAM_PAGES / THP_LOW_WATERMARK_DIVISOR;
+    uint32_t free_frames = get_free_dram_frames();
+    if (free_frames < low) {
+        thp_shrink(low - free_frames);
+    }
+
+    if (++thp.ticks < thp.scan_interval) {
+        return;
+    }
+    thp.ticks = 0;
+
+    // 合并需要一个大页的连续空闲页框，空闲页框接近低水位时不合并
+    if (get_free_dram_frames() < HUGE_PAGE_PAGES + low) {
+        return;
+    }
+    uint32_t collapsed = thp_scan(thp.regions_to_scan);
+    if (collapsed > 0) {
+        printf("透明大页后台扫描合并 %u 个大页\n", collapsed);
+    }
+}
+
+// 打印透明大页统计信息和快表覆盖范围
+void print_thp_stats(void) {
+    uint32_t huge_pages = thp_count_huge_pages();
+    uint32_t used_frames = PHYSICAL_PAGES - get_free_frames_count();
+    printf("\n=== 透明大页统计信息 ===\n");
+    printf("透明大页: %s（大页 %u KB，%u 页）\n",
+           thp.enabled ? "开启" : "关闭", system_config.huge_page_size >> 10, HUGE_PAGE_PAGES);
+    printf("后台合并: 每 %u 个时间片扫描 %u 个区域，最多补零 %u 页\n",
+           thp.scan_interval, thp.regions_to_scan, thp.max_ptes_none);
+    printf("当前大页数: %u（%u 个页框，占已用页框 %.1f%%）\n", huge_pages, huge_pages * HUGE_PAGE_PAGES,
+           used_frames ? (double)huge_pages * HUGE_PAGE_PAGES * 100.0 / used_frames : 0.0);
+    printf("可整块分配的连续空闲区域: %u\n", count_free_contiguous(HUGE_PAGE_PAGES, HUGE_PAGE_PAGES));
+    printf("缺页时映射大页: %u 次，退回普通页: %u 次\n", thp.fault_alloc, thp.fault_fallback);
+    printf("大页映射减少的缺页次数（估计）: %llu\n",
+           (unsigned long long)thp.fault_alloc * (HUGE_PAGE_PAGES - 1));
+    printf("后台合并: %u 次（原地 %u 次），没有连续页框失败: %u 次\n",
+           thp.collapsed, thp.collapsed_in_place, thp.collapse_failed);
+    printf("扫描区域数: %u，完整扫描轮数: %u\n", thp.regions_scanned, thp.full_scans);
+    printf("拆分: %u 次，内存紧张时回收全零子页: %u 个，当前未写入子页: %u 个\n",
+           thp.splits, thp.split_reclaimed, thp.untouched);
+    print_tlb_stats();
+}
@@ -0,0 +1,451 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../include/tier.h"
+#include "../include/memory.h"
+#include "../include/process.h"
+#include "../include/compact.h"
+#include "../include/pagecache.h"
+
+// 分层内存管理器
+static TierManager tier;
+
+// 每个页框的热度：8位老化寄存器，每次扫描右移一位，本次扫描被访问时最高位置1
+static uint8_t* heat = NULL;
+
+// 冷页列表中的一项：记录排序时页面的热度和访问时间，二者改变说明页面已被访问或换成了别的页面
+typedef struct {
+    uint32_t frame;
+    uint8_t heat;
+    uint64_t last_access;
+} ColdEntry;
+
+// 一层内存的冷页列表：扫描时按冷热排序（最冷在前），降级和换出时从头取用，
+// 缺页时无需遍历整层页框
+typedef struct {
+    ColdEntry* entries;
+    uint32_t count;
+    uint32_t head;               // 之前的项都已失效
+    bool refilled;               // 本次扫描之后是否已因取完而重建过
+} ColdList;
+
+static ColdList dram_cold;
+static ColdList slow_cold;
+
+/**
+ * @brief 初始化分层内存
+ *
+ * 慢速内存层是物理页框号 [DRAM_PAGES, PHYSICAL_PAGES) 的部分，普通页框分配不使用它，
+ * 只有降级的页面放在这里。配置了慢速内存时默认开启。
+ */
+void tier_init(void) {
+    memset(&tier, 0, sizeof(TierManager));
+    tier.enabled = SLOW_PAGES > 0;
+    tier.scan_interval = TIER_DEFAULT_SCAN_INTERVAL;
+    tier.promote_scans = TIER_DEFAULT_PROMOTE_SCANS;
+    tier.migrate_budget = TIER_DEFAULT_MIGRATE_BUDGET;
+
+    if (!heat) {
+        heat = (uint8_t*)malloc(sizeof(uint8_t) * PHYSICAL_PAGES);
+        dram_cold.entries = (ColdEntry*)malloc(sizeof(ColdEntry) * DRAM_PAGES);
+        slow_cold.entries = (ColdEntry*)malloc(sizeof(ColdEntry) * (SLOW_PAGES ? SLOW_PAGES : 1));
+        if (!heat || !dram_cold.entries || !slow_cold.entries) {
+            fprintf(stderr, "分层内存初始化失败\n");
+            exit(1);
+        }
+    }
+    memset(heat, 0, sizeof(uint8_t) * PHYSICAL_PAGES);
+    dram_cold.count = dram_cold.head = 0;
+    dram_cold.refilled = false;
+    slow_cold.count = slow_cold.head = 0;
+    slow_cold.refilled = false;
+}
+
+void tier_set_enabled(bool enabled) {
+    if (enabled && SLOW_PAGES == 0) {
+        printf("没有配置慢速内存（--slow-memory），无法开启分层内存\n");
+        return;
+    }
+    tier.enabled = enabled;
+    printf("分层内存已%s\n", enabled ? "开启" : "关闭");
+}
+
+bool tier_is_enabled(void) {
+    return tier.enabled;
+}
+
+bool frame_in_slow_tier(uint32_t frame) {
+    return frame >= DRAM_PAGES && frame < PHYSICAL_PAGES;
+}
+
+// 区间 [first, end) 中第一个空闲页框
+static uint32_t free_frame_in(uint32_t first, uint32_t end) {
+    for (uint32_t i = first; i < end; i++) {
+        if (!memory_manager.frames[i].is_allocated) {
+            return i;
+        }
+    }
+    return (uint32_t)-1;
+}
+
+uint32_t tier_free_slow_frames(void) {
+    uint32_t free_count = 0;
+    for (uint32_t i = DRAM_PAGES; i < PHYSICAL_PAGES; i++) {
+        if (!memory_manager.frames[i].is_allocated) {
+            free_count++;
+        }
+    }
+    return free_count;
+}
+
+/**
+ * @brief 记录一次内存访问命中的层级
+ *
+ * @param frame 访问的页框
+ * @param resident 访问时页面是否已在内存中（否则经缺页调入，计为未命中）
+ */
+void tier_record_access(uint32_t frame, bool resident) {
+    if (!resident) {
+        tier.misses++;
+    } else if (frame_in_slow_tier(frame)) {
+        tier.slow_hits++;
+        tier.access_time_ns += system_config.slow_latency;
+    } else {
+        tier.dram_hits++;
+        tier.access_time_ns += DRAM_LATENCY_NS;
+    }
+}
+
+// 页框迁移时热度随页面移动
+void tier_migrate_frame(uint32_t src, uint32_t dst) {
+    if (!heat || src >= PHYSICAL_PAGES || dst >= PHYSICAL_PAGES) {
+        return;
+    }
+    heat[dst] = heat[src];
+    heat[src] = 0;
+}
+
+// 映射该页框的页表项中是否有访问位被置位，检查后清除访问位
+static bool test_and_clear_referenced(uint32_t frame) {
+    FrameMapping mapping;
+    uint32_t cursor = frame_mappings_begin(frame);
+    bool referenced = false;
+    while (frame_mappings_next(frame, &cursor, &mapping)) {
+        PageTableEntry* pte = &mapping.process->page_table[mapping.virtual_page];
+        if (pte->flags.referenced) {
+            referenced = true;
+            pte->flags.referenced = false;
+        }
+    }
+    return referenced;
+}
+
+// 最近 promote_scans 次扫描都被访问过
+static bool frame_is_hot(uint32_t frame) {
+    uint32_t scans = tier.promote_scans;
+    return (uint32_t)(heat[frame] >> (8 - scans)) == (1u << scans) - 1;
+}
+
+// 比较两个页框的冷热：热度低的更冷，热度相同时最久未访问的更冷
+static bool colder_than(uint32_t a, uint32_t b) {
+    if (heat[a] != heat[b]) {
+        return heat[a] < heat[b];
+    }
+    return memory_manager.frames[a].last_access_time < memory_manager.frames[b].last_access_time;
+}
+
+static int compare_cold(const void* a, const void* b) {
+    const ColdEntry* x = (const ColdEntry*)a;
+    const ColdEntry* y = (const ColdEntry*)b;
+    if (x->heat != y->heat) {
+        return x->heat < y->heat ? -1 : 1;
+    }
+    if (x->last_access != y->last_access) {
+        return x->last_access < y->last_access ? -1 : 1;
+    }
+    return x->frame < y->frame ? -1 : (x->frame > y->frame);
+}
+
+// 按当前热度重建 [first, end) 中可迁移页框的冷页列表
+static void cold_list_build(ColdList* list, uint32_t first, uint32_t end) {
+    list->count = 0;
+    list->head = 0;
+    for (uint32_t i = first; i < end; i++) {
+        if (compact_frame_movable(i)) {
+            list->entries[list->count++] = (ColdEntry){
+                .frame = i,
+                .heat = heat[i],
+                .last_access = memory_manager.frames[i].last_access_time
+            };
+        }
+    }
+    qsort(list->entries, list->count, sizeof(ColdEntry), compare_cold);
+}
+
+// 列表项对应的页面自排序以来没有被访问、迁移或释放
+static bool cold_entry_valid(const ColdEntry* entry) {
+    return compact_frame_movable(entry->frame) && heat[entry->frame] == entry->heat &&
+           memory_manager.frames[entry->frame].last_access_time == entry->last_access;
+}
+
+// 页框能否被 requester 降级或换出：与页面置换的候选条件相同
+static bool frame_evictable(uint32_t frame, PCB* requester) {
+    FrameInfo* info = &memory_manager.frames[frame];
+    if (!info->is_allocated || info->is_swapping) {
+        return false;
+    }
+    if (info->process_id == 0) {
+        return pagecache_find_frame(frame, NULL);
+    }
+    PCB* owner = get_process_by_pid(info->process_id);
+    if (!owner || info->virtual_page_num >= owner->page_table_size ||
+        !owner->page_table[info->virtual_page_num].flags.present) {
+        return false;
+    }
+    return can_evict_from(owner, requester);
+}
+
+/**
+ * @brief 从冷页列表中取最冷的、满足条件的页框
+ *
+ * 失效的项在列表头部时直接丢弃；列表取完时每次扫描之后最多重建一次。
+ *
+ * @param list 冷页列表
+ * @param first 该层的第一个页框号
+ * @param end 该层最后一个页框号加1
+ * @param requester 需要页框的进程
+ * @param scoped 是否只选 requester 按置换范围和页框配额可以置换的页面
+ * @param except 跳过的页框，-1 表示不跳过
+ * @return uint32_t 页框号，没有时返回-1
+ */
+static uint32_t cold_list_pick(ColdList* list, uint32_t first, uint32_t end,
+                               PCB* requester, bool scoped, uint32_t except) {
+    for (;;) {
+        for (uint32_t i = list->head; i < list->count; i++) {
+            ColdEntry* entry = &list->entries[i];
+            if (!cold_entry_valid(entry)) {
+                if (i == list->head) {
+                    list->head++;
+                }
+                continue;
+            }
+            if (entry->frame != except && (!scoped || frame_evictable(entry->frame, requester))) {
+                return entry->frame;
+            }
+        }
+        if (list->head < list->count || list->refilled) {
+            return (uint32_t)-1;
+        }
+        cold_list_build(list, first, end);
+        list->refilled = true;
+    }
+}
+
+// DRAM 中最冷的可迁移页框，requester 不为 NULL 时只选它按置换范围和配额可以置换的页面
+static uint32_t coldest_dram_frame(PCB* requester) {
+    return cold_list_pick(&dram_cold, 0, DRAM_PAGES, requester, requester != NULL, (uint32_t)-1);
+}
+
+/**
+ * @brief 慢速内存层已满时换出其中最冷的页面，腾出一个慢速内存页框
+ *
+ * @param requester 需要页框的进程（按置换范围和页框配额选择），NULL 表示全局
+ * @param hotter_than 只换出比该页框冷的页面，-1 表示不限制
+ * @return uint32_t 腾出的慢速内存页框，失败返回-1
+ */
+static uint32_t evict_slow_frame(PCB* requester, uint32_t hotter_than) {
+    uint32_t victim = cold_list_pick(&slow_cold, DRAM_PAGES, PHYSICAL_PAGES, requester, true, hotter_than);
+    if (victim == (uint32_t)-1 || (hotter_than != (uint32_t)-1 && !colder_than(victim, hotter_than))) {
+        return (uint32_t)-1;
+    }
+
+    PCB* owner = get_process_by_pid(memory_manager.frames[victim].process_id);
+    bool cached = pagecache_find_frame(victim, NULL);
+    printf("分层内存：慢速内存层已满，换出最冷的页框 %u\n", victim);
+    if (!swap_out_page(victim)) {
+        return (uint32_t)-1;
+    }
+    if (owner && !cached) {
+        owner->stats.pages_swapped_out++;
+    }
+    tier.slow_evicted++;
+    heat[victim] = 0;
+    return victim;
+}
+
+/**
+ * @brief 把 DRAM 中最冷的页面降级到慢速内存层
+ *
+ * @param requester 需要页框的进程，慢速内存层已满时按它的置换范围换出慢速内存页面
+ * @param may_evict 慢速内存层已满时是否换出其中最冷的页面
+ * @return uint32_t 腾出的 DRAM 页框，失败返回-1
+ */
+static uint32_t demote_coldest(PCB* requester, bool may_evict) {
+    uint32_t src = coldest_dram_frame(requester);
+    if (src == (uint32_t)-1) {
+        return (uint32_t)-1;
+    }
+
+    uint32_t dst = free_frame_in(DRAM_PAGES, PHYSICAL_PAGES);
+    if (dst == (uint32_t)-1 && may_evict) {
+        dst = evict_slow_frame(requester, (uint32_t)-1);
+    }
+    if (dst == (uint32_t)-1 || !compact_migrate_frame(src, dst)) {
+        tier.migrate_failed++;
+        return (uint32_t)-1;
+    }
+    printf("分层内存：页框 %u 降级到慢速内存页框 %u\n", src, dst);
+    return src;
+}
+
+/**
+ * @brief 分配页框时 DRAM 已满：把冷页降级到慢速内存层，代替换出到交换区
+ *
+ * 慢速内存层也满时，先把慢速内存层中最冷的页面换出，再降级。
+ *
+ * @param requester 缺页进程
+ * @param count 需要腾出的 DRAM 页框数
+ * @return uint32_t 腾出的 DRAM 页框数
+ */
+uint32_t tier_demote(PCB* requester, uint32_t count) {
+    if (!tier.enabled) {
+        return 0;
+    }
+
+    uint32_t demoted = 0;
+    while (demoted < count && demote_coldest(requester, true) != (uint32_t)-1) {
+        demoted++;
+    }
+    tier.demoted += demoted;
+    return demoted;
+}
+
+/**
+ * @brief 把慢速内存层中的热页提升回 DRAM
+ *
+ * DRAM 没有空闲页框时与比它冷的 DRAM 页面交换位置；慢速内存层也满时，
+ * 先换出慢速内存层中比它冷的页面腾出位置。
+ */
+static bool promote_frame(uint32_t frame) {
+    uint32_t dst = free_frame_in(0, DRAM_PAGES);
+    if (dst == (uint32_t)-1) {
+        uint32_t victim = coldest_dram_frame(NULL);
+        if (victim == (uint32_t)-1 || !colder_than(victim, frame)) {
+            return false;
+        }
+        uint32_t slot = free_frame_in(DRAM_PAGES, PHYSICAL_PAGES);
+        if (slot == (uint32_t)-1) {
+            slot = evict_slow_frame(NULL, frame);
+        }
+        if (slot == (uint32_t)-1 || !compact_migrate_frame(victim, slot)) {
+            return false;
+        }
+        tier.background_demoted++;
+        dst = victim;
+    }
+
+    if (!compact_migrate_frame(frame, dst)) {
+        return false;
+    }
+    printf("分层内存：热页从慢速内存页框 %u 提升到 DRAM 页框 %u\n", frame, dst);
+    return true;
+}
+
+/**
+ * @brief 扫描访问位更新热度，提升热页并在 DRAM 空闲页框不足时降级冷页
+ *
+ * @return uint32_t 迁移的页框数
+ */
+uint32_t tier_scan(void) {
+    tier.scans++;
+    for (uint32_t i = 0; i < PHYSICAL_PAGES; i++) {
+        if (!memory_manager.frames[i].is_allocated) {
+            heat[i] = 0;
+            continue;
+        }
+        heat[i] = (uint8_t)((heat[i] >> 1) | (test_and_clear_referenced(i) ? 0x80 : 0));
+    }
+    if (!tier.enabled) {
+        return 0;
+    }
+
+    // 热度只在扫描时变化，按新的热度重新排序两层的冷页
+    cold_list_build(&dram_cold, 0, DRAM_PAGES);
+    cold_list_build(&slow_cold, DRAM_PAGES, PHYSICAL_PAGES);
+    dram_cold.refilled = false;
+    slow_cold.refilled = false;
+
+    uint32_t migrated = 0;
+    for (uint32_t i = DRAM_PAGES; i < PHYSICAL_PAGES && migrated < tier.migrate_budget; i++) {
+        if (!memory_manager.frames[i].is_allocated || !frame_is_hot(i)) {
+            continue;
+        }
+        if (promote_frame(i)) {
+            tier.promoted++;
+            migrated++;
+        } else {
+            tier.migrate_failed++;
+        }
+    }
+
+    // 慢速内存层还有空间时保持少量 DRAM 空闲页框，缺页和提升时不必同步降级
+    uint32_t low = DRAM_PAGES / TIER_LOW_WATERMARK_DIVISOR;
+    if (low == 0) {
+        low = 1;
+    }
+    while (migrated < tier.migrate_budget && get_free_dram_frames() < low &&
+           free_frame_in(DRAM_PAGES, PHYSICAL_PAGES) != (uint32_t)-1 &&
+           demote_coldest(NULL, false) != (uint32_t)-1) {
+        tier.background_demoted++;
+        migrated++;
+    }
+    return migrated;
+}
+
+// 时间片轮转时调用，按间隔扫描
+void tier_tick(void) {
+    if (!tier.enabled || ++tier.ticks < tier.scan_interval) {
+        return;
+    }
+    tier.ticks = 0;
+
+    uint32_t migrated = tier_scan();
+    if (migrated > 0) {
+        printf("分层内存后台扫描迁移 %u 个页框\n", migrated);
+    }
+}
+
+static void print_tier_row(const char* name, uint32_t frames, uint32_t used, uint64_t hits, uint64_t total) {
+    printf("%-10s %8u %8u %10llu %8.1f%%\n", name, frames, used, (unsigned long long)hits,
+           total ? (double)hits * 100.0 / total : 0.0);
+}
+
+// 打印各层容量、命中率和迁移统计
+void print_tier_stats(void) {
+    uint32_t slow_used = SLOW_PAGES - tier_free_slow_frames();
+    uint32_t dram_used = DRAM_PAGES - get_free_dram_frames();
+    uint64_t total = tier.dram_hits + tier.slow_hits + tier.misses;
+    uint64_t hits = tier.dram_hits + tier.slow_hits;
+
+    printf("\n=== 分层内存统计信息 ===\n");
+    printf("分层内存: %s（DRAM %u 页，慢速内存 %u 页）\n",
+           tier.enabled ? "开启" : "关闭", DRAM_PAGES, SLOW_PAGES);
+    printf("访问延迟: DRAM %u ns，慢速内存 %u ns\n", DRAM_LATENCY_NS, system_config.slow_latency);
+    printf("热度扫描: 每 %u 个时间片一次，连续 %u 次扫描被访问的页面视为热页，每次最多迁移 %u 个页框\n",
+           tier.scan_interval, tier.promote_scans, tier.migrate_budget);
+
+    printf("\n层级         页框数     已用   命中次数    命中率\n");
+    print_tier_row("DRAM", DRAM_PAGES, dram_used, tier.dram_hits, total);
+    print_tier_row("慢速内存", SLOW_PAGES, slow_used, tier.slow_hits, total);
+    printf("%-10s %8s %8s %10llu %8.1f%%\n", "缺页", "-", "-", (unsigned long long)tier.misses,
+           total ? (double)tier.misses * 100.0 / total : 0.0);
+
+    double average = hits ? (double)tier.access_time_ns / hits : DRAM_LATENCY_NS;
+    printf("\n命中访问平均延迟: %.1f ns（全部命中 DRAM 时 %u ns，%.2f 倍）\n",
+           average, DRAM_LATENCY_NS, average / DRAM_LATENCY_NS);
+    printf("扫描次数: %u\n", tier.scans);
+    printf("降级页面: %u（按需 %u，后台 %u），提升页面: %u，迁移失败: %u\n",
+           tier.demoted + tier.background_demoted, tier.demoted, tier.background_demoted,
+           tier.promoted, tier.migrate_failed);
+    printf("慢速内存层换出页面: %u\n", tier.slow_evicted);
+}
@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include <string.h>
+#include "../include/tlb.h"
+#include "../include/process.h"
+
+// 快表模型
+static Tlb tlb;
+
+void tlb_init(void) {
+    memset(&tlb, 0, sizeof(Tlb));
+}
+
+// 清空所有条目，统计信息保留
+void tlb_flush(void) {
+    memset(tlb.entries, 0, sizeof(tlb.entries));
+    memset(tlb.huge_entries, 0, sizeof(tlb.huge_entries));
+}
+
+/**
+ * @brief 条目是否仍与页表一致
+ *
+ * 模型不做快表击落：页表项被换出、拆分或重新映射后，
+ * 条目在下次使用时与页表项比较发现不一致而失效。
+ */
+static bool entry_current(const TlbEntry* entry, PCB* process, bool huge) {
+    if (!process || !process->page_table || entry->tag >= process->page_table_size) {
+        return false;
+    }
+    const PageTableEntry* pte = &process->page_table[entry->tag];
+    return pte->flags.present && pte->flags.huge == huge && pte->frame_number == entry->frame;
+}
+
+/**
+ * @brief 记录一次地址转换
+ *
+ * 页面所在区域由大页映射时查找大页条目，一个条目覆盖整个大页；
+ * 否则查找普通页条目。未命中时按LRU替换条目（相当于一次页表遍历）。
+ *
+ * @param process 访问的进程
+ * @param virtual_page 已驻留的虚拟页号
+ * @return true 快表命中
+ */
+bool tlb_access(PCB* process, uint32_t virtual_page) {
+    if (!process || virtual_page >= process->page_table_size ||
+        !process->page_table[virtual_page].flags.present) {
+        return false;
+    }
+
+    tlb.clock++;
+    bool huge = process->page_table[virtual_page].flags.huge;
+    uint32_t tag = huge ? virtual_page & ~(HUGE_PAGE_PAGES - 1) : virtual_page;
+    TlbEntry* set = huge ? tlb.huge_entries : tlb.entries;
+    uint32_t count = huge ? TLB_HUGE_ENTRIES : TLB_ENTRIES;
+
+    TlbEntry* victim = &set[0];
+    for (uint32_t i = 0; i < count; i++) {
+        TlbEntry* entry = &set[i];
+        if (entry->valid && entry->pid == process->pid && entry->tag == tag) {
+            if (entry_current(entry, process, huge)) {
+                entry->last_use = tlb.clock;
+                tlb.hits++;
+                if (huge) {
+                    tlb.huge_hits++;
+                }
+                return true;
+            }
+            entry->valid = false;
+            tlb.stale++;
+        }
+        if (victim->valid && (!entry->valid || entry->last_use < victim->last_use)) {
+            victim = entry;
+        }
+    }
+
+    tlb.misses++;
+    victim->valid = true;
+    victim->pid = process->pid;
+    victim->tag = tag;
+    victim->frame = process->page_table[tag].frame_number;
+    victim->last_use = tlb.clock;
+    return false;
+}
+
+// 当前有效条目覆盖的地址空间（字节）
+uint64_t tlb_reach(void) {
+    uint64_t reach = 0;
+    for (uint32_t i = 0; i < TLB_ENTRIES; i++) {
+        if (tlb.entries[i].valid && entry_current(&tlb.entries[i], get_process_by_pid(tlb.entries[i].pid), false)) {
+            reach += PAGE_SIZE;
+        }
+    }
+    for (uint32_t i = 0; i < TLB_HUGE_ENTRIES; i++) {
+        if (tlb.huge_entries[i].valid &&
+            entry_current(&tlb.huge_entries[i], get_process_by_pid(tlb.huge_entries[i].pid), true)) {
+            reach += system_config.huge_page_size;
+        }
+    }
+    return reach;
+}
+
+// 打印快表统计信息
+void print_tlb_stats(void) {
+    uint64_t accesses = tlb.hits + tlb.misses;
+    printf("\n=== 快表统计信息 ===\n");
+    printf("容量: 普通页 %u 项，大页 %u 项\n", TLB_ENTRIES, TLB_HUGE_ENTRIES);
+    printf("地址转换: %llu 次，命中: %llu 次（大页条目 %llu 次），未命中: %llu 次\n",
+           (unsigned long long)accesses, (unsigned long long)tlb.hits,
+           (unsigned long long)tlb.huge_hits, (unsigned long long)tlb.misses);
+    printf("命中率: %.1f%%\n", accesses ? (double)tlb.hits * 100.0 / accesses : 0.0);
+    printf("因页表项改变失效的条目: %llu\n", (unsigned long long)tlb.stale);
+    printf("当前覆盖范围: %llu KB\n", (unsigned long long)(tlb_reach() >> 10));
+    printf("最大覆盖范围: 仅普通页 %llu KB，使用大页 %llu KB\n",
+           (unsigned long long)((uint64_t)TLB_ENTRIES * PAGE_SIZE >> 10),
+           (unsigned long long)(((uint64_t)TLB_ENTRIES * PAGE_SIZE +
+                                 (uint64_t)TLB_HUGE_ENTRIES * system_config.huge_page_size) >> 10));
+}
@@ -0,0 +1,402 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/trace.h"
+#include "../include/swapio.h"
+
+// Chrome Trace Event 格式中的分组（"pid"），每组下按 "tid" 分为多条时间线
+#define TRACE_GROUP_CPU       1   // CPU：按上下文切换得到的进程运行区间
+#define TRACE_GROUP_PROCESS   2   // 进程：每个模拟进程一条时间线（缺页、换出），0 为内核
+#define TRACE_GROUP_SWAP_IO   3   // 交换 I/O：每个线程一条时间线
+
+// 一个线程的环形缓冲区
+//
+// 只由所属线程写入：先写事件，再以 release 语义推进 head；
+// 导出时以 acquire 语义读取 head，之前的事件都已写完。
+typedef struct {
+    TraceEvent events[TRACE_RING_SIZE];
+    uint64_t head;                     // 累计写入的事件数
+} __attribute__((aligned(64))) TraceRing;
+
+// 事件跟踪器
+typedef struct {
+    TraceRing* rings[TRACE_MAX_THREADS];
+    bool claimed[TRACE_MAX_THREADS];   // 环形缓冲区是否被某个线程占用，线程退出后归还
+    uint64_t dropped;                  // 线程数超出上限丢弃的事件数
+    uint64_t start_ns;                 // 开始跟踪的时间，导出的时间戳相对于此
+    uint64_t stop_ns;                  // 停止跟踪的时间，0 表示仍在跟踪
+} Tracer;
+
+bool trace_enabled = false;
+
+static Tracer tracer;
+static __thread TraceRing* local_ring = NULL;
+static __thread uint16_t local_thread = 0;
+static __thread bool ring_claimed = false;
+static __thread uint32_t context_pid = 0;
+
+/**
+ * @brief 取得本线程的环形缓冲区，首次记录时认领空闲槽位
+ *
+ * 槽位的环形缓冲区第一次使用时分配，之后一直保留：已退出线程归还的槽位被新线程认领时，
+ * 事件接在原有事件之后，导出时同一槽位是同一条时间线（如重新创建的交换 I/O 工作线程）。
+ */
+static TraceRing* claim_ring(void) {
+    if (ring_claimed) {
+        return local_ring;
+    }
+
+    for (uint32_t i = 0; i < TRACE_MAX_THREADS; i++) {
+        bool expected = false;
+        if (!__atomic_compare_exchange_n(&tracer.claimed[i], &expected, true, false,
+                                         __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            continue;
+        }
+        TraceRing* ring = __atomic_load_n(&tracer.rings[i], __ATOMIC_ACQUIRE);
+        if (!ring) {
+            ring = (TraceRing*)calloc(1, sizeof(TraceRing));
+            if (!ring) {
+                __atomic_store_n(&tracer.claimed[i], false, __ATOMIC_RELEASE);
+                return NULL;
+            }
+            __atomic_store_n(&tracer.rings[i], ring, __ATOMIC_RELEASE);
+        }
+        local_thread = (uint16_t)i;
+        local_ring = ring;
+        ring_claimed = true;
+        return ring;
+    }
+    return NULL;
+}
+
+// 线程退出前调用：归还环形缓冲区，其中的事件保留到导出或被覆盖
+void trace_thread_exit(void) {
+    if (!ring_claimed) {
+        return;
+    }
+    __atomic_store_n(&tracer.claimed[local_thread], false, __ATOMIC_RELEASE);
+    ring_claimed = false;
+    local_ring = NULL;
+    local_thread = 0;
+}
+
+// 停止跟踪并释放所有环形缓冲区（交换 I/O 工作线程已退出后调用）
+void trace_shutdown(void) {
+    trace_enabled = false;
+    for (uint32_t i = 0; i < TRACE_MAX_THREADS; i++) {
+        free(tracer.rings[i]);
+        tracer.rings[i] = NULL;
+        tracer.claimed[i] = false;
+    }
+    ring_claimed = false;
+    local_ring = NULL;
+    local_thread = 0;
+}
+
+void trace_record(TraceEventType type, uint64_t start_ns, uint64_t end_ns, uint32_t pid,
+                  uint32_t arg0, uint32_t arg1, uint32_t arg2) {
+    TraceRing* ring = claim_ring();
+    if (!ring) {
+        __atomic_fetch_add(&tracer.dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    TraceEvent* event = &ring->events[head & (TRACE_RING_SIZE - 1)];
+    event->timestamp_ns = start_ns;
+    event->duration_ns = end_ns > start_ns ? end_ns - start_ns : 0;
+    event->pid = pid;
+    event->arg0 = arg0;
+    event->arg1 = arg1;
+    event->arg2 = arg2;
+    event->type = (uint16_t)type;
+    event->thread = local_thread;
+    event->reserved = 0;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+uint32_t trace_set_context(uint32_t pid) {
+    uint32_t previous = context_pid;
+    context_pid = pid;
+    return previous;
+}
+
+uint32_t trace_context(void) {
+    return context_pid;
+}
+
+/**
+ * @brief 清空所有环形缓冲区并开始跟踪
+ *
+ * 先等待交换 I/O 完成，清空时工作线程不会同时写入。
+ */
+void trace_start(void) {
+    swapio_drain();
+    for (uint32_t i = 0; i < TRACE_MAX_THREADS; i++) {
+        TraceRing* ring = __atomic_load_n(&tracer.rings[i], __ATOMIC_ACQUIRE);
+        if (ring) {
+            __atomic_store_n(&ring->head, 0, __ATOMIC_RELEASE);
+        }
+    }
+    __atomic_store_n(&tracer.dropped, 0, __ATOMIC_RELAXED);
+    tracer.start_ns = metrics_now_ns();
+    tracer.stop_ns = 0;
+    trace_enabled = true;
+    printf("事件跟踪已开始（每个线程保留最近 %u 个事件）\n", TRACE_RING_SIZE);
+}
+
+void trace_stop(void) {
+    if (!trace_enabled) {
+        printf("事件跟踪未开启\n");
+        return;
+    }
+    trace_enabled = false;
+    swapio_drain();
+    tracer.stop_ns = metrics_now_ns();
+    printf("事件跟踪已停止\n");
+}
+
+// 环形缓冲区中保留的事件数
+static uint64_t ring_retained(const TraceRing* ring) {
+    uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    return head < TRACE_RING_SIZE ? head : TRACE_RING_SIZE;
+}
+
+static int compare_events(const void* a, const void* b) {
+    const TraceEvent* x = (const TraceEvent*)a;
+    const TraceEvent* y = (const TraceEvent*)b;
+    if (x->timestamp_ns != y->timestamp_ns) {
+        return x->timestamp_ns < y->timestamp_ns ? -1 : 1;
+    }
+    // 同一时刻开始的事件，持续时间长的在前，保证嵌套关系
+    if (x->duration_ns != y->duration_ns) {
+        return x->duration_ns > y->duration_ns ? -1 : 1;
+    }
+    return 0;
+}
+
+// 收集所有线程保留的事件并按开始时间排序
+static TraceEvent* collect_events(uint32_t* count) {
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < TRACE_MAX_THREADS; i++) {
+        TraceRing* ring = __atomic_load_n(&tracer.rings[i], __ATOMIC_ACQUIRE);
+        if (ring) {
+            total += ring_retained(ring);
+        }
+    }
+
+    TraceEvent* events = (TraceEvent*)malloc((total > 0 ? total : 1) * sizeof(TraceEvent));
+    if (!events) {
+        return NULL;
+    }
+
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < TRACE_MAX_THREADS; i++) {
+        TraceRing* ring = __atomic_load_n(&tracer.rings[i], __ATOMIC_ACQUIRE);
+        if (!ring) {
+            continue;
+        }
+        uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        uint64_t retained = ring_retained(ring);
+        for (uint64_t seq = head - retained; seq < head && n < total; seq++) {
+            events[n++] = ring->events[seq & (TRACE_RING_SIZE - 1)];
+        }
+    }
+
+    qsort(events, n, sizeof(TraceEvent), compare_events);
+    *count = n;
+    return events;
+}
+
+// 相对开始跟踪时间的微秒数（Chrome Trace Event 的时间单位）
+static double trace_us(uint64_t ns) {
+    return ns > tracer.start_ns ? (double)(ns - tracer.start_ns) / 1000.0 : 0.0;
+}
+
+static void write_separator(FILE* out, bool* first) {
+    fprintf(out, "%s\n", *first ? "" : ",");
+    *first = false;
+}
+
+static void write_metadata(FILE* out, bool* first, const char* what, uint32_t group, uint32_t tid,
+                           const char* name) {
+    write_separator(out, first);
+    fprintf(out, "{\"name\":\"%s\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+            what, group, tid, name);
+}
+
+// 每个出现过的进程和线程一条带名字的时间线
+static void write_track_names(FILE* out, bool* first, const TraceEvent* events, uint32_t count) {
+    char name[32];
+    bool threads[TRACE_MAX_THREADS] = {false};
+    uint32_t* pids = (uint32_t*)malloc((count > 0 ? count : 1) * sizeof(uint32_t));
+    uint32_t pid_count = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        const TraceEvent* event = &events[i];
+        if (event->thread < TRACE_MAX_THREADS && !threads[event->thread]) {
+            threads[event->thread] = true;
+            snprintf(name, sizeof(name), "thread %u", event->thread);
+            write_metadata(out, first, "thread_name", TRACE_GROUP_SWAP_IO, event->thread, name);
+        }
+
+        if (event->pid == 0 || !pids) {
+            continue;
+        }
+        bool seen = false;
+        for (uint32_t j = 0; j < pid_count && !seen; j++) {
+            seen = pids[j] == event->pid;
+        }
+        if (!seen) {
+            pids[pid_count++] = event->pid;
+            snprintf(name, sizeof(name), "pid %u", event->pid);
+            write_metadata(out, first, "thread_name", TRACE_GROUP_PROCESS, event->pid, name);
+        }
+    }
+    free(pids);
+}
+
+// 写出一个事件，持续事件用 "X"，瞬时事件用 "i"
+static void write_event(FILE* out, bool* first, const TraceEvent* event) {
+    static const char* names[TRACE_EVENT_TYPES] = {
+        "fault", "victim", "evict", "swap read", "swap write", "switch", "preempt"
+    };
+    uint32_t group = TRACE_GROUP_PROCESS, tid = event->pid;
+    if (event->type == TRACE_SWAP_READ || event->type == TRACE_SWAP_WRITE) {
+        group = TRACE_GROUP_SWAP_IO;
+        tid = event->thread;
+    } else if (event->type == TRACE_SWITCH || event->type == TRACE_PREEMPT) {
+        group = TRACE_GROUP_CPU;
+        tid = 0;
+    }
+
+    write_separator(out, first);
+    fprintf(out, "{\"name\":\"%s\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,",
+            names[event->type], group, tid, trace_us(event->timestamp_ns));
+    if (event->type == TRACE_FAULT || event->type == TRACE_EVICT ||
+        event->type == TRACE_SWAP_READ || event->type == TRACE_SWAP_WRITE) {
+        fprintf(out, "\"ph\":\"X\",\"dur\":%.3f,", (double)event->duration_ns / 1000.0);
+    } else {
+        fprintf(out, "\"ph\":\"i\",\"s\":\"t\",");
+    }
+
+    switch (event->type) {
+        case TRACE_FAULT:
+            fprintf(out, "\"args\":{\"page\":%u,\"write\":%u,\"async\":%u,\"ok\":%u}}",
+                    event->arg0, (event->arg1 & TRACE_FAULT_WRITE) ? 1 : 0,
+                    (event->arg1 & TRACE_FAULT_ASYNC) ? 1 : 0, event->arg2);
+            break;
+        case TRACE_VICTIM:
+        case TRACE_EVICT:
+            fprintf(out, "\"args\":{\"frame\":%u,\"owner\":%u,\"page\":%u}}",
+                    event->arg0, event->arg1, event->arg2);
+            break;
+        case TRACE_SWAP_READ:
+        case TRACE_SWAP_WRITE:
+            fprintf(out, "\"args\":{\"block\":%u}}", event->arg0);
+            break;
+        default:
+            fprintf(out, "\"args\":{\"from\":%u,\"to\":%u}}", event->arg0, event->arg1);
+            break;
+    }
+}
+
+// 按上下文切换事件生成 CPU 时间线上每个进程的运行区间
+static void write_run_slices(FILE* out, bool* first, const TraceEvent* events, uint32_t count,
+                             uint64_t end_ns) {
+    uint32_t running = 0;
+    uint64_t since = tracer.start_ns;
+    for (uint32_t i = 0; i <= count; i++) {
+        bool at_end = i == count;
+        if (!at_end && events[i].type != TRACE_SWITCH) {
+            continue;
+        }
+        uint64_t now = at_end ? end_ns : events[i].timestamp_ns;
+        // 跟踪开始前已在运行的进程，由第一次切换的换出进程得知
+        uint32_t previous = at_end ? running : events[i].arg0;
+        if (previous != 0 && now > since) {
+            write_separator(out, first);
+            fprintf(out, "{\"name\":\"pid %u\",\"ph\":\"X\",\"pid\":%u,\"tid\":0,\"ts\":%.3f,"
+                    "\"dur\":%.3f,\"args\":{\"pid\":%u}}",
+                    previous, TRACE_GROUP_CPU, trace_us(since), (double)(now - since) / 1000.0, previous);
+        }
+        if (!at_end) {
+            running = events[i].arg1;
+            since = now;
+        }
+    }
+}
+
+/**
+ * @brief 把保留的事件导出为 Chrome Trace Event JSON
+ *
+ * 文件可以直接在 chrome://tracing 或 Perfetto UI 中打开。
+ */
+bool trace_export(const char* path) {
+    FILE* out = fopen(path, "w");
+    if (!out) {
+        printf("错误：无法打开文件 %s\n", path);
+        return false;
+    }
+
+    // 跟踪仍在进行时先等待交换 I/O 完成，工作线程不会在收集时写入
+    swapio_drain();
+    uint32_t count = 0;
+    TraceEvent* events = collect_events(&count);
+    if (!events) {
+        fclose(out);
+        return false;
+    }
+    uint64_t end_ns = tracer.stop_ns != 0 ? tracer.stop_ns : metrics_now_ns();
+
+    bool first = true;
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    write_metadata(out, &first, "process_name", TRACE_GROUP_CPU, 0, "CPU");
+    write_metadata(out, &first, "thread_name", TRACE_GROUP_CPU, 0, "cpu 0");
+    write_metadata(out, &first, "process_name", TRACE_GROUP_PROCESS, 0, "processes");
+    write_metadata(out, &first, "thread_name", TRACE_GROUP_PROCESS, 0, "kernel");
+    write_metadata(out, &first, "process_name", TRACE_GROUP_SWAP_IO, 0, "swap I/O");
+    write_track_names(out, &first, events, count);
+
+    write_run_slices(out, &first, events, count, end_ns);
+    for (uint32_t i = 0; i < count; i++) {
+        if (events[i].type != TRACE_SWITCH) {
+            write_event(out, &first, &events[i]);
+        }
+    }
+    fprintf(out, "\n]}\n");
+    free(events);
+
+    bool ok = !ferror(out);
+    if (fclose(out) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        printf("错误：写入文件 %s 失败\n", path);
+        return false;
+    }
+    printf("已导出 %u 个事件到 %s（Chrome Trace Event JSON，可在 Perfetto UI 中打开）\n", count, path);
+    return true;
+}
+
+void print_trace_status(void) {
+    printf("\n=== 事件跟踪 ===\n");
+    printf("状态: %s\n", trace_enabled ? "跟踪中" : "未开启");
+
+    uint64_t recorded = 0, retained = 0;
+    uint32_t threads = 0;
+    for (uint32_t i = 0; i < TRACE_MAX_THREADS; i++) {
+        TraceRing* ring = __atomic_load_n(&tracer.rings[i], __ATOMIC_ACQUIRE);
+        if (!ring) {
+            continue;
+        }
+        threads++;
+        recorded += __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        retained += ring_retained(ring);
+    }
+    printf("记录事件的线程数: %u（上限 %u）\n", threads, TRACE_MAX_THREADS);
+    printf("已记录事件: %llu，保留: %llu，覆盖: %llu，丢弃: %llu\n",
+           (unsigned long long)recorded, (unsigned long long)retained,
+           (unsigned long long)(recorded - retained),
+           (unsigned long long)__atomic_load_n(&tracer.dropped, __ATOMIC_RELAXED));
+}
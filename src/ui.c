@@ -2,7 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 
-// ƽ̨ʱ֧
+// 跨平台的延时函数支持
 #ifdef _WIN32
 #include <windows.h>
 #else
@@ -14,23 +14,38 @@
 #include "../include/process.h"
 #include "../include/memory.h"
 #include "../include/vm.h"
+#include "../include/shm.h"
+#include "../include/ksm.h"
+#include "../include/thp.h"
+#include "../include/tlb.h"
+#include "../include/compact.h"
+#include "../include/numa.h"
+#include "../include/tier.h"
+#include "../include/profile.h"
+#include "../include/metrics.h"
+#include "../include/trace.h"
+#include "../include/zswap.h"
+#include "../include/swapdev.h"
+#include "../include/swapio.h"
+#include "../include/swapalloc.h"
 #include "../include/storage.h"
+#include "../include/pagecache.h"
 #include "../include/dump.h"
 
 #define MAX_CMD_LEN 256
 #define MAX_ARGS 4
 
-// ⲿ
+// 声明外部变量
 extern MemoryManager memory_manager;
 
-// 
+// 命令解析
 static Command parse_command(char* cmd_str) {
-    Command cmd = {CMD_UNKNOWN, {0}};  // ʼֶΪ0
+    Command cmd = {CMD_UNKNOWN, {0}};  // 初始化所有字段为0
     char* token = strtok(cmd_str, " \n");
     
     if (!token) return cmd;
     
-    // 
+    // 基本命令
     if (strcmp(token, "help") == 0) {
         cmd.type = CMD_HELP;
     } else if (strcmp(token, "status") == 0) {
@@ -38,7 +53,7 @@ static Command parse_command(char* cmd_str) {
     } else if (strcmp(token, "exit") == 0) {
         cmd.type = CMD_EXIT;
     } else if (strcmp(token, "proc") == 0) {
-        // ̹
+        // 进程管理命令
         token = strtok(NULL, " \n");
         if (token) {
             if (strcmp(token, "create") == 0) {
@@ -75,6 +90,18 @@ static Command parse_command(char* cmd_str) {
                 if (token) cmd.args.size = (uint32_t)strtoul(token, NULL, 0);
                 token = strtok(NULL, " \n");  // flags
                 if (token) cmd.args.flags = (uint32_t)strtoul(token, NULL, 0);
+            } else if (strcmp(token, "fork") == 0) {
+                cmd.type = CMD_PROC_FORK;
+                token = strtok(NULL, " \n");  // pid
+                if (token) cmd.args.pid = (uint32_t)strtoul(token, NULL, 0);
+            } else if (strcmp(token, "quota") == 0) {
+                cmd.type = CMD_PROC_QUOTA;
+                token = strtok(NULL, " \n");  // pid
+                if (token) cmd.args.pid = (uint32_t)strtoul(token, NULL, 0);
+                token = strtok(NULL, " \n");  // min_pages
+                if (token) cmd.args.size = (uint32_t)strtoul(token, NULL, 0);
+                token = strtok(NULL, " \n");  // max_pages
+                if (token) cmd.args.flags = (uint32_t)strtoul(token, NULL, 0);
             } else if (strcmp(token, "time") == 0) {
                 cmd.type = CMD_PROC_TIME;
                 token = strtok(NULL, " \n");  // pid
@@ -84,7 +111,7 @@ static Command parse_command(char* cmd_str) {
             }
         }
     } else if (strcmp(token, "mem") == 0) {
-        // ڴ
+        // 内存管理命令
         token = strtok(NULL, " \n");
         if (token) {
             if (strcmp(token, "alloc") == 0) {
@@ -141,10 +168,53 @@ static Command parse_command(char* cmd_str) {
                     else if (strcmp(token, "best") == 0) cmd.args.flags = BEST_FIT;
                     else if (strcmp(token, "worst") == 0) cmd.args.flags = WORST_FIT;
                 }
+            } else if (strcmp(token, "ksm") == 0) {
+                cmd.type = CMD_MEM_KSM;
+                cmd.args.flags = 3;  // 默认显示统计
+                token = strtok(NULL, " \n");  // on/off/scan/stat
+                if (token) {
+                    if (strcmp(token, "off") == 0) cmd.args.flags = 0;
+                    else if (strcmp(token, "on") == 0) cmd.args.flags = 1;
+                    else if (strcmp(token, "scan") == 0) cmd.args.flags = 2;
+                    token = strtok(NULL, " \n");  // 可选的扫描页框数
+                    if (token) cmd.args.size = (uint32_t)strtoul(token, NULL, 0);
+                }
+            } else if (strcmp(token, "thp") == 0) {
+                cmd.type = CMD_MEM_THP;
+                cmd.args.flags = 3;  // 默认显示统计
+                token = strtok(NULL, " \n");  // on/off/scan/split/stat
+                if (token) {
+                    if (strcmp(token, "off") == 0) cmd.args.flags = 0;
+                    else if (strcmp(token, "on") == 0) cmd.args.flags = 1;
+                    else if (strcmp(token, "scan") == 0) cmd.args.flags = 2;
+                    else if (strcmp(token, "split") == 0) cmd.args.flags = 4;
+                    token = strtok(NULL, " \n");  // 可选的扫描区域数
+                    if (token) cmd.args.size = (uint32_t)strtoul(token, NULL, 0);
+                }
+            } else if (strcmp(token, "compact") == 0) {
+                cmd.type = CMD_MEM_COMPACT;
+                cmd.args.flags = 3;  // 默认显示统计
+                token = strtok(NULL, " \n");  // on/off/run/stat
+                if (token) {
+                    if (strcmp(token, "off") == 0) cmd.args.flags = 0;
+                    else if (strcmp(token, "on") == 0) cmd.args.flags = 1;
+                    else if (strcmp(token, "run") == 0) cmd.args.flags = 2;
+                    token = strtok(NULL, " \n");  // 可选的迁移页框数
+                    if (token) cmd.args.size = (uint32_t)strtoul(token, NULL, 0);
+                }
+            } else if (strcmp(token, "scope") == 0) {
+                cmd.type = CMD_MEM_SCOPE;
+                cmd.args.flags = (uint32_t)-1;
+                token = strtok(NULL, " \n");  // scope
+                if (token) {
+                    if (strcmp(token, "global") == 0) cmd.args.flags = REPLACE_GLOBAL;
+                    else if (strcmp(token, "local") == 0) cmd.args.flags = REPLACE_LOCAL;
+                    else if (strcmp(token, "quota") == 0) cmd.args.flags = REPLACE_QUOTA;
+                }
             }
         }
     } else if (strcmp(token, "vm") == 0) {
-        // ڴ
+        // 虚拟内存管理命令
         token = strtok(NULL, " \n");
         if (token) {
             if (strcmp(token, "page") == 0) {
@@ -159,14 +229,191 @@ static Command parse_command(char* cmd_str) {
                 }
             } else if (strcmp(token, "swap") == 0) {
                 cmd.type = CMD_VM_SWAP;
-                token = strtok(NULL, " \n");  // list/clean
-                if (token) cmd.args.flags = (strcmp(token, "clean") == 0) ? 1 : 0;
+                token = strtok(NULL, " \n");  // list/clean/compact
+                if (token) {
+                    if (strcmp(token, "clean") == 0) {
+                        cmd.args.flags = 1;
+                    } else if (strcmp(token, "compact") == 0) {
+                        cmd.args.flags = 2;
+                    } else {
+                        cmd.args.flags = 0;
+                    }
+                }
             } else if (strcmp(token, "stat") == 0) {
                 cmd.type = CMD_VM_STAT;
+            } else if (strcmp(token, "zswap") == 0) {
+                cmd.type = CMD_VM_ZSWAP;
+                cmd.args.flags = 2;  // 默认显示统计
+                token = strtok(NULL, " \n");  // on/off/stat
+                if (token) {
+                    if (strcmp(token, "off") == 0) cmd.args.flags = 0;
+                    else if (strcmp(token, "on") == 0) cmd.args.flags = 1;
+                }
+            } else if (strcmp(token, "aio") == 0) {
+                cmd.type = CMD_VM_AIO;
+                cmd.args.flags = 2;  // 默认显示统计
+                token = strtok(NULL, " \n");  // on/off/stat
+                if (token) {
+                    if (strcmp(token, "off") == 0) cmd.args.flags = 0;
+                    else if (strcmp(token, "on") == 0) cmd.args.flags = 1;
+                }
+            } else if (strcmp(token, "swapdev") == 0) {
+                cmd.type = CMD_VM_SWAPDEV;
+                cmd.args.flags = 2;  // 默认显示统计
+                cmd.args.addr = SWAPDEV_SYNC_NONE;
+                token = strtok(NULL, " \n");  // memory/file
+                if (token && strcmp(token, "memory") == 0) {
+                    cmd.args.flags = 0;
+                } else if (token && strcmp(token, "file") == 0) {
+                    cmd.args.flags = 1;
+                    token = strtok(NULL, " \n");  // path
+                    if (token) cmd.args.text = strdup(token);
+                    // 可选项：direct、sync none/write/dsync
+                    while ((token = strtok(NULL, " \n")) != NULL) {
+                        if (strcmp(token, "direct") == 0) {
+                            cmd.args.size = 1;
+                        } else if (strcmp(token, "sync") == 0) {
+                            token = strtok(NULL, " \n");
+                            if (!token) break;
+                            if (strcmp(token, "write") == 0) cmd.args.addr = SWAPDEV_SYNC_WRITE;
+                            else if (strcmp(token, "dsync") == 0) cmd.args.addr = SWAPDEV_SYNC_DSYNC;
+                        }
+                    }
+                }
             }
         }
+    } else if (strcmp(token, "shm") == 0) {
+        // 共享内存段命令
+        token = strtok(NULL, " \n");
+        if (token) {
+            if (strcmp(token, "create") == 0) {
+                cmd.type = CMD_SHM_CREATE;
+                token = strtok(NULL, " \n");  // name
+                if (token) cmd.args.text = strdup(token);
+                token = strtok(NULL, " \n");  // pages
+                if (token) cmd.args.size = (uint32_t)strtoul(token, NULL, 0);
+            } else if (strcmp(token, "destroy") == 0) {
+                cmd.type = CMD_SHM_DESTROY;
+                token = strtok(NULL, " \n");  // name
+                if (token) cmd.args.text = strdup(token);
+            } else if (strcmp(token, "attach") == 0) {
+                cmd.type = CMD_SHM_ATTACH;
+                token = strtok(NULL, " \n");  // pid
+                if (token) cmd.args.pid = (uint32_t)strtoul(token, NULL, 0);
+                token = strtok(NULL, " \n");  // name
+                if (token) cmd.args.text = strdup(token);
+                token = strtok(NULL, " \n");  // start page
+                if (token) cmd.args.addr = (uint32_t)strtoul(token, NULL, 0);
+            } else if (strcmp(token, "detach") == 0) {
+                cmd.type = CMD_SHM_DETACH;
+                token = strtok(NULL, " \n");  // pid
+                if (token) cmd.args.pid = (uint32_t)strtoul(token, NULL, 0);
+                token = strtok(NULL, " \n");  // name
+                if (token) cmd.args.text = strdup(token);
+            } else if (strcmp(token, "list") == 0) {
+                cmd.type = CMD_SHM_LIST;
+            }
+        }
+    } else if (strcmp(token, "numa") == 0) {
+        // NUMA命令
+        token = strtok(NULL, " \n");
+        if (!token || strcmp(token, "stat") == 0) {
+            cmd.type = CMD_NUMA_STAT;
+        } else if (strcmp(token, "policy") == 0) {
+            cmd.type = CMD_NUMA_POLICY;
+            cmd.args.flags = (uint32_t)-1;
+            token = strtok(NULL, " \n");  // pid
+            if (token) cmd.args.pid = (uint32_t)strtoul(token, NULL, 0);
+            token = strtok(NULL, " \n");  // policy
+            if (token) {
+                if (strcmp(token, "local") == 0) cmd.args.flags = NUMA_POLICY_LOCAL;
+                else if (strcmp(token, "interleave") == 0) cmd.args.flags = NUMA_POLICY_INTERLEAVE;
+                else if (strcmp(token, "preferred") == 0) cmd.args.flags = NUMA_POLICY_PREFERRED;
+            }
+            token = strtok(NULL, " \n");  // preferred 的节点
+            if (token) cmd.args.size = (uint32_t)strtoul(token, NULL, 0);
+        } else if (strcmp(token, "home") == 0) {
+            cmd.type = CMD_NUMA_HOME;
+            token = strtok(NULL, " \n");  // pid
+            if (token) cmd.args.pid = (uint32_t)strtoul(token, NULL, 0);
+            token = strtok(NULL, " \n");  // node
+            cmd.args.size = token ? (uint32_t)strtoul(token, NULL, 0) : (uint32_t)-1;
+        } else if (strcmp(token, "balance") == 0) {
+            cmd.type = CMD_NUMA_BALANCE;
+            cmd.args.flags = 2;  // 默认立即平衡一次
+            token = strtok(NULL, " \n");  // on/off/run
+            if (token) {
+                if (strcmp(token, "off") == 0) cmd.args.flags = 0;
+                else if (strcmp(token, "on") == 0) cmd.args.flags = 1;
+            }
+        } else if (strcmp(token, "distance") == 0) {
+            cmd.type = CMD_NUMA_DISTANCE;
+            token = strtok(NULL, " \n");  // distance
+            if (token) cmd.args.size = (uint32_t)strtoul(token, NULL, 0);
+        }
+    } else if (strcmp(token, "tier") == 0) {
+        // 分层内存命令
+        token = strtok(NULL, " \n");
+        if (!token || strcmp(token, "stat") == 0) {
+            cmd.type = CMD_TIER_STAT;
+        } else if (strcmp(token, "on") == 0 || strcmp(token, "off") == 0) {
+            cmd.type = CMD_TIER_SET;
+            cmd.args.flags = strcmp(token, "on") == 0 ? 1 : 0;
+        } else if (strcmp(token, "scan") == 0) {
+            cmd.type = CMD_TIER_SCAN;
+            token = strtok(NULL, " \n");  // 扫描次数
+            cmd.args.size = token ? (uint32_t)strtoul(token, NULL, 0) : 1;
+        } else if (strcmp(token, "demote") == 0) {
+            cmd.type = CMD_TIER_DEMOTE;
+            token = strtok(NULL, " \n");  // 页框数
+            cmd.args.size = token ? (uint32_t)strtoul(token, NULL, 0) : 1;
+        }
+    } else if (strcmp(token, "profile") == 0) {
+        // 访问剖析命令
+        token = strtok(NULL, " \n");
+        if (!token || strcmp(token, "list") == 0) {
+            cmd.type = CMD_PROFILE_LIST;
+        } else {
+            if (strcmp(token, "start") == 0) cmd.type = CMD_PROFILE_START;
+            else if (strcmp(token, "stop") == 0) cmd.type = CMD_PROFILE_STOP;
+            else if (strcmp(token, "show") == 0) cmd.type = CMD_PROFILE_SHOW;
+            else if (strcmp(token, "heatmap") == 0) cmd.type = CMD_PROFILE_HEATMAP;
+            token = strtok(NULL, " \n");  // pid
+            if (token) cmd.args.pid = (uint32_t)strtoul(token, NULL, 0);
+            token = strtok(NULL, " \n");  // 目标缺页率（百分比）
+            if (token) cmd.args.text = strdup(token);
+        }
+    } else if (strcmp(token, "metrics") == 0) {
+        // 指标命令
+        token = strtok(NULL, " \n");
+        if (!token || strcmp(token, "show") == 0) {
+            cmd.type = CMD_METRICS_SHOW;
+        } else if (strcmp(token, "prom") == 0) {
+            cmd.type = CMD_METRICS_PROM;
+        } else if (strcmp(token, "export") == 0) {
+            cmd.type = CMD_METRICS_EXPORT;
+            token = strtok(NULL, " \n");  // 文件名
+            if (token) cmd.args.text = strdup(token);
+            token = strtok(NULL, " \n");  // 格式
+            cmd.args.size = token && strcmp(token, "json") == 0 ?
+                METRICS_FORMAT_JSON : METRICS_FORMAT_PROMETHEUS;
+        }
+    } else if (strcmp(token, "trace") == 0) {
+        // 事件跟踪命令
+        token = strtok(NULL, " \n");
+        if (!token || strcmp(token, "stat") == 0) {
+            cmd.type = CMD_TRACE_STAT;
+        } else if (strcmp(token, "start") == 0) {
+            cmd.type = CMD_TRACE_START;
+        } else if (strcmp(token, "stop") == 0) {
+            cmd.type = CMD_TRACE_STOP;
+        } else if (strcmp(token, "export") == 0) {
+            cmd.type = CMD_TRACE_EXPORT;
+            token = strtok(NULL, " \n");  // 文件名
+            if (token) cmd.args.text = strdup(token);
+        }
     } else if (strcmp(token, "disk") == 0) {
-        // ̹
+        // 磁盘管理命令
         token = strtok(NULL, " \n");
         if (token) {
             if (strcmp(token, "alloc") == 0) {
@@ -187,12 +434,42 @@ static Command parse_command(char* cmd_str) {
                 cmd.type = CMD_DISK_READ;
                 token = strtok(NULL, " \n");  // block
                 if (token) cmd.args.addr = (uint32_t)strtoul(token, NULL, 0);
+                token = strtok(NULL, " \n");  // 可选的块数
+                cmd.args.size = token ? (uint32_t)strtoul(token, NULL, 0) : 1;
             } else if (strcmp(token, "stat") == 0) {
                 cmd.type = CMD_DISK_STAT;
+            } else if (strcmp(token, "memory") == 0) {
+                cmd.type = CMD_DISK_BACKEND;
+                cmd.args.flags = 0;
+            } else if (strcmp(token, "file") == 0) {
+                token = strtok(NULL, " \n");  // path
+                if (token) {
+                    cmd.type = CMD_DISK_BACKEND;
+                    cmd.args.flags = 1;
+                    cmd.args.text = strdup(token);
+                }
+            } else if (strcmp(token, "sync") == 0) {
+                cmd.type = CMD_DISK_SYNC;
+            } else if (strcmp(token, "map") == 0) {
+                cmd.type = CMD_DISK_MAP;
+                token = strtok(NULL, " \n");  // pid
+                if (token) cmd.args.pid = (uint32_t)strtoul(token, NULL, 0);
+                token = strtok(NULL, " \n");  // block
+                if (token) cmd.args.block = (uint32_t)strtoul(token, NULL, 0);
+                token = strtok(NULL, " \n");  // count
+                if (token) cmd.args.size = (uint32_t)strtoul(token, NULL, 0);
+                token = strtok(NULL, " \n");  // start page
+                if (token) cmd.args.addr = (uint32_t)strtoul(token, NULL, 0);
+            } else if (strcmp(token, "unmap") == 0) {
+                cmd.type = CMD_DISK_UNMAP;
+                token = strtok(NULL, " \n");  // pid
+                if (token) cmd.args.pid = (uint32_t)strtoul(token, NULL, 0);
+                token = strtok(NULL, " \n");  // start page
+                if (token) cmd.args.addr = (uint32_t)strtoul(token, NULL, 0);
             }
         }
     } else if (strcmp(token, "state") == 0) {
-        // ϵͳ״̬
+        // 系统状态管理命令
         token = strtok(NULL, " \n");
         if (token) {
             if (strcmp(token, "save") == 0) {
@@ -205,6 +482,21 @@ static Command parse_command(char* cmd_str) {
                 if (token) cmd.args.text = strdup(token);
             } else if (strcmp(token, "reset") == 0) {
                 cmd.type = CMD_STATE_RESET;
+            } else if (strcmp(token, "incr") == 0 || strcmp(token, "stream") == 0) {
+                cmd.type = CMD_STATE_CHECKPOINT;
+                cmd.args.flags = strcmp(token, "stream") == 0;  // 1表示后台写入
+                token = strtok(NULL, " \n");  // filename
+                if (token) cmd.args.text = strdup(token);
+            } else if (strcmp(token, "auto") == 0) {
+                cmd.type = CMD_STATE_AUTO;
+                token = strtok(NULL, " \n");  // interval
+                if (token) cmd.args.size = (uint32_t)strtoul(token, NULL, 0);
+                token = strtok(NULL, " \n");  // optional prefix
+                if (token) cmd.args.text = strdup(token);
+            } else if (strcmp(token, "stat") == 0) {
+                cmd.type = CMD_STATE_STAT;
+            } else if (strcmp(token, "config") == 0) {
+                cmd.type = CMD_STATE_CONFIG;
             }
         }
     } else if (strcmp(token, "app") == 0) {
@@ -212,16 +504,16 @@ static Command parse_command(char* cmd_str) {
         if (token) {
             if (strcmp(token, "create") == 0) {
                 cmd.type = CMD_APP_CREATE;
-                // PID
+                // 解析PID
                 token = strtok(NULL, " \n");
                 if (token) cmd.args.pid = (uint32_t)strtoul(token, NULL, 0);
-                // ȼ
+                // 解析优先级
                 token = strtok(NULL, " \n");
                 if (token) cmd.args.priority = (uint32_t)strtoul(token, NULL, 0);
-                // ҳ
+                // 解析代码段页数
                 token = strtok(NULL, " \n");
                 if (token) cmd.args.code_pages = (uint32_t)strtoul(token, NULL, 0);
-                // ݶҳ
+                // 解析数据段页数
                 token = strtok(NULL, " \n");
                 if (token) cmd.args.data_pages = (uint32_t)strtoul(token, NULL, 0);
             } else if (strcmp(token, "run") == 0) {
@@ -239,12 +531,20 @@ static Command parse_command(char* cmd_str) {
         if (token) {
             if (strcmp(token, "tick") == 0) {
                 cmd.type = CMD_TIME_TICK;
-                token = strtok(NULL, " \n");  // ѡtick
+                token = strtok(NULL, " \n");  // 可选的tick数量
                 if (token) {
                     cmd.args.size = (uint32_t)strtoul(token, NULL, 0);
                 } else {
-                    cmd.args.size = 1;  // ĬһʱƬ
+                    cmd.args.size = 1;  // 默认一个时间片
                 }
+            } else if (strcmp(token, "fault") == 0) {
+                token = strtok(NULL, " \n");
+                if (token) {
+                    cmd.type = CMD_TIME_FAULT;
+                    cmd.args.size = (uint32_t)strtoul(token, NULL, 0);
+                }
+            } else if (strcmp(token, "stat") == 0) {
+                cmd.type = CMD_TIME_STAT;
             }
         }
     } else if (strncmp(cmd_str, CMD_STR_PROC_ACCESS, strlen(CMD_STR_PROC_ACCESS)) == 0) {
@@ -259,63 +559,125 @@ static Command parse_command(char* cmd_str) {
 }
 
 void show_help(void) {
-    printf("\n=== ϵͳ ===\n");
-    printf("\n\n");
-    printf("help [command]          - ʾϢ\n");
-    printf("status                  - ʾϵͳ״̬\n");
-    printf("exit                    - ˳ϵͳ\n");
+    printf("\n=== 系统命令 ===\n");
+    printf("\n基本命令\n");
+    printf("help [command]          - 显示帮助信息\n");
+    printf("status                  - 显示系统状态\n");
+    printf("exit                    - 退出系统\n");
+    
+    printf("\n进程管理\n");
+    printf("app create <pid> <prio> <code_pages> <data_pages> - 创建进程\n");
+    printf("proc kill <pid>         - 终止进程\n");
+    printf("proc list               - 显示进程列表\n");
+    printf("proc info <pid>         - 显示进程信息\n");
+    printf("proc prio <pid> <prio>  - 设置优先级\n");
+    printf("proc access <pid> <count> - 模拟进程内存访问\n");
+    printf("proc alloc <pid> <size> <type> - 分配内存(type:0堆/1栈)\n");
+    printf("proc fork <pid>         - 以写时复制方式复制进程\n");
+    printf("time tick [n]           - 模拟n个时钟滴答\n");
+    printf("time fault <ticks>      - 设置换入缺页的服务时间(0为不阻塞)\n");
+    printf("time stat               - 显示CPU利用率与I/O等待\n");
+    
+    printf("\n内存管理\n");
+    printf("mem map                 - 显示内存映射\n");
+    printf("mem stat                - 显示内存统计\n");
     
-    printf("\n̹\n");
-    printf("app create <pid> <prio> <code_pages> <data_pages> - \n");
-    printf("proc kill <pid>         - ֹ\n");
-    printf("proc list               - ʾб\n");
-    printf("proc info <pid>         - ʾϢ\n");
-    printf("proc prio <pid> <prio>  - ȼ\n");
-    printf("proc access <pid> <count> - ģڴ\n");
-    printf("proc alloc <pid> <size> <type> - ڴ(type:0/1ջ)\n");
+    printf("\n虚拟内存管理\n");
+    printf("vm page <in/out> <pid> <page> - 页面操作\n");
+    printf("vm swap <list/clean/compact> - 交换区管理\n");
+    printf("vm stat                 - 显示虚拟内存统计\n");
+    printf("vm zswap <on/off/stat>  - 压缩交换池开关/统计\n");
+    printf("vm aio <on/off/stat>    - 交换文件异步读写开关/统计\n");
+    printf("vm swapdev [memory | file <path> [direct] [sync none/write/dsync]] - 切换交换设备/统计\n");
     
-    printf("\nڴ\n");
-    printf("mem map                 - ʾڴӳ\n");
-    printf("mem stat                - ʾڴͳ\n");
+    printf("\n磁盘管理\n");
+    printf("disk alloc <size>       - 分配磁盘空间\n");
+    printf("disk free <block>       - 释放磁盘空间\n");
+    printf("disk write <block> \"text\" - 写入磁盘块\n");
+    printf("disk read <block> [count] - 读取连续的磁盘块\n");
+    printf("disk stat               - 显示磁盘状态\n");
+    printf("disk file <path>        - 使用映射的磁盘映像文件（已有映像直接加载）\n");
+    printf("disk memory             - 切换回内存磁盘\n");
+    printf("disk sync               - 写回页缓存脏页并同步磁盘映像（检查点）\n");
+    printf("disk map <pid> <block> <count> <page> - 把磁盘块映射到进程的虚拟页\n");
+    printf("disk unmap <pid> <page> - 解除进程虚拟页起的磁盘块映射\n");
     
-    printf("\nڴ\n");
-    printf("vm page <in/out> <pid> <page> - ҳ\n");
-    printf("vm swap <list/clean>    - \n");
-    printf("vm stat                 - ʾڴͳ\n");
+    printf("\n系统状态\n");
+    printf("state save [file]       - 保存完整快照\n");
+    printf("state load [file]       - 恢复快照（增量快照沿快照链恢复）\n");
+    printf("state incr <file>       - 保存相对上一个检查点的增量快照\n");
+    printf("state stream <file>     - 捕获增量快照后由后台线程写入\n");
+    printf("state auto <ticks> [prefix] - 每隔若干时钟滴答保存检查点（0关闭）\n");
+    printf("state stat              - 显示快照状态\n");
+    printf("state config            - 显示启动时配置的内存几何参数\n");
+    printf("state reset             - 重置系统状态\n");
     
-    printf("\nʾ\n");
-    printf("1. ڴСλΪֽ\n");
-    printf("2. ȼΧ0() - 2()\n");
-    printf("3. ҳС4096ֽ\n");
+    printf("\n共享内存\n");
+    printf("shm create <name> <pages> - 创建共享内存段\n");
+    printf("shm destroy <name>      - 销毁共享内存段\n");
+    printf("shm attach <pid> <name> <page> - 把共享内存段挂接到进程的虚拟页\n");
+    printf("shm detach <pid> <name> - 解除挂接\n");
+    printf("shm list                - 显示共享内存段\n");
+    printf("numa stat               - NUMA拓扑、访问矩阵和进程放置\n");
+    printf("numa policy <pid> <local/interleave/preferred> [node] - 设置进程的内存分配策略\n");
+    printf("numa home <pid> <node>  - 把进程迁到另一个节点运行\n");
+    printf("numa balance <on/off/run> - 自动NUMA平衡(后台迁移热页开关/立即迁移)\n");
+    printf("numa distance <d>       - 设置跨节点访问距离(本节点为10)\n");
+    printf("tier stat               - 分层内存各层容量、命中率和迁移统计\n");
+    printf("tier <on/off>           - 开启/关闭分层内存(冷页降级到慢速内存层而不是换出)\n");
+    printf("tier scan [n]           - 立即扫描访问位n次，提升热页并降级冷页\n");
+    printf("tier demote <n>         - 把DRAM中最冷的n个页面降级到慢速内存层\n");
+    printf("profile start <pid>     - 开始剖析进程的内存访问(每页访问次数和重用距离)\n");
+    printf("profile stop <pid>      - 停止剖析\n");
+    printf("profile show <pid> [目标缺页率%%] - 重用距离分布、缺页率曲线和所需页框数\n");
+    printf("profile heatmap <pid>   - 页面访问热度图\n");
+    printf("profile list            - 列出正在剖析的进程\n");
+    printf("metrics [show]          - 打印所有指标(计数器、仪表和延迟直方图)\n");
+    printf("metrics prom            - 按Prometheus文本格式打印指标\n");
+    printf("metrics export <文件> [prom/json] - 把指标快照导出到文件\n");
+    printf("trace start             - 开始事件跟踪(缺页、牺牲页框、换出、交换I/O、上下文切换)\n");
+    printf("trace stop              - 停止事件跟踪\n");
+    printf("trace export <文件>     - 导出Chrome Trace Event JSON(可在Perfetto UI中打开)\n");
+    printf("trace [stat]            - 事件跟踪状态\n");
     
-    printf("proc time <pid> <time>  - ýʱƬ\n");
-    printf("mem strategy <type>      - ڴ(first/best/worst)\n");
+    printf("\n提示：\n");
+    printf("1. 内存大小单位为字节\n");
+    printf("2. 优先级范围：0(高) - 2(低)\n");
+    printf("3. 页大小：%u字节\n", PAGE_SIZE);
+    
+    printf("proc time <pid> <time>  - 设置进程时间片\n");
+    printf("mem strategy <type>      - 设置内存分配策略(first/best/worst)\n");
+    printf("mem scope <type>         - 设置页面置换范围(global/local/quota)\n");
+    printf("proc quota <pid> <min> <max> - 设置进程页框下限/上限(页数，0表示不限制)\n");
+    printf("mem ksm <on/off/scan [n]/stat> - 相同页合并(后台扫描开关/立即扫描n个页框/统计)\n");
+    printf("mem thp <on/off/scan [n]/split/stat> - 透明大页(开关/立即合并扫描n个区域/拆分全部大页/统计和快表覆盖范围)\n");
+    printf("mem compact <on/off/run [n]/stat> - 内存整理(后台整理开关/立即迁移最多n个页框/统计)\n");
 }
 
 void show_detailed_help(CommandType cmd_type) {
     switch (cmd_type) {
         case CMD_MEM_ALLOC:
-            printf("\nڴϸ˵\n");
+            printf("\n内存分配命令详细说明\n");
             printf("mem alloc <pid> <addr> <size> [flags]\n");
-            printf("  pid  - ID\n");
-            printf("  addr - ʼַʽ0x1000\n");
-            printf("  size - Сֽ\n");
-            printf("  flags - ѡ\n");
-            printf("    -r  ֻ\n");
-            printf("    -w  д\n");
-            printf("    -x  ִ\n");
-            printf("ʾmem alloc 1 0x1000 4096 -w\n");
+            printf("  pid  - 进程ID\n");
+            printf("  addr - 起始地址，格式：0x1000\n");
+            printf("  size - 大小（字节数）\n");
+            printf("  flags - 可选项\n");
+            printf("    -r  只读\n");
+            printf("    -w  写入\n");
+            printf("    -x  执行\n");
+            printf("示例：mem alloc 1 0x1000 4096 -w\n");
             break;
             
         default:
-            printf("Ч\n");
+            printf("无效命令\n");
             break;
     }
 }
 
 void ui_init(void) {
-    printf("ӭʹڴϵͳ\n");
-    printf(" 'help' ȡ\n");
+    printf("欢迎使用内存管理系统\n");
+    printf("输入 'help' 获取帮助\n");
 }
 
 void ui_run(void) {
@@ -331,7 +693,7 @@ void ui_run(void) {
         
         handle_command(&cmd);
         
-        // ͷŲ
+        // 释放参数
         if (cmd.args.text) {
             free(cmd.args.text);
             cmd.args.text = NULL;
@@ -340,126 +702,132 @@ void ui_run(void) {
 }
 
 void ui_shutdown(void) {
-    printf("ϵͳ˳...\n");
+    printf("系统退出...\n");
 }
 
-// ڴʼ麯
+// 内存访问检查函数
 bool check_memory_access(PCB* process, uint32_t addr) {
     if (!process) return false;
     
-    // ҳ
+    // 计算页号
     uint32_t page_num = addr / PAGE_SIZE;
     
-    // εķΧ
-    // 
+    // 检查各个段的范围
+    // 代码段
     if (page_num >= process->memory_layout.code.start_page && 
         page_num < process->memory_layout.code.start_page + process->memory_layout.code.num_pages) {
         return true;
     }
     
-    // ݶ
+    // 数据段
     if (page_num >= process->memory_layout.data.start_page && 
         page_num < process->memory_layout.data.start_page + process->memory_layout.data.num_pages) {
         return true;
     }
     
-    // 
+    // 堆区
     if (page_num >= process->memory_layout.heap.start_page && 
         page_num < process->memory_layout.heap.start_page + process->memory_layout.heap.num_pages) {
         return true;
     }
     
-    // ջ
+    // 栈区
     if (page_num >= process->memory_layout.stack.start_page && 
         page_num < process->memory_layout.stack.start_page + process->memory_layout.stack.num_pages) {
         return true;
     }
     
+    // 挂接的共享内存段和文件映射
+    if (page_num < process->page_table_size &&
+        (process->page_table[page_num].flags.shm || process->page_table[page_num].flags.file)) {
+        return true;
+    }
+    
     return false;
 }
 
-// ӡڴ״̬ ASCII ͼ
+// 打印内存段状态的 ASCII 图形
 void print_segment_ascii(PCB* process, uint32_t start_page, uint32_t num_pages) {
     for (uint32_t i = 0; i < num_pages; i++) {
         uint32_t page = start_page + i;
         if (page < process->page_table_size) {
             if (process->page_table[page].flags.present) {
-                printf(" ");
+                printf("■ ");
             } else if (process->page_table[page].flags.swapped) {
                 printf("S ");
             } else {
-                printf(" ");
+                printf("□ ");
             }
         }
     }
 }
 
-// ӡڴ沼
+// 打印内存布局
 void print_memory_layout(PCB* process) {
     if (!process) return;
     
-    printf("\n===  %u ڴ沼 ===\n", process->pid);
-    printf("Σҳ %u-%u (%u ҳ)%s\n",
+    printf("\n=== 进程 %u 内存布局 ===\n", process->pid);
+    printf("代码段：页号 %u-%u (%u 页)%s\n",
            process->memory_layout.code.start_page,
            process->memory_layout.code.start_page + process->memory_layout.code.num_pages - 1,
            process->memory_layout.code.num_pages,
-           process->memory_layout.code.is_allocated ? " [ѷ]" : "");
+           process->memory_layout.code.is_allocated ? " [已分配]" : "");
     
-    printf("ݶΣҳ %u-%u (%u ҳ)%s\n",
+    printf("数据段：页号 %u-%u (%u 页)%s\n",
            process->memory_layout.data.start_page,
            process->memory_layout.data.start_page + process->memory_layout.data.num_pages - 1,
            process->memory_layout.data.num_pages,
-           process->memory_layout.data.is_allocated ? " [ѷ]" : "");
+           process->memory_layout.data.is_allocated ? " [已分配]" : "");
     
-    printf("  ҳ %u-%u (%u ҳ)%s\n",
+    printf("堆区：  页号 %u-%u (%u 页)%s\n",
            process->memory_layout.heap.start_page,
            process->memory_layout.heap.start_page + process->memory_layout.heap.num_pages - 1,
            process->memory_layout.heap.num_pages,
-           process->memory_layout.heap.is_allocated ? " [ѷ]" : "");
+           process->memory_layout.heap.is_allocated ? " [已分配]" : "");
     
-    printf("ջ  ҳ %u-%u (%u ҳ)%s\n",
+    printf("栈区：  页号 %u-%u (%u 页)%s\n",
            process->memory_layout.stack.start_page,
            process->memory_layout.stack.start_page + process->memory_layout.stack.num_pages - 1,
            process->memory_layout.stack.num_pages,
-           process->memory_layout.stack.is_allocated ? " [ѷ]" : "");
+           process->memory_layout.stack.is_allocated ? " [已分配]" : "");
 }
 
-// ϵͳ״̬ͼʾ
+// 系统状态图形显示
 void print_system_status_graph(void) {
-    printf("\n=== ϵͳڴʹ ===\n\n");
+    printf("\n=== 系统内存使用情况 ===\n\n");
     
-    // ʾͼ
-    printf("ͼ:   ? ?δ\n\n");
+    // 显示图例
+    printf("图例: □空闲 ■已用 ?交换 ?未分配\n\n");
     
-    // ʾڴʹ
-    printf("ڴʹ:\n");
-    for (int i = 0; i < PHYSICAL_PAGES; i++) {
-        if (i % 32 == 0) printf("%3d: ", i);
+    // 显示物理内存使用情况
+    printf("物理内存使用:\n");
+    for (uint32_t i = 0; i < PHYSICAL_PAGES; i++) {
+        if (i % 32 == 0) printf("%3u: ", i);
         if (memory_manager.frames[i].is_allocated)
-            printf("");
+            printf("■");
         else
-            printf("");
+            printf("□");
         if ((i + 1) % 32 == 0) printf("\n");
     }
     
-    printf("\n=== ڴӳ ===\n");
+    printf("\n=== 进程内存映射 ===\n");
     for (uint32_t i = 0; i < scheduler.total_processes; i++) {
         PCB* process = get_process_by_pid(i + 1);
         if (process) {
-            printf("\n %d (%s):\n", process->pid, process->name);
+            printf("\n进程 %d (%s):\n", process->pid, process->name);
             
-            // ʾڴʹ
+            // 显示内存段使用情况
             printf("     0  1  2  3  4  5  6  7  8  9\n");
-            printf(" ");
+            printf("代码 ");
             print_segment_ascii(process, process->memory_layout.code.start_page,
                               process->memory_layout.code.num_pages);
-            printf("\n ");
+            printf("\n数据 ");
             print_segment_ascii(process, process->memory_layout.data.start_page,
                               process->memory_layout.data.num_pages);
-            printf("\n   ");
+            printf("\n堆   ");
             print_segment_ascii(process, process->memory_layout.heap.start_page,
                               process->memory_layout.heap.num_pages);
-            printf("\nջ   ");
+            printf("\n栈   ");
             print_segment_ascii(process, process->memory_layout.stack.start_page,
                               process->memory_layout.stack.num_pages);
             printf("\n");
@@ -467,7 +835,7 @@ void print_system_status_graph(void) {
     }
 }
 
-// û
+// 处理用户命令
 void handle_command(Command* cmd) {
     PCB* process;
     uint32_t block;
@@ -478,7 +846,7 @@ void handle_command(Command* cmd) {
             break;
             
         case CMD_STATUS:
-            printf("\n=== ϵͳ״̬ ===\n");
+            printf("\n=== 系统状态 ===\n");
             print_scheduler_status();
             print_memory_map();
             print_vm_stats();
@@ -486,25 +854,25 @@ void handle_command(Command* cmd) {
             break;
             
         case CMD_PROC_CREATE:
-            // Ϊ½Ĭڴ沼
+            // 为新进程设置默认内存布局
             MemoryLayout default_layout = {
                 .code_start = 0x1000,
                 .code_size = PAGE_SIZE,
                 .data_start = 0x2000,
                 .data_size = PAGE_SIZE,
                 .heap_start = 0x3000,
-                .heap_size = PAGE_SIZE * 5,  // 5ҳѿռ
-                .stack_start = 0x8000,       // 㹻ռ
-                .stack_size = PAGE_SIZE * 5   // 5ҳջռ
+                .heap_size = PAGE_SIZE * 5,  // 5页堆空间
+                .stack_start = 0x8000,       // 给堆区留出足够空间
+                .stack_size = PAGE_SIZE * 5   // 5页栈空间
             };
             
-            // ҪҳС
+            // 计算需要的页表大小
             uint32_t page_table_size = (default_layout.stack_start + default_layout.stack_size) / PAGE_SIZE;
             
             process = process_create(cmd->args.pid, page_table_size);
             if (process) {
-                printf(" %u ɹ\n", cmd->args.pid);
-                // Ĭڴ沼
+                printf("进程 %u 创建成功\n", cmd->args.pid);
+                // 创建默认内存布局
                 ProcessMemoryLayout default_memory_layout = {
                     .code = {
                         .start_page = 0,
@@ -529,7 +897,7 @@ void handle_command(Command* cmd) {
                 };
                 process->memory_layout = default_memory_layout;
             } else {
-                printf("̴ʧ\n");
+                printf("进程创建失败\n");
             }
             break;
             
@@ -537,9 +905,9 @@ void handle_command(Command* cmd) {
             process = get_process_by_pid(cmd->args.pid);
             if (process) {
                 process_destroy(process);
-                printf(" %u ֹ\n", cmd->args.pid);
+                printf("进程 %u 已终止\n", cmd->args.pid);
             } else {
-                printf("Ҳ %u\n", cmd->args.pid);
+                printf("找不到进程 %u\n", cmd->args.pid);
             }
             break;
             
@@ -550,13 +918,13 @@ void handle_command(Command* cmd) {
         case CMD_PROC_INFO:
             process = get_process_by_pid(cmd->args.pid);
             if (process) {
-                printf("\n %u Ϣ\n", process->pid);
+                printf("\n进程 %u 信息：\n", process->pid);
                 print_process_status(process->state);
-                printf("ȼ%d\n", process->priority);
-                printf("ʱƬ%u\n", process->time_slice);
+                printf("优先级：%d\n", process->priority);
+                printf("时间片：%u\n", process->time_slice);
                 print_process_stats(process);
             } else {
-                printf("Ҳ %u\n", cmd->args.pid);
+                printf("找不到进程 %u\n", cmd->args.pid);
             }
             break;
             
@@ -566,12 +934,12 @@ void handle_command(Command* cmd) {
                 ProcessPriority new_priority = (ProcessPriority)cmd->args.flags;
                 if (new_priority >= PRIORITY_HIGH && new_priority <= PRIORITY_LOW) {
                     set_process_priority(process, new_priority);
-                    printf(" %u ȼѸΪ %d\n", cmd->args.pid, new_priority);
+                    printf("进程 %u 的优先级已更新为 %d\n", cmd->args.pid, new_priority);
                 } else {
-                    printf("ЧȼֵӦΪ 0-2\n");
+                    printf("无效的优先级值（应为 0-2）\n");
                 }
             } else {
-                printf("Ҳ %u\n", cmd->args.pid);
+                printf("找不到进程 %u\n", cmd->args.pid);
             }
             break;
             
@@ -579,10 +947,10 @@ void handle_command(Command* cmd) {
             process = get_process_by_pid(cmd->args.pid);
             if (process) {
                 if (process_allocate_memory(process, cmd->args.addr, cmd->args.size)) {
-                    printf("ڴɹ\n");
+                    printf("内存分配成功\n");
                 }
             } else {
-                printf("Ҳ %u\n", cmd->args.pid);
+                printf("找不到进程 %u\n", cmd->args.pid);
             }
             break;
             
@@ -590,9 +958,9 @@ void handle_command(Command* cmd) {
             process = get_process_by_pid(cmd->args.pid);
             if (process) {
                 process_free_memory(process, cmd->args.addr, cmd->args.size);
-                printf("ڴͷ\n");
+                printf("内存已释放\n");
             } else {
-                printf("Ҳ %u\n", cmd->args.pid);
+                printf("找不到进程 %u\n", cmd->args.pid);
             }
             break;
             
@@ -605,22 +973,25 @@ void handle_command(Command* cmd) {
             if (process) {
                 if (cmd->args.flags) {  // page in
                     if (page_in(process, cmd->args.addr / PAGE_SIZE)) {
-                        printf("ҳɹ\n");
+                        printf("页面调入成功\n");
                     }
                 } else {  // page out
                     if (page_out(process, cmd->args.addr / PAGE_SIZE)) {
-                        printf("ҳɹ\n");
+                        printf("页面调出成功\n");
                     }
                 }
             } else {
-                printf("Ҳ %u\n", cmd->args.pid);
+                printf("找不到进程 %u\n", cmd->args.pid);
             }
             break;
             
         case CMD_VM_SWAP:
-            if (cmd->args.flags) {  // clean
+            if (cmd->args.flags == 2) {  // compact
+                printf("交换区整理完成，迁移 %u 个交换区块\n", swap_compact(SWAP_SIZE));
+                print_swap_fragmentation();
+            } else if (cmd->args.flags) {  // clean
                 clean_swap_area();
-                printf("\n");
+                printf("交换区已清理\n");
             } else {  // list
                 print_swap_status();
             }
@@ -630,47 +1001,169 @@ void handle_command(Command* cmd) {
             print_vm_stats();
             break;
             
+        case CMD_VM_AIO:
+            if (cmd->args.flags == 2) {
+                print_swapio_stats();
+            } else {
+                swapio_set_enabled(cmd->args.flags == 1);
+            }
+            break;
+            
+        case CMD_VM_SWAPDEV:
+            if (cmd->args.flags == 0) {
+                swapdev_use_memory();
+            } else if (cmd->args.flags == 1) {
+                swapdev_use_file(cmd->args.text, cmd->args.size != 0, (SwapDevSync)cmd->args.addr);
+            } else {
+                print_swapdev_stats();
+            }
+            break;
+            
+        case CMD_VM_ZSWAP:
+            if (cmd->args.flags == 2) {
+                print_zswap_stats();
+            } else {
+                zswap_set_enabled(cmd->args.flags == 1);
+            }
+            break;
+            
         case CMD_DISK_ALLOC:
             block = storage_allocate(cmd->args.size);
             if (block != (uint32_t)-1) {
-                printf("̿ɹ%u\n", block);
+                printf("分配磁盘块成功：%u\n", block);
             } else {
-                printf("̿ռʧ\n");
+                printf("磁盘空间分配失败\n");
             }
             break;
             
         case CMD_DISK_FREE:
             storage_free(cmd->args.addr);
-            printf("̿ %u ͷ\n", cmd->args.addr);
+            pagecache_drop_unallocated();
+            printf("磁盘块 %u 已释放\n", cmd->args.addr);
+            break;
+            
+        case CMD_DISK_WRITE: {
+            // 文本写入块首，其余部分清零
+            uint8_t* data = (uint8_t*)calloc(1, BLOCK_SIZE);
+            if (!data || !cmd->args.text) {
+                printf("用法：disk write <block> \"text\"\n");
+                free(data);
+                break;
+            }
+            size_t len = strlen(cmd->args.text);
+            memcpy(data, cmd->args.text, len < BLOCK_SIZE ? len : BLOCK_SIZE);
+            if (pagecache_write(cmd->args.addr, data)) {
+                printf("磁盘块 %u 写入成功\n", cmd->args.addr);
+            }
+            free(data);
             break;
+        }
+            
+        case CMD_DISK_READ: {
+            // 连续多块一次读出，逐块显示开头的内容
+            uint32_t count = cmd->args.size ? cmd->args.size : 1;
+            uint8_t* data = (uint8_t*)malloc((size_t)count * BLOCK_SIZE);
+            if (!data) {
+                printf("内存不足\n");
+                break;
+            }
+            if (pagecache_readv(cmd->args.addr, count, data)) {
+                for (uint32_t i = 0; i < count; i++) {
+                    const uint8_t* block_data = data + (size_t)i * BLOCK_SIZE;
+                    printf("磁盘块 %u: ", cmd->args.addr + i);
+                    for (int j = 0; j < 16; j++) {
+                        printf("%c", (block_data[j] >= 32 && block_data[j] <= 126) ? block_data[j] : '.');
+                    }
+                    printf("\n");
+                }
+            } else {
+                printf("磁盘块 %u 起的 %u 块读取失败\n", cmd->args.addr, count);
+            }
+            free(data);
+            break;
+        }
             
         case CMD_DISK_STAT:
             print_storage_status();
+            print_pagecache_status();
+            break;
+            
+        case CMD_DISK_BACKEND:
+            // 换到其他映像后缓存内容不再有效，先写回再丢弃
+            pagecache_sync();
+            if (cmd->args.flags ? storage_use_file(cmd->args.text) : storage_use_memory()) {
+                pagecache_invalidate_all();
+            }
+            break;
+            
+        case CMD_DISK_SYNC:
+            printf("页缓存写回 %u 块\n", pagecache_sync());
+            storage_sync();
+            break;
+            
+        case CMD_DISK_MAP:
+            pagecache_map(cmd->args.pid, cmd->args.block, cmd->args.size, cmd->args.addr);
+            break;
+            
+        case CMD_DISK_UNMAP:
+            pagecache_unmap(cmd->args.pid, cmd->args.addr);
             break;
             
         case CMD_STATE_SAVE:
             if (dump_system_state(cmd->args.text ? cmd->args.text : "system.dump")) {
-                printf("ϵͳ״̬ɹ\n");
+                printf("系统状态保存成功\n");
             } else {
-                printf("ϵͳ״̬ʧ\n");
+                printf("系统状态保存失败\n");
             }
             break;
             
         case CMD_STATE_LOAD:
             if (restore_system_state(cmd->args.text ? cmd->args.text : "system.dump")) {
-                printf("ϵͳ״ָ̬ɹ\n");
+                printf("系统状态恢复成功\n");
             } else {
-                printf("ϵͳ״ָ̬ʧ\n");
+                printf("系统状态恢复失败\n");
             }
             break;
             
         case CMD_STATE_RESET:
+            dump_forget_checkpoint();
             scheduler_shutdown();
             vm_shutdown();
             memory_init();
             vm_init();
+            shm_init();
+            ksm_init();
+            thp_init();
+            tlb_init();
+            compact_init();
+            profile_init();
+            pagecache_init();
             scheduler_init();
-            printf("ϵͳ\n");
+            printf("系统已重置\n");
+            break;
+            
+        case CMD_STATE_CHECKPOINT:
+            if (!cmd->args.text) {
+                printf("用法：state %s <file>\n", cmd->args.flags ? "stream" : "incr");
+            } else if (cmd->args.flags) {
+                dump_start_stream(cmd->args.text, true);
+            } else if (dump_incremental_state(cmd->args.text)) {
+                printf("检查点保存成功\n");
+            } else {
+                printf("检查点保存失败\n");
+            }
+            break;
+            
+        case CMD_STATE_AUTO:
+            dump_set_auto_checkpoint(cmd->args.size, cmd->args.text);
+            break;
+            
+        case CMD_STATE_STAT:
+            print_dump_status();
+            break;
+            
+        case CMD_STATE_CONFIG:
+            print_config();
             break;
             
         case CMD_APP_CREATE: {
@@ -682,18 +1175,18 @@ void handle_command(Command* cmd) {
             );
             
             if (!process) {
-                printf("ʧ\n");
+                printf("创建进程失败\n");
                 return;
             }
             
-            printf("̳ɹPID=%u\n", process->pid);
-            printf("ڴ沼֣\n");
-            printf("Σ%uҳʼҳ=%u\n", process->memory_layout.code.num_pages, process->memory_layout.code.start_page);
-            printf("ݶΣ%uҳʼҳ=%u\n", process->memory_layout.data.num_pages, process->memory_layout.data.start_page);
-            printf("ѣ%uҳ%s\n", process->memory_layout.heap.num_pages, 
-                   process->memory_layout.heap.is_allocated ? "ѷ䣩" : "δ䣩");
-            printf("ջ%uҳ%s\n", process->memory_layout.stack.num_pages,
-                   process->memory_layout.stack.is_allocated ? "ѷ䣩" : "δ䣩");
+            printf("创建进程成功，PID=%u\n", process->pid);
+            printf("内存布局：\n");
+            printf("代码段：%u页（起始页=%u）\n", process->memory_layout.code.num_pages, process->memory_layout.code.start_page);
+            printf("数据段：%u页（起始页=%u）\n", process->memory_layout.data.num_pages, process->memory_layout.data.start_page);
+            printf("堆：%u页%s\n", process->memory_layout.heap.num_pages, 
+                   process->memory_layout.heap.is_allocated ? "（已分配）" : "（未分配）");
+            printf("栈：%u页%s\n", process->memory_layout.stack.num_pages,
+                   process->memory_layout.stack.is_allocated ? "（已分配）" : "（未分配）");
             break;
         }
             
@@ -702,14 +1195,17 @@ void handle_command(Command* cmd) {
             if (process) {
                 monitor_process(process);
             } else {
-                printf("Ҳ %u\n", cmd->args.pid);
+                printf("找不到进程 %u\n", cmd->args.pid);
             }
             break;
             
         case CMD_MEM_PROFILE:
-            printf("\n=== ϵͳڴʹ÷ ===\n");
-            PCB* analyzed[MAX_PROCESSES] = {NULL};  // ¼ѷĽ
+            printf("\n=== 系统内存使用分析 ===\n");
+            PCB** analyzed = (PCB**)calloc(MAX_PROCESSES, sizeof(PCB*));  // 记录已分析的进程
             int analyzed_count = 0;
+            if (!analyzed) {
+                break;
+            }
             
             for (int i = 0; i < 3; i++) {
                 PCB* current = scheduler.ready_queue[i];
@@ -732,6 +1228,7 @@ void handle_command(Command* cmd) {
                 !is_process_analyzed(scheduler.running_process, analyzed, analyzed_count)) {
                 analyze_memory_usage(scheduler.running_process);
             }
+            free(analyzed);
             break;
             
         case CMD_MEM_OPTIMIZE:
@@ -739,7 +1236,7 @@ void handle_command(Command* cmd) {
             if (process) {
                 optimize_memory_layout(process);
             } else {
-                printf("Ҳ %u\n", cmd->args.pid);
+                printf("找不到进程 %u\n", cmd->args.pid);
             }
             break;
             
@@ -751,51 +1248,65 @@ void handle_command(Command* cmd) {
             process = get_process_by_pid(cmd->args.pid);
             if (process) {
                 if (process->state == PROCESS_READY) {
-                    process->state = PROCESS_RUNNING;
-                    set_running_process(process);
-                    printf("Ӧó PID %u \n", cmd->args.pid);
-                    printf("ʹ 'time tick [n]' ģʱƬת\n");
+                    if (!set_running_process(process)) {
+                        printf("应用程序 PID %u 无法启动：页面无法调入\n", cmd->args.pid);
+                        break;
+                    }
+                    printf("应用程序 PID %u 已启动\n", cmd->args.pid);
+                    printf("使用 'time tick [n]' 命令来模拟时间片轮转\n");
                 } else {
-                    printf("Ӧó PID %u ޷ǰ״̬%d\n", cmd->args.pid, process->state);
+                    printf("应用程序 PID %u 无法启动，当前状态：%d\n", cmd->args.pid, process->state);
                 }
             } else {
-                printf("Ҳ %u\n", cmd->args.pid);
+                printf("找不到进程 %u\n", cmd->args.pid);
             }
             break;
             
         case CMD_TIME_TICK:
             for (uint32_t i = 0; i < cmd->args.size; i++) {
                 time_tick();
-                printf("\n=== ʱƬ %u ===\n", i + 1);
+                printf("\n=== 时间片 %u ===\n", i + 1);
                 print_scheduler_status();
-                Sleep(1000);  // ӳ1Ա۲
+                Sleep(1000);  // 延迟1秒以便观察
             }
             break;
             
+        case CMD_TIME_FAULT:
+            set_fault_service_ticks(cmd->args.size);
+            break;
+            
+        case CMD_TIME_STAT:
+            print_cpu_utilization();
+            break;
+            
         case CMD_MEM_WRITE:
             process = get_process_by_pid(cmd->args.pid);
             if (!process) {
-                printf("Ҳ %u\n", cmd->args.pid);
+                printf("找不到进程 %u\n", cmd->args.pid);
                 break;
             }
             
-            // ַǷЧ
+            // 检查地址是否有效
             bool address_valid = false;
             if (check_memory_access(process, cmd->args.addr)) {
                 address_valid = true;
             }
             
             if (!address_valid) {
-                printf("Чڴַ: 0x%x\n", cmd->args.addr);
+                printf("无效的内存地址: 0x%x\n", cmd->args.addr);
                 break;
             }
             
-            // дڴ
+            // 写入内存
             if (cmd->args.text) {
                 size_t len = strlen(cmd->args.text);
                 for (size_t i = 0; i < len; i++) {
-                    access_memory(process, cmd->args.addr + i, true);  // д
-                    // ʵд
+                    access_memory(process, cmd->args.addr + i, true);  // 写入操作
+                    // 页面正在从交换文件异步读入时，等待读入完成后重新访问
+                    if (swapio_finish_fault(process, (cmd->args.addr + i) / PAGE_SIZE)) {
+                        access_memory(process, cmd->args.addr + i, true);
+                    }
+                    // 实际写入数据
                     uint32_t frame = process->page_table[cmd->args.addr / PAGE_SIZE].frame_number;
                     uint32_t offset = cmd->args.addr % PAGE_SIZE;
                     uint8_t* phys_addr = (uint8_t*)get_physical_address(frame);
@@ -803,42 +1314,43 @@ void handle_command(Command* cmd) {
                         phys_addr[offset + i] = cmd->args.text[i];
                     }
                 }
-                printf("ɹд %zu ֽڵַ 0x%x\n", len, cmd->args.addr);
+                printf("成功写入 %zu 字节到地址 0x%x\n", len, cmd->args.addr);
             }
             break;
             
         case CMD_MEM_READ:
             process = get_process_by_pid(cmd->args.pid);
             if (!process) {
-                printf("Ҳ %u\n", cmd->args.pid);
+                printf("找不到进程 %u\n", cmd->args.pid);
                 break;
             }
             
-            // ַǷЧ
+            // 检查地址是否有效
             if (!check_memory_access(process, cmd->args.addr)) {
-                printf("Чڴַ: 0x%x\n", cmd->args.addr);
+                printf("无效的内存地址: 0x%x\n", cmd->args.addr);
                 break;
             }
             
-            // ȡڴ
-            access_memory(process, cmd->args.addr, false);  // ȡ
+            // 读取内存
+            access_memory(process, cmd->args.addr, false);  // 读取操作
+            swapio_finish_fault(process, cmd->args.addr / PAGE_SIZE);
             uint32_t frame = process->page_table[cmd->args.addr / PAGE_SIZE].frame_number;
             uint32_t offset = cmd->args.addr % PAGE_SIZE;
             uint8_t* phys_addr = (uint8_t*)get_physical_address(frame);
             if (phys_addr) {
-                printf("ַ 0x%x :\n", cmd->args.addr);
-                // ʾʮ
+                printf("地址 0x%x 的内容:\n", cmd->args.addr);
+                // 显示十六进制
                 printf("HEX:  ");
                 for (int i = 0; i < 16 && (offset + i) < PAGE_SIZE; i++) {
                     printf("%02x ", phys_addr[offset + i]);
                 }
                 printf("\n");
                 
-                // ʾASCII
+                // 显示ASCII
                 printf("ASCII: ");
                 for (int i = 0; i < 16 && (offset + i) < PAGE_SIZE; i++) {
                     char c = phys_addr[offset + i];
-                    // ֻʾɴӡַʾΪ
+                    // 只显示可打印字符，其他显示为点
                     printf("%c  ", (c >= 32 && c <= 126) ? c : '.');
                 }
                 printf("\n");
@@ -846,7 +1358,7 @@ void handle_command(Command* cmd) {
             break;
             
         case CMD_UNKNOWN:
-            printf("δ֪\n");
+            printf("未知命令\n");
             break;
             
         case CMD_PROC_ACCESS:
@@ -862,13 +1374,13 @@ void handle_command(Command* cmd) {
             if (process) {
                 if (cmd->args.time_slice > 0) {
                     process->time_slice = cmd->args.time_slice;
-                    printf(" %u ʱƬѸΪ %u\n", 
+                    printf("进程 %u 的时间片已更新为 %u\n", 
                            cmd->args.pid, cmd->args.time_slice);
                 } else {
-                    printf("ʱƬ0\n");
+                    printf("错误：时间片必须大于0\n");
                 }
             } else {
-                printf("Ҳ %u\n", cmd->args.pid);
+                printf("找不到进程 %u\n", cmd->args.pid);
             }
             break;
             
@@ -876,28 +1388,252 @@ void handle_command(Command* cmd) {
             switch (cmd->args.flags) {
                 case FIRST_FIT:
                     set_allocation_strategy(FIRST_FIT);
-                    printf("ڴΪ״Ӧ㷨\n");
+                    printf("内存分配策略已设置为首次适应算法\n");
                     break;
                 case BEST_FIT:
                     set_allocation_strategy(BEST_FIT);
-                    printf("ڴΪӦ㷨\n");
+                    printf("内存分配策略已设置为最佳适应算法\n");
                     break;
                 case WORST_FIT:
                     set_allocation_strategy(WORST_FIT);
-                    printf("ڴΪӦ㷨\n");
+                    printf("内存分配策略已设置为最差适应算法\n");
                     break;
                 default:
-                    printf("Чڴ\n");
-                    printf("òԣ\n");
-                    printf("  first - ״Ӧ㷨\n");
-                    printf("  best  - Ӧ㷨\n");
-                    printf("  worst - Ӧ㷨\n");
+                    printf("无效的内存分配策略\n");
+                    printf("可用策略：\n");
+                    printf("  first - 首次适应算法\n");
+                    printf("  best  - 最佳适应算法\n");
+                    printf("  worst - 最差适应算法\n");
+                    break;
+            }
+            break;
+            
+        case CMD_MEM_SCOPE:
+            switch (cmd->args.flags) {
+                case REPLACE_GLOBAL:
+                case REPLACE_LOCAL:
+                case REPLACE_QUOTA:
+                    set_replacement_scope((ReplacementScope)cmd->args.flags);
+                    printf("页面置换范围已设置为%s\n",
+                           get_replacement_scope_name((ReplacementScope)cmd->args.flags));
+                    break;
+                default:
+                    printf("无效的页面置换范围\n");
+                    printf("可用范围：\n");
+                    printf("  global - 全局置换\n");
+                    printf("  local  - 局部置换（只置换缺页进程自己的页面）\n");
+                    printf("  quota  - 配额置换（按进程页框下限/上限）\n");
+                    break;
+            }
+            break;
+            
+        case CMD_PROC_FORK:
+            process = fork_process(cmd->args.pid);
+            if (process) {
+                printf("共享页框：%u，私有页框：%u\n", count_shared_frames(), count_private_frames());
+            } else {
+                printf("进程复制失败\n");
+            }
+            break;
+            
+        case CMD_MEM_KSM:
+            if (cmd->args.flags == 0 || cmd->args.flags == 1) {
+                ksm_set_enabled(cmd->args.flags == 1);
+            } else if (cmd->args.flags == 2) {
+                uint32_t before = get_free_frames_count();
+                uint32_t merged = ksm_scan(cmd->args.size);
+                printf("本次扫描合并回收 %u 个页框，空闲页框 %u -> %u\n",
+                       merged, before, get_free_frames_count());
+            } else {
+                print_ksm_stats();
+            }
+            break;
+            
+        case CMD_MEM_THP:
+            if (cmd->args.flags == 0 || cmd->args.flags == 1) {
+                thp_set_enabled(cmd->args.flags == 1);
+            } else if (cmd->args.flags == 2) {
+                uint32_t collapsed = thp_scan(cmd->args.size);
+                printf("本次扫描合并 %u 个大页，当前大页数 %u\n", collapsed, thp_count_huge_pages());
+            } else if (cmd->args.flags == 4) {
+                printf("已拆分 %u 个大页\n", thp_split_all());
+            } else {
+                print_thp_stats();
+            }
+            break;
+            
+        case CMD_MEM_COMPACT:
+            if (cmd->args.flags == 0 || cmd->args.flags == 1) {
+                compact_set_enabled(cmd->args.flags == 1);
+            } else if (cmd->args.flags == 2) {
+                uint32_t fragments = count_memory_fragments();
+                uint32_t migrated = compact_memory(cmd->args.size);
+                printf("迁移页框 %u 个，空闲碎片 %u -> %u，最长连续空闲 %u 页\n",
+                       migrated, fragments, count_memory_fragments(), largest_free_run());
+            } else {
+                print_compact_stats();
+            }
+            break;
+            
+        case CMD_SHM_CREATE:
+            shm_create(cmd->args.text, cmd->args.size);
+            break;
+            
+        case CMD_SHM_DESTROY:
+            shm_destroy(cmd->args.text);
+            break;
+            
+        case CMD_SHM_ATTACH:
+            if (shm_attach(cmd->args.pid, cmd->args.text, cmd->args.addr)) {
+                printf("共享页框：%u，私有页框：%u\n", count_shared_frames(), count_private_frames());
+            }
+            break;
+            
+        case CMD_SHM_DETACH:
+            shm_detach(cmd->args.pid, cmd->args.text);
+            break;
+            
+        case CMD_SHM_LIST:
+            print_shm_status();
+            break;
+            
+        case CMD_NUMA_STAT:
+            print_numa_stats();
+            break;
+            
+        case CMD_NUMA_POLICY:
+            if (cmd->args.flags == (uint32_t)-1) {
+                printf("用法：numa policy <pid> <local/interleave/preferred> [node]\n");
+            } else {
+                numa_set_policy(cmd->args.pid, (NumaPolicy)cmd->args.flags, cmd->args.size);
+            }
+            break;
+            
+        case CMD_NUMA_HOME:
+            numa_set_home(cmd->args.pid, cmd->args.size);
+            break;
+            
+        case CMD_NUMA_BALANCE:
+            if (cmd->args.flags == 0 || cmd->args.flags == 1) {
+                numa_set_balancing(cmd->args.flags == 1);
+            } else {
+                printf("迁移热页 %u 个\n", numa_balance(0));
+            }
+            break;
+            
+        case CMD_NUMA_DISTANCE:
+            numa_set_distance(cmd->args.size);
+            break;
+            
+        case CMD_TIER_STAT:
+            print_tier_stats();
+            break;
+            
+        case CMD_TIER_SET:
+            tier_set_enabled(cmd->args.flags == 1);
+            break;
+            
+        case CMD_TIER_SCAN: {
+            uint32_t migrated = 0;
+            for (uint32_t i = 0; i < cmd->args.size; i++) {
+                migrated += tier_scan();
+            }
+            printf("扫描 %u 次，迁移页框 %u 个\n", cmd->args.size, migrated);
+            break;
+        }
+            
+        case CMD_PROFILE_START:
+            profile_start(cmd->args.pid);
+            break;
+            
+        case CMD_PROFILE_STOP:
+            profile_stop(cmd->args.pid);
+            break;
+            
+        case CMD_PROFILE_SHOW:
+            print_profile(cmd->args.pid, cmd->args.text ? strtod(cmd->args.text, NULL) : 0.0);
+            break;
+            
+        case CMD_PROFILE_HEATMAP:
+            print_profile_heatmap(cmd->args.pid);
+            break;
+            
+        case CMD_PROFILE_LIST:
+            print_profile_list();
+            break;
+            
+        case CMD_METRICS_SHOW:
+            print_metrics_summary();
+            break;
+            
+        case CMD_METRICS_PROM: {
+            MetricsSnapshot* snapshot = (MetricsSnapshot*)malloc(sizeof(MetricsSnapshot));
+            if (snapshot) {
+                metrics_snapshot(snapshot);
+                metrics_write_prometheus(stdout, snapshot);
+                metrics_snapshot_free(snapshot);
+                free(snapshot);
+            }
+            break;
+        }
+            
+        case CMD_METRICS_EXPORT:
+            if (!cmd->args.text) {
+                printf("用法: metrics export <文件> [prom/json]\n");
+            } else {
+                metrics_export(cmd->args.text, (MetricsFormat)cmd->args.size);
+            }
+            break;
+            
+        case CMD_TRACE_START:
+            trace_start();
+            break;
+            
+        case CMD_TRACE_STOP:
+            trace_stop();
+            break;
+            
+        case CMD_TRACE_EXPORT:
+            if (!cmd->args.text) {
+                printf("用法: trace export <文件>\n");
+            } else {
+                trace_export(cmd->args.text);
+            }
+            break;
+            
+        case CMD_TRACE_STAT:
+            print_trace_status();
+            break;
+            
+        case CMD_TIER_DEMOTE:
+            if (!tier_is_enabled()) {
+                printf("分层内存未开启\n");
+            } else {
+                printf("降级页面 %u 个\n", tier_demote(NULL, cmd->args.size));
+            }
+            break;
+            
+        case CMD_PROC_QUOTA:
+            process = get_process_by_pid(cmd->args.pid);
+            if (process) {
+                if (cmd->args.flags > 0 && cmd->args.size > cmd->args.flags) {
+                    printf("错误：页框下限不能大于上限\n");
                     break;
+                }
+                process->app_config.min_memory = (uint64_t)cmd->args.size * PAGE_SIZE;
+                process->app_config.max_memory = (uint64_t)cmd->args.flags * PAGE_SIZE;
+                printf("进程 %u 的页框配额已设置为：下限 %u 页，上限 %u 页\n",
+                       cmd->args.pid, cmd->args.size, cmd->args.flags);
+                if (get_replacement_scope() != REPLACE_QUOTA) {
+                    printf("提示：配额只在 'mem scope quota' 模式下生效\n");
+                }
+            } else {
+                printf("找不到进程 %u\n", cmd->args.pid);
             }
             break;
             
         default:
-            printf("δʵ\n");
+            printf("命令未实现\n");
             break;
     }
 } 
\ No newline at end of file
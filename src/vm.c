@@ -7,209 +7,432 @@
 #include <time.h>
 #include "../include/vm.h"
 #include "../include/memory.h"
-
-// ȫֱͽṹ
+#include "../include/shm.h"
+#include "../include/zswap.h"
+#include "../include/swapdev.h"
+#include "../include/swapio.h"
+#include "../include/swapalloc.h"
+#include "../include/pagecache.h"
+#include "../include/dump.h"
+#include "../include/thp.h"
+#include "../include/tlb.h"
+#include "../include/numa.h"
+#include "../include/tier.h"
+#include "../include/profile.h"
+#include "../include/metrics.h"
+#include "../include/trace.h"
+
+// 全局变量和结构体
 bool swap_out_page(uint32_t frame);
 void clock_tick_handler(void);
 uint64_t get_current_time(void);
 
-// ڴʵҳûȹ
+// 虚拟内存管理器实例，管理交换区和页面置换等功能
 VMManager vm_manager;
 
-// ҳûͳϢ
+// 页面置换统计信息
 PageReplacementStats page_stats = {0};
 
 /**
- * @brief ʼڴͳϢĳʼ
+ * @brief 初始化虚拟内存管理器，包括交换区和统计信息的初始化
  */
 void vm_init(void) {
-    // ʼ佻Ϣ
+    // 初始化交换区管理器，分配交换区块信息数组
     vm_manager.swap_blocks = (SwapBlockInfo*)calloc(SWAP_SIZE, sizeof(SwapBlockInfo));
-    // 佻ʵʴ洢ռ
-    vm_manager.swap_area = malloc(SWAP_SIZE * SWAP_BLOCK_SIZE);
-    // ʼн
+    vm_manager.swap_write_seq = (uint64_t*)calloc(SWAP_SIZE, sizeof(uint64_t));
+    vm_manager.swap_write_count = 0;
+    // 初始化空闲交换块数量
     vm_manager.swap_free_blocks = SWAP_SIZE;
     
-    // ʼڴͳ
+    // 初始化内存访问统计
     memset(&vm_manager.stats, 0, sizeof(MemoryStats));
 
-    // ڴǷɹ
-    if (!vm_manager.swap_blocks || !vm_manager.swap_area) {
-        fprintf(stderr, "ڴʼʧ\n");
-        exit(1); // ڴʧܣ˳
+    // 初始化交换区簇分配器和交换区前端的压缩池
+    swapalloc_init();
+    zswap_init();
+
+    // 检查内存分配是否成功，并打开交换设备（内存交换区或交换文件）
+    if (!vm_manager.swap_blocks || !vm_manager.swap_write_seq || !swapdev_init()) {
+        fprintf(stderr, "虚拟内存初始化失败\n");
+        exit(1); // 内存分配失败，退出程序
     }
+
+    // 交换文件的异步读写引擎
+    swapio_init();
+
+    // 分片计数器和延迟直方图随内存统计一起清零
+    metrics_reset();
 }
 
 /**
- * @brief ڴʣдȱҳжϴ
+ * @brief 处理内存访问，包括读写操作和缺页中断处理
  * 
- * @param process ҪڴĽPCB
- * @param virtual_address Ҫʵַ
- * @param is_write Ƿд
+ * @param process 要访问内存的进程PCB
+ * @param virtual_address 要访问的虚拟地址
+ * @param is_write 是否是写操作
  */
 void access_memory(PCB* process, uint32_t virtual_address, bool is_write) {
     if (!process || !process->page_table) {
-        printf("ЧĽ̻ҳ\n");
+        printf("错误：无效的进程或页表\n");
         return;
     }
     
     vm_manager.stats.total_accesses++;
     
-    // ҳźƫ
-    uint32_t page_num = (virtual_address & 0xFFFFF000) >> 12;  // 20λΪҳ
-    uint32_t offset = virtual_address & 0xFFF;                 // 12λΪҳƫ
+    // 计算页号和偏移量
+    uint32_t page_num = page_of(virtual_address);         // 高位为页号
+    uint32_t offset = offset_in_page(virtual_address);    // 低 PAGE_SHIFT 位为页内偏移
     
     if (page_num >= process->page_table_size) {
-        printf("󣺷ʵַ 0x%x (ҳ=%u, ƫ=0x%x) ҳΧ\n", 
+        printf("错误：访问地址 0x%x (页号=%u, 偏移=0x%x) 超出进程页表范围\n", 
                virtual_address, page_num, offset);
         return;
     }
     
+    // 按段统计访问，剖析开启时记录重用距离（缺页的访问也计入）
+    update_process_stats(process, page_num);
+    profile_record_access(process, page_num);
+    
     PageTableEntry* pte = &process->page_table[page_num];
+    bool resident = pte->flags.present;
+    metrics_add(resident ? METRIC_LRU_HITS : METRIC_LRU_MISSES, 1);
     
-    // ҳ治ڴ
+    // 如果页面不在内存中（同步处理的缺页由 handle_page_fault 计数）
     if (!pte->flags.present) {
-        printf("\n=== ȱҳж ===\n");
-        vm_manager.stats.page_faults++;
-        if (!handle_page_fault(process, page_num)) {
-            printf("޷ַ 0x%x\n", virtual_address);
+        printf("\n=== 处理缺页中断 ===\n");
+        
+        // 页面需要从交换文件读取时异步换入，进程阻塞直到读取完成
+        if (pte->flags.swapped && !pte->flags.shm && swapio_start_fault(process, page_num)) {
+            vm_manager.stats.page_faults++;
+            process->stats.page_faults++;
             return;
         }
+        
+        bool from_swap = pte->flags.swapped;
+        if (!handle_page_fault(process, page_num, is_write)) {
+            printf("错误：无法处理地址 0x%x\n", virtual_address);
+            return;
+        }
+        
+        // 同步换入的页面：本次访问完成后进程阻塞到缺页服务完成
+        if (from_swap) {
+            block_for_fault_service(process);
+        }
     }
     
-    // ҳʱ
+    // 更新页面访问时间，访问位供分层内存的热度扫描使用
     uint64_t current_time = get_current_time();
     pte->last_access_time = current_time;
+    pte->flags.referenced = true;
     
-    // ҳϢ
+    // 更新页框访问信息
     if (pte->flags.present) {
         uint32_t frame = pte->frame_number;
         memory_manager.frames[frame].last_access_time = current_time;
         
         if (is_write) {
+            // 写入写时复制页面时先复制出私有页面
+            if (pte->flags.cow) {
+                if (!handle_cow_fault(process, page_num)) {
+                    printf("错误：无法处理地址 0x%x 的写时复制\n", virtual_address);
+                    return;
+                }
+                frame = pte->frame_number;
+                memory_manager.frames[frame].last_access_time = current_time;
+            }
             pte->flags.dirty = true;
             memory_manager.frames[frame].is_dirty = true;
-            printf(" %d дַ 0x%x (ҳ=%u, ƫ=0x%x, ҳ=%u)\n", 
+            frame_mark_written(frame);
+            printf("进程 %d 写入地址 0x%x (页号=%u, 偏移=0x%x, 页框=%u)\n", 
                    process->pid, virtual_address, page_num, offset, frame);
         } else {
-            printf(" %d ȡַ 0x%x (ҳ=%u, ƫ=0x%x, ҳ=%u)\n", 
+            printf("进程 %d 读取地址 0x%x (页号=%u, 偏移=0x%x, 页框=%u)\n", 
                    process->pid, virtual_address, page_num, offset, frame);
         }
+        tlb_access(process, page_num);
+        numa_record_access(process, pte->frame_number);
+        tier_record_access(pte->frame_number, resident);
     }
 }
 
 /**
- * @brief ȱҳжϣҳҳû
+ * @brief 为缺页进程获取一个页框，按当前置换范围和页框配额进行置换
  * 
- * @param process ȱҳжϵĽPCB
- * @param virtual_address ȱҳжϵĵַ
- * @return true ɹ
- * @return false ʧ
+ * 配额模式下，已达到 max_memory 上限的进程不能再占用空闲页框，只能置换自己的页面；
+ * 其他进程的驻留页数不会被压到 min_memory 下限以下。
+ * 
+ * @param process 缺页进程
+ * @param virtual_page 缺页的虚拟页号
+ * @return uint32_t 页框号，失败返回-1
  */
-bool handle_page_fault(PCB* process, uint32_t virtual_page) {
-    printf("\n=== ȱҳж ===\n");
-    printf(" %u ҳ %u\n", process->pid, virtual_page);
+uint32_t obtain_frame_for_page(PCB* process, uint32_t virtual_page) {
+    bool at_ceiling = process_at_frame_ceiling(process);
+    uint32_t frame = (uint32_t)-1;
     
-    // ͳϢ
-    vm_manager.stats.page_faults++;
-    process->stats.page_faults++;
+    // 未达到上限时优先使用空闲页框，没有空闲页框时先拆分大页回收全零子页，
+    // 再把冷页降级到慢速内存层，都不行时才换出到交换区
+    if (!at_ceiling) {
+        frame = allocate_frame(process->pid, virtual_page);
+        if (frame == (uint32_t)-1 && thp_shrink(1) > 0) {
+            frame = allocate_frame(process->pid, virtual_page);
+        }
+        if (frame == (uint32_t)-1 && tier_demote(process, 1) > 0) {
+            frame = allocate_frame(process->pid, virtual_page);
+        }
+        if (frame != (uint32_t)-1) {
+            return frame;
+        }
+    } else {
+        printf("进程 %u 已达到页框上限 %u，只能置换自身页面\n",
+               process->pid, get_process_max_frames(process));
+    }
     
-    // ҳǷЧ
-    if (virtual_page >= process->page_table_size) {
-        printf("ҳ %u ҳΧ %u\n", virtual_page, process->page_table_size);
-        return false;
+    printf("\n=== 需要进行页面置换（%s） ===\n",
+           get_replacement_scope_name(get_replacement_scope()));
+    printf("当前空闲页框数: %u\n", memory_manager.free_frames_count);
+    
+    // 更新统计信息
+    vm_manager.stats.page_replacements++;
+    process->stats.page_replacements++;
+    
+    // 选择牺牲页框并换出
+    uint32_t victim_frame = evict_victim_frame(process);
+    if (victim_frame == (uint32_t)-1) {
+        printf("错误：无法置换出空闲页框\n");
+        return (uint32_t)-1;
     }
     
-    PageTableEntry* pte = &process->page_table[virtual_page];
-    printf("ҳ״̬present=%d, swapped=%d\n", 
-           pte->flags.present, pte->flags.swapped);
+    // 将页框重新分配给当前进程
+    frame = victim_frame;
+    memory_manager.frames[frame].is_allocated = true;
+    memory_manager.frames[frame].process_id = process->pid;
+    memory_manager.frames[frame].virtual_page_num = virtual_page;
+    memory_manager.frames[frame].last_access_time = get_current_time();
+    memory_manager.frames[frame].is_dirty = false;
+    memory_manager.frames[frame].ref_count = 0;
+    memory_manager.free_frames_count--;
+    frame_mark_written(frame);
     
-    // Էһҳ
-    uint32_t frame = allocate_frame(process->pid, virtual_page);
+    // 记录当前进程的映射
+    frame_get(frame, process->pid, virtual_page);
     
-    // ûпҳҪҳû
-    if (frame == (uint32_t)-1) {
-        printf("\n=== Ҫҳû ===\n");
-        printf("ǰҳ: %u\n", memory_manager.free_frames_count);
-        
-        // ͳϢ
-        vm_manager.stats.page_replacements++;
-        process->stats.page_replacements++;
-        
-        // ѡҳ
-        uint32_t victim_frame = select_victim_frame();
+    return frame;
+}
+
+/**
+ * @brief 选择牺牲页框并换出
+ * 
+ * 牺牲页框无法换出时（例如交换区已满而页面是脏的），在本次置换期间锁定该页框，
+ * 改选下一个候选页框，最多尝试 MAX_EVICTION_ATTEMPTS 个。
+ * 
+ * @param requester 缺页进程，NULL 表示全局置换
+ * @return uint32_t 已释放的页框号，失败返回-1
+ */
+uint32_t evict_victim_frame(PCB* requester) {
+    uint32_t skipped[MAX_EVICTION_ATTEMPTS];
+    uint32_t skipped_count = 0;
+    uint32_t freed = (uint32_t)-1;
+    
+    while (freed == (uint32_t)-1 && skipped_count < MAX_EVICTION_ATTEMPTS) {
+        uint32_t victim_frame = select_victim_frame_for(requester);
         if (victim_frame == (uint32_t)-1) {
-            printf("޷ѡûҳ\n");
-            return false;
+            printf("错误：无法选择置换页框\n");
+            break;
         }
         
-        // ȡҳĽ
+        // 未被映射的页缓存页框不属于任何进程
         PCB* victim_process = get_process_by_pid(memory_manager.frames[victim_frame].process_id);
-        if (!victim_process) {
-            printf("ҲҳĽ\n");
-            return false;
-        }
-        
-        uint32_t victim_page = memory_manager.frames[victim_frame].virtual_page_num;
-        printf("ѡ %u ҳ %u (ҳ %u) û\n", 
-               victim_process->pid, victim_page, victim_frame);
-        
-        // ҳд뽻
-        if (!swap_out_page(victim_frame)) {
-            printf("޷ҳд뽻\n");
-            return false;
+        bool victim_cached = pagecache_find_frame(victim_frame, NULL);
+        if (victim_process) {
+            printf("选择进程 %u 的页面 %u (页框 %u) 进行置换\n", 
+                   victim_process->pid, memory_manager.frames[victim_frame].virtual_page_num, victim_frame);
+        } else if (victim_cached) {
+            printf("选择页缓存页框 %u 进行置换\n", victim_frame);
+        } else {
+            printf("错误：找不到牺牲页框所属的进程\n");
         }
         
-        // ±ûҳҳ
-        PageTableEntry* victim_pte = &victim_process->page_table[victim_page];
-        victim_pte->flags.present = false;
-        victim_pte->flags.swapped = true;
-        printf("±ûҳҳpresent=%d, swapped=%d\n",
-               victim_pte->flags.present, victim_pte->flags.swapped);
-        
-        // ҳǰ
-        frame = victim_frame;
-        printf("ҳ %u Ϣ\n", frame);
-        printf("  ֮ǰ - pid=%u, page=%u, dirty=%d\n",
-               memory_manager.frames[frame].process_id,
-               memory_manager.frames[frame].virtual_page_num,
-               memory_manager.frames[frame].is_dirty);
-               
-        memory_manager.frames[frame].is_allocated = true;
-        memory_manager.frames[frame].process_id = process->pid;
-        memory_manager.frames[frame].virtual_page_num = virtual_page;
-        memory_manager.frames[frame].last_access_time = get_current_time();
-        memory_manager.frames[frame].is_dirty = false;
-        
-        // ҳڽУҪڴ
-        if (pte->flags.swapped) {
-            printf("ҳڽУҪڴ\n");
-            if (!swap_in_page(process->pid, virtual_page, frame)) {
-                printf("޷ӽҳ\n");
-                return false;
+        // 将牺牲页框的内容写入交换区（页缓存页框写回存储），同时更新牺牲页面的页表项
+        if ((victim_process || victim_cached) && swap_out_page(victim_frame)) {
+            if (victim_process && !victim_cached) {
+                victim_process->stats.pages_swapped_out++;
             }
+            freed = victim_frame;
+        } else {
+            printf("页框 %u 无法换出，改选其他页框\n", victim_frame);
+            memory_manager.frames[victim_frame].is_swapping = true;
+            skipped[skipped_count++] = victim_frame;
         }
-        
-        printf("  ֮ - pid=%u, page=%u, dirty=%d\n",
-               memory_manager.frames[frame].process_id,
-               memory_manager.frames[frame].virtual_page_num,
-               memory_manager.frames[frame].is_dirty);
     }
     
-    // ҳڽУҪڴ
+    for (uint32_t i = 0; i < skipped_count; i++) {
+        memory_manager.frames[skipped[i]].is_swapping = false;
+    }
+    return freed;
+}
+
+/**
+ * @brief 处理写时复制缺页：为写入进程复制一份私有页面
+ * 
+ * 如果页框只剩当前进程一个映射，直接恢复可写；否则分配新页框、
+ * 复制页面内容，并释放对共享页框的引用。
+ * 
+ * @param process 写入的进程
+ * @param virtual_page 写入的虚拟页号
+ * @return true 处理成功
+ * @return false 处理失败
+ */
+bool handle_cow_fault(PCB* process, uint32_t virtual_page) {
+    if (!process || virtual_page >= process->page_table_size) {
+        return false;
+    }
+    
+    PageTableEntry* pte = &process->page_table[virtual_page];
+    if (!pte->flags.present || !pte->flags.cow) {
+        return true;
+    }
+    
+    vm_manager.stats.cow_faults++;
+    uint32_t shared_frame = pte->frame_number;
+    FrameInfo* shared_info = &memory_manager.frames[shared_frame];
+    
+    // 只剩一个映射，无需复制
+    if (shared_info->ref_count <= 1) {
+        pte->flags.cow = false;
+        shared_info->process_id = process->pid;
+        shared_info->virtual_page_num = virtual_page;
+        frame_update_charge(shared_frame);
+        printf("进程 %u 的页面 %u 已是唯一映射，直接恢复可写\n", process->pid, virtual_page);
+        return true;
+    }
+    
+    // 复制期间锁定共享页框，防止被选为牺牲页框
+    shared_info->is_swapping = true;
+    uint32_t new_frame = obtain_frame_for_page(process, virtual_page);
+    shared_info->is_swapping = false;
+    if (new_frame == (uint32_t)-1) {
+        printf("错误：无法为写时复制分配页框\n");
+        return false;
+    }
+    
+    if (is_zero_frame(shared_frame)) {
+        // 写入零页框映射：按需分配清零的页框
+        memset(get_physical_address(new_frame), 0, PAGE_SIZE);
+    } else {
+        memcpy(get_physical_address(new_frame), get_physical_address(shared_frame), PAGE_SIZE);
+        memory_manager.frames[new_frame].is_dirty = shared_info->is_dirty;
+    }
+    
+    // 先切换页表项，再释放对共享页框的引用
+    pte->frame_number = new_frame;
+    pte->flags.cow = false;
+    release_frame(shared_frame, process->pid, virtual_page);
+    
+    if (is_zero_frame(shared_frame)) {
+        vm_manager.stats.zero_fill_faults++;
+        printf("按需清零：进程 %u 的页面 %u 首次写入，分配页框 %u\n",
+               process->pid, virtual_page, new_frame);
+        return true;
+    }
+    
+    vm_manager.stats.cow_copies++;
+    printf("写时复制：进程 %u 的页面 %u 从共享页框 %u 复制到页框 %u\n",
+           process->pid, virtual_page, shared_frame, new_frame);
+    return true;
+}
+
+/**
+ * @brief 处理缺页中断，包括页面调入和页面置换
+ * 
+ * 未写入过的页面（既不在内存也不在交换区）按需清零：读取时只读映射全局零页框，
+ * 写入时才分配页框并清零。
+ * 
+ * @param process 发生缺页中断的进程PCB
+ * @param virtual_page 发生缺页中断的虚拟页号
+ * @param is_write 是否为写访问
+ * @param in_flight 输出：页面已在异步换入中，等待其完成
+ * @return true 处理成功
+ * @return false 处理失败
+ */
+static bool service_page_fault(PCB* process, uint32_t virtual_page, bool is_write, bool* in_flight) {
+    printf("\n=== 处理缺页中断 ===\n");
+    printf("进程 %u 访问页面 %u\n", process->pid, virtual_page);
+    
+    // 更新统计信息
+    vm_manager.stats.page_faults++;
+    process->stats.page_faults++;
+    
+    // 检查页号是否有效
+    if (virtual_page >= process->page_table_size) {
+        printf("错误：页号 %u 超出页表范围 %u\n", virtual_page, process->page_table_size);
+        return false;
+    }
+    
+    PageTableEntry* pte = &process->page_table[virtual_page];
+    printf("页表项状态：present=%d, swapped=%d\n", 
+           pte->flags.present, pte->flags.swapped);
+    
+    // 页面已在异步换入中，等待读取完成
+    if (swapio_finish_fault(process, virtual_page)) {
+        *in_flight = true;
+        return true;
+    }
+    
+    // 共享内存段的页面由所属段提供页框
+    if (pte->flags.shm) {
+        return shm_handle_fault(process, virtual_page);
+    }
+    
+    // 文件映射的页面经页缓存从存储块读入
+    if (pte->flags.file) {
+        return pagecache_handle_fault(process, virtual_page);
+    }
+    
+    // 未写入过的页面，读取时映射零页框，不占用新页框
+    if (!pte->flags.swapped && !is_write) {
+        frame_get(memory_manager.zero_frame, process->pid, virtual_page);
+        pte->frame_number = memory_manager.zero_frame;
+        pte->flags.present = true;
+        pte->flags.cow = true;
+        pte->last_access_time = get_current_time();
+        vm_manager.stats.zero_page_maps++;
+        printf("页面 %u 未写入过，只读映射零页框 %u\n", virtual_page, memory_manager.zero_frame);
+        return true;
+    }
+    
+    // 未写入过的页面首次写入时，所在区域完全未映射则整体映射一个大页
+    if (!pte->flags.swapped && thp_handle_fault(process, virtual_page)) {
+        return true;
+    }
+    
+    // 按置换范围和页框配额获取页框
+    uint32_t frame = obtain_frame_for_page(process, virtual_page);
+    if (frame == (uint32_t)-1) {
+        printf("错误：无法为进程 %u 的页面 %u 获取页框\n", process->pid, virtual_page);
+        return false;
+    }
+    
+    // 如果页面在交换区中，需要调入内存
     if (pte->flags.swapped) {
-        printf("ҳڽУҪڴ\n");
-        vm_manager.stats.disk_reads++;
+        printf("页面在交换区中，需要调入内存\n");
         process->stats.pages_swapped_in++;
+        uint64_t start = get_current_time();
         if (!swap_in_page(process->pid, virtual_page, frame)) {
-            printf("޷ӽҳ\n");
+            printf("错误：无法从交换区调入页面\n");
+            free_frame(frame);
             return false;
         }
+        vm_manager.stats.major_faults++;
+        vm_manager.stats.major_fault_time_us += get_current_time() - start;
+    } else {
+        // 未写入过的页面首次写入，分配清零的页框
+        memset(get_physical_address(frame), 0, PAGE_SIZE);
+        vm_manager.stats.zero_fill_faults++;
     }
     
-    // ҳ
-    printf("µǰ̵ҳ\n");
-    printf("  ֮ǰ - present=%d, swapped=%d, frame=%u\n",
+    // 更新页表项
+    printf("更新当前进程的页表项：\n");
+    printf("  之前 - present=%d, swapped=%d, frame=%u\n",
            pte->flags.present, pte->flags.swapped, pte->frame_number);
            
     pte->frame_number = frame;
@@ -217,237 +440,393 @@ bool handle_page_fault(PCB* process, uint32_t virtual_page) {
     pte->flags.swapped = false;
     pte->last_access_time = get_current_time();
     
-    printf("  ֮ - present=%d, swapped=%d, frame=%u\n",
+    printf("  之后 - present=%d, swapped=%d, frame=%u\n",
            pte->flags.present, pte->flags.swapped, pte->frame_number);
     
-    printf("ҳ %u Ѽصҳ %u\n", virtual_page, frame);
+    printf("页面 %u 已加载到页框 %u\n", virtual_page, frame);
     
     return true;
 }
 
 /**
- * @brief ̵ҳϢ
+ * @brief 处理缺页中断，并把处理耗时记入缺页延迟直方图
+ * 
+ * 异步换入的缺页从提交到完成的耗时和跟踪事件由换入完成时记录，这里不重复记录。
+ */
+bool handle_page_fault(PCB* process, uint32_t virtual_page, bool is_write) {
+    bool in_flight = false;
+    uint64_t start = metrics_now_ns();
+    uint32_t context = trace_set_context(process->pid);
+    bool ok = service_page_fault(process, virtual_page, is_write, &in_flight);
+    trace_set_context(context);
+    if (!in_flight) {
+        if (ok) {
+            metrics_observe_ns(METRIC_FAULT_SERVICE, metrics_now_ns() - start);
+        }
+        trace_complete(TRACE_FAULT, start, process->pid, virtual_page,
+                       is_write ? TRACE_FAULT_WRITE : 0, ok);
+    }
+    return ok;
+}
+
+/**
+ * @brief 输出进程的页表信息
  * 
- * @param process ҪҳϢĽPCB
+ * @param process 要输出页表信息的进程PCB
  */
 void dump_page_table(PCB* process) {
-    printf("\n===  %u ҳ ===\n", process->pid);
+    printf("\n=== 进程 %u 的页表 ===\n", process->pid);
     int present_count = 0, swapped_count = 0;
     
-    // ̵ҳ
+    // 遍历进程的页表项
     for (uint32_t i = 0; i < process->page_table_size; i++) {
         PageTableEntry* pte = &process->page_table[i];
-        if (pte->flags.present || pte->flags.swapped) { // ҳڴл򱻽
-            printf("ҳ: %u, ״̬: %s%s, ҳ: %u\n",
+        if (pte->flags.present || pte->flags.swapped) { // 如果页面在内存中或被交换
+            printf("页号: %u, 状态: %s%s, 页框: %u\n",
                    i,
-                   pte->flags.present ? "ڴ" : "ڴ",
-                   pte->flags.swapped ? ", " : "",
+                   pte->flags.present ? "在内存" : "不在内存",
+                   pte->flags.swapped ? ", 被交换" : "",
                    pte->flags.present ? pte->frame_number : pte->flags.swap_index);
             
-            // ͳϢ
+            // 更新统计信息
             if (pte->flags.present) present_count++;
             if (pte->flags.swapped) swapped_count++;
         }
     }
     
-    // ͳϢ
-    printf("\nڴҳ: %d, ҳ: %d\n",
+    // 输出统计信息
+    printf("\n在内存的页数: %d, 被交换的页数: %d\n",
            present_count, swapped_count);
 }
 
 /**
- * @brief رڴͷԴ
+ * @brief 关闭虚拟内存管理器，释放资源
  */
 void vm_shutdown(void) {
-    free(vm_manager.swap_blocks); // ͷŽϢ
-    free(vm_manager.swap_area);   // ͷŽʵʴ洢ռ
+    free(vm_manager.swap_blocks); // 释放交换区块信息数组
+    free(vm_manager.swap_write_seq);
+    swapio_shutdown();            // 等待异步请求完成
+    swapdev_shutdown();           // 关闭交换设备
+    zswap_shutdown();             // 释放压缩交换池
 }
 
 /**
- * @brief һ飬ؽ
+ * @brief 分配一个交换区块，返回交换区块索引
  * 
- * @param process_id ID
- * @param virtual_page ҳ
- * @return uint32_t ʧܷ-1
+ * @param process_id 进程ID
+ * @param virtual_page 虚拟页号
+ * @return uint32_t 交换区块索引，如果分配失败返回-1
  */
 uint32_t allocate_swap_block(uint32_t process_id, uint32_t virtual_page) {
-    if (vm_manager.swap_free_blocks == 0) { // ûпн
+    if (vm_manager.swap_free_blocks == 0) { // 如果没有空闲交换块
         return (uint32_t)-1;
     }
 
-    // Ϣ飬ҵһеĽ
-    for (uint32_t i = 0; i < SWAP_SIZE; i++) {
-        if (!vm_manager.swap_blocks[i].is_used) {
-            vm_manager.swap_blocks[i].is_used = true; // Ϊʹ
-            vm_manager.swap_blocks[i].process_id = process_id; // ýID
-            vm_manager.swap_blocks[i].virtual_page = virtual_page; // ҳ
-            vm_manager.swap_free_blocks--; // ٿн
-            return i; // ؽ
-        }
+    // 按簇选择交换区块，使虚拟相邻的页面在交换区中也相邻
+    uint32_t i = swapalloc_alloc(process_id, virtual_page);
+    if (i == (uint32_t)-1) {
+        return (uint32_t)-1; // 如果所有交换区块都被使用，返回-1表示分配失败
     }
-    return (uint32_t)-1; // н鶼ʹã-1ʾʧ
+    vm_manager.swap_blocks[i].is_used = true; // 标记为已使用
+    vm_manager.swap_blocks[i].process_id = process_id; // 设置进程ID
+    vm_manager.swap_blocks[i].virtual_page = virtual_page; // 设置虚拟页号
+    vm_manager.swap_blocks[i].ref_count = 1; // 分配者持有一个引用
+    vm_manager.swap_free_blocks--; // 减少空闲交换块数量
+    return i; // 返回交换区块索引
 }
 
 /**
- * @brief ͷһ
+ * @brief 查找进程虚拟页所在的交换区块
  * 
- * @param swap_index 
+ * 按页表项记录的索引查找：共享的块只记录第一个映射者，不能按块信息反查。
+ * 
+ * @param process_id 进程ID
+ * @param virtual_page 虚拟页号
+ * @return uint32_t 交换区块索引，找不到返回-1
+ */
+uint32_t find_swap_block(uint32_t process_id, uint32_t virtual_page) {
+    PCB* process = get_process_by_pid(process_id);
+    if (!process || virtual_page >= process->page_table_size) {
+        return (uint32_t)-1;
+    }
+    
+    PageTableEntry* pte = &process->page_table[virtual_page];
+    uint32_t swap_index = pte->flags.swap_index;
+    if (!pte->flags.swapped || pte->flags.shm || swap_index >= SWAP_SIZE ||
+        !vm_manager.swap_blocks[swap_index].is_used) {
+        return (uint32_t)-1;
+    }
+    return swap_index;
+}
+
+/**
+ * @brief 增加一个页表项对交换区块的引用（复制进程时子进程共享父进程的块）
+ * 
+ * @param swap_index 交换区块索引
+ */
+void swap_block_get(uint32_t swap_index) {
+    if (swap_index < SWAP_SIZE && vm_manager.swap_blocks[swap_index].is_used) {
+        vm_manager.swap_blocks[swap_index].ref_count++;
+    }
+}
+
+/**
+ * @brief 释放一个交换区块的引用，最后一个引用释放时回收块
+ * 
+ * @param swap_index 交换区块索引
  */
 void free_swap_block(uint32_t swap_index) {
-    // 齻ǷЧ
+    // 其他页表项仍引用该块时只减少引用计数
+    if (swap_index < SWAP_SIZE && vm_manager.swap_blocks[swap_index].ref_count > 1) {
+        vm_manager.swap_blocks[swap_index].ref_count--;
+        return;
+    }
+    
+    // 检查交换区块索引是否有效
     if (swap_index < SWAP_SIZE && vm_manager.swap_blocks[swap_index].is_used) {
-        vm_manager.swap_blocks[swap_index].is_used = false; // Ϊδʹ
-        vm_manager.swap_blocks[swap_index].process_id = 0; // ýIDΪ0
-        vm_manager.swap_blocks[swap_index].virtual_page = 0; // ҳΪ0
-        vm_manager.swap_free_blocks++; // ӿн
+        zswap_invalidate(swap_index); // 丢弃压缩池中的数据
+        dump_forget_lazy_swap(swap_index); // 不再引用快照文件中的数据
+        swapalloc_free(swap_index); // 更新所属簇
+        vm_manager.swap_blocks[swap_index].is_used = false; // 标记为未使用
+        vm_manager.swap_blocks[swap_index].process_id = 0; // 设置进程ID为0
+        vm_manager.swap_blocks[swap_index].virtual_page = 0; // 设置虚拟页号为0
+        vm_manager.swap_blocks[swap_index].ref_count = 0;
+        vm_manager.swap_free_blocks++; // 增加空闲交换块数量
     }
 }
 
 /**
- * @brief ҳд뽻
+ * @brief 迁移交换区块（交换区整理使用），并更新页表项或共享内存段中的索引
  * 
- * @param process ҪдҳĽPCB
- * @param page_num Ҫдҳҳ
- * @return true дɹ
- * @return false дʧ
+ * 目标块必须已由分配器计入所属簇且未使用。数据保留在原来的层级：
+ * 压缩池中的块重新放入压缩池，交换设备上的块直接写入设备。
+ * 被多个页表项共享的块不迁移：块信息只记录第一个映射者，无法更新其他页表项。
+ * 
+ * @param from 原交换区块索引
+ * @param to 目标交换区块索引
+ * @return true 迁移成功
+ * @return false 迁移失败（目标块已释放，原块保持不变）
+ */
+bool relocate_swap_block(uint32_t from, uint32_t to) {
+    if (from >= SWAP_SIZE || to >= SWAP_SIZE ||
+        !vm_manager.swap_blocks[from].is_used || vm_manager.swap_blocks[to].is_used ||
+        vm_manager.swap_blocks[from].ref_count > 1) {
+        return false;
+    }
+
+    SwapBlockInfo info = vm_manager.swap_blocks[from];
+    vm_manager.swap_blocks[to] = info;
+    vm_manager.swap_free_blocks--;
+
+    uint8_t data[SWAP_BLOCK_SIZE];
+    bool in_zswap = zswap_contains(from);
+    if (!read_from_swap(from, data) ||
+        !(in_zswap ? write_to_swap(to, data) : swapdev_write(to, data))) {
+        free_swap_block(to);
+        return false;
+    }
+    vm_manager.swap_write_seq[to] = ++vm_manager.swap_write_count;
+
+    // 共享内存段的块由段记录索引，进程的块记录在页表项中
+    if (info.process_id == 0) {
+        shm_relocate_swap_block(from, to);
+    } else {
+        PCB* process = get_process_by_pid(info.process_id);
+        if (process && info.virtual_page < process->page_table_size) {
+            PageTableEntry* pte = &process->page_table[info.virtual_page];
+            if (pte->flags.swapped && pte->flags.swap_index == from) {
+                pte->flags.swap_index = to;
+            }
+        }
+    }
+
+    free_swap_block(from);
+    return true;
+}
+
+/**
+ * @brief 将页面写入交换区
+ * 
+ * @param process 要写入页面的进程PCB
+ * @param page_num 要写入页面的页号
+ * @return true 写入成功
+ * @return false 写入失败
  */
 bool page_out(PCB* process, uint32_t page_num) {
-    // ҳǷЧ
+    // 检查页号是否有效
     if (!process || page_num >= process->page_table_size ||
         !process->page_table[page_num].flags.present) {
-        printf("ҳ %u Ч\n", page_num);
+        printf("错误：页号 %u 无效\n", page_num);
         return false;
     }
 
     PageTableEntry* pte = &process->page_table[page_num];
-    // ҳǷڴ
+    // 检查页面是否在内存中
     if (!pte->flags.present) {
-        printf("ҳ %u ڴ\n", page_num);
+        printf("错误：页号 %u 不在内存中\n", page_num);
         return false;
     }
+    
+    // 大页中的页面单独换出前先拆分
+    thp_split_page(process, page_num);
+    
+    // 零页框映射和全零页面不写交换区，恢复为按需清零
+    if (!pte->flags.shm && !pte->flags.file && (is_zero_frame(pte->frame_number) ||
+                            is_zero_page(get_physical_address(pte->frame_number)))) {
+        uint32_t frame = pte->frame_number;
+        pte->frame_number = (uint32_t)-1;
+        pte->flags.present = false;
+        pte->flags.cow = false;
+        release_frame(frame, process->pid, page_num);
+        vm_manager.stats.zero_swap_skips++;
+        printf("页面 %u 内容全零，无需写入交换区\n", page_num);
+        return true;
+    }
+    
+    // 共享内存段和页缓存的页面由其持有者统一换出，这里只解除当前进程的映射
+    if (pte->flags.shm || pte->flags.file) {
+        uint32_t frame = pte->frame_number;
+        pte->frame_number = (uint32_t)-1;
+        pte->flags.present = false;
+        release_frame(frame, process->pid, page_num);
+        printf("页面 %u 属于%s，已解除映射\n", page_num, pte->flags.shm ? "共享内存段" : "文件映射");
+        return true;
+    }
 
-    // һн
+    // 分配一个空闲交换区块
     uint32_t swap_index = allocate_swap_block(process->pid, page_num);
-    if (swap_index == (uint32_t)-1) { // ʧ
-        printf("ûпн\n");
+    if (swap_index == (uint32_t)-1) { // 如果分配失败
+        printf("错误：没有空闲交换区块\n");
         return false;
     }
 
-    // ȡҳ
+    // 读取页面数据
     uint8_t page_data[PAGE_SIZE];
     if (!read_physical_memory(pte->frame_number, 0, page_data, PAGE_SIZE)) {
-        printf("󣺶ȡڴʧ\n");
-        free_swap_block(swap_index); // ͷŽ
+        printf("错误：读取物理内存失败\n");
+        free_swap_block(swap_index); // 释放交换区块
         return false;
     }
     
-    // д뽻
+    // 将数据写入交换区
     if (!write_to_swap(swap_index, page_data)) {
-        printf("д뽻ʧ\n");
-        free_swap_block(swap_index); // ͷŽ
+        printf("错误：写入交换区失败\n");
+        free_swap_block(swap_index); // 释放交换区块
         return false;
     }
 
-    // ͷҳ
-    free_frame(pte->frame_number); // ͷҳ
-    pte->frame_number = (uint32_t)-1; // ҳΪ-1ʾڴ
-    pte->flags.present = false; // ҳ治ڴ
-    pte->flags.swapped = true; // ҳ汻
-    pte->flags.swap_index = swap_index; // ý
+    // 释放页面（共享页框只释放当前进程的引用）
+    uint32_t old_frame = pte->frame_number;
+    pte->frame_number = (uint32_t)-1; // 设置页框为-1表示不在内存中
+    pte->flags.present = false; // 设置页面不在内存中
+    pte->flags.cow = false;
+    release_frame(old_frame, process->pid, page_num);
+    pte->flags.swapped = true; // 设置页面被交换
+    pte->flags.swap_index = swap_index; // 设置交换区块索引
     
-    // ͳϢ
+    // 更新统计信息
     vm_manager.stats.page_replacements++;
-    printf("ҳ %u д뽻: %u\n", page_num, swap_index);
+    printf("页面 %u 已写入交换区，交换区块索引: %u\n", page_num, swap_index);
     return true;
 }
 
 /**
- * @brief ҳڴ
+ * @brief 将页面调入内存
  * 
- * @param process ҪҳĽPCB
- * @param virtual_page Ҫҳҳ
- * @return true ɹ
- * @return false ʧ
+ * @param process 要调入页面的进程PCB
+ * @param virtual_page 要调入页面的虚拟页号
+ * @return true 调入成功
+ * @return false 调入失败
  */
 bool page_in(PCB* process, uint32_t virtual_page) {
-    // ҳǷЧ
+    // 检查页号是否有效
     if (!process || virtual_page >= process->page_table_size) {
         return false;
     }
 
     PageTableEntry* pte = &process->page_table[virtual_page];
-    // ҳǷ񱻽
+    // 检查页面是否被交换
     if (!pte->flags.swapped) {
-        return false; // ҳ治ڽfalseʾҪ
+        return false; // 如果页面不在交换区，返回false表示不需要调入
     }
 
-    // Էһҳ
-    uint32_t frame = allocate_frame(process->pid, virtual_page);
-    if (frame == (uint32_t)-1) { // ʧ
-        uint32_t victim_page = select_victim_page(process); // ѡһҳ
-        if (victim_page != (uint32_t)-1) {
-            printf("ѡ %u ҳ %u û\n", process->pid, victim_page);
-            if (page_out(process, victim_page)) { // ҳд뽻
-                frame = allocate_frame(process->pid, virtual_page); // ·ҳ
-            }
-        }
-    }
+    // 按置换范围和页框配额获取页框
+    uint32_t frame = obtain_frame_for_page(process, virtual_page);
 
-    if (frame == (uint32_t)-1) { // ʧ
+    if (frame == (uint32_t)-1) { // 如果分配失败
         return false;
     }
 
-    // ȡҳ
+    // 读取页面数据
     uint8_t page_data[PAGE_SIZE];
     uint32_t swap_index = pte->flags.swap_index;
     if (!read_from_swap(swap_index, page_data)) {
-        free_frame(frame); // ͷҳ
+        free_frame(frame); // 释放页框
         return false;
     }
 
-    // дڴ
+    // 将数据写入物理内存
     if (!write_physical_memory(frame, 0, page_data, PAGE_SIZE)) {
-        free_frame(frame); // ͷҳ
+        free_frame(frame); // 释放页框
         return false;
     }
 
-    // ҳ
+    // 更新页表项
     pte->frame_number = frame;
-    pte->flags.present = true; // ҳڴ
-    pte->flags.swapped = false; // ҳ治ڽ
+    pte->flags.present = true; // 设置页面在内存中
+    pte->flags.swapped = false; // 设置页面不在交换区
     
-    printf("ҳ %u Ѽصҳ %u\n", virtual_page, frame);
+    printf("页面 %u 已加载到页框 %u\n", virtual_page, frame);
     return true;
 }
 
 /**
- * @brief ȡн
+ * @brief 获取空闲交换区块数量
  * 
- * @return uint32_t н
+ * @return uint32_t 空闲交换区块数量
  */
 uint32_t get_free_swap_blocks(void) {
     return vm_manager.swap_free_blocks;
 }
 
 /**
- * @brief ڴͳϢ
+ * @brief 输出虚拟内存管理器的统计信息
  */
 void print_vm_stats(void) {
     float page_fault_rate = vm_manager.stats.total_accesses > 0 ? 
         (float)vm_manager.stats.page_faults * 100 / vm_manager.stats.total_accesses : 0;
     
-    printf("=== ڴͳϢ ===\n");
-    printf("ܷʴ: %u\n", vm_manager.stats.total_accesses);
-    printf("ȱҳ: %u (%.1f%%)\n", vm_manager.stats.page_faults, page_fault_rate);
-    printf("ҳû: %u\n", vm_manager.stats.page_replacements);
-    printf("д: %u\n", vm_manager.stats.disk_writes);
-    printf("ҳ: %u\n", vm_manager.stats.pages_swapped_out);
-    printf("ҳ: %u\n", vm_manager.stats.pages_swapped_in);
+    printf("=== 虚拟内存管理器统计信息 ===\n");
+    printf("页面置换范围: %s\n", get_replacement_scope_name(get_replacement_scope()));
+    printf("总访问次数: %u\n", vm_manager.stats.total_accesses);
+    printf("缺页次数: %u (%.1f%%)\n", vm_manager.stats.page_faults, page_fault_rate);
+    printf("页面置换次数: %u\n", vm_manager.stats.page_replacements);
+    printf("磁盘写入次数: %u\n", vm_manager.stats.disk_writes);
+    printf("页面调出次数: %u\n", vm_manager.stats.pages_swapped_out);
+    printf("页面调入次数: %u\n", vm_manager.stats.pages_swapped_in);
+    printf("写时复制缺页次数: %u\n", vm_manager.stats.cow_faults);
+    printf("写时复制复制页数: %u\n", vm_manager.stats.cow_copies);
+    printf("零页框只读映射次数: %u\n", vm_manager.stats.zero_page_maps);
+    printf("按需清零分配次数: %u\n", vm_manager.stats.zero_fill_faults);
+    printf("全零页面跳过换出次数: %u\n", vm_manager.stats.zero_swap_skips);
+    
+    printf("\n=== 页框共享统计信息 ===\n");
+    printf("共享页框数: %u\n", count_shared_frames());
+    printf("私有页框数: %u\n", count_private_frames());
     
-    printf("\n=== ͳϢ ===\n");
-    printf(": %u\n", SWAP_SIZE);
-    printf("н: %u\n", SWAP_SIZE - vm_manager.swap_free_blocks);
-    printf("ʹý: %u\n", vm_manager.swap_free_blocks);
+    printf("\n=== 交换区统计信息 ===\n");
+    printf("交换区块总数: %u\n", SWAP_SIZE);
+    printf("空闲交换区块数: %u\n", vm_manager.swap_free_blocks);
+    printf("已使用交换区块数: %u\n", SWAP_SIZE - vm_manager.swap_free_blocks);
+    printf("交换区实际写入次数: %u\n", vm_manager.stats.writes_to_disk);
+    printf("换入缺页次数: %u，平均换入延迟: %.2f 微秒\n", vm_manager.stats.major_faults,
+           vm_manager.stats.major_faults > 0 ?
+           (double)vm_manager.stats.major_fault_time_us / vm_manager.stats.major_faults : 0.0);
+
+    print_swapdev_stats();
+    print_swapio_stats();
+
+    print_zswap_stats();
     
     float fragmentation = 0;
     if (memory_manager.free_frames_count > 0) {
@@ -455,301 +834,403 @@ void print_vm_stats(void) {
         fragmentation = (float)fragments * 100 / memory_manager.free_frames_count;
     }
     
-    printf("\n=== ڴƬͳϢ ===\n");
-    printf("ҳ: %u\n", memory_manager.free_frames_count);
-    printf("ڴƬ: %u\n", count_memory_fragments());
-    printf("ڴƬ: %.1f%%\n", fragmentation);
+    printf("\n=== 内存碎片统计信息 ===\n");
+    printf("空闲页框数: %u\n", memory_manager.free_frames_count);
+    printf("内存碎片数: %u\n", count_memory_fragments());
+    printf("内存碎片率: %.1f%%\n", fragmentation);
+
+    print_swap_fragmentation();
 }
 
 /**
- * @brief ҳдڴ
+ * @brief 将页面数据写入物理内存
  * 
- * @param process ҪдҳĽPCB
- * @param virtual_address Ҫдҳַ
- * @param data Ҫд
- * @param size ҪдݴС
- * @return true дɹ
- * @return false дʧ
+ * @param process 要写入页面的进程PCB
+ * @param virtual_address 要写入页面的虚拟地址
+ * @param data 要写入的数据
+ * @param size 要写入的数据大小
+ * @return true 写入成功
+ * @return false 写入失败
  */
 bool write_page_data(PCB* process, uint32_t virtual_address, const void* data, size_t size) {
-    uint32_t page_num = virtual_address / PAGE_SIZE;
+    uint32_t page_num = page_of(virtual_address);
     if (!process || page_num >= process->page_table_size) {
         return false;
     }
 
-    // ҳǷڴ
+    // 检查页面是否在内存中
     if (!process->page_table[page_num].flags.present) {
-        if (!handle_page_fault(process, virtual_address)) {
+        if (!handle_page_fault(process, page_num, true)) {
             return false;
         }
     }
 
-    // ȡҳ
+    // 写时复制页面需要先复制
+    if (process->page_table[page_num].flags.cow && !handle_cow_fault(process, page_num)) {
+        return false;
+    }
+
+    // 获取页框号
     uint32_t frame = process->page_table[page_num].frame_number;
     if (!write_physical_memory(frame, 0, data, size)) {
         return false;
     }
 
-    // ҳʱ
+    // 更新页面访问时间
     process->page_table[page_num].last_access_time = get_current_time();
     return true;
 }
 
 /**
- * @brief ҳݴڴȡڴ
+ * @brief 将页面数据从物理内存读取到虚拟内存
  * 
- * @param process ҪȡҳĽPCB
- * @param virtual_address Ҫȡҳַ
- * @param buffer Ҫȡݻ
- * @param size ҪȡݴС
- * @return true ȡɹ
- * @return false ȡʧ
+ * @param process 要读取页面的进程PCB
+ * @param virtual_address 要读取页面的虚拟地址
+ * @param buffer 要读取的数据缓冲区
+ * @param size 要读取的数据大小
+ * @return true 读取成功
+ * @return false 读取失败
  */
 bool read_page_data(PCB* process, uint32_t virtual_address, void* buffer, size_t size) {
-    uint32_t page_num = virtual_address / PAGE_SIZE;
+    uint32_t page_num = page_of(virtual_address);
     if (!process || page_num >= process->page_table_size) {
         return false;
     }
 
-    // ҳǷڴ
+    // 检查页面是否在内存中
     if (!process->page_table[page_num].flags.present) {
-        if (!handle_page_fault(process, virtual_address)) {
+        if (!handle_page_fault(process, page_num, false)) {
             return false;
         }
     }
 
-    // ȡҳ
+    // 获取页框号
     uint32_t frame = process->page_table[page_num].frame_number;
     if (!read_physical_memory(frame, 0, buffer, size)) {
         return false;
     }
 
-    // ҳʱ
+    // 更新页面访问时间
     process->page_table[page_num].last_access_time = get_current_time();
     return true;
 }
 
 /**
- * @brief д뽻
+ * @brief 将数据写入交换区
  * 
- * @param swap_index 
- * @param data Ҫд
- * @return true дɹ
- * @return false дʧ
+ * @param swap_index 交换区块索引
+ * @param data 要写入的数据
+ * @return true 写入成功
+ * @return false 写入失败
  */
 bool write_to_swap(uint32_t swap_index, const void* data) {
-    if (swap_index >= SWAP_SIZE || !data) { // 齻ǷЧ
+    if (swap_index >= SWAP_SIZE || !data) { // 检查交换区块索引是否有效
         return false;
     }
 
-    // 齻Ƿʹ
+    // 检查交换区块是否被使用
     if (!vm_manager.swap_blocks[swap_index].is_used) {
         return false;
     }
+    vm_manager.swap_write_seq[swap_index] = ++vm_manager.swap_write_count;
+    dump_forget_lazy_swap(swap_index);
+
+    // 优先压缩后放入压缩池，不可压缩或池已满时再写入交换区
+    if (zswap_store(swap_index, data)) {
+        return true;
+    }
 
-    // д뽻
-    uint8_t* dest = (uint8_t*)vm_manager.swap_area + (swap_index * SWAP_BLOCK_SIZE);
-    memcpy(dest, data, SWAP_BLOCK_SIZE); // 
-    vm_manager.stats.writes_to_disk++; // Ӵд
+    // 交换文件上的写入排队后批量提交
+    if (swapio_queue_write(swap_index, data)) {
+        vm_manager.stats.writes_to_disk++;
+        return true;
+    }
+
+    // 将数据写入交换设备
+    if (!swapdev_write(swap_index, data)) {
+        return false;
+    }
+    vm_manager.stats.writes_to_disk++; // 增加磁盘写入次数
 
-    return true; // дɹ
+    return true; // 写入成功
 }
 
 /**
- * @brief ӽȡ
+ * @brief 从交换区读取数据
  * 
- * @param swap_index 
- * @param buffer Ҫȡݻ
- * @return true ȡɹ
- * @return false ȡʧ
+ * @param swap_index 交换区块索引
+ * @param buffer 要读取的数据缓冲区
+ * @return true 读取成功
+ * @return false 读取失败
  */
 bool read_from_swap(uint32_t swap_index, void* buffer) {
-    if (swap_index >= SWAP_SIZE || !buffer) { // 齻ǷЧ
+    if (swap_index >= SWAP_SIZE || !buffer) { // 检查交换区块索引是否有效
         return false;
     }
 
-    // 齻Ƿʹ
+    // 检查交换区块是否被使用
     if (!vm_manager.swap_blocks[swap_index].is_used) {
         return false;
     }
 
-    // ݴӽȡ
-    uint8_t* src = (uint8_t*)vm_manager.swap_area + (swap_index * SWAP_BLOCK_SIZE);
-    memcpy(buffer, src, SWAP_BLOCK_SIZE); // 
+    // 恢复快照后尚未读入的块从映射的快照文件解压
+    if (dump_swap_is_lazy(swap_index)) {
+        return dump_lazy_swap_read(swap_index, buffer);
+    }
+
+    // 数据在压缩池中时直接解压
+    if (zswap_load(swap_index, buffer)) {
+        return true;
+    }
 
-    return true; // ȡɹ
+    // 数据还在未落盘的写请求中
+    if (swapio_read_pending(swap_index, buffer)) {
+        return true;
+    }
+
+    // 将数据从交换设备读取到缓冲区
+    return swapdev_read(swap_index, buffer);
 }
 
 /**
- * @brief ȡϢ
+ * @brief 获取交换区块信息数组
  * 
- * @return SwapBlockInfo* Ϣ
+ * @return SwapBlockInfo* 交换区块信息数组
  */
 SwapBlockInfo* get_swap_blocks(void) {
     return vm_manager.swap_blocks;
 }
 
 /**
- * @brief ȡʵʴ洢ռ
+ * @brief 获取交换区实际存储空间
  * 
- * @return void* ʵʴ洢ռ
+ * @return void* 交换区实际存储空间
  */
 void* get_swap_area(void) {
     return vm_manager.swap_area;
 }
 
 /**
- * @brief ȡڴͳϢ
+ * @brief 获取内存访问统计信息
  * 
- * @return MemoryStats ڴͳϢ
+ * @return MemoryStats 内存访问统计信息
  */
 MemoryStats get_memory_stats(void) {
     return vm_manager.stats;
 }
 
 /**
- * @brief ͷн
+ * @brief 清理交换区，释放所有交换区块
  */
 void clean_swap_area(void) {
-    for (uint32_t i = 0; i < SWAP_BLOCKS; i++) {
-        if (vm_manager.swap_blocks[i].is_used) { // 鱻ʹ
-            vm_manager.swap_blocks[i].is_used = false; // Ϊδʹ
-            vm_manager.swap_blocks[i].process_id = 0; // ýIDΪ0
-            vm_manager.swap_blocks[i].virtual_page = 0; // ҳΪ0
-            vm_manager.swap_free_blocks++; // ӿн
+    for (uint32_t i = 0; i < SWAP_SIZE; i++) {
+        if (vm_manager.swap_blocks[i].is_used) { // 如果交换区块被使用
+            zswap_invalidate(i); // 丢弃压缩池中的数据
+            vm_manager.swap_blocks[i].is_used = false; // 标记为未使用
+            vm_manager.swap_blocks[i].process_id = 0; // 设置进程ID为0
+            vm_manager.swap_blocks[i].virtual_page = 0; // 设置虚拟页号为0
+            vm_manager.swap_blocks[i].ref_count = 0;
+            vm_manager.swap_free_blocks++; // 增加空闲交换块数量
         }
     }
+    swapalloc_rebuild();
 }
 
 /**
- * @brief ״̬
+ * @brief 输出交换区状态
  */
 void print_swap_status(void) {
     uint32_t used_blocks = 0;
-    // Ϣ飬ͳʹý
-    for (uint32_t i = 0; i < SWAP_BLOCKS; i++) {
+    // 遍历交换区块信息数组，统计已使用交换区块数量
+    for (uint32_t i = 0; i < SWAP_SIZE; i++) {
         if (vm_manager.swap_blocks[i].is_used) {
             used_blocks++;
         }
     }
-    printf("ʹý: %u\n", SWAP_BLOCKS);
-    printf("н: %u\n", SWAP_BLOCKS - used_blocks);
-    printf("ʹý: %u\n", used_blocks);
+    printf("总交换区块数: %u\n", SWAP_SIZE);
+    printf("空闲交换区块数: %u\n", SWAP_SIZE - used_blocks);
+    printf("已使用交换区块数: %u\n", used_blocks);
     
-    printf("\n״̬\n");
-    // Ϣ飬ÿ״̬
-    for (uint32_t i = 0; i < SWAP_BLOCKS; i++) {
+    printf("\n交换区块状态\n");
+    // 遍历交换区块信息数组，输出每个交换区块的状态
+    for (uint32_t i = 0; i < SWAP_SIZE; i++) {
         if (vm_manager.swap_blocks[i].is_used) {
-            printf(" %u: PID=%u, ҳ=%u\n",
+            printf(" %u: PID=%u, 虚拟页号=%u",
                    i,
                    vm_manager.swap_blocks[i].process_id,
                    vm_manager.swap_blocks[i].virtual_page);
+            if (vm_manager.swap_blocks[i].ref_count > 1) {
+                printf(", 共享引用数=%u", vm_manager.swap_blocks[i].ref_count);
+            }
+            printf("\n");
         }
     }
 }
 
 /**
- * @brief ȡһûҳ
+ * @brief 获取最后一个被置换的页面
  * 
- * @return uint32_t һûҳ
+ * @return uint32_t 最后一个被置换的页面
  */
 uint32_t get_last_replaced_page(void) {
     return vm_manager.stats.last_replaced_page;
 }
 
 /**
- * @brief ҳûͳϢ
+ * @brief 更新页面置换统计信息
  * 
- * @param page_num ûҳ
+ * @param page_num 被置换的页面
  */
 void update_replacement_stats(uint32_t page_num) {
-    vm_manager.stats.page_replacements++; // ҳû
-    vm_manager.stats.last_replaced_page = page_num; // һûҳ
-    printf("ҳ %u ûǰҳû: %u\n", page_num, vm_manager.stats.page_replacements);
+    vm_manager.stats.page_replacements++; // 增加页面置换次数
+    vm_manager.stats.last_replaced_page = page_num; // 设置最后一个被置换的页面
+    printf("页面 %u 被置换，当前页面置换次数: %u\n", page_num, vm_manager.stats.page_replacements);
 }
 
 /**
- * @brief ҳд뽻
+ * @brief 将页面写入交换区
  * 
- * @param frame Ҫдҳҳ
- * @return true дɹ
- * @return false дʧ
+ * @param frame 要写入页面的页框号
+ * @return true 写入成功
+ * @return false 写入失败
  */
-bool swap_out_page(uint32_t frame) {
+static bool write_out_frame(uint32_t frame) {
     if (frame >= PHYSICAL_PAGES || !memory_manager.frames[frame].is_allocated) {
-        printf("ҳ %u Ч\n", frame);
+        printf("错误：页框号 %u 无效\n", frame);
         return false;
     }
 
     FrameInfo* frame_info = &memory_manager.frames[frame];
-    PCB* process = get_process_by_pid(frame_info->process_id);
-    if (!process) {
-        printf("Ҳ %u\n", frame_info->process_id);
-        return false;
+    
+    // 大页中的页框被选为牺牲页框时，先把大页拆分为普通页
+    thp_split_frame(frame);
+    
+    // 页缓存的页面写回存储后直接回收，不占用交换区
+    if (pagecache_find_frame(frame, NULL)) {
+        return pagecache_evict_frame(frame);
     }
-
-    uint32_t virtual_page = frame_info->virtual_page_num;
-    if (virtual_page >= process->page_table_size) {
-        printf("ҳ %u ҳΧ %u\n", virtual_page, process->page_table_size);
+    
+    // 通过反向映射查找映射该页框的所有页表项，页框释放后不能留下仍指向它的映射
+    FrameMapping* mappings;
+    uint32_t mapping_count;
+    if (!collect_frame_mappings(frame, &mappings, &mapping_count)) {
         return false;
     }
-
-    // һн
-    uint32_t swap_index = allocate_swap_block(process->pid, virtual_page);
-    if (swap_index == (uint32_t)-1) {
-        printf("޷佻\n");
+    
+    uint32_t segment_id, segment_page;
+    bool is_shm = shm_find_frame(frame, &segment_id, &segment_page);
+    if (mapping_count == 0 && !is_shm) {
+        printf("错误：找不到进程 %u\n", frame_info->process_id);
+        free(mappings);
         return false;
     }
 
-    // ҳд뽻
-    void* page_data = get_physical_memory() + (frame * PAGE_SIZE);
-    if (!write_to_swap(swap_index, page_data)) {
-        printf("д뽻ʧ\n");
-        free_swap_block(swap_index);
-        return false;
+    uint32_t swap_index = (uint32_t)-1;
+    bool is_zero = !is_shm && is_zero_page(get_physical_address(frame));
+    if (is_zero) {
+        // 全零页面无需写入交换区，页表项恢复为按需清零
+        vm_manager.stats.zero_swap_skips++;
+    } else if (is_shm) {
+        // 共享内存段的页面只写一份，由段记录交换区块
+        if (!shm_swap_out_page(segment_id, segment_page, frame)) {
+            free(mappings);
+            return false;
+        }
+    } else {
+        // 写时复制共享的页框只写一份，所有映射共享同一个交换区块
+        swap_index = allocate_swap_block(mappings[0].process->pid, mappings[0].virtual_page);
+        if (swap_index == (uint32_t)-1) {
+            printf("错误：无法分配交换区块\n");
+            free(mappings);
+            return false;
+        }
+
+        // 将页面数据写入交换区
+        void* page_data = get_physical_memory() + ((size_t)frame * PAGE_SIZE);
+        if (!write_to_swap(swap_index, page_data)) {
+            printf("错误：写入交换区失败\n");
+            free_swap_block(swap_index);
+            free(mappings);
+            return false;
+        }
+        vm_manager.swap_blocks[swap_index].ref_count = mapping_count;
     }
 
-    // ҳ
-    PageTableEntry* pte = &process->page_table[virtual_page];
-    pte->flags.present = false;
-    pte->flags.swapped = true;
-    pte->flags.swap_index = swap_index;
+    // 更新页表项，所有映射一并失效
+    for (uint32_t i = 0; i < mapping_count; i++) {
+        PageTableEntry* pte = &mappings[i].process->page_table[mappings[i].virtual_page];
+        pte->flags.present = false;
+        pte->flags.cow = false;
+        if (is_shm || is_zero) {
+            pte->frame_number = (uint32_t)-1;
+        } else {
+            pte->flags.swapped = true;
+            pte->flags.swap_index = swap_index;
+        }
+    }
+    uint32_t virtual_page = frame_info->virtual_page_num;
 
-    // ҳ汻޸ĹҪд
+    // 如果页面被修改过，需要写入磁盘
     if (frame_info->is_dirty) {
         vm_manager.stats.disk_writes++;
     }
     vm_manager.stats.pages_swapped_out++;
 
-    // ҳϢ
+    // 更新页框信息
     frame_info->is_allocated = false;
     frame_info->process_id = 0;
     frame_info->virtual_page_num = 0;
     frame_info->is_dirty = false;
+    frame_info->ref_count = 0;
+    clear_frame_mappings(frame);
+    frame_update_charge(frame);
     memory_manager.free_frames_count++;
 
-    printf("ҳ %u д뽻: %u\n", virtual_page, swap_index);
+    if (mapping_count > 1) {
+        printf("共享页框 %u 的 %u 个映射已全部换出\n", frame, mapping_count);
+    }
+    if (is_zero) {
+        printf("页面 %u 内容全零，跳过交换区写入\n", virtual_page);
+    } else if (!is_shm) {
+        printf("页面 %u 已写入交换区，交换区块索引: %u\n", virtual_page, swap_index);
+    }
 
+    free(mappings);
     return true;
 }
 
 /**
- * @brief ȡǰʱ
+ * @brief 换出一个页框，并把耗时记入换出延迟直方图和事件跟踪
+ */
+bool swap_out_page(uint32_t frame) {
+    uint32_t owner = frame < PHYSICAL_PAGES ? memory_manager.frames[frame].process_id : 0;
+    uint32_t page = frame < PHYSICAL_PAGES ? memory_manager.frames[frame].virtual_page_num : 0;
+    uint64_t start = metrics_now_ns();
+    bool ok = write_out_frame(frame);
+    if (ok) {
+        metrics_observe_ns(METRIC_EVICTION, metrics_now_ns() - start);
+        trace_complete(TRACE_EVICT, start, trace_context(), frame, owner, page);
+    }
+    return ok;
+}
+
+/**
+ * @brief 获取当前时间
  * 
- * @return uint64_t ǰʱ
+ * @return uint64_t 当前时间
  */
 uint64_t get_current_time(void) {
 #ifdef _WIN32
-    // WindowsϵͳGetSystemTimeAsFileTime
+    // Windows系统调用GetSystemTimeAsFileTime
     FILETIME ft;
     GetSystemTimeAsFileTime(&ft);
     ULARGE_INTEGER uli;
     uli.LowPart = ft.dwLowDateTime;
     uli.HighPart = ft.dwHighDateTime;
-    // תΪ΢루Windowsʱ160111յڵ΢
+    // 转换为微秒（Windows时间从1601年1月1日到现在的微秒数）
     return (uli.QuadPart - 116444736000000000ULL) / 10;
 #else
-    // Windowsϵͳclock_gettime
+    // 非Windows系统调用clock_gettime
     struct timespec ts;
     clock_gettime(CLOCK_MONOTONIC, &ts);
     return (ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
@@ -757,72 +1238,71 @@ uint64_t get_current_time(void) {
 }
 
 /**
- * @brief ҳûͳϢ
+ * @brief 输出页面置换统计信息
  */
 void print_page_replacement_stats(void) {
-    printf("\n=== ҳûͳϢ ===\n");
-    printf("ȱҳ: %u\n", page_stats.total_page_faults);
-    printf("ҳû: %u\n", page_stats.page_replacements);
-    printf("̶ȡ: %u\n", page_stats.disk_reads);
-    printf("д: %u\n", page_stats.disk_writes);
-    printf("LRU: %.2f%%\n", 
+    // 从内存统计和指标注册表取值，不再单独计数
+    page_stats.total_page_faults = vm_manager.stats.page_faults;
+    page_stats.page_replacements = vm_manager.stats.page_replacements;
+    page_stats.disk_reads = vm_manager.stats.disk_reads;
+    page_stats.disk_writes = vm_manager.stats.disk_writes;
+    page_stats.lru_hits = (uint32_t)metrics_counter_value(METRIC_LRU_HITS);
+    page_stats.lru_misses = (uint32_t)metrics_counter_value(METRIC_LRU_MISSES);
+
+    printf("\n=== 页面置换统计信息 ===\n");
+    printf("总缺页次数: %u\n", page_stats.total_page_faults);
+    printf("页面置换次数: %u\n", page_stats.page_replacements);
+    printf("磁盘读取次数: %u\n", page_stats.disk_reads);
+    printf("磁盘写入次数: %u\n", page_stats.disk_writes);
+    printf("LRU命中率: %.2f%%\n", 
            page_stats.lru_hits + page_stats.lru_misses > 0 ?
            (float)page_stats.lru_hits / (page_stats.lru_hits + page_stats.lru_misses) * 100 : 0);
 }
 
 /**
- * @brief ӽҳصڴ
+ * @brief 从交换区将页面加载到内存
  * 
- * @param pid ID
- * @param virtual_page ҳ
- * @param frame Ŀҳ
- * @return true سɹ
- * @return false ʧ
+ * @param pid 进程ID
+ * @param virtual_page 虚拟页号
+ * @param frame 目标页框号
+ * @return true 加载成功
+ * @return false 加载失败
  */
 bool swap_in_page(uint32_t pid, uint32_t virtual_page, uint32_t frame) {
-    // Ч
+    // 检查参数有效性
     if (frame >= PHYSICAL_PAGES) {
-        printf("Чҳ %u\n", frame);
+        printf("错误：无效的页框号 %u\n", frame);
         return false;
     }
 
-    // ҶӦĽ
-    uint32_t swap_index = (uint32_t)-1;
-    for (uint32_t i = 0; i < SWAP_SIZE; i++) {
-        if (vm_manager.swap_blocks[i].is_used &&
-            vm_manager.swap_blocks[i].process_id == pid &&
-            vm_manager.swap_blocks[i].virtual_page == virtual_page) {
-            swap_index = i;
-            break;
-        }
-    }
-
+    // 查找对应的交换区块
+    uint32_t swap_index = find_swap_block(pid, virtual_page);
     if (swap_index == (uint32_t)-1) {
-        printf("ڽҲ %u ҳ %u\n", pid, virtual_page);
+        printf("错误：在交换区中找不到进程 %u 的页面 %u\n", pid, virtual_page);
         return false;
     }
 
-    // ȡ
+    // 读取交换区数据
     uint8_t page_data[PAGE_SIZE];
     if (!read_from_swap(swap_index, page_data)) {
-        printf("󣺴ӽȡʧ\n");
+        printf("错误：从交换区读取数据失败\n");
         return false;
     }
 
-    // дڴ
+    // 将数据写入物理内存
     if (!write_physical_memory(frame, 0, page_data, PAGE_SIZE)) {
-        printf("дڴʧ\n");
+        printf("错误：写入物理内存失败\n");
         return false;
     }
 
-    // ͷŽ
+    // 释放交换区块
     free_swap_block(swap_index);
 
-    // ͳϢ
+    // 更新统计信息
     vm_manager.stats.disk_reads++;
     vm_manager.stats.pages_swapped_in++;
 
-    printf("ҳɹӽصڴ棺PID=%u, ҳ=%u, ҳ=%u\n", 
+    printf("页面成功从交换区加载到内存：PID=%u, 虚拟页号=%u, 页框=%u\n", 
            pid, virtual_page, frame);
     return true;
 }
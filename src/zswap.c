@@ -0,0 +1,210 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../include/zswap.h"
+#include "../include/compress.h"
+#include "../include/vm.h"
+
+// 压缩交换池状态
+static bool zswap_enabled = true;
+static uint8_t* pool = NULL;
+static bool* chunk_used = NULL;          // ZSWAP_POOL_CHUNKS 项
+static uint32_t next_chunk = 0;           // 下次分配的起始搜索位置
+static uint32_t used_chunks = 0;
+static ZswapEntry* entries = NULL;       // SWAP_SIZE 项
+static ZswapStats stats;
+
+// 初始化压缩交换池
+void zswap_init(void) {
+    if (!pool) {
+        pool = (uint8_t*)malloc((size_t)ZSWAP_POOL_PAGES * PAGE_SIZE);
+        if (!pool) {
+            fprintf(stderr, "压缩交换池初始化失败，禁用压缩交换\n");
+            zswap_enabled = false;
+        }
+    }
+    if (!entries) {
+        chunk_used = (bool*)malloc(sizeof(bool) * ZSWAP_POOL_CHUNKS);
+        entries = (ZswapEntry*)malloc(sizeof(ZswapEntry) * SWAP_SIZE);
+        if (!chunk_used || !entries) {
+            fprintf(stderr, "压缩交换池初始化失败\n");
+            exit(1);
+        }
+    }
+
+    memset(chunk_used, 0, sizeof(bool) * ZSWAP_POOL_CHUNKS);
+    memset(entries, 0, sizeof(ZswapEntry) * SWAP_SIZE);
+    memset(&stats, 0, sizeof(stats));
+    next_chunk = 0;
+    used_chunks = 0;
+}
+
+// 释放压缩交换池
+void zswap_shutdown(void) {
+    free(pool);
+    pool = NULL;
+}
+
+void zswap_set_enabled(bool enabled) {
+    if (enabled && !pool) {
+        printf("压缩交换池未初始化，无法开启\n");
+        return;
+    }
+    zswap_enabled = enabled;
+    printf("压缩交换池已%s（池中已有页面仍可读取）\n", enabled ? "开启" : "关闭");
+}
+
+bool zswap_is_enabled(void) {
+    return zswap_enabled;
+}
+
+// 从上次位置开始查找连续的空闲分配块（首次适应）
+static uint32_t allocate_chunks(uint32_t count) {
+    for (uint32_t scanned = 0; scanned < ZSWAP_POOL_CHUNKS; ) {
+        uint32_t start = (next_chunk + scanned) % ZSWAP_POOL_CHUNKS;
+        if (start + count > ZSWAP_POOL_CHUNKS) {
+            // 剩余空间不足以放下，回到池开头继续
+            scanned += ZSWAP_POOL_CHUNKS - start;
+            continue;
+        }
+
+        uint32_t run = 0;
+        while (run < count && !chunk_used[start + run]) {
+            run++;
+        }
+        if (run == count) {
+            for (uint32_t i = 0; i < count; i++) {
+                chunk_used[start + i] = true;
+            }
+            used_chunks += count;
+            next_chunk = (start + count) % ZSWAP_POOL_CHUNKS;
+            return start;
+        }
+        scanned += run + 1;
+    }
+    return (uint32_t)-1;
+}
+
+static void free_chunks(uint32_t first, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        chunk_used[first + i] = false;
+    }
+    used_chunks -= count;
+}
+
+/**
+ * @brief 把交换区块的数据压缩后放入压缩池
+ *
+ * 压缩后超过 ZSWAP_MAX_STORED_SIZE 或池中没有足够的连续空间时返回 false，
+ * 由调用者把原始数据写入交换区。
+ *
+ * @param swap_index 交换区块索引
+ * @param data 页面数据
+ * @return true 已放入压缩池
+ * @return false 需要写入交换区
+ */
+bool zswap_store(uint32_t swap_index, const void* data) {
+    if (swap_index >= SWAP_SIZE) {
+        return false;
+    }
+
+    // 覆盖写入时先丢弃旧的压缩数据
+    zswap_invalidate(swap_index);
+
+    if (!zswap_enabled || !pool) {
+        return false;
+    }
+
+    uint8_t buffer[LZ_COMPRESS_BOUND(PAGE_SIZE)];
+    uint64_t start = get_current_time();
+    size_t length = lz_compress((const uint8_t*)data, PAGE_SIZE, buffer, ZSWAP_MAX_STORED_SIZE);
+    stats.compress_time_us += get_current_time() - start;
+    stats.store_attempts++;
+
+    if (length == 0) {
+        stats.rejected_pages++;
+        return false;
+    }
+
+    uint32_t count = (uint32_t)((length + ZSWAP_CHUNK_SIZE - 1) / ZSWAP_CHUNK_SIZE);
+    uint32_t first = allocate_chunks(count);
+    if (first == (uint32_t)-1) {
+        stats.spilled_pages++;
+        return false;
+    }
+
+    memcpy(pool + (size_t)first * ZSWAP_CHUNK_SIZE, buffer, length);
+
+    ZswapEntry* entry = &entries[swap_index];
+    entry->stored = true;
+    entry->first_chunk = first;
+    entry->chunk_count = count;
+    entry->length = (uint32_t)length;
+
+    stats.stored_pages++;
+    stats.original_bytes += PAGE_SIZE;
+    stats.compressed_bytes += length;
+    return true;
+}
+
+// 从压缩池中读取交换区块，不在池中时返回 false
+bool zswap_load(uint32_t swap_index, void* buffer) {
+    if (swap_index >= SWAP_SIZE || !entries[swap_index].stored) {
+        return false;
+    }
+
+    ZswapEntry* entry = &entries[swap_index];
+    uint64_t start = get_current_time();
+    size_t length = lz_decompress(pool + (size_t)entry->first_chunk * ZSWAP_CHUNK_SIZE,
+                                  entry->length, (uint8_t*)buffer, PAGE_SIZE);
+    stats.decompress_time_us += get_current_time() - start;
+    stats.loads++;
+
+    if (length != PAGE_SIZE) {
+        printf("错误：交换区块 %u 的压缩数据已损坏\n", swap_index);
+        return false;
+    }
+    return true;
+}
+
+// 丢弃交换区块在压缩池中的数据
+void zswap_invalidate(uint32_t swap_index) {
+    if (swap_index >= SWAP_SIZE || !entries[swap_index].stored) {
+        return;
+    }
+
+    ZswapEntry* entry = &entries[swap_index];
+    free_chunks(entry->first_chunk, entry->chunk_count);
+    stats.stored_pages--;
+    stats.original_bytes -= PAGE_SIZE;
+    stats.compressed_bytes -= entry->length;
+    memset(entry, 0, sizeof(ZswapEntry));
+}
+
+// 交换区块的数据是否在压缩池中
+bool zswap_contains(uint32_t swap_index) {
+    return swap_index < SWAP_SIZE && entries[swap_index].stored;
+}
+
+ZswapStats get_zswap_stats(void) {
+    return stats;
+}
+
+// 打印压缩交换池统计信息
+void print_zswap_stats(void) {
+    printf("\n=== 压缩交换池统计信息 ===\n");
+    printf("状态: %s\n", zswap_enabled ? "开启" : "关闭");
+    printf("池容量: %u KB，已用: %u KB (%.1f%%)\n",
+           ZSWAP_POOL_PAGES * PAGE_SIZE / 1024,
+           used_chunks * ZSWAP_CHUNK_SIZE / 1024,
+           (float)used_chunks * 100 / ZSWAP_POOL_CHUNKS);
+    printf("池中页面数: %u\n", stats.stored_pages);
+    printf("压缩率: %.2f:1\n", stats.compressed_bytes > 0 ?
+           (double)stats.original_bytes / stats.compressed_bytes : 0.0);
+    printf("不可压缩页面数: %u\n", stats.rejected_pages);
+    printf("池满写入交换区页面数: %u\n", stats.spilled_pages);
+    printf("平均压缩耗时: %.2f 微秒\n", stats.store_attempts > 0 ?
+           (double)stats.compress_time_us / stats.store_attempts : 0.0);
+    printf("平均解压耗时: %.2f 微秒\n", stats.loads > 0 ?
+           (double)stats.decompress_time_us / stats.loads : 0.0);
+}